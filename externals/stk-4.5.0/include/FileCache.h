@@ -0,0 +1,55 @@
+#ifndef STK_FILECACHE_H
+#define STK_FILECACHE_H
+
+#include "Stk.h"
+#include <memory>
+
+namespace stk {
+
+/***************************************************/
+/*! \class FileCache
+    \brief Process-wide cache of decoded audio files.
+
+    FileWvIn and FileLoop objects loading the same file
+    entirely into memory (e.g. the instruments rawwaves)
+    share a single read-only copy of the decoded samples,
+    so that the file is read from disk only once and every
+    instrument instance (or voice) only keeps its own
+    playback state.
+
+    The data is reference counted: it stays valid as long
+    as an object uses it, even after clear() has been called.
+    The cache is thread-safe.
+
+    Added for qmusic, not part of the original STK.
+*/
+/***************************************************/
+
+class FileCache
+{
+public:
+  //! Decoded file data shared between the readers.
+  typedef std::shared_ptr<const StkFrames> Data;
+
+  //! Return the decoded content of a file, loading it if needed.
+  /*!
+    The data layout is the one used by FileWvIn, or by FileLoop
+    when \e loop is true (the first frame is repeated after the last
+    one).  A null pointer is returned for files larger than \e
+    maxFrames, which are to be read incrementally.  An StkError is
+    thrown if the file cannot be read.
+  */
+  static Data load( const std::string &fileName, bool raw, bool doNormalize,
+                    bool loop, unsigned long maxFrames );
+
+  //! Release the cache references to the data.
+  /*!
+    Files are read again on next load, the data still used
+    by the readers is released by the last of them.
+  */
+  static void clear( void );
+};
+
+} // stk namespace
+
+#endif
@@ -3,6 +3,7 @@
 
 #include "WvIn.h"
 #include "FileRead.h"
+#include "FileCache.h"
 
 namespace stk {
 
@@ -89,7 +90,7 @@ public:
   virtual void normalize( StkFloat peak );
 
   //! Return the file size in sample frames.
-  virtual unsigned long getSize( void ) const { return file_.fileSize(); };
+  virtual unsigned long getSize( void ) const { return fileSize_; };
 
   //! Return the input file sample rate in Hz (not the data read rate).
   /*!
@@ -100,7 +101,7 @@ public:
   virtual StkFloat getFileRate( void ) const { return data_.dataRate(); };
 
   //! Query whether a file is open.
-  bool isOpen( void ) { return file_.isOpen(); };
+  bool isOpen( void ) { return sharedData_ || file_.isOpen(); };
 
   //! Query whether reading is complete.
   bool isFinished( void ) const { return finished_; };
@@ -165,7 +166,19 @@ protected:
 
   void sampleRateChanged( StkFloat newRate, StkFloat oldRate );
 
+  // Samples to read from, shared or owned.
+  const StkFrames& frames( void ) const { return sharedData_ ? *sharedData_ : data_; };
+
+  // Use the cached file data, if the file is not to be read by chunks.
+  // data_ then only keeps the number of channels and the data rate.
+  bool openShared( const std::string &fileName, bool raw, bool doNormalize, bool loop );
+
+  // Take a private copy of shared data, before modifying it.
+  void detachShared( void );
+
   FileRead file_;
+  FileCache::Data sharedData_;
+  unsigned long fileSize_;
   bool finished_;
   bool interpolate_;
   bool normalizing_;
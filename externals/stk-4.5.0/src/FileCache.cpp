@@ -0,0 +1,95 @@
+/***************************************************/
+/*! \class FileCache
+    \brief Process-wide cache of decoded audio files.
+
+    FileWvIn and FileLoop objects loading the same file
+    entirely into memory (e.g. the instruments rawwaves)
+    share a single read-only copy of the decoded samples,
+    so that the file is read from disk only once and every
+    instrument instance (or voice) only keeps its own
+    playback state.
+
+    Added for qmusic, not part of the original STK.
+*/
+/***************************************************/
+
+#include "FileCache.h"
+#include "FileRead.h"
+#include <cmath>
+#include <map>
+#include <mutex>
+
+namespace stk {
+
+namespace {
+
+struct Key
+{
+  std::string fileName;
+  bool raw;
+  bool doNormalize;
+  bool loop;
+
+  bool operator< ( const Key &other ) const
+  {
+    if ( fileName != other.fileName ) return fileName < other.fileName;
+    if ( raw != other.raw ) return raw < other.raw;
+    if ( doNormalize != other.doNormalize ) return doNormalize < other.doNormalize;
+    return loop < other.loop;
+  }
+};
+
+std::mutex cacheMutex;
+std::map<Key, FileCache::Data> cache;
+
+} // namespace
+
+FileCache::Data FileCache :: load( const std::string &fileName, bool raw, bool doNormalize,
+                                   bool loop, unsigned long maxFrames )
+{
+  Key key = { fileName, raw, doNormalize, loop };
+
+  std::lock_guard<std::mutex> lock( cacheMutex );
+  std::map<Key, Data>::const_iterator it = cache.find( key );
+  if ( it != cache.end() && it->second->frames() <= maxFrames + ( loop ? 1 : 0 ) )
+    return it->second;
+
+  // Attempt to open the file ... an error might be thrown here.
+  FileRead file( fileName, raw );
+  if ( file.fileSize() > maxFrames ) return Data();
+
+  std::shared_ptr<StkFrames> data( new StkFrames( file.fileSize() + ( loop ? 1 : 0 ), file.channels() ) );
+  file.read( *data, 0, doNormalize );
+  file.close();
+
+  // Copy the first sample frame to the last one for looping.
+  if ( loop ) {
+    for ( unsigned int i=0; i<data->channels(); i++ )
+      (*data)( data->frames() - 1, i ) = (*data)[i];
+  }
+
+  // Normalize all channels equally by the greatest magnitude.
+  if ( doNormalize ) {
+    StkFloat max = 0.0;
+    for ( size_t i=0; i<data->size(); i++ ) {
+      if ( fabs( (*data)[i] ) > max )
+        max = (StkFloat) fabs( (double) (*data)[i] );
+    }
+    if ( max > 0.0 ) {
+      max = 1.0 / max;
+      for ( size_t i=0; i<data->size(); i++ )
+        (*data)[i] *= max;
+    }
+  }
+
+  cache[key] = data;
+  return data;
+}
+
+void FileCache :: clear( void )
+{
+  std::lock_guard<std::mutex> lock( cacheMutex );
+  cache.clear();
+}
+
+} // stk namespace
@@ -45,8 +45,17 @@ void FileLoop :: openFile( std::string fileName, bool raw, bool doNormalize )
   // Call close() in case another file is already open.
   this->closeFile();
 
+  // Files loaded at once are shared through the cache.
+  if ( this->openShared( fileName, raw, doNormalize, true ) ) {
+    lastFrame_.resize( 1, data_.channels() );
+    this->setRate( data_.dataRate() / Stk::sampleRate() );
+    this->reset();
+    return;
+  }
+
   // Attempt to open the file ... an error might be thrown here.
   file_.open( fileName, raw );
+  fileSize_ = file_.fileSize();
 
   // Determine whether chunking or not.
   if ( file_.fileSize() > chunkThreshold_ ) {
@@ -98,7 +107,7 @@ void FileLoop :: addTime( StkFloat time )
   // Add an absolute time in samples.
   time_ += time;
 
-  StkFloat fileSize = file_.fileSize();
+  StkFloat fileSize = fileSize_;
   while ( time_ < 0.0 )
     time_ += fileSize;
   while ( time_ >= fileSize )
@@ -108,7 +117,7 @@ void FileLoop :: addTime( StkFloat time )
 void FileLoop :: addPhase( StkFloat angle )
 {
   // Add a time in cycles (one cycle = fileSize).
-  StkFloat fileSize = file_.fileSize();
+  StkFloat fileSize = fileSize_;
   time_ += fileSize * angle;
 
   while ( time_ < 0.0 )
@@ -120,7 +129,7 @@ void FileLoop :: addPhase( StkFloat angle )
 void FileLoop :: addPhaseOffset( StkFloat angle )
 {
   // Add a phase offset in cycles, where 1.0 = fileSize.
-  phaseOffset_ = file_.fileSize() * angle;
+  phaseOffset_ = fileSize_ * angle;
 }
 
 StkFloat FileLoop :: tick( unsigned int channel )
@@ -134,7 +143,7 @@ StkFloat FileLoop :: tick( unsigned int channel )
 
   // Check limits of time address ... if necessary, recalculate modulo
   // fileSize.
-  StkFloat fileSize = file_.fileSize();
+  StkFloat fileSize = fileSize_;
 
   while ( time_ < 0.0 )
     time_ += fileSize;
@@ -162,8 +171,8 @@ StkFloat FileLoop :: tick( unsigned int channel )
       }
       while ( time_ > (StkFloat) ( chunkPointer_ + chunkSize_ - 1 ) ) { // positive rate
         chunkPointer_ += chunkSize_ - 1; // overlap chunks by one frame
-        if ( chunkPointer_ + chunkSize_ > file_.fileSize() ) { // at end of file
-          chunkPointer_ = file_.fileSize() - chunkSize_ + 1; // leave extra frame at end of buffer
+        if ( chunkPointer_ + chunkSize_ > fileSize_ ) { // at end of file
+          chunkPointer_ = fileSize_ - chunkSize_ + 1; // leave extra frame at end of buffer
           // Now fill extra frame with first frame data.
           for ( unsigned int j=0; j<firstFrame_.channels(); j++ )
             data_( data_.frames() - 1, j ) = firstFrame_[j];
@@ -180,11 +189,11 @@ StkFloat FileLoop :: tick( unsigned int channel )
 
   if ( interpolate_ ) {
     for ( unsigned int i=0; i<lastFrame_.size(); i++ )
-      lastFrame_[i] = data_.interpolate( tyme, i );
+      lastFrame_[i] = frames().interpolate( tyme, i );
   }
   else {
     for ( unsigned int i=0; i<lastFrame_.size(); i++ )
-      lastFrame_[i] = data_( (size_t) tyme, i );
+      lastFrame_[i] = frames()( (size_t) tyme, i );
   }
 
   // Increment time, which can be negative.
@@ -195,7 +204,7 @@ StkFloat FileLoop :: tick( unsigned int channel )
 
 StkFrames& FileLoop :: tick( StkFrames& frames )
 {
-  if ( !file_.isOpen() ) {
+  if ( !this->isOpen() ) {
 #if defined(_STK_DEBUG_)
     oStream_ << "FileLoop::tick(): no file data is loaded!";
     handleError( StkError::WARNING );
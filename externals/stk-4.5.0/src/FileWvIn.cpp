@@ -37,7 +37,7 @@
 namespace stk {
 
 FileWvIn :: FileWvIn( unsigned long chunkThreshold, unsigned long chunkSize )
-  : finished_(true), interpolate_(false), time_(0.0), rate_(0.0),
+  : fileSize_(0), finished_(true), interpolate_(false), time_(0.0), rate_(0.0),
     chunkThreshold_(chunkThreshold), chunkSize_(chunkSize)
 {
   Stk::addSampleRateAlert( this );
@@ -45,7 +45,7 @@ FileWvIn :: FileWvIn( unsigned long chunkThreshold, unsigned long chunkSize )
 
 FileWvIn :: FileWvIn( std::string fileName, bool raw, bool doNormalize,
                       unsigned long chunkThreshold, unsigned long chunkSize )
-  : finished_(true), interpolate_(false), time_(0.0), rate_(0.0),
+  : fileSize_(0), finished_(true), interpolate_(false), time_(0.0), rate_(0.0),
     chunkThreshold_(chunkThreshold), chunkSize_(chunkSize)
 {
   openFile( fileName, raw, doNormalize );
@@ -67,6 +67,8 @@ void FileWvIn :: sampleRateChanged( StkFloat newRate, StkFloat oldRate )
 void FileWvIn :: closeFile( void )
 {
   if ( file_.isOpen() ) file_.close();
+  sharedData_.reset();
+  fileSize_ = 0;
   finished_ = true;
   lastFrame_.resize( 0, 0 );
 }
@@ -76,8 +78,17 @@ void FileWvIn :: openFile( std::string fileName, bool raw, bool doNormalize )
   // Call close() in case another file is already open.
   this->closeFile();
 
+  // Files loaded at once are shared through the cache.
+  if ( this->openShared( fileName, raw, doNormalize, false ) ) {
+    lastFrame_.resize( 1, data_.channels() );
+    this->setRate( data_.dataRate() / Stk::sampleRate() );
+    this->reset();
+    return;
+  }
+
   // Attempt to open the file ... an error might be thrown here.
   file_.open( fileName, raw );
+  fileSize_ = file_.fileSize();
 
   // Determine whether chunking or not.
   if ( file_.fileSize() > chunkThreshold_ ) {
@@ -106,6 +117,28 @@ void FileWvIn :: openFile( std::string fileName, bool raw, bool doNormalize )
   this->reset();
 }
 
+bool FileWvIn :: openShared( const std::string &fileName, bool raw, bool doNormalize, bool loop )
+{
+  // Attempt to load the file ... an error might be thrown here.
+  sharedData_ = FileCache::load( fileName, raw, doNormalize, loop, chunkThreshold_ );
+  if ( !sharedData_ ) return false;
+
+  chunking_ = false;
+  fileSize_ = sharedData_->frames() - ( loop ? 1 : 0 );
+  data_.resize( 0, sharedData_->channels() );
+  data_.setDataRate( sharedData_->dataRate() );
+  return true;
+}
+
+void FileWvIn :: detachShared( void )
+{
+  if ( !sharedData_ ) return;
+  data_.resize( sharedData_->frames(), sharedData_->channels() );
+  for ( size_t i=0; i<data_.size(); i++ ) data_[i] = (*sharedData_)[i];
+  data_.setDataRate( sharedData_->dataRate() );
+  sharedData_.reset();
+}
+
 void FileWvIn :: reset(void)
 {
   time_ = (StkFloat) 0.0;
@@ -124,6 +157,8 @@ void FileWvIn :: normalize( StkFloat peak )
   // When chunking, the "normalization" scaling is performed by FileRead.
   if ( chunking_ ) return;
 
+  this->detachShared();
+
   size_t i;
   StkFloat max = 0.0;
 
@@ -146,7 +181,7 @@ void FileWvIn :: setRate( StkFloat rate )
 
   // If negative rate and at beginning of sound, move pointer to end
   // of sound.
-  if ( (rate_ < 0) && (time_ == 0.0) ) time_ = file_.fileSize() - 1.0;
+  if ( (rate_ < 0) && (time_ == 0.0) ) time_ = fileSize_ - 1.0;
 
   if ( fmod( rate_, 1.0 ) != 0.0 ) interpolate_ = true;
   else interpolate_ = false;
@@ -158,8 +193,8 @@ void FileWvIn :: addTime( StkFloat time )
   time_ += time;
 
   if ( time_ < 0.0 ) time_ = 0.0;
-  if ( time_ > file_.fileSize() - 1.0 ) {
-    time_ = file_.fileSize() - 1.0;
+  if ( time_ > fileSize_ - 1.0 ) {
+    time_ = fileSize_ - 1.0;
     for ( unsigned int i=0; i<lastFrame_.size(); i++ ) lastFrame_[i] = 0.0;
     finished_ = true;
   }
@@ -176,7 +211,7 @@ StkFloat FileWvIn :: tick( unsigned int channel )
 
   if ( finished_ ) return 0.0;
 
-  if ( time_ < 0.0 || time_ > (StkFloat) ( file_.fileSize() - 1.0 ) ) {
+  if ( time_ < 0.0 || time_ > (StkFloat) ( fileSize_ - 1.0 ) ) {
     for ( unsigned int i=0; i<lastFrame_.size(); i++ ) lastFrame_[i] = 0.0;
     finished_ = true;
     return 0.0;
@@ -209,11 +244,11 @@ StkFloat FileWvIn :: tick( unsigned int channel )
 
   if ( interpolate_ ) {
     for ( unsigned int i=0; i<lastFrame_.size(); i++ )
-      lastFrame_[i] = data_.interpolate( tyme, i );
+      lastFrame_[i] = frames().interpolate( tyme, i );
   }
   else {
     for ( unsigned int i=0; i<lastFrame_.size(); i++ )
-      lastFrame_[i] = data_( (size_t) tyme, i );
+      lastFrame_[i] = frames()( (size_t) tyme, i );
   }
 
   // Increment time, which can be negative.
@@ -224,7 +259,7 @@ StkFloat FileWvIn :: tick( unsigned int channel )
 
 StkFrames& FileWvIn :: tick( StkFrames& frames )
 {
-  if ( !file_.isOpen() ) {
+  if ( !this->isOpen() ) {
 #if defined(_STK_DEBUG_)
     oStream_ << "FileWvIn::tick(): no file data is loaded!";
     handleError( StkError::DEBUG_PRINT );
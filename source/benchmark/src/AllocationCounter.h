@@ -0,0 +1,40 @@
+/*
+                          qmusic
+
+    Copyright (C) 2015 Arthur Benilov,
+    arthur.benilov@gmail.com
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This software is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    Lesser General Public License for more details.
+*/
+
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+/**
+ * @brief Counter of dynamic memory allocations.
+ *
+ * The benchmark executable replaces the global operator new,
+ * so that every heap allocation made by the framework and the plugins
+ * is counted (on Windows only the allocations made by the executable
+ * itself are visible).
+ */
+class AllocationCounter
+{
+public:
+
+    /**
+     * Returns total number of allocations made so far.
+     * @return
+     */
+    static long count();
+};
+
+#endif // ALLOCATIONCOUNTER_H
@@ -0,0 +1,92 @@
+/*
+                          qmusic
+
+    Copyright (C) 2015 Arthur Benilov,
+    arthur.benilov@gmail.com
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This software is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    Lesser General Public License for more details.
+*/
+
+#include <cstdlib>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <QVector>
+#include "Fft.h"
+#include "RealFft.h"
+#include "FftBenchmark.h"
+
+/// Minimal measurement time for every size, in nanoseconds.
+const qint64 cMeasureTimeNs(200000000);
+
+const int cSizes[] = { 256, 512, 1024, 2048, 4096, 8192 };
+
+namespace {
+
+/**
+ * Repeat a function until the measurement time is elapsed.
+ * @return Average time of a single call, in microseconds.
+ */
+template <typename F>
+double measure(F func)
+{
+    // Warm up caches and branch predictors
+    func();
+
+    QElapsedTimer timer;
+    timer.start();
+    qint64 nRuns = 0;
+    do {
+        func();
+        nRuns++;
+    } while (timer.nsecsElapsed() < cMeasureTimeNs);
+
+    return timer.nsecsElapsed() * 1.0e-3 / nRuns;
+}
+
+} // namespace
+
+void FftBenchmark::run(QTextStream &out)
+{
+    out << "FFT benchmark, time per transform (us)" << endl;
+    out << QString("%1 %2 %3 %4")
+           .arg("size", 8)
+           .arg("Fft", 12)
+           .arg("RealFft", 12)
+           .arg("speedup", 10) << endl;
+
+    for (int size : cSizes) {
+        QVector<float> signal(size);
+        for (int i = 0; i < size; i++) {
+            signal[i] = float(qrand()) / RAND_MAX - 0.5f;
+        }
+
+        // Complex transform of the real signal, as used by the spectrum view
+        Fft::Array array(size);
+        double fftTime = measure([&]() {
+            for (int i = 0; i < size; i++) {
+                array[i] = signal.at(i);
+            }
+            Fft::direct(array);
+        });
+
+        RealFft realFft(size);
+        QVector<float> spectrum(realFft.spectrumSize());
+        double realFftTime = measure([&]() {
+            realFft.forward(signal.constData(), spectrum.data());
+        });
+
+        out << QString("%1 %2 %3 %4")
+               .arg(size, 8)
+               .arg(fftTime, 12, 'f', 2)
+               .arg(realFftTime, 12, 'f', 2)
+               .arg(fftTime / realFftTime, 10, 'f', 1) << endl;
+    }
+}
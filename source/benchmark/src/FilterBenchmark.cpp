@@ -0,0 +1,127 @@
+/*
+                          qmusic
+
+    Copyright (C) 2015 Arthur Benilov,
+    arthur.benilov@gmail.com
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This software is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    Lesser General Public License for more details.
+*/
+
+#include <cstdlib>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <QVector>
+#include "Port.h"
+#include "BiquadFilter.h"
+#include "BiquadFilterBank.h"
+#include "FilterBenchmark.h"
+
+/// Minimal measurement time for every case, in nanoseconds.
+const qint64 cMeasureTimeNs(200000000);
+
+const int cFilters[] = { 1, 4, 8, 16 };
+
+namespace {
+
+/**
+ * Repeat a function until the measurement time is elapsed.
+ * @return Average time of a single call, in nanoseconds.
+ */
+template <typename F>
+double measure(F func)
+{
+    func();
+
+    QElapsedTimer timer;
+    timer.start();
+    qint64 nRuns = 0;
+    do {
+        func();
+        nRuns++;
+    } while (timer.nsecsElapsed() < cMeasureTimeNs);
+
+    return double(timer.nsecsElapsed()) / nRuns;
+}
+
+} // namespace
+
+void FilterBenchmark::run(QTextStream &out)
+{
+    const int blockSize = Port::MaxBlockSize;
+
+    out << "Filter benchmark, time per sample per filter (ns), modulated cut-off" << endl;
+    out << QString("%1 %2 %3 %4")
+           .arg("filters", 8)
+           .arg("doFilter", 12)
+           .arg("block", 12)
+           .arg("bank", 12) << endl;
+
+    for (int nFilters : cFilters) {
+        QVector<QVector<float>> buffers(nFilters, QVector<float>(blockSize));
+        QVector<const float*> inputs(nFilters);
+        QVector<float*> outputs(nFilters);
+        for (int i = 0; i < nFilters; i++) {
+            for (float &x : buffers[i]) {
+                x = float(qrand()) / RAND_MAX - 0.5f;
+            }
+            inputs[i] = buffers.at(i).constData();
+            outputs[i] = buffers[i].data();
+        }
+
+        QVector<BiquadFilter> filters(nFilters);
+        for (BiquadFilter &filter : filters) {
+            filter.setSampleRate(44100.0);
+            filter.setQFactor(2.0);
+        }
+        BiquadFilterBank bank(nFilters);
+
+        int block = 0;
+        auto modulate = [&](int i) {
+            filters[i].setCutOffFrequency(1000.0 + 500.0 * ((block + i) % 16));
+        };
+
+        double perSample = measure([&]() {
+            block++;
+            for (int i = 0; i < nFilters; i++) {
+                modulate(i);
+                IFilter *pFilter = &filters[i];
+                float *p = outputs[i];
+                for (int j = 0; j < blockSize; j++) {
+                    p[j] = float(pFilter->doFilter(p[j]));
+                }
+            }
+        });
+
+        double perBlock = measure([&]() {
+            block++;
+            for (int i = 0; i < nFilters; i++) {
+                modulate(i);
+                filters[i].processBlock(outputs[i], outputs[i], blockSize);
+            }
+        });
+
+        double perBank = measure([&]() {
+            block++;
+            for (int i = 0; i < nFilters; i++) {
+                modulate(i);
+                bank.setCoefficients(i, filters.at(i).coefficients());
+            }
+            bank.process(inputs.constData(), outputs.constData(), blockSize);
+        });
+
+        double norm = 1.0 / (nFilters * blockSize);
+        out << QString("%1 %2 %3 %4")
+               .arg(nFilters, 8)
+               .arg(perSample * norm, 12, 'f', 2)
+               .arg(perBlock * norm, 12, 'f', 2)
+               .arg(perBank * norm, 12, 'f', 2) << endl;
+    }
+}
@@ -0,0 +1,41 @@
+/*
+                          qmusic
+
+    Copyright (C) 2015 Arthur Benilov,
+    arthur.benilov@gmail.com
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This software is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    Lesser General Public License for more details.
+*/
+
+#ifndef FILTERBENCHMARK_H
+#define FILTERBENCHMARK_H
+
+class QTextStream;
+
+/**
+ * @brief Filter kernels micro-benchmark.
+ *
+ * Compares per-sample filtering via IFilter interface with the block
+ * kernels and the lockstep filter bank, for a number of filters
+ * (channels or voices) running at once.
+ */
+class FilterBenchmark
+{
+public:
+
+    /**
+     * Run the benchmark and print the results.
+     * @param out Output stream.
+     */
+    static void run(QTextStream &out);
+};
+
+#endif // FILTERBENCHMARK_H
@@ -0,0 +1,286 @@
+/*
+                          qmusic
+
+    Copyright (C) 2015 Arthur Benilov,
+    arthur.benilov@gmail.com
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This software is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    Lesser General Public License for more details.
+*/
+
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QVector>
+#include <QtVariantPropertyManager>
+#include <qmath.h>
+#include "Application.h"
+#include "AudioUnitsManager.h"
+#include "AudioUnitPlugin.h"
+#include "AudioUnit.h"
+#include "InputPort.h"
+#include "OutputPort.h"
+#include "SignalChain.h"
+#include "SignalChainScene.h"
+#include "NoteOnEvent.h"
+#include "NoteOffEvent.h"
+#include "AllocationCounter.h"
+#include "SignalChainBenchmark.h"
+
+/// Number of blocks processed before measuring.
+const int cWarmUpBlocks(16);
+
+/// Lowest note played on patches.
+const int cBaseNote(48);
+
+/// Velocity of the played notes.
+const int cVelocity(100);
+
+/**
+ * Terminal unit consuming the outputs of the benchmarked unit.
+ * The signal chain only schedules the units contributing to a unit
+ * without outputs, a unit left alone would not be processed at all.
+ */
+class BenchmarkSink : public AudioUnit
+{
+public:
+
+    BenchmarkSink(AudioUnit *pSource)
+        : AudioUnit(pSource->plugin())
+    {
+        for (OutputPort *pOutput : pSource->outputs()) {
+            addInput()->connect(pOutput);
+        }
+    }
+
+protected:
+
+    void process() override {}
+    void processBlock(int nFrames) override { Q_UNUSED(nFrames); }
+};
+
+/**
+ * Set the number of voices of the polyphonic containers of a chain.
+ * @param pSignalChain Signal chain, not started.
+ * @param nVoices Number of voices.
+ * @return Number of containers found.
+ */
+static int setNumberOfVoices(SignalChain *pSignalChain, int nVoices)
+{
+    int nContainers = 0;
+    for (IAudioUnit *pIAu : pSignalChain->audioUnits()) {
+        AudioUnit *pAu = dynamic_cast<AudioUnit*>(pIAu);
+        if (pAu == nullptr) {
+            continue;
+        }
+        QtVariantPropertyManager *pManager = pAu->propertyManager();
+        for (QtProperty *pProperty : pManager->properties()) {
+            if (pProperty->propertyName() == "Voices") {
+                pManager->setValue(pProperty, nVoices);
+                nContainers++;
+            }
+        }
+    }
+    return nContainers;
+}
+
+SignalChainBenchmark::SignalChainBenchmark(int nBlocks)
+    : m_nBlocks(nBlocks),
+      m_filter()
+{
+    Q_ASSERT(nBlocks > 0);
+}
+
+QJsonArray SignalChainBenchmark::runAudioUnits()
+{
+    QJsonArray results;
+    AudioUnitsManager *pManager = Application::instance()->audioUnitsManager();
+
+    for (const QString &category : pManager->categories()) {
+        for (AudioUnitPlugin *pPlugin : pManager->audioUnitsInCategory(category)) {
+            if (isFiltered(pPlugin->uid())) {
+                continue;
+            }
+
+            AudioUnit *pAudioUnit = dynamic_cast<AudioUnit*>(pPlugin->createInstance());
+            if (pAudioUnit == nullptr) {
+                qWarning() << "Unable to create audio unit" << pPlugin->uid();
+                continue;
+            }
+
+            // The chain owns the unit and will delete it
+            SignalChain signalChain;
+            signalChain.setTimeStep(1.0 / cSampleRate);
+            signalChain.addAudioUnit(pAudioUnit);
+            signalChain.addAudioUnit(new BenchmarkSink(pAudioUnit));
+
+            // Drive every input with its own signal, so that units
+            // with several inputs do not see identical values.
+            int nInputs = pAudioUnit->inputs().count();
+            QVector<OutputPort*> sources(nInputs);
+            for (int i = 0; i < nInputs; i++) {
+                sources[i] = new OutputPort();
+                pAudioUnit->inputs().at(i)->connect(sources[i]);
+            }
+
+            signalChain.start();
+            signalChain.enable(true);
+
+            // Instruments produce nothing unless a note is played
+            NoteOnEvent noteOn(cBaseNote + 12, cVelocity);
+            signalChain.handleEvent(&noteOn);
+
+            long position = 0;
+            QJsonObject result = measure(&signalChain, [&](int nFrames) {
+                for (int i = 0; i < nInputs; i++) {
+                    // Unipolar sine in [0, 1], with frequencies in a harmonic series
+                    float *pBuffer = sources[i]->buffer();
+                    double w = 2.0 * M_PI * 110.0 * (i + 1) / cSampleRate;
+                    for (int k = 0; k < nFrames; k++) {
+                        pBuffer[k] = float(0.5 + 0.5 * qSin(w * (position + k)));
+                    }
+                    sources[i]->setSilent(false);
+                }
+                position += nFrames;
+            });
+
+            signalChain.enable(false);
+            signalChain.stop();
+
+            for (InputPort *pInput : pAudioUnit->inputs()) {
+                pInput->disconnect();
+            }
+            qDeleteAll(sources);
+
+            if (result["nsPerSample"].toDouble() <= 0.0) {
+                qWarning() << "Audio unit" << pPlugin->uid() << "has not been processed";
+            }
+
+            result["uid"] = pPlugin->uid();
+            result["name"] = pPlugin->name();
+            result["category"] = category;
+            results.append(result);
+        }
+    }
+
+    return results;
+}
+
+QJsonArray SignalChainBenchmark::runPatches(const QString &path, const QList<int> &voiceCounts)
+{
+    QJsonArray results;
+    QDir dir(path);
+
+    QStringList files;
+    QDirIterator it(path, QStringList() << "*.sch", QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        files.append(it.next());
+    }
+    files.sort();
+
+    for (const QString &file : files) {
+        QString name = dir.relativeFilePath(file);
+        if (isFiltered(name)) {
+            continue;
+        }
+
+        for (int nVoices : voiceCounts) {
+            SignalChainScene *pScene = SignalChainScene::loadFromFile(file);
+            if (pScene == nullptr) {
+                break;
+            }
+
+            SignalChain *pSignalChain = pScene->signalChain();
+
+            // Every note gets its own voice. Patches without polyphonic
+            // containers render a single voice, measured once.
+            int nContainers = setNumberOfVoices(pSignalChain, nVoices);
+            if (nContainers == 0 && nVoices != voiceCounts.first()) {
+                delete pScene;
+                break;
+            }
+
+            pSignalChain->setTimeStep(1.0 / cSampleRate);
+
+            // Starting clones the voices of the polyphonic containers
+            QElapsedTimer timer;
+            timer.start();
+            pSignalChain->start();
+            double startMs = timer.nsecsElapsed() * 1.0e-6;
+
+            pSignalChain->enable(true);
+
+            // Chord spread over a few octaves
+            for (int i = 0; i < nVoices; i++) {
+                NoteOnEvent noteOn(cBaseNote + (i * 5) % 48, cVelocity);
+                pSignalChain->handleEvent(&noteOn);
+            }
+
+            QJsonObject result = measure(pSignalChain, [](int) {});
+
+            for (int i = 0; i < nVoices; i++) {
+                NoteOffEvent noteOff(cBaseNote + (i * 5) % 48, cVelocity);
+                pSignalChain->handleEvent(&noteOff);
+            }
+
+            pSignalChain->enable(false);
+            pSignalChain->stop();
+            delete pScene;
+
+            result["patch"] = name;
+            result["notes"] = nVoices;
+            result["voices"] = nContainers > 0 ? nVoices : 1;
+            result["startMs"] = startMs;
+            results.append(result);
+        }
+    }
+
+    return results;
+}
+
+bool SignalChainBenchmark::isFiltered(const QString &name) const
+{
+    return !m_filter.isEmpty() && !name.contains(m_filter, Qt::CaseInsensitive);
+}
+
+QJsonObject SignalChainBenchmark::measure(SignalChain *pSignalChain, const std::function<void(int)> &beforeBlock)
+{
+    Q_ASSERT(pSignalChain != nullptr);
+
+    for (int i = 0; i < cWarmUpBlocks; i++) {
+        beforeBlock(cBlockSize);
+        pSignalChain->processBlock(cBlockSize);
+    }
+
+    QElapsedTimer timer;
+    qint64 elapsedNs = 0;
+    long allocations = 0;
+
+    for (int i = 0; i < m_nBlocks; i++) {
+        beforeBlock(cBlockSize);
+
+        long allocationsBefore = AllocationCounter::count();
+        timer.start();
+        pSignalChain->processBlock(cBlockSize);
+        elapsedNs += timer.nsecsElapsed();
+        allocations += AllocationCounter::count() - allocationsBefore;
+    }
+
+    double nSamples = double(m_nBlocks) * cBlockSize;
+    double nsPerSample = elapsedNs / nSamples;
+
+    QJsonObject result;
+    result["nsPerSample"] = nsPerSample;
+    result["samplesPerSecond"] = nsPerSample > 0.0 ? 1.0e9 / nsPerSample : 0.0;
+    result["realTimeFactor"] = nsPerSample > 0.0 ? 1.0e9 / (nsPerSample * cSampleRate) : 0.0;
+    result["allocationsPerBlock"] = double(allocations) / m_nBlocks;
+    return result;
+}
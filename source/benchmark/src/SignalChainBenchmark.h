@@ -0,0 +1,92 @@
+/*
+                          qmusic
+
+    Copyright (C) 2015 Arthur Benilov,
+    arthur.benilov@gmail.com
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This software is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    Lesser General Public License for more details.
+*/
+
+#ifndef SIGNALCHAINBENCHMARK_H
+#define SIGNALCHAINBENCHMARK_H
+
+#include <functional>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QStringList>
+
+class SignalChain;
+
+/**
+ * @brief Audio units and patches benchmark.
+ *
+ * Every audio unit plugin is instantiated in a signal chain with
+ * its inputs driven by synthetic signals and its outputs connected
+ * to a sink unit. Every patch is loaded and played
+ * with a number of notes held simultaneously. For each case the processing
+ * time per sample, the throughput and the number of heap allocations
+ * per block are reported as JSON objects. Patches also report the time
+ * taken to start the chain, which includes cloning the container voices.
+ */
+class SignalChainBenchmark
+{
+public:
+
+    /// Block size used for processing.
+    static const int cBlockSize = 256;
+
+    /// Sample rate the chains are rendered at.
+    static const int cSampleRate = 44100;
+
+    /**
+     * Construct the benchmark.
+     * @param nBlocks Number of measured blocks per case.
+     */
+    SignalChainBenchmark(int nBlocks);
+
+    /**
+     * Set a filter on the plugin UIDs or patch file names.
+     * @param filter Substring to be matched, empty string to run all cases.
+     */
+    void setFilter(const QString &filter) { m_filter = filter; }
+
+    /**
+     * Benchmark all loaded audio unit plugins.
+     * @return Results, one object per plugin.
+     */
+    QJsonArray runAudioUnits();
+
+    /**
+     * Benchmark all patches found in the directory (recursively).
+     * @param path Patches directory.
+     * @param voiceCounts Numbers of simultaneous notes to play, the polyphonic
+     *                    containers are given as many voices.
+     * @return Results, one object per patch and voice count.
+     */
+    QJsonArray runPatches(const QString &path, const QList<int> &voiceCounts);
+
+private:
+
+    bool isFiltered(const QString &name) const;
+
+    /**
+     * Run the signal chain and measure it.
+     * @param pSignalChain Started signal chain.
+     * @param beforeBlock Function called prior each block (excluded from timing).
+     * @return Measurement results.
+     */
+    QJsonObject measure(SignalChain *pSignalChain, const std::function<void(int)> &beforeBlock);
+
+    int m_nBlocks;
+    QString m_filter;
+};
+
+#endif // SIGNALCHAINBENCHMARK_H
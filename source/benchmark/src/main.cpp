@@ -0,0 +1,103 @@
+/*
+                          qmusic
+
+    Copyright (C) 2015 Arthur Benilov,
+    arthur.benilov@gmail.com
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This software is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    Lesser General Public License for more details.
+*/
+
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+#include "Application.h"
+#include "AudioDevicesManager.h"
+#include "AudioUnitsManager.h"
+#include "FftBenchmark.h"
+#include "FilterBenchmark.h"
+#include "SignalChainBenchmark.h"
+
+/*
+ * Performance benchmarks.
+ * This is not a test: the results are printed out (or saved)
+ * as JSON, so that they can be compared between builds.
+ */
+int main(int argc, char *argv[])
+{
+    // No windows are created, so the display is not required
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    Application app(argc, argv);
+    QTextStream out(stdout);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Audio units, patches and DSP benchmarks.");
+    parser.addHelpOption();
+
+    QCommandLineOption outputOption(QStringList() << "o" << "output", "Save JSON results to the file.", "file");
+    QCommandLineOption patchesOption("patches", "Patches directory.", "path", "patches");
+    QCommandLineOption blocksOption("blocks", "Number of measured blocks per case.", "count", "2000");
+    QCommandLineOption filterOption("filter", "Run only plugins or patches which name contains the string.", "string");
+    QCommandLineOption fftOption("fft", "Run the FFT micro-benchmark only (text output).");
+    QCommandLineOption filtersOption("filters", "Run the filter kernels micro-benchmark only (text output).");
+    parser.addOption(outputOption);
+    parser.addOption(patchesOption);
+    parser.addOption(blocksOption);
+    parser.addOption(filterOption);
+    parser.addOption(fftOption);
+    parser.addOption(filtersOption);
+    parser.process(app);
+
+    if (parser.isSet(fftOption)) {
+        FftBenchmark::run(out);
+        return 0;
+    }
+
+    if (parser.isSet(filtersOption)) {
+        FilterBenchmark::run(out);
+        return 0;
+    }
+
+    // Speakers must not start their rendering threads
+    app.audioDevicesManager()->setCallbackRenderEnabled(true);
+    app.audioUnitsManager()->initialize();
+
+    SignalChainBenchmark benchmark(qMax(1, parser.value(blocksOption).toInt()));
+    benchmark.setFilter(parser.value(filterOption));
+
+    QJsonObject root;
+    root["version"] = QMUSIC_VERSION;
+    root["date"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    root["blockSize"] = SignalChainBenchmark::cBlockSize;
+    root["sampleRate"] = SignalChainBenchmark::cSampleRate;
+    root["audioUnits"] = benchmark.runAudioUnits();
+    root["patches"] = benchmark.runPatches(parser.value(patchesOption), QList<int>() << 1 << 4 << 8 << 16);
+
+    QByteArray json = QJsonDocument(root).toJson();
+
+    if (parser.isSet(outputOption)) {
+        QFile file(parser.value(outputOption));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            QTextStream(stderr) << "Unable to write " << file.fileName() << endl;
+            return 1;
+        }
+        file.write(json);
+    } else {
+        out << json;
+    }
+
+    return 0;
+}
@@ -0,0 +1,106 @@
+/*
+                          qmusic
+
+    Copyright (C) 2015 Arthur Benilov,
+    arthur.benilov@gmail.com
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This software is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    Lesser General Public License for more details.
+*/
+
+#ifndef ADAPTIVERESAMPLER_H
+#define ADAPTIVERESAMPLER_H
+
+#include <QVector>
+#include "DspApi.h"
+
+/**
+ * @brief Resampler compensating the drift between two clocks.
+ *
+ * Samples produced with one clock (e.g. an audio input device) are
+ * consumed with another one (e.g. the output device). The clocks are
+ * nominally equal but drift apart, so the producer-consumer buffer
+ * slowly fills up or runs dry.
+ *
+ * This resampler changes the consumption rate by a tiny ratio that is
+ * driven by a PI controller keeping the buffer fill around the target.
+ * Samples are interpolated with the 4-point cubic Hermite (Catmull-Rom)
+ * interpolator, which adds two samples of latency.
+ */
+class QMUSIC_DSP_API AdaptiveResampler
+{
+public:
+
+    /**
+     * Construct the resampler.
+     * @param nChannels Number of channels resampled simultaneously.
+     * @param maxFrames Maximum number of frames produced per call.
+     */
+    AdaptiveResampler(int nChannels, int maxFrames);
+
+    /**
+     * Reset resampling ratio to 1 and clear the history.
+     */
+    void reset();
+
+    /**
+     * Update the resampling ratio.
+     * @param error Buffer fill minus target fill, in frames.
+     * @param dt Time elapsed since the previous update, seconds.
+     */
+    void control(double error, double dt);
+
+    /**
+     * Returns current ratio of consumed input frames per output frame.
+     * @return
+     */
+    double ratio() const { return m_ratio; }
+
+    /**
+     * Returns number of input frames to be provided to produce the output.
+     * @param nOutput Number of frames to be produced.
+     * @return Number of input frames.
+     */
+    int inputFrames(int nOutput) const;
+
+    /**
+     * Resample the signal.
+     * If less than inputFrames() frames are given the last input
+     * sample is repeated.
+     * @param ppInput Input channels.
+     * @param nInput Number of input frames.
+     * @param ppOutput Output channels.
+     * @param nOutput Number of frames to produce, up to maxFrames.
+     */
+    void process(const float * const *ppInput, int nInput, float * const *ppOutput, int nOutput);
+
+private:
+
+    /// Number of samples used by the interpolator.
+    static const int cTaps = 4;
+
+    int m_nChannels;
+    int m_maxFrames;
+    int m_pendingCapacity;
+
+    double m_ratio;     ///< Consumed input frames per output frame.
+    double m_phase;     ///< Position between the two middle taps, [0..1).
+    double m_error;     ///< Filtered buffer fill error.
+    double m_integral;  ///< Integral of the error.
+
+    /// Interpolator taps, cTaps per channel, latest sample last.
+    QVector<float> m_taps;
+
+    /// Input frames not consumed yet, per channel.
+    QVector<float> m_pending;
+    int m_nPending;
+};
+
+#endif // ADAPTIVERESAMPLER_H
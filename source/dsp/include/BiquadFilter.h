@@ -29,12 +29,38 @@ public:
         Type_HighShelf  ///< High-pass shelf.
     };
 
+    /// Normalized filter coefficients (a0 = 1).
+    struct Coefficients {
+        double b0;
+        double b1;
+        double b2;
+        double a1;
+        double a2;
+    };
+
     explicit BiquadFilter(Type type = Type_LPF);
 
     void reset() override;
     void update() override;
     double doFilter(double x) override;
 
+    /**
+     * Process a block of samples.
+     * When the coefficients have been changed since the previous block
+     * they are interpolated linearly over this block, so that modulating
+     * the filter parameters does not produce zipper noise.
+     * @param pIn Input samples.
+     * @param pOut Output samples, may be the same as input.
+     * @param nFrames Number of samples to process.
+     */
+    void processBlock(const float *pIn, float *pOut, int nFrames) override;
+
+    /**
+     * Returns the filter coefficients, as reached at the end of the next block.
+     * @return
+     */
+    const Coefficients& coefficients() const { return m_target; }
+
     Type type() const { return m_type; }
     void setType(Type type);
 
@@ -50,6 +76,9 @@ private:
     // its type and cut-off frequency.
     void recalculate();
 
+    // Update the terms that do not depend on the cut-off frequency.
+    void updateGainTerms();
+
     /// Filter type.
     Type m_type;
 
@@ -61,14 +90,15 @@ private:
     /// shelf slope.
     double m_q;
 
+    // Cached gain terms.
+    double m_A;
+    double m_sqrtA;
+    double m_shelfSlope;
 
-    // Filter coefficients.
-    double m_a0;
-    double m_a1;
-    double m_a2;
-    double m_b0;
-    double m_b1;
-    double m_b2;
+    // Filter coefficients currently in use and
+    // the ones to interpolate to over the next block.
+    Coefficients m_coeffs;
+    Coefficients m_target;
 
     // Processing memory.
     double m_x_1;
@@ -0,0 +1,113 @@
+/*
+                          qmusic
+
+    Copyright (C) 2015 Arthur Benilov,
+    arthur.benilov@gmail.com
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This software is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    Lesser General Public License for more details.
+*/
+
+#ifndef BIQUADFILTERBANK_H
+#define BIQUADFILTERBANK_H
+
+#include <QVector>
+#include "DspApi.h"
+#include "BiquadFilter.h"
+
+/**
+ * @brief Bank of biquad filters running in lockstep.
+ *
+ * The filters (lanes) are processed simultaneously, four at a time
+ * with SSE2 or NEON, their coefficients and states being stored as
+ * structure of arrays. This suits the channels or voices that are
+ * filtered the same way but with their own parameters.
+ *
+ * Lanes use the transposed direct form II in single precision.
+ * Coefficients changes are interpolated linearly over the next block.
+ * First order sections (e.g. VAOnePoleFilter::biquadCoefficients())
+ * can be run as well.
+ */
+class QMUSIC_DSP_API BiquadFilterBank
+{
+public:
+
+    /**
+     * Construct the filter bank.
+     * All the lanes are initialized as pass-through.
+     * @param nLanes Number of filters.
+     */
+    explicit BiquadFilterBank(int nLanes);
+
+    /**
+     * Returns number of filters in the bank.
+     * @return
+     */
+    int lanes() const { return m_nLanes; }
+
+    /**
+     * Clear all filters memory.
+     * Pending coefficients changes are applied without interpolation.
+     */
+    void reset();
+
+    /**
+     * Clear a single filter memory.
+     * @param lane Filter index.
+     */
+    void resetLane(int lane);
+
+    /**
+     * Set coefficients of a filter.
+     * @param lane Filter index.
+     * @param coeffs Normalized coefficients.
+     */
+    void setCoefficients(int lane, const BiquadFilter::Coefficients &coeffs);
+
+    /**
+     * Filter a block of samples by all the lanes.
+     * @param ppIn Input samples, a buffer per lane.
+     * @param ppOut Output samples, a buffer per lane, may be the same as input.
+     * @param nFrames Number of samples to process.
+     */
+    void process(const float * const *ppIn, float * const *ppOut, int nFrames);
+
+private:
+
+    /// Lanes processed simultaneously.
+    static const int cWidth = 4;
+
+    /// Coefficients and states stored for every lane.
+    enum Param {
+        Param_B0,
+        Param_B1,
+        Param_B2,
+        Param_A1,
+        Param_A2,
+        Param_TargetB0,
+        Param_TargetB1,
+        Param_TargetB2,
+        Param_TargetA1,
+        Param_TargetA2,
+        Param_S1,
+        Param_S2,
+        Param_Count
+    };
+
+    float& param(Param p, int lane) { return m_data[p * m_stride + lane]; }
+
+    int m_nLanes;
+    int m_stride;   ///< Number of lanes rounded up to cWidth.
+
+    /// Parameters arrays, m_stride values each.
+    QVector<float> m_data;
+};
+
+#endif // BIQUADFILTERBANK_H
@@ -0,0 +1,101 @@
+/*
+                          qmusic
+
+    Copyright (C) 2015 Arthur Benilov,
+    arthur.benilov@gmail.com
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This software is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    Lesser General Public License for more details.
+*/
+
+#ifndef CONVOLVER_H
+#define CONVOLVER_H
+
+#include <QList>
+#include <QVector>
+#include "DspApi.h"
+
+/**
+ * @brief Zero-latency partitioned convolution.
+ *
+ * Convolves a signal with a long impulse response (e.g. a room reverberation).
+ * The first taps of the response are applied in direct form, so that
+ * no latency is introduced. The rest of the response is split into
+ * stages of uniform partitions of growing size, each stage being processed
+ * by overlap-save FFT convolution with a frequency-domain delay line.
+ * A stage of partition size P only starts at response offset of at least P,
+ * so its result is always ready before it is needed.
+ *
+ * All the memory is allocated on construction, processing does not allocate.
+ */
+class QMUSIC_DSP_API Convolver
+{
+public:
+
+    /**
+     * Construct the convolver.
+     * @param ir Impulse response, must not be empty.
+     */
+    Convolver(const QVector<float> &ir);
+
+    ~Convolver();
+
+    /**
+     * Returns impulse response length (number of taps).
+     * @return
+     */
+    int length() const { return m_length; }
+
+    /**
+     * Clear the convolver state.
+     */
+    void reset();
+
+    /**
+     * Process a single sample.
+     * @param x Input sample.
+     * @return Output sample.
+     */
+    float process(float x);
+
+    /**
+     * Process a block of samples.
+     * @param pIn Input samples.
+     * @param pOut Output samples, may be the same as the input.
+     * @param nFrames Number of samples to process.
+     */
+    void process(const float *pIn, float *pOut, int nFrames);
+
+private:
+
+    Q_DISABLE_COPY(Convolver)
+
+    class Stage;
+
+    /// Maximum number of samples processed at once by the head.
+    static const int HeadBlockSize = 64;
+
+    /**
+     * Apply the direct form head of the impulse response.
+     * @param pIn Input samples.
+     * @param pOut Output samples, overwritten.
+     * @param nFrames Number of samples, up to HeadBlockSize.
+     */
+    void processHead(const float *pIn, float *pOut, int nFrames);
+
+    int m_length;                   ///< Impulse response length.
+    QVector<float> m_head;          ///< Reversed direct form taps.
+    QVector<float> m_history;       ///< Input history (doubled circular buffer).
+    int m_historyIndex;             ///< Position of the last input sample in history.
+    QVector<float> m_input;         ///< Copy of the input block (in-place processing).
+    QList<Stage*> m_stages;         ///< FFT convolution stages.
+};
+
+#endif // CONVOLVER_H
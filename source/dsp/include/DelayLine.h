@@ -24,22 +24,58 @@
  * Signal delay line.
  *
  * Delay line keeps an internal samples buffer used to
- * delay the signal propagation.
+ * delay the signal propagation. The buffer is a circular
+ * buffer of a power of two size, so that the read and write
+ * positions wrap with a mask.
+ *
+ * The signal can be processed one sample at a time (process()),
+ * or by blocks: a block of samples is written first, then read
+ * by any number of taps, each one with its own delay. A delay
+ * of zero samples returns the sample just written.
  */
 class QMUSIC_DSP_API DelayLine
 {
 public:
 
+    /// Fractional delay interpolation.
+    enum Interpolation {
+        Interpolation_None,     ///< Delay rounded down to an integer number of samples.
+        Interpolation_Linear,
+        Interpolation_Lagrange, ///< Third order Lagrange, delay of one sample at least.
+        Interpolation_Allpass   ///< First order allpass, delay of half a sample at least.
+    };
+
+    /**
+     * Delay line read position.
+     * A tap keeps the delay reached at the end of the last block read,
+     * from which the delay is smoothed toward the next block's one,
+     * as well as the allpass interpolator memory.
+     */
+    struct Tap
+    {
+        float delay;        ///< Current delay, in samples.
+        float allpassOut;   ///< Allpass interpolator last output.
+
+        Tap() : delay(0.0f), allpassOut(0.0f) {}
+    };
+
     /**
      * Construct delay line.
      * @param nSamplesMax Maximum number of samples to be delayed.
+     * @param nFramesMax Maximum number of samples in a block.
      */
-    DelayLine(int nSamplesMax = 4096);
+    DelayLine(int nSamplesMax = 4096, int nFramesMax = 1);
 
     /// Destructor.
     ~DelayLine();
 
-    void allocate(int nSamplesMax);
+    /**
+     * Set the delay line capacity and clear it.
+     * The buffer is only reallocated when it is too small.
+     * @param nSamplesMax Maximum number of samples to be delayed.
+     * @param nFramesMax Maximum number of samples in a block.
+     */
+    void allocate(int nSamplesMax, int nFramesMax = 1);
 
     /**
      * @brief Set current delay (in samples).
@@ -48,8 +84,21 @@ public:
      */
     void setDelay(int nSamples);
 
+    /**
+     * Set current delay as a fraction of the maximum delay.
+     * @param f Delay fraction, within [0, 1].
+     */
     void setDelayFraction(double f);
 
+    /**
+     * Returns current delay (in samples) used by process().
+     * @return
+     */
+    float delay() const { return m_tap.delay; }
+
+    Interpolation interpolation() const { return m_interpolation; }
+    void setInterpolation(Interpolation interpolation) { m_interpolation = interpolation; }
+
     /**
      * Reset the delay line.
      * This will clear the internal buffer by setting all the
@@ -62,7 +111,46 @@ public:
      * @param x Incoming sample.
      * @return Outgoing sample (delayed).
      */
-    double process(double x);
+    float process(float x);
+
+    /**
+     * Write a block of samples into the delay line.
+     * @param pIn Incoming samples.
+     * @param nFrames Number of samples, not greater than nFramesMax.
+     */
+    void write(const float *pIn, int nFrames);
+
+    /**
+     * Read the last written block with a delay changing linearly
+     * from the tap's current delay to the given one.
+     * @param tap Read position.
+     * @param pOut Outgoing samples.
+     * @param nFrames Number of samples, not greater than the written ones.
+     * @param delay Delay at the end of the block, in samples.
+     */
+    void read(Tap &tap, float *pOut, int nFrames, float delay) const;
+
+    /**
+     * Read the last written block with a delay for each sample.
+     * @param tap Read position.
+     * @param pOut Outgoing samples.
+     * @param pDelay Delays, in samples.
+     * @param nFrames Number of samples, not greater than the written ones.
+     */
+    void read(Tap &tap, float *pOut, const float *pDelay, int nFrames) const;
+
+    /**
+     * Read the last written block with several taps and mix them.
+     * The delay of every tap is smoothed as for a single tap read.
+     * @param pTaps Read positions.
+     * @param pDelays Delays at the end of the block, one per tap.
+     * @param pGains Taps gains.
+     * @param nTaps Number of taps.
+     * @param pOut Mixed outgoing samples.
+     * @param nFrames Number of samples, not greater than the written ones.
+     */
+    void read(Tap *pTaps, const float *pDelays, const float *pGains, int nTaps,
+              float *pOut, int nFrames) const;
 
     /**
      * Returns maximum possible delay (in samples).
@@ -72,13 +160,31 @@ public:
 
 private:
 
-    int m_nSamples;     ///< Number of samples to delay.
+    /// Returns the sample written at the given (unmasked) position.
+    inline float at(int index) const { return m_pBuffer[unsigned(index) & m_mask]; }
+
+    /// Limit the delay to the range supported by the interpolation.
+    float clampDelay(float delay) const;
+
+    /// Read one sample with a fractional delay.
+    float interpolate(Tap &tap, int index, float delay) const;
+
+    /// Read part of the last block with a linearly changing delay.
+    void readRamp(Tap &tap, float *pOut, int offset, int nFrames,
+                  float startDelay, float endDelay) const;
+
+    /// Read with a constant delay, without interpolator state.
+    void readConstant(float *pOut, int index, int nFrames, float delay) const;
+
     int m_nSamplesMax;  ///< Maximum number of samples.
-    double *m_pBuffer;  ///< Samples buffer.
-    int m_inIndex;      ///< Index within the buffer for input sample.
-    int m_outIndex;     ///< Index within the buffer for output sample.
-    double m_frac;
+    int m_nFramesMax;   ///< Maximum number of samples in a block.
+    float *m_pBuffer;   ///< Samples buffer.
+    int m_size;         ///< Buffer size, power of two.
+    unsigned m_mask;    ///< Buffer index mask.
+    int m_writeIndex;   ///< Position of the next sample to be written.
+    int m_nWritten;     ///< Number of samples in the last written block.
+    Interpolation m_interpolation;
+    Tap m_tap;          ///< Read position of process().
 };
 
 #endif // DELAYLINE_H
-
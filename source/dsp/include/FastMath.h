@@ -0,0 +1,101 @@
+/*
+                          qmusic
+
+    Copyright (C) 2015 Arthur Benilov,
+    arthur.benilov@gmail.com
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This software is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    Lesser General Public License for more details.
+*/
+
+#ifndef FASTMATH_H
+#define FASTMATH_H
+
+#include <cmath>
+
+/**
+ * @brief Fast approximations of the elementary functions.
+ *
+ * These are used to recompute the filter coefficients at control rate,
+ * where the standard library functions would dominate the cost of a
+ * modulated filter. Polynomials are evaluated in double precision
+ * and are accurate to about 1e-9 within the documented ranges.
+ */
+class FastMath
+{
+public:
+
+    /**
+     * Sine function.
+     * @param x Argument in [-pi, pi].
+     * @return
+     */
+    static inline double sin(double x)
+    {
+        // Reduce to [-pi/2, pi/2] where the series converges fast
+        if (x > cHalfPi) {
+            x = cPi - x;
+        } else if (x < -cHalfPi) {
+            x = -cPi - x;
+        }
+        double x2 = x * x;
+        return x * (1.0 + x2 * (-1.0 / 6.0 + x2 * (1.0 / 120.0 + x2 * (-1.0 / 5040.0 + x2 * (1.0 / 362880.0
+                    + x2 * (-1.0 / 39916800.0 + x2 * (1.0 / 6227020800.0)))))));
+    }
+
+    /**
+     * Sine and cosine of the same angle.
+     * The cosine is computed via the half angle, so that 1 - cos(x) keeps
+     * its relative precision at low frequencies.
+     * @param x Argument in [0, pi].
+     * @param s Sine of x.
+     * @param c Cosine of x.
+     */
+    static inline void sinCos(double x, double &s, double &c)
+    {
+        double sh = sin(0.5 * x);
+        double ch = sin(cHalfPi - 0.5 * x);
+        s = 2.0 * sh * ch;
+        c = 1.0 - 2.0 * sh * sh;
+    }
+
+    /**
+     * Tangent function.
+     * @param x Argument in (-pi/2, pi/2).
+     * @return
+     */
+    static inline double tan(double x)
+    {
+        double c = sin(cHalfPi - std::fabs(x));
+        return sin(x) / c;
+    }
+
+    /**
+     * Hyperbolic sine function.
+     * @param x Argument, the approximation is used for |x| < 1.
+     * @return
+     */
+    static inline double sinh(double x)
+    {
+        if (std::fabs(x) >= 1.0) {
+            return std::sinh(x);
+        }
+        double x2 = x * x;
+        return x * (1.0 + x2 * (1.0 / 6.0 + x2 * (1.0 / 120.0 + x2 * (1.0 / 5040.0 + x2 * (1.0 / 362880.0
+                    + x2 * (1.0 / 39916800.0))))));
+    }
+
+private:
+
+    static constexpr double cPi = 3.14159265358979323846;
+    static constexpr double cHalfPi = 1.57079632679489661923;
+};
+
+#endif // FASTMATH_H
@@ -20,12 +20,16 @@
 
 #include <complex>
 #include <valarray>
+#include <QVector>
 #include "DspApi.h"
 
 /**
  * @brief Implement fast Fourier transformation.
  * This class performs direct and inverse fast Fourier transform
  * including windowing.
+ *
+ * This is a simple complex transform that recomputes its twiddles
+ * on every call. Use RealFft for real signals and repeated transforms.
  */
 class QMUSIC_DSP_API Fft
 {
@@ -58,6 +62,14 @@ public:
      * @param x
      */
     static void inverse(Array &x);
+
+    /**
+     * Compute window coefficients.
+     * @param win Window type.
+     * @param size Number of samples.
+     * @return Window coefficients.
+     */
+    static QVector<float> window(Window win, int size);
 };
 
 #endif // FFT_H
@@ -18,6 +18,7 @@
 #ifndef FILTERABSTRACTIMPL_H
 #define FILTERABSTRACTIMPL_H
 
+#include <QStringList>
 #include "DspApi.h"
 #include "IFilter.h"
 
@@ -28,11 +29,56 @@ class QMUSIC_DSP_API FilterAbstractImpl : public IFilter
 {
 public:
 
+    /// Cut-off frequency modulation interval.
+    enum ModulationInterval {
+        ModulationInterval_Block,   ///< Cut-off sampled once per block.
+        ModulationInterval_64,      ///< Every 64 samples.
+        ModulationInterval_32,      ///< Every 32 samples.
+        ModulationInterval_16,      ///< Every 16 samples.
+        ModulationInterval_Sample,  ///< Every sample.
+        ModulationInterval_Count
+    };
+
+    /// Default cut-off modulation interval.
+    static const ModulationInterval cDefaultModulationInterval = ModulationInterval_32;
+
     FilterAbstractImpl();
 
     void setSampleRate(double sr) override;
     void setCutOffFrequency(double f) override;
 
+    /**
+     * Default block processing, calling doFilter() for every sample.
+     */
+    void processBlock(const float *pIn, float *pOut, int nFrames) override;
+
+    /**
+     * Process a block of samples with a modulated cut-off frequency.
+     * The cut-off frequency is sampled at the end of every modulation
+     * interval, and interpolated by processBlock() in between.
+     * @param pIn Input samples.
+     * @param pCutOff Cut-off frequencies, one per sample.
+     * @param pOut Output samples, may be the same as input.
+     * @param nFrames Number of samples to process.
+     * @param audioRate Whether the cut-off frequency changes within the block,
+     * otherwise it is sampled only once.
+     */
+    void processModulatedBlock(const float *pIn, const float *pCutOff, float *pOut, int nFrames, bool audioRate);
+
+    ModulationInterval modulationInterval() const { return m_modulationInterval; }
+
+    /**
+     * Set the cut-off modulation interval.
+     * @param interval Interval, or its index in the modulationIntervalNames() list.
+     */
+    void setModulationInterval(int interval);
+
+    /**
+     * Returns the modulation intervals names, to be listed in the user interface.
+     * @return
+     */
+    static QStringList modulationIntervalNames();
+
 protected:
 
     double sampleRate() const { return m_sampleRate; }
@@ -42,6 +88,7 @@ private:
 
     double m_sampleRate;
     double m_cutOffFrequency;
+    ModulationInterval m_modulationInterval;
 };
 
 #endif // FILTERABSTRACTIMPL_H
@@ -56,6 +56,14 @@ public:
      */
     virtual double doFilter(double x) = 0;
 
+    /**
+     * Process a block of samples.
+     * @param pIn Input samples.
+     * @param pOut Output samples, may be the same as input.
+     * @param nFrames Number of samples to process.
+     */
+    virtual void processBlock(const float *pIn, float *pOut, int nFrames) = 0;
+
     /// Destructor.
     virtual ~IFilter() {}
 };
@@ -0,0 +1,98 @@
+/*
+                          qmusic
+
+    Copyright (C) 2015 Arthur Benilov,
+    arthur.benilov@gmail.com
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This software is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    Lesser General Public License for more details.
+*/
+#ifndef NOISEGENERATOR_H
+#define NOISEGENERATOR_H
+
+#include <QtGlobal>
+#include "DspApi.h"
+
+/**
+ * @brief Noise generator with its own random numbers sequence.
+ *
+ * White noise comes from four xorshift128 generators running in
+ * lockstep (with SSE2 or NEON), each one producing every fourth
+ * sample. Pink noise is obtained by filtering white noise
+ * (Paul Kellet's refined method, within 0.05 dB above 9 Hz),
+ * brown noise by a leaky integrator.
+ *
+ * The sequence only depends on the seed: it is the same whatever
+ * the blocks sizes are, which makes offline renders reproducible.
+ * Generators do not share any state, so that each voice can have
+ * its own one.
+ */
+class QMUSIC_DSP_API NoiseGenerator
+{
+public:
+
+    /// Noise spectrum.
+    enum Color {
+        Color_White,    ///< Flat spectrum.
+        Color_Pink,     ///< -3 dB per octave.
+        Color_Brown     ///< -6 dB per octave.
+    };
+
+    /**
+     * Construct the generator.
+     * @param seed Random numbers sequence seed.
+     */
+    explicit NoiseGenerator(quint64 seed = 0);
+
+    /**
+     * Restart the random numbers sequence.
+     * This also clears the filters memory.
+     * @param seed
+     */
+    void setSeed(quint64 seed);
+
+    Color color() const { return m_color; }
+    void setColor(Color color) { m_color = color; }
+
+    /**
+     * Generate noise samples in [-1, 1].
+     * @param pOut Output buffer.
+     * @param nFrames Number of samples to generate.
+     */
+    void generate(float *pOut, int nFrames);
+
+private:
+
+    /// Number of interleaved generators.
+    static const int cLanes = 4;
+
+    /// Generate white noise.
+    void white(float *pOut, int nFrames);
+
+    /// Generate next samples of all the lanes.
+    void step(float *pOut);
+
+    Color m_color;
+
+    /// xorshift128 states (x, y, z, w), cLanes values each.
+    quint32 m_state[4 * cLanes];
+
+    /// Samples generated but not output yet.
+    float m_pending[cLanes];
+    int m_pendingIndex;
+
+    /// Pink noise filter states.
+    float m_pink[7];
+
+    /// Brown noise integrator state.
+    float m_brown;
+};
+
+#endif // NOISEGENERATOR_H
@@ -0,0 +1,112 @@
+/*
+                          qmusic
+
+    Copyright (C) 2015 Arthur Benilov,
+    arthur.benilov@gmail.com
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This software is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    Lesser General Public License for more details.
+*/
+
+#ifndef REALFFT_H
+#define REALFFT_H
+
+#include <QVector>
+#include "DspApi.h"
+
+/**
+ * @brief Fast Fourier transform plan for real signals.
+ *
+ * A real sequence of N samples is transformed by means of a complex
+ * FFT of N/2 points followed by a split step. The complex transform
+ * processes two radix-2 stages per pass (radix-4 butterflies), using
+ * SSE2 when available.
+ *
+ * The plan precomputes the twiddle factors and the bit-reversal
+ * permutation on construction, so that transforms do not allocate
+ * any memory and can be used from the audio thread. A plan can be shared
+ * between threads since the transforms do not modify it.
+ *
+ * The spectrum is stored as N/2 + 1 interleaved complex values
+ * (re0, im0, re1, im1, ..., reN/2, imN/2), i.e. N + 2 floats.
+ * Buffers aligned on 16 bytes give the best performance.
+ */
+class QMUSIC_DSP_API RealFft
+{
+public:
+
+    /**
+     * Construct the transform plan.
+     * @param size Number of real samples, power of two, at least 4.
+     */
+    RealFft(int size);
+
+    /**
+     * Returns number of real samples.
+     * @return
+     */
+    int size() const { return m_size; }
+
+    /**
+     * Returns number of floats in the spectrum (N + 2).
+     * @return
+     */
+    int spectrumSize() const { return m_size + 2; }
+
+    /**
+     * Perform the direct (unnormalized) transform.
+     * @param pIn N real samples.
+     * @param pOut N/2 + 1 complex values. This can be the input buffer
+     *             for in-place transform, provided it holds N + 2 floats.
+     */
+    void forward(const float *pIn, float *pOut) const;
+
+    /**
+     * Perform the inverse transform, scaled so that
+     * inverse(forward(x)) == x.
+     * @param pIn N/2 + 1 complex values. This buffer is used as a scratch
+     *            area and is modified by the transform.
+     * @param pOut N real samples. This can be the input buffer
+     *             for in-place transform.
+     */
+    void inverse(float *pIn, float *pOut) const;
+
+private:
+
+    /**
+     * Copy complex values in bit-reversed order.
+     * @param pSrc Source interleaved complex values.
+     * @param pDst Destination, can be the same as the source.
+     */
+    void permute(const float *pSrc, float *pDst) const;
+
+    /**
+     * In-place complex FFT of N/2 interleaved values in bit-reversed order.
+     * @param pData Interleaved complex values.
+     * @param inverse Whether to perform the inverse (unnormalized) transform.
+     */
+    void complexTransform(float *pData, bool inverse) const;
+
+    /**
+     * Build the twiddles of all radix-4 passes.
+     * @param sign -1 for the direct transform, +1 for the inverse one.
+     * @return Twiddles table.
+     */
+    QVector<float> makeTwiddles(double sign) const;
+
+    int m_size;                     ///< Number of real samples.
+    int m_half;                     ///< Size of the complex transform.
+    QVector<int> m_bitReverse;      ///< Bit-reversal permutation of N/2 points.
+    QVector<float> m_forwardTwiddles;   ///< Direct transform passes twiddles.
+    QVector<float> m_inverseTwiddles;   ///< Inverse transform passes twiddles.
+    QVector<float> m_splitTwiddles; ///< Real split twiddles (cos, sin).
+};
+
+#endif // REALFFT_H
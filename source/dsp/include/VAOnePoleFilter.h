@@ -20,6 +20,7 @@
 
 #include "DspApi.h"
 #include "FilterAbstractImpl.h"
+#include "BiquadFilter.h"
 
 /**
  * @brief Virtual analogue single pole filter
@@ -39,6 +40,24 @@ public:
     void update() override;
     double doFilter(double x) override;
 
+    /**
+     * Process a block of samples.
+     * Cut-off frequency changes are interpolated over the block.
+     * @param pIn Input samples.
+     * @param pOut Output samples, may be the same as input.
+     * @param nFrames Number of samples to process.
+     */
+    void processBlock(const float *pIn, float *pOut, int nFrames) override;
+
+    /**
+     * Returns the equivalent biquad coefficients of this filter.
+     * The trapezoidal one-pole filter is the bilinear transform
+     * of the analog one, so it can be run as a first order biquad,
+     * e.g. by a BiquadFilterBank. Feedback input is not accounted for.
+     * @return
+     */
+    BiquadFilter::Coefficients biquadCoefficients() const;
+
     void setType(Type t) { m_type = t; }
 
     void setFeedback(double fb) { m_dFeedback = fb; }
@@ -52,6 +71,7 @@ private:
     Type m_type;
 
     double m_dAlpha;
+    double m_dTargetAlpha;  ///< Alpha to be reached by the end of the next block.
     double m_dBeta;
     double m_dZ1;
     double m_dGamma;
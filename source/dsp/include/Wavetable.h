@@ -0,0 +1,186 @@
+/*
+                          qmusic
+
+    Copyright (C) 2015 Arthur Benilov,
+    arthur.benilov@gmail.com
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This software is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    Lesser General Public License for more details.
+*/
+#ifndef WAVETABLE_H
+#define WAVETABLE_H
+
+#include <cmath>
+#include <QtGlobal>
+#include <QVector>
+#include "DspApi.h"
+
+/**
+ * @brief Band-limited wavetable oscillator.
+ *
+ * A single cycle waveform is stored as a set of mip-mapped tables,
+ * one per octave: level k keeps only the harmonics below
+ * (TableSize / 2) >> k, so that the level chosen for a given frequency
+ * never produces partials above Nyquist. The tables are computed
+ * once (from the harmonics amplitudes via an inverse FFT), then read
+ * with linear or cubic interpolation.
+ *
+ * The phase is a 32 bits fixed point fraction of cycle, which wraps
+ * by itself. Phases of a block are accumulated first and only then
+ * looked up, so the accumulation loop is vectorized by the compiler.
+ *
+ * Rendering does not modify the wavetable, so that a table can be shared
+ * between the units and voices.
+ */
+class QMUSIC_DSP_API Wavetable
+{
+public:
+
+    /// Standard waveforms.
+    enum Shape {
+        Shape_Sine,
+        Shape_Sawtooth,
+        Shape_Square,
+        Shape_Triangle
+    };
+
+    /// Table lookup interpolation.
+    enum Interpolation {
+        Interpolation_Linear,
+        Interpolation_Cubic
+    };
+
+    /// Number of samples in a cycle.
+    static const int TableSize = 2048;
+
+    /// Number of mip-map levels.
+    static const int Levels = 10;
+
+    /**
+     * Construct a silent wavetable.
+     */
+    Wavetable();
+
+    /**
+     * Construct a wavetable of a standard waveform.
+     * @param shape
+     */
+    explicit Wavetable(Shape shape);
+
+    /**
+     * Generate tables of a standard waveform.
+     * Sawtooth is rising, square starts with its positive half-period
+     * and triangle starts from its maximum, which matches the naive
+     * waveforms computed from the same phase.
+     * The harmonics keep the amplitudes of the unit waveforms, so that
+     * band-limited sawtooth and square overshoot slightly (Gibbs phenomenon)
+     * rather than being scaled down.
+     * @param shape
+     */
+    void setShape(Shape shape);
+
+    /**
+     * Generate tables from a single cycle waveform.
+     * The waveform is analysed by a discrete Fourier transform, so that
+     * it can be of any length. It is scaled down if the band-limited
+     * tables exceed the [-1, 1] range.
+     * @param pSamples Cycle samples.
+     * @param nSamples Number of samples, at least 2.
+     * @return false if there are not enough samples.
+     */
+    bool setWaveform(const float *pSamples, int nSamples);
+
+    /**
+     * Convert a phase expressed in cycles to fixed point.
+     * Only the fractional part of the phase is kept.
+     * @param cycles
+     * @return
+     */
+    static quint32 phase(double cycles)
+    {
+        return quint32(quint64((cycles - std::floor(cycles)) * cPhaseScale));
+    }
+
+    /**
+     * Convert a fixed point phase to cycles, in [0, 1).
+     * @param phase
+     * @return
+     */
+    static double cycles(quint32 phase) { return phase / cPhaseScale; }
+
+    /**
+     * Convert a frequency to a fixed point phase increment.
+     * Negative frequencies run the waveform backwards.
+     * @param f Frequency normalized to the sample rate (cycles per sample).
+     * @return
+     */
+    static quint32 increment(double f)
+    {
+        return quint32(qint64(f * cPhaseScale));
+    }
+
+    /**
+     * Render a block at constant frequency.
+     * @param pOut Output buffer.
+     * @param nFrames Number of samples to render.
+     * @param phase Phase of the first sample, updated to the phase
+     *              following the block.
+     * @param increment Phase increment per sample.
+     * @param interpolation
+     */
+    void render(float *pOut, int nFrames, quint32 &phase, quint32 increment,
+                Interpolation interpolation = Interpolation_Linear) const;
+
+    /**
+     * Render a block with a per sample frequency.
+     * A table level is chosen for every 64 samples, after the highest
+     * frequency among them.
+     * @param pOut Output buffer.
+     * @param nFrames Number of samples to render.
+     * @param phase Phase of the first sample, updated to the phase
+     *              following the block.
+     * @param pIncrements Phase increments per sample.
+     * @param interpolation
+     */
+    void render(float *pOut, int nFrames, quint32 &phase, const quint32 *pIncrements,
+                Interpolation interpolation = Interpolation_Linear) const;
+
+private:
+
+    static constexpr double cPhaseScale = 4294967296.0;
+
+    /// Samples stored in front of (1) and after (2) every table.
+    static const int cGuard = 3;
+    static const int cStride = TableSize + cGuard;
+
+    /// Samples rendered per level choice.
+    static const int cChunk = 64;
+
+    /**
+     * Build all the levels from harmonics amplitudes.
+     * @param cosines Cosine amplitudes, starting from DC.
+     * @param sines Sine amplitudes, starting from DC.
+     * @param normalize Scale the levels down when they exceed the [-1, 1] range.
+     */
+    void build(const QVector<double> &cosines, const QVector<double> &sines, bool normalize);
+
+    /// Returns the level suited for the phase increment.
+    int level(quint32 increment) const;
+
+    /// Returns the first sample of the level table.
+    const float* table(int level) const { return m_tables.constData() + level * cStride + 1; }
+
+    static void lookup(const float *pTable, const quint32 *pPhases, float *pOut, int nFrames,
+                       Interpolation interpolation);
+
+    QVector<float> m_tables;
+};
+
+#endif // WAVETABLE_H
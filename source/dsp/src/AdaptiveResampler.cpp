@@ -0,0 +1,129 @@
+/*
+                          qmusic
+
+    Copyright (C) 2015 Arthur Benilov,
+    arthur.benilov@gmail.com
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This software is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    Lesser General Public License for more details.
+*/
+
+#include <cmath>
+#include <cstring>
+#include <QtGlobal>
+#include "AdaptiveResampler.h"
+
+/// Time constant of the buffer fill error filter, seconds.
+const double cErrorTimeConstant(0.5);
+
+/// Proportional gain, ratio per frame of error.
+const double cKp(3.0e-6);
+
+/// Integral gain, ratio per frame-second of error.
+const double cKi(2.0e-7);
+
+/// Maximum deviation of the ratio from 1.
+const double cMaxDeviation(0.005);
+
+AdaptiveResampler::AdaptiveResampler(int nChannels, int maxFrames)
+    : m_nChannels(nChannels),
+      m_maxFrames(maxFrames),
+      m_pendingCapacity(2 * maxFrames + cTaps),
+      m_taps(nChannels * cTaps),
+      m_pending(nChannels * (2 * maxFrames + cTaps))
+{
+    Q_ASSERT(nChannels > 0);
+    Q_ASSERT(maxFrames > 0);
+    reset();
+}
+
+void AdaptiveResampler::reset()
+{
+    m_ratio = 1.0;
+    m_phase = 0.0;
+    m_error = 0.0;
+    m_integral = 0.0;
+    m_taps.fill(0.0f);
+    m_nPending = 0;
+}
+
+void AdaptiveResampler::control(double error, double dt)
+{
+    // Buffer fill is jumping by whole device buffers, so it is low-pass filtered
+    m_error += (error - m_error) * qMin(1.0, dt / cErrorTimeConstant);
+
+    // Integrator is limited to avoid winding up while the ratio is saturated
+    const double integralMax = cMaxDeviation / cKi;
+    m_integral = qBound(-integralMax, m_integral + m_error * dt, integralMax);
+
+    double deviation = cKp * m_error + cKi * m_integral;
+    m_ratio = 1.0 + qBound(-cMaxDeviation, deviation, cMaxDeviation);
+}
+
+int AdaptiveResampler::inputFrames(int nOutput) const
+{
+    // One extra frame covers rounding of the accumulated phase
+    int n = int(std::floor(m_phase + nOutput * m_ratio)) + 1 - m_nPending;
+    return qMax(0, n);
+}
+
+void AdaptiveResampler::process(const float * const *ppInput, int nInput, float * const *ppOutput, int nOutput)
+{
+    Q_ASSERT(nOutput <= m_maxFrames);
+
+    // Append the input to the pending frames
+    nInput = qMin(nInput, m_pendingCapacity - m_nPending);
+    for (int c = 0; c < m_nChannels; c++) {
+        std::memcpy(m_pending.data() + c * m_pendingCapacity + m_nPending, ppInput[c], nInput * sizeof(float));
+    }
+    m_nPending += nInput;
+
+    int consumed = 0;
+    double phase = m_phase;
+
+    for (int i = 0; i < nOutput; i++) {
+        phase += m_ratio;
+        while (phase >= 1.0) {
+            phase -= 1.0;
+            // Shift the next input frame into the taps, repeating the last one when starving
+            for (int c = 0; c < m_nChannels; c++) {
+                float *pTaps = m_taps.data() + c * cTaps;
+                float x = consumed < m_nPending ? m_pending.at(c * m_pendingCapacity + consumed) : pTaps[cTaps - 1];
+                pTaps[0] = pTaps[1];
+                pTaps[1] = pTaps[2];
+                pTaps[2] = pTaps[3];
+                pTaps[3] = x;
+            }
+            consumed++;
+        }
+
+        // Catmull-Rom interpolation between the two middle taps
+        float t = float(phase);
+        for (int c = 0; c < m_nChannels; c++) {
+            const float *x = m_taps.constData() + c * cTaps;
+            float c1 = 0.5f * (x[2] - x[0]);
+            float c2 = x[0] - 2.5f * x[1] + 2.0f * x[2] - 0.5f * x[3];
+            float c3 = 0.5f * (x[3] - x[0]) + 1.5f * (x[1] - x[2]);
+            ppOutput[c][i] = ((c3 * t + c2) * t + c1) * t + x[1];
+        }
+    }
+
+    m_phase = phase;
+
+    // Keep the frames which have not been consumed
+    consumed = qMin(consumed, m_nPending);
+    m_nPending -= consumed;
+    if (m_nPending > 0 && consumed > 0) {
+        for (int c = 0; c < m_nChannels; c++) {
+            float *pPending = m_pending.data() + c * m_pendingCapacity;
+            std::memmove(pPending, pPending + consumed, m_nPending * sizeof(float));
+        }
+    }
+}
@@ -1,36 +1,46 @@
 #include <qmath.h>
+#include "FastMath.h"
 #include "BiquadFilter.h"
 
+/// Limit of the normalized angular frequency, keeping it within (0, pi).
+const double cMinW0(1.0e-6);
+
 BiquadFilter::BiquadFilter(Type type)
     : FilterAbstractImpl(),
       m_type(type),
       m_dBGain(0.0),
       m_q(1.0)
 {
+    updateGainTerms();
     recalculate();
+    m_coeffs = m_target;
     m_x_1 = m_x_2 = m_y_1 = m_y_2 = 0.0;
 }
 
 void BiquadFilter::setType(Type t)
 {
     m_type = t;
+    updateGainTerms();
     recalculate();
 }
 
 void BiquadFilter::setDBGain(double g)
 {
     m_dBGain = g;
+    updateGainTerms();
     recalculate();
 }
 
 void BiquadFilter::setQFactor(double q)
 {
     m_q = q;
+    updateGainTerms();
     recalculate();
 }
 
 void BiquadFilter::reset()
 {
+    m_coeffs = m_target;
     m_x_1 = m_x_2 = 0.0;
     m_y_1 = m_y_2 = 0.0;
 }
@@ -42,8 +52,11 @@ void BiquadFilter::update()
 
 double BiquadFilter::doFilter(double x)
 {
-    double y = m_b0*x + m_b1*m_x_1 + m_b2*m_x_2
-                      - m_a1*m_y_1 - m_a2*m_y_2;
+    // Per-sample processing does not interpolate the coefficients
+    m_coeffs = m_target;
+
+    double y = m_coeffs.b0*x + m_coeffs.b1*m_x_1 + m_coeffs.b2*m_x_2
+                             - m_coeffs.a1*m_y_1 - m_coeffs.a2*m_y_2;
 
     m_x_2 = m_x_1;
     m_x_1 = x;
@@ -53,21 +66,83 @@ double BiquadFilter::doFilter(double x)
     return y;
 }
 
-void BiquadFilter::recalculate()
+void BiquadFilter::processBlock(const float *pIn, float *pOut, int nFrames)
 {
-    // @see http://www.musicdsp.org/files/Audio-EQ-Cookbook.txt
+    if (nFrames <= 0) {
+        return;
+    }
 
-    double A = 0.0;
-    if (m_type == Type_PeakingEQ || m_type == Type_LowShelf || m_type == Type_HighShelf) {
-        A = sqrt(pow(10.0, m_dBGain/40.0));
+    // Keep everything in locals, so that the compiler
+    // holds the state in registers for the whole block.
+    double b0 = m_coeffs.b0;
+    double b1 = m_coeffs.b1;
+    double b2 = m_coeffs.b2;
+    double a1 = m_coeffs.a1;
+    double a2 = m_coeffs.a2;
+    double x1 = m_x_1;
+    double x2 = m_x_2;
+    double y1 = m_y_1;
+    double y2 = m_y_2;
+
+    if (b0 == m_target.b0 && b1 == m_target.b1 && b2 == m_target.b2
+            && a1 == m_target.a1 && a2 == m_target.a2) {
+        for (int i = 0; i < nFrames; i++) {
+            double x = pIn[i];
+            double y = b0*x + b1*x1 + b2*x2 - a1*y1 - a2*y2;
+            x2 = x1;
+            x1 = x;
+            y2 = y1;
+            y1 = y;
+            pOut[i] = float(y);
+        }
     } else {
-        A = sqrt(pow(10.0, m_dBGain/20.0));
+        double k = 1.0 / nFrames;
+        double db0 = (m_target.b0 - b0) * k;
+        double db1 = (m_target.b1 - b1) * k;
+        double db2 = (m_target.b2 - b2) * k;
+        double da1 = (m_target.a1 - a1) * k;
+        double da2 = (m_target.a2 - a2) * k;
+        for (int i = 0; i < nFrames; i++) {
+            b0 += db0;
+            b1 += db1;
+            b2 += db2;
+            a1 += da1;
+            a2 += da2;
+            double x = pIn[i];
+            double y = b0*x + b1*x1 + b2*x2 - a1*y1 - a2*y2;
+            x2 = x1;
+            x1 = x;
+            y2 = y1;
+            y1 = y;
+            pOut[i] = float(y);
+        }
+        m_coeffs = m_target;
     }
+
+    m_x_1 = x1;
+    m_x_2 = x2;
+    m_y_1 = y1;
+    m_y_2 = y2;
+}
+
+void BiquadFilter::recalculate()
+{
+    // @see http://www.musicdsp.org/files/Audio-EQ-Cookbook.txt
+
+    const double A = m_A;
+    const double sqrtA = m_sqrtA;
+
+    // Cut-off frequency is modulated, so this runs at control rate:
+    // the gain terms are cached and the trigonometry is approximated.
     double w0 = 2.0 * M_PI * cutOffFrequency() / sampleRate();
+    w0 = qBound(cMinW0, w0, M_PI - cMinW0);
 
-    double cos_w0 = cos(w0);
-    double sin_w0 = sin(w0);
+    double sin_w0 = 0.0;
+    double cos_w0 = 0.0;
+    FastMath::sinCos(w0, sin_w0, cos_w0);
     double alpha = 0.0;
+    double a0 = 1.0, a1 = 0.0, a2 = 0.0;
+    double b0 = 1.0, b1 = 0.0, b2 = 0.0;
 
     switch (m_type)
     {
@@ -79,11 +154,11 @@ void BiquadFilter::recalculate()
     case Type_BPF:
     case Type_Notch:
     case Type_PeakingEQ:
-        alpha = sin_w0 * sinh(log(2.0)/2.0 * m_q * w0/sin_w0);
+        alpha = sin_w0 * FastMath::sinh(M_LN2/2.0 * m_q * w0/sin_w0);
         break;
     case Type_LowShelf:
     case Type_HighShelf:
-        alpha = sin_w0/2.0 * sqrt((A + 1.0/A) * (1/m_q - 1) + 2.0);
+        alpha = sin_w0/2.0 * m_shelfSlope;
         break;
     default:
         Q_ASSERT(!"Should never get here");
@@ -91,78 +166,89 @@ void BiquadFilter::recalculate()
 
     switch (m_type) {
     case Type_LPF:
-        m_b0 = (1.0 - cos_w0) / 2.0;
-        m_b1 = 1.0 - cos_w0;
-        m_b2 = (1.0 - cos_w0) / 2.0;
-        m_a0 = 1.0 + alpha;
-        m_a1 = -2.0 * cos_w0;
-        m_a2 = 1.0 - alpha;
+        b0 = (1.0 - cos_w0) / 2.0;
+        b1 = 1.0 - cos_w0;
+        b2 = (1.0 - cos_w0) / 2.0;
+        a0 = 1.0 + alpha;
+        a1 = -2.0 * cos_w0;
+        a2 = 1.0 - alpha;
         break;
     case Type_HPF:
-        m_b0 = (1.0 + cos_w0) / 2.0;
-        m_b1 = -(1.0 + cos_w0);
-        m_b2 = (1.0 + cos_w0) / 2.0;
-        m_a0 = 1.0 + alpha;
-        m_a1 = -2.0 * cos_w0;
-        m_a2 = 1.0 - alpha;
+        b0 = (1.0 + cos_w0) / 2.0;
+        b1 = -(1.0 + cos_w0);
+        b2 = (1.0 + cos_w0) / 2.0;
+        a0 = 1.0 + alpha;
+        a1 = -2.0 * cos_w0;
+        a2 = 1.0 - alpha;
         break;
     case Type_BPF:
         // Constant 0 dB peak gain
-        m_b0 = alpha;
-        m_b1 = 0.0;
-        m_b2 = -alpha;
-        m_a0 = 1.0 + alpha;
-        m_a1 = -2.0 * cos_w0;
-        m_a2 = 1.0 - alpha;
+        b0 = alpha;
+        b1 = 0.0;
+        b2 = -alpha;
+        a0 = 1.0 + alpha;
+        a1 = -2.0 * cos_w0;
+        a2 = 1.0 - alpha;
         break;
     case Type_Notch:
-        m_b0 = 1.0;
-        m_b1 = -2.0 * cos_w0;
-        m_b2 = 1.0f;
-        m_a0 = 1.0 + alpha;
-        m_a1 = -2.0 * cos_w0;
-        m_a2 = 1.0 - alpha;
+        b0 = 1.0;
+        b1 = -2.0 * cos_w0;
+        b2 = 1.0f;
+        a0 = 1.0 + alpha;
+        a1 = -2.0 * cos_w0;
+        a2 = 1.0 - alpha;
         break;
     case Type_APF:
-        m_b0 = 1.0 - alpha;
-        m_b1 = -2.0 * cos_w0;
-        m_b2 = 1.0 + alpha;
-        m_a0 = 1.0 + alpha;
-        m_a1 = -2.0 * cos_w0;
-        m_a2 = 1.0 - alpha;
+        b0 = 1.0 - alpha;
+        b1 = -2.0 * cos_w0;
+        b2 = 1.0 + alpha;
+        a0 = 1.0 + alpha;
+        a1 = -2.0 * cos_w0;
+        a2 = 1.0 - alpha;
         break;
     case Type_PeakingEQ:
-        m_b0 = 1.0 + alpha * A;
-        m_b1 = -2.0 * cos_w0;
-        m_b2 = 1.0 - alpha * A;
-        m_a0 = 1.0 + alpha/A;
-        m_a1 = -2.0*cos_w0;
-        m_a2 = 1. - alpha/A;
+        b0 = 1.0 + alpha * A;
+        b1 = -2.0 * cos_w0;
+        b2 = 1.0 - alpha * A;
+        a0 = 1.0 + alpha/A;
+        a1 = -2.0*cos_w0;
+        a2 = 1. - alpha/A;
         break;
     case Type_LowShelf:
-        m_b0 = A*((A + 1.0) - (A - 1.0)*cos_w0 + 2.0*sqrt(A)*alpha);
-        m_b1 = 2.0*A*((A - 1.0) - (A + 1.0)*cos_w0);
-        m_b2 = A*((A + 1.0) - (A - 1.0)*cos_w0 - 2.0*sqrt(A)*alpha);
-        m_a0 = (A + 1.0) + (A - 1.0)*cos_w0 + 2.0*sqrt(A)*alpha;
-        m_a1 = -2.0*((A - 1.0) + (A + 1.0)*cos_w0);
-        m_a2 = (A + 1.0) + (A - 1.0)*cos_w0 - 2.0*sqrt(A)*alpha;
+        b0 = A*((A + 1.0) - (A - 1.0)*cos_w0 + 2.0*sqrtA*alpha);
+        b1 = 2.0*A*((A - 1.0) - (A + 1.0)*cos_w0);
+        b2 = A*((A + 1.0) - (A - 1.0)*cos_w0 - 2.0*sqrtA*alpha);
+        a0 = (A + 1.0) + (A - 1.0)*cos_w0 + 2.0*sqrtA*alpha;
+        a1 = -2.0*((A - 1.0) + (A + 1.0)*cos_w0);
+        a2 = (A + 1.0) + (A - 1.0)*cos_w0 - 2.0*sqrtA*alpha;
         break;
     case Type_HighShelf:
-        m_b0 = A*((A + 1.0) + (A - 1.0)*cos_w0 + 2.0*sqrt(A)*alpha);
-        m_b1 = -2.0*A*((A - 1.0) + (A + 1.0)*cos_w0);
-        m_b2 = A*((A + 1.0) + (A - 1.0)*cos_w0 - 2.0*sqrt(A)*alpha);
-        m_a0 = (A + 1.0) - (A - 1.0)*cos_w0 + 2.0*sqrt(A)*alpha;
-        m_a1 = 2.0*((A - 1) - (A + 1.0)*cos_w0);
-        m_a2 = (A + 1.0) - (A - 1.0)*cos_w0 - 2.0*sqrt(A)*alpha;
+        b0 = A*((A + 1.0) + (A - 1.0)*cos_w0 + 2.0*sqrtA*alpha);
+        b1 = -2.0*A*((A - 1.0) + (A + 1.0)*cos_w0);
+        b2 = A*((A + 1.0) + (A - 1.0)*cos_w0 - 2.0*sqrtA*alpha);
+        a0 = (A + 1.0) - (A - 1.0)*cos_w0 + 2.0*sqrtA*alpha;
+        a1 = 2.0*((A - 1) - (A + 1.0)*cos_w0);
+        a2 = (A + 1.0) - (A - 1.0)*cos_w0 - 2.0*sqrtA*alpha;
         break;
     default:
         Q_ASSERT(!"Should never get here");
     }
 
     // Normalize the coefficients.
-    m_a1 /= m_a0;
-    m_a2 /= m_a0;
-    m_b0 /= m_a0;
-    m_b1 /= m_a0;
-    m_b2 /= m_a0;
+    m_target.a1 = a1 / a0;
+    m_target.a2 = a2 / a0;
+    m_target.b0 = b0 / a0;
+    m_target.b1 = b1 / a0;
+    m_target.b2 = b2 / a0;
+}
+
+void BiquadFilter::updateGainTerms()
+{
+    if (m_type == Type_PeakingEQ || m_type == Type_LowShelf || m_type == Type_HighShelf) {
+        m_A = sqrt(pow(10.0, m_dBGain/40.0));
+    } else {
+        m_A = sqrt(pow(10.0, m_dBGain/20.0));
+    }
+    m_sqrtA = sqrt(m_A);
+    m_shelfSlope = sqrt((m_A + 1.0/m_A) * (1/m_q - 1) + 2.0);
 }
@@ -0,0 +1,244 @@
+/*
+                          qmusic
+
+    Copyright (C) 2015 Arthur Benilov,
+    arthur.benilov@gmail.com
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This software is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    Lesser General Public License for more details.
+*/
+
+#include <qmath.h>
+#include "BiquadFilterBank.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   define QMUSIC_DSP_SSE2
+#   include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#   define QMUSIC_DSP_NEON
+#   include <arm_neon.h>
+#endif
+
+/// States below this level are flushed to zero to avoid denormals.
+const float cDenormalLevel(1.0e-20f);
+
+namespace {
+
+/*
+ * Four lanes vector operations.
+ */
+#if defined(QMUSIC_DSP_SSE2)
+
+typedef __m128 Vec;
+
+inline Vec load(const float *p) { return _mm_loadu_ps(p); }
+inline void store(float *p, Vec v) { _mm_storeu_ps(p, v); }
+inline Vec splat(float x) { return _mm_set1_ps(x); }
+inline Vec add(Vec a, Vec b) { return _mm_add_ps(a, b); }
+inline Vec sub(Vec a, Vec b) { return _mm_sub_ps(a, b); }
+inline Vec mul(Vec a, Vec b) { return _mm_mul_ps(a, b); }
+inline Vec gather(const float * const *pp, int i) { return _mm_set_ps(pp[3][i], pp[2][i], pp[1][i], pp[0][i]); }
+
+inline Vec flushDenormals(Vec v)
+{
+    const Vec absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    return _mm_and_ps(v, _mm_cmpgt_ps(_mm_and_ps(v, absMask), splat(cDenormalLevel)));
+}
+
+#elif defined(QMUSIC_DSP_NEON)
+
+typedef float32x4_t Vec;
+
+inline Vec load(const float *p) { return vld1q_f32(p); }
+inline void store(float *p, Vec v) { vst1q_f32(p, v); }
+inline Vec splat(float x) { return vdupq_n_f32(x); }
+inline Vec add(Vec a, Vec b) { return vaddq_f32(a, b); }
+inline Vec sub(Vec a, Vec b) { return vsubq_f32(a, b); }
+inline Vec mul(Vec a, Vec b) { return vmulq_f32(a, b); }
+
+inline Vec gather(const float * const *pp, int i)
+{
+    const float x[4] = { pp[0][i], pp[1][i], pp[2][i], pp[3][i] };
+    return vld1q_f32(x);
+}
+
+inline Vec flushDenormals(Vec v)
+{
+    uint32x4_t mask = vcgtq_f32(vabsq_f32(v), splat(cDenormalLevel));
+    return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(v), mask));
+}
+
+#else
+
+struct Vec {
+    float v[4];
+};
+
+inline Vec load(const float *p) { Vec r; for (int k = 0; k < 4; k++) r.v[k] = p[k]; return r; }
+inline void store(float *p, const Vec &a) { for (int k = 0; k < 4; k++) p[k] = a.v[k]; }
+inline Vec splat(float x) { Vec r; for (int k = 0; k < 4; k++) r.v[k] = x; return r; }
+inline Vec add(const Vec &a, const Vec &b) { Vec r; for (int k = 0; k < 4; k++) r.v[k] = a.v[k] + b.v[k]; return r; }
+inline Vec sub(const Vec &a, const Vec &b) { Vec r; for (int k = 0; k < 4; k++) r.v[k] = a.v[k] - b.v[k]; return r; }
+inline Vec mul(const Vec &a, const Vec &b) { Vec r; for (int k = 0; k < 4; k++) r.v[k] = a.v[k] * b.v[k]; return r; }
+inline Vec gather(const float * const *pp, int i) { Vec r; for (int k = 0; k < 4; k++) r.v[k] = pp[k][i]; return r; }
+
+inline Vec flushDenormals(const Vec &a)
+{
+    Vec r;
+    for (int k = 0; k < 4; k++) {
+        r.v[k] = qAbs(a.v[k]) > cDenormalLevel ? a.v[k] : 0.0f;
+    }
+    return r;
+}
+
+#endif
+
+} // namespace
+
+BiquadFilterBank::BiquadFilterBank(int nLanes)
+    : m_nLanes(nLanes),
+      m_stride((nLanes + cWidth - 1) / cWidth * cWidth),
+      m_data(Param_Count * m_stride, 0.0f)
+{
+    Q_ASSERT(nLanes > 0);
+
+    // Pass-through, including the padding lanes
+    for (int lane = 0; lane < m_stride; lane++) {
+        param(Param_B0, lane) = 1.0f;
+        param(Param_TargetB0, lane) = 1.0f;
+    }
+}
+
+void BiquadFilterBank::reset()
+{
+    for (int lane = 0; lane < m_nLanes; lane++) {
+        resetLane(lane);
+    }
+}
+
+void BiquadFilterBank::resetLane(int lane)
+{
+    Q_ASSERT(lane >= 0 && lane < m_nLanes);
+
+    param(Param_B0, lane) = param(Param_TargetB0, lane);
+    param(Param_B1, lane) = param(Param_TargetB1, lane);
+    param(Param_B2, lane) = param(Param_TargetB2, lane);
+    param(Param_A1, lane) = param(Param_TargetA1, lane);
+    param(Param_A2, lane) = param(Param_TargetA2, lane);
+    param(Param_S1, lane) = 0.0f;
+    param(Param_S2, lane) = 0.0f;
+}
+
+void BiquadFilterBank::setCoefficients(int lane, const BiquadFilter::Coefficients &coeffs)
+{
+    Q_ASSERT(lane >= 0 && lane < m_nLanes);
+
+    param(Param_TargetB0, lane) = float(coeffs.b0);
+    param(Param_TargetB1, lane) = float(coeffs.b1);
+    param(Param_TargetB2, lane) = float(coeffs.b2);
+    param(Param_TargetA1, lane) = float(coeffs.a1);
+    param(Param_TargetA2, lane) = float(coeffs.a2);
+}
+
+void BiquadFilterBank::process(const float * const *ppIn, float * const *ppOut, int nFrames)
+{
+    Q_ASSERT(ppIn != nullptr);
+    Q_ASSERT(ppOut != nullptr);
+
+    if (nFrames <= 0) {
+        return;
+    }
+
+    const Vec k = splat(1.0f / nFrames);
+    float y[cWidth];
+
+    for (int group = 0; group < m_stride; group += cWidth) {
+        int nLanes = qMin(cWidth, m_nLanes - group);
+
+        // Padding lanes read the last lane input, their output is discarded
+        const float *pIn[cWidth];
+        for (int i = 0; i < cWidth; i++) {
+            pIn[i] = ppIn[group + qMin(i, nLanes - 1)];
+        }
+
+        float *p = m_data.data() + group;
+        Vec b0 = load(p + Param_B0 * m_stride);
+        Vec b1 = load(p + Param_B1 * m_stride);
+        Vec b2 = load(p + Param_B2 * m_stride);
+        Vec a1 = load(p + Param_A1 * m_stride);
+        Vec a2 = load(p + Param_A2 * m_stride);
+        Vec tb0 = load(p + Param_TargetB0 * m_stride);
+        Vec tb1 = load(p + Param_TargetB1 * m_stride);
+        Vec tb2 = load(p + Param_TargetB2 * m_stride);
+        Vec ta1 = load(p + Param_TargetA1 * m_stride);
+        Vec ta2 = load(p + Param_TargetA2 * m_stride);
+        Vec s1 = load(p + Param_S1 * m_stride);
+        Vec s2 = load(p + Param_S2 * m_stride);
+
+        bool ramp = false;
+        for (int param = Param_B0; param <= Param_A2 && !ramp; param++) {
+            for (int i = 0; i < cWidth && !ramp; i++) {
+                ramp = p[param * m_stride + i] != p[(param + Param_TargetB0) * m_stride + i];
+            }
+        }
+
+        if (ramp) {
+            // Coefficients are interpolated from the start values rather than
+            // accumulated, which would drift the poles of the low frequency filters.
+            Vec db0 = mul(sub(tb0, b0), k);
+            Vec db1 = mul(sub(tb1, b1), k);
+            Vec db2 = mul(sub(tb2, b2), k);
+            Vec da1 = mul(sub(ta1, a1), k);
+            Vec da2 = mul(sub(ta2, a2), k);
+            Vec n = splat(0.0f);
+            const Vec one = splat(1.0f);
+
+            for (int i = 0; i < nFrames; i++) {
+                n = add(n, one);
+                Vec cb0 = add(b0, mul(db0, n));
+                Vec cb1 = add(b1, mul(db1, n));
+                Vec cb2 = add(b2, mul(db2, n));
+                Vec ca1 = add(a1, mul(da1, n));
+                Vec ca2 = add(a2, mul(da2, n));
+
+                Vec x = gather(pIn, i);
+                Vec out = add(mul(cb0, x), s1);
+                s1 = add(sub(mul(cb1, x), mul(ca1, out)), s2);
+                s2 = sub(mul(cb2, x), mul(ca2, out));
+
+                store(y, out);
+                for (int lane = 0; lane < nLanes; lane++) {
+                    ppOut[group + lane][i] = y[lane];
+                }
+            }
+        } else {
+            for (int i = 0; i < nFrames; i++) {
+                Vec x = gather(pIn, i);
+                Vec out = add(mul(b0, x), s1);
+                s1 = add(sub(mul(b1, x), mul(a1, out)), s2);
+                s2 = sub(mul(b2, x), mul(a2, out));
+
+                store(y, out);
+                for (int lane = 0; lane < nLanes; lane++) {
+                    ppOut[group + lane][i] = y[lane];
+                }
+            }
+        }
+
+        // Land exactly on the target coefficients
+        store(p + Param_B0 * m_stride, tb0);
+        store(p + Param_B1 * m_stride, tb1);
+        store(p + Param_B2 * m_stride, tb2);
+        store(p + Param_A1 * m_stride, ta1);
+        store(p + Param_A2 * m_stride, ta2);
+        store(p + Param_S1 * m_stride, flushDenormals(s1));
+        store(p + Param_S2 * m_stride, flushDenormals(s2));
+    }
+}
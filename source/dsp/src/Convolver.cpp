@@ -0,0 +1,264 @@
+/*
+                          qmusic
+
+    Copyright (C) 2015 Arthur Benilov,
+    arthur.benilov@gmail.com
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This software is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    Lesser General Public License for more details.
+*/
+
+#include <algorithm>
+#include "RealFft.h"
+#include "Convolver.h"
+
+/// Number of taps processed in direct form.
+const int cHeadLength(64);
+
+/// Partition sizes of the FFT stages.
+/// Each stage covers the response up to twice the next stage partition size.
+const int cPartitionSizes[] = { 64, 512, 4096 };
+const int cNumberOfStages(sizeof(cPartitionSizes) / sizeof(cPartitionSizes[0]));
+
+/**
+ * @brief Uniformly partitioned overlap-save convolution stage.
+ *
+ * The stage applies the impulse response taps [offset, offset + length)
+ * with the partitions of P samples. The input is collected by blocks of P samples,
+ * and the output for the next block is computed once the current block is complete.
+ * This gives a latency of P samples that is compensated by the stage offset.
+ */
+class Convolver::Stage
+{
+public:
+
+    Stage(const float *pIr, int offset, int length, int partitionSize);
+
+    void reset();
+
+    /**
+     * Process samples, adding the result to the output.
+     * @param pIn Input samples.
+     * @param pOut Output samples to accumulate to.
+     * @param nFrames Number of samples.
+     */
+    void process(const float *pIn, float *pOut, int nFrames);
+
+private:
+
+    /// Convolve the complete input block.
+    void processPartition();
+
+    int m_partitionSize;            ///< Partition size P.
+    int m_nPartitions;              ///< Number of response partitions.
+    int m_nDelayPartitions;         ///< Partitions to skip to match the stage offset.
+    int m_nSlots;                   ///< Frequency-domain delay line length.
+    RealFft m_fft;                  ///< Transform of 2P samples.
+    QVector<float> m_irSpectra;     ///< Spectra of the response partitions.
+    QVector<float> m_fdl;           ///< Frequency-domain delay line of input spectra.
+    int m_fdlIndex;                 ///< Slot of the most recent input spectrum.
+    QVector<float> m_input;         ///< Last 2P input samples.
+    QVector<float> m_output;        ///< Output samples of the current block.
+    QVector<float> m_spectrum;      ///< Accumulated output spectrum.
+    QVector<float> m_time;          ///< Inverse transform result.
+    int m_fill;                     ///< Number of samples in the current block.
+};
+
+Convolver::Stage::Stage(const float *pIr, int offset, int length, int partitionSize)
+    : m_partitionSize(partitionSize),
+      m_nPartitions((length + partitionSize - 1) / partitionSize),
+      m_nDelayPartitions(offset / partitionSize - 1),
+      m_nSlots(m_nDelayPartitions + m_nPartitions),
+      m_fft(2 * partitionSize),
+      m_fdlIndex(0),
+      m_fill(0)
+{
+    Q_ASSERT(pIr != nullptr);
+    Q_ASSERT(offset >= partitionSize);
+    Q_ASSERT(offset % partitionSize == 0);
+    Q_ASSERT(length > 0);
+
+    int spectrumSize = m_fft.spectrumSize();
+
+    m_irSpectra = QVector<float>(m_nPartitions * spectrumSize, 0.0f);
+    m_fdl = QVector<float>(m_nSlots * spectrumSize, 0.0f);
+    m_input = QVector<float>(2 * partitionSize, 0.0f);
+    m_output = QVector<float>(partitionSize, 0.0f);
+    m_spectrum = QVector<float>(spectrumSize, 0.0f);
+    m_time = QVector<float>(2 * partitionSize, 0.0f);
+
+    // Partition spectra: P taps zero-padded to 2P samples.
+    for (int k = 0; k < m_nPartitions; k++) {
+        int first = k * partitionSize;
+        int count = std::min(partitionSize, length - first);
+        std::fill(m_time.begin(), m_time.end(), 0.0f);
+        std::copy(pIr + offset + first, pIr + offset + first + count, m_time.begin());
+        m_fft.forward(m_time.constData(), m_irSpectra.data() + k * spectrumSize);
+    }
+}
+
+void Convolver::Stage::reset()
+{
+    std::fill(m_fdl.begin(), m_fdl.end(), 0.0f);
+    std::fill(m_input.begin(), m_input.end(), 0.0f);
+    std::fill(m_output.begin(), m_output.end(), 0.0f);
+    m_fdlIndex = 0;
+    m_fill = 0;
+}
+
+void Convolver::Stage::process(const float *pIn, float *pOut, int nFrames)
+{
+    float *pInput = m_input.data() + m_partitionSize;
+    const float *pOutput = m_output.constData();
+
+    while (nFrames > 0) {
+        int n = std::min(nFrames, m_partitionSize - m_fill);
+        for (int i = 0; i < n; i++) {
+            pInput[m_fill + i] = pIn[i];
+            pOut[i] += pOutput[m_fill + i];
+        }
+        m_fill += n;
+        pIn += n;
+        pOut += n;
+        nFrames -= n;
+
+        if (m_fill == m_partitionSize) {
+            processPartition();
+            m_fill = 0;
+        }
+    }
+}
+
+void Convolver::Stage::processPartition()
+{
+    int spectrumSize = m_fft.spectrumSize();
+
+    // Push the input block spectrum to the delay line
+    m_fdlIndex = (m_fdlIndex == 0 ? m_nSlots : m_fdlIndex) - 1;
+    m_fft.forward(m_input.constData(), m_fdl.data() + m_fdlIndex * spectrumSize);
+
+    // Multiply-accumulate the delayed input spectra with the response partitions
+    float *pAcc = m_spectrum.data();
+    std::fill(pAcc, pAcc + spectrumSize, 0.0f);
+    for (int k = 0; k < m_nPartitions; k++) {
+        int slot = (m_fdlIndex + m_nDelayPartitions + k) % m_nSlots;
+        const float *pX = m_fdl.constData() + slot * spectrumSize;
+        const float *pH = m_irSpectra.constData() + k * spectrumSize;
+        for (int i = 0; i < spectrumSize; i += 2) {
+            float xr = pX[i];
+            float xi = pX[i + 1];
+            float hr = pH[i];
+            float hi = pH[i + 1];
+            pAcc[i] += xr * hr - xi * hi;
+            pAcc[i + 1] += xr * hi + xi * hr;
+        }
+    }
+
+    m_fft.inverse(pAcc, m_time.data());
+
+    // Overlap-save: only the last P samples are valid
+    std::copy(m_time.constBegin() + m_partitionSize, m_time.constEnd(), m_output.begin());
+
+    // Slide the input window
+    std::copy(m_input.constBegin() + m_partitionSize, m_input.constEnd(), m_input.begin());
+}
+
+Convolver::Convolver(const QVector<float> &ir)
+    : m_length(ir.count()),
+      m_historyIndex(0),
+      m_stages()
+{
+    Q_ASSERT(!ir.isEmpty());
+
+    // Direct form head, stored reversed for a forward dot product
+    int headLength = std::min(m_length, cHeadLength);
+    m_head = QVector<float>(headLength, 0.0f);
+    for (int i = 0; i < headLength; i++) {
+        m_head[i] = ir.at(headLength - 1 - i);
+    }
+    m_history = QVector<float>(2 * headLength, 0.0f);
+    m_input = QVector<float>(HeadBlockSize, 0.0f);
+
+    // FFT stages for the rest of the response
+    int offset = headLength;
+    for (int i = 0; i < cNumberOfStages && offset < m_length; i++) {
+        int end = i + 1 < cNumberOfStages ? 2 * cPartitionSizes[i + 1] : m_length;
+        end = std::min(end, m_length);
+        if (end > offset) {
+            m_stages.append(new Stage(ir.constData(), offset, end - offset, cPartitionSizes[i]));
+            offset = end;
+        }
+    }
+}
+
+Convolver::~Convolver()
+{
+    qDeleteAll(m_stages);
+}
+
+void Convolver::reset()
+{
+    std::fill(m_history.begin(), m_history.end(), 0.0f);
+    m_historyIndex = 0;
+    for (Stage *pStage : m_stages) {
+        pStage->reset();
+    }
+}
+
+float Convolver::process(float x)
+{
+    float y;
+    process(&x, &y, 1);
+    return y;
+}
+
+void Convolver::process(const float *pIn, float *pOut, int nFrames)
+{
+    Q_ASSERT(pIn != nullptr);
+    Q_ASSERT(pOut != nullptr);
+
+    while (nFrames > 0) {
+        int n = std::min(nFrames, int(HeadBlockSize));
+
+        // Keep the input since the output may overwrite it
+        std::copy(pIn, pIn + n, m_input.begin());
+        const float *pInput = m_input.constData();
+
+        processHead(pInput, pOut, n);
+        for (Stage *pStage : m_stages) {
+            pStage->process(pInput, pOut, n);
+        }
+
+        pIn += n;
+        pOut += n;
+        nFrames -= n;
+    }
+}
+
+void Convolver::processHead(const float *pIn, float *pOut, int nFrames)
+{
+    int headLength = m_head.count();
+    const float *pHead = m_head.constData();
+    float *pHistory = m_history.data();
+
+    for (int i = 0; i < nFrames; i++) {
+        m_historyIndex = m_historyIndex + 1 == headLength ? 0 : m_historyIndex + 1;
+        pHistory[m_historyIndex] = pIn[i];
+        pHistory[m_historyIndex + headLength] = pIn[i];
+
+        // Oldest sample first, matching the reversed taps
+        const float *pX = pHistory + m_historyIndex + 1;
+        float y = 0.0f;
+        for (int k = 0; k < headLength; k++) {
+            y += pHead[k] * pX[k];
+        }
+        pOut[i] = y;
+    }
+}
@@ -20,19 +20,31 @@
 #include <qmath.h>
 #include "DelayLine.h"
 
-DelayLine::DelayLine(int nSamplesMax)
-    : m_nSamples(0),
-      m_nSamplesMax(nSamplesMax),
-      m_pBuffer(nullptr)
+namespace {
+
+int nextPowerOfTwo(int n)
 {
-    Q_ASSERT(nSamplesMax > 0);
+    int p = 1;
+    while (p < n) {
+        p <<= 1;
+    }
+    return p;
+}
 
-    m_nSamples = 0;
-    m_inIndex = 0;
-    m_outIndex = 0;
-    m_frac = 0.0;
+} // namespace
 
-    allocate(nSamplesMax);
+DelayLine::DelayLine(int nSamplesMax, int nFramesMax)
+    : m_nSamplesMax(0),
+      m_nFramesMax(0),
+      m_pBuffer(nullptr),
+      m_size(0),
+      m_mask(0),
+      m_writeIndex(0),
+      m_nWritten(0),
+      m_interpolation(Interpolation_Linear),
+      m_tap()
+{
+    allocate(nSamplesMax, nFramesMax);
 }
 
 DelayLine::~DelayLine()
@@ -40,42 +52,31 @@ DelayLine::~DelayLine()
     delete[] m_pBuffer;
 }
 
-void DelayLine::allocate(int nSamplesMax)
+void DelayLine::allocate(int nSamplesMax, int nFramesMax)
 {
     Q_ASSERT(nSamplesMax > 0);
-    if (m_pBuffer == nullptr) {
-        // First time allocation
-        m_nSamplesMax = nSamplesMax;
-        m_pBuffer = new double[m_nSamplesMax];
-    } else {
-        // Buffer is already allocated
-        if (m_nSamplesMax != nSamplesMax) {
-            // But of a different size, reallocate the buffer
-            delete[] m_pBuffer;
-            m_nSamplesMax = nSamplesMax;
-            m_pBuffer = new double[m_nSamplesMax];
-        }
+    Q_ASSERT(nFramesMax > 0);
+
+    m_nSamplesMax = nSamplesMax;
+    m_nFramesMax = nFramesMax;
+
+    // Room for the longest delay of the first sample of a block, the
+    // rest of the block, and the interpolation neighbours.
+    int size = nextPowerOfTwo(nSamplesMax + nFramesMax + 2);
+    if (m_pBuffer == nullptr || size > m_size) {
+        delete[] m_pBuffer;
+        m_size = size;
+        m_mask = unsigned(size - 1);
+        m_pBuffer = new float[m_size];
     }
+
+    m_tap.delay = qMin(m_tap.delay, float(m_nSamplesMax - 1));
     reset();
 }
 
 void DelayLine::setDelay(int nSamples)
 {
-    // Reset interpolation
-    m_frac = 0.0;
-    if (nSamples == m_nSamples) {
-        // No change
-        return;
-    }
-
-    int delay = qMin(nSamples, m_nSamplesMax - 1);
-    m_nSamples = delay;
-
-    if (m_inIndex >= m_nSamples) {
-        m_outIndex = m_inIndex - m_nSamples;
-    } else {
-        m_outIndex = m_nSamplesMax - m_nSamples + m_inIndex;
-    }
+    m_tap.delay = float(qBound(0, nSamples, m_nSamplesMax - 1));
 }
 
 void DelayLine::setDelayFraction(double f)
@@ -87,32 +88,204 @@ void DelayLine::setDelayFraction(double f)
         f = 1.0;
     }
 
-    double fSamples = double(m_nSamplesMax - 1) * f;
-    int nSamples = ceil(fSamples);
-    setDelay(nSamples);
-
-    // Linear interpolation factor
-    m_frac = ceil(fSamples) - fSamples;
+    m_tap.delay = float(double(m_nSamplesMax - 1) * f);
 }
 
 void DelayLine::reset()
 {
     Q_ASSERT(m_pBuffer != nullptr);
-    memset(m_pBuffer, 0, sizeof(double) * m_nSamplesMax);
+    memset(m_pBuffer, 0, sizeof(float) * m_size);
+    m_writeIndex = 0;
+    m_nWritten = 0;
+    m_tap.allpassOut = 0.0f;
+}
+
+float DelayLine::process(float x)
+{
+    write(&x, 1);
+
+    float out;
+    float delay = m_tap.delay;
+    read(m_tap, &out, &delay, 1);
+    return out;
+}
+
+void DelayLine::write(const float *pIn, int nFrames)
+{
+    Q_ASSERT(nFrames <= m_nFramesMax);
+
+    // Copy in at most two contiguous parts
+    int n = qMin(nFrames, m_size - m_writeIndex);
+    memcpy(m_pBuffer + m_writeIndex, pIn, sizeof(float) * n);
+    memcpy(m_pBuffer, pIn + n, sizeof(float) * (nFrames - n));
+
+    m_writeIndex = (m_writeIndex + nFrames) & m_mask;
+    m_nWritten = nFrames;
+}
+
+void DelayLine::read(Tap &tap, float *pOut, int nFrames, float delay) const
+{
+    Q_ASSERT(nFrames <= m_nWritten);
+
+    delay = clampDelay(delay);
+    readRamp(tap, pOut, 0, nFrames, clampDelay(tap.delay), delay);
+    tap.delay = delay;
+}
+
+void DelayLine::read(Tap &tap, float *pOut, const float *pDelay, int nFrames) const
+{
+    Q_ASSERT(nFrames <= m_nWritten);
+
+    int index = m_writeIndex - m_nWritten;
+    for (int i = 0; i < nFrames; ++i) {
+        pOut[i] = interpolate(tap, index + i, clampDelay(pDelay[i]));
+    }
+    if (nFrames > 0) {
+        tap.delay = clampDelay(pDelay[nFrames - 1]);
+    }
 }
 
-double DelayLine::process(double x)
+void DelayLine::read(Tap *pTaps, const float *pDelays, const float *pGains, int nTaps,
+                     float *pOut, int nFrames) const
 {
-    if (m_pBuffer == nullptr || m_nSamples == 0) {
-        return x;
+    Q_ASSERT(nFrames <= m_nWritten);
+
+    const int cChunkSize(64);
+    float chunk[cChunkSize];
+
+    memset(pOut, 0, sizeof(float) * nFrames);
+
+    for (int t = 0; t < nTaps; ++t) {
+        Tap &tap = pTaps[t];
+        const float gain = pGains[t];
+        const float startDelay = clampDelay(tap.delay);
+        const float delta = clampDelay(pDelays[t]) - startDelay;
+
+        // Read the tap by chunks, the delay following the same ramp over the whole block
+        float delay = startDelay;
+        for (int offset = 0; offset < nFrames; offset += cChunkSize) {
+            int n = qMin(cChunkSize, nFrames - offset);
+            float endDelay = startDelay + delta * (offset + n) / nFrames;
+            readRamp(tap, chunk, offset, n, delay, endDelay);
+            for (int i = 0; i < n; ++i) {
+                pOut[offset + i] += gain * chunk[i];
+            }
+            delay = endDelay;
+        }
+        tap.delay = startDelay + delta;
     }
+}
 
-    m_pBuffer[m_inIndex] = x;
-    double out = m_pBuffer[m_outIndex];
+float DelayLine::clampDelay(float delay) const
+{
+    float minDelay = 0.0f;
+    if (m_interpolation == Interpolation_Lagrange) {
+        minDelay = 1.0f;
+    } else if (m_interpolation == Interpolation_Allpass) {
+        minDelay = 0.5f;
+    }
+    return qBound(minDelay, delay, float(m_nSamplesMax - 1));
+}
 
-    m_inIndex = (m_inIndex + 1) % m_nSamplesMax;
-    m_outIndex = (m_outIndex + 1) % m_nSamplesMax;
+float DelayLine::interpolate(Tap &tap, int index, float delay) const
+{
+    int d = int(delay);
+    float f = delay - d;
+    int k = index - d;  // Position of the sample delayed by d
 
-    // Linear interpolation
-    return out * (1.0 - m_frac) + m_pBuffer[m_outIndex] * m_frac;
+    switch (m_interpolation) {
+    case Interpolation_None:
+        return at(k);
+    case Interpolation_Linear: {
+        float a = at(k);
+        return a + f * (at(k - 1) - a);
+    }
+    case Interpolation_Lagrange: {
+        // Samples delayed by d-1, d, d+1 and d+2
+        float x0 = at(k + 1);
+        float x1 = at(k);
+        float x2 = at(k - 1);
+        float x3 = at(k - 2);
+        float fm1 = f - 1.0f;
+        float fm2 = f - 2.0f;
+        float fp1 = f + 1.0f;
+        return -f * fm1 * fm2 * (1.0f / 6.0f) * x0
+                + fp1 * fm1 * fm2 * 0.5f * x1
+                - fp1 * f * fm2 * 0.5f * x2
+                + fp1 * f * fm1 * (1.0f / 6.0f) * x3;
+    }
+    case Interpolation_Allpass: {
+        // Keep the fractional part within [0.5, 1.5) where the allpass phase delay is flat
+        if (f < 0.5f) {
+            f += 1.0f;
+            ++k;
+        }
+        float eta = (1.0f - f) / (1.0f + f);
+        float out = eta * (at(k) - tap.allpassOut) + at(k - 1);
+        tap.allpassOut = out;
+        return out;
+    }
+    default:
+        break;
+    }
+    return 0.0f;
+}
+
+void DelayLine::readRamp(Tap &tap, float *pOut, int offset, int nFrames,
+                         float startDelay, float endDelay) const
+{
+    int index = m_writeIndex - m_nWritten + offset;
+
+    if (startDelay == endDelay && m_interpolation != Interpolation_Allpass) {
+        readConstant(pOut, index, nFrames, endDelay);
+        return;
+    }
+
+    // Delay changes linearly, reaching the end delay on the last sample
+    float step = (endDelay - startDelay) / nFrames;
+    for (int i = 0; i < nFrames; ++i) {
+        pOut[i] = interpolate(tap, index + i, startDelay + step * (i + 1));
+    }
+}
+
+void DelayLine::readConstant(float *pOut, int index, int nFrames, float delay) const
+{
+    int d = int(delay);
+    float f = delay - d;
+    int k = index - d;
+
+    switch (m_interpolation) {
+    case Interpolation_None:
+        // Copy contiguous parts of the buffer
+        for (int i = 0; i < nFrames;) {
+            int start = int(unsigned(k + i) & m_mask);
+            int n = qMin(nFrames - i, m_size - start);
+            memcpy(pOut + i, m_pBuffer + start, sizeof(float) * n);
+            i += n;
+        }
+        break;
+    case Interpolation_Linear:
+        for (int i = 0; i < nFrames; ++i) {
+            float a = at(k + i);
+            pOut[i] = a + f * (at(k + i - 1) - a);
+        }
+        break;
+    case Interpolation_Lagrange: {
+        // Same coefficients for the whole block
+        float fm1 = f - 1.0f;
+        float fm2 = f - 2.0f;
+        float fp1 = f + 1.0f;
+        float c0 = -f * fm1 * fm2 * (1.0f / 6.0f);
+        float c1 = fp1 * fm1 * fm2 * 0.5f;
+        float c2 = -fp1 * f * fm2 * 0.5f;
+        float c3 = fp1 * f * fm1 * (1.0f / 6.0f);
+        for (int i = 0; i < nFrames; ++i) {
+            pOut[i] = c0 * at(k + i + 1) + c1 * at(k + i) + c2 * at(k + i - 1) + c3 * at(k + i - 2);
+        }
+        break;
+    }
+    default:
+        Q_ASSERT(false);
+        break;
+    }
 }
@@ -40,8 +40,9 @@ void Fft::direct(Fft::Array &x, Window win)
 {
     if (win != Window_None) {
         // Apply window
-        for (int i = 0; i < x.size(); i++) {
-            x[i] *= cWindows[win](i, static_cast<int>(x.size()));
+        QVector<float> w = window(win, static_cast<int>(x.size()));
+        for (int i = 0; i < w.count(); i++) {
+            x[i] *= w.at(i);
         }
     }
 
@@ -103,3 +104,13 @@ void Fft::inverse(Array &x)
     // scale the numbers
     x /= x.size();
 }
+
+QVector<float> Fft::window(Window win, int size)
+{
+    std::function<double(int, int)> func = cWindows.value(win);
+    QVector<float> w(size);
+    for (int i = 0; i < size; i++) {
+        w[i] = float(func(i, size));
+    }
+    return w;
+}
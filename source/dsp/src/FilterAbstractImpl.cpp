@@ -15,11 +15,16 @@
     Lesser General Public License for more details.
 */
 
+#include <qglobal.h>
 #include "FilterAbstractImpl.h"
 
+/// Modulation intervals in samples, zero for the whole block.
+const int cModulationIntervals[FilterAbstractImpl::ModulationInterval_Count] = { 0, 64, 32, 16, 1 };
+
 FilterAbstractImpl::FilterAbstractImpl()
     : m_sampleRate(44100.0),
-      m_cutOffFrequency(1000.0)
+      m_cutOffFrequency(1000.0),
+      m_modulationInterval(cDefaultModulationInterval)
 {
 }
 
@@ -36,3 +41,35 @@ void FilterAbstractImpl::setCutOffFrequency(double f)
         update();
     }
 }
+
+void FilterAbstractImpl::processBlock(const float *pIn, float *pOut, int nFrames)
+{
+    for (int i = 0; i < nFrames; i++) {
+        pOut[i] = float(doFilter(pIn[i]));
+    }
+}
+
+void FilterAbstractImpl::processModulatedBlock(const float *pIn, const float *pCutOff, float *pOut, int nFrames, bool audioRate)
+{
+    int interval = cModulationIntervals[m_modulationInterval];
+    if (!audioRate || interval == 0) {
+        // Cut-off not changing within the block is only sampled once
+        interval = nFrames;
+    }
+
+    for (int offset = 0; offset < nFrames; offset += interval) {
+        int n = qMin(interval, nFrames - offset);
+        setCutOffFrequency(pCutOff[offset + n - 1]);
+        processBlock(pIn + offset, pOut + offset, n);
+    }
+}
+
+void FilterAbstractImpl::setModulationInterval(int interval)
+{
+    m_modulationInterval = static_cast<ModulationInterval>(qBound(0, interval, ModulationInterval_Count - 1));
+}
+
+QStringList FilterAbstractImpl::modulationIntervalNames()
+{
+    return QStringList() << "Block" << "64 samples" << "32 samples" << "16 samples" << "Every sample";
+}
@@ -0,0 +1,223 @@
+/*
+                          qmusic
+
+    Copyright (C) 2015 Arthur Benilov,
+    arthur.benilov@gmail.com
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This software is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    Lesser General Public License for more details.
+*/
+#include "NoiseGenerator.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   define QMUSIC_DSP_SSE2
+#   include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#   define QMUSIC_DSP_NEON
+#   include <arm_neon.h>
+#endif
+
+/*
+ * Random numbers are converted to floats by placing their 23 upper
+ * bits into the mantissa of a number in [2, 4), then offsetting it
+ * to [-1, 1).
+ */
+const quint32 cExponentTwo(0x40000000);
+const float cOffset(3.0f);
+
+/// Brown noise integrator leak and gain.
+const float cBrownLeak(1.0f / 1.02f);
+const float cBrownGain(3.5f);
+
+/// Pink noise output gain.
+const float cPinkGain(0.11f);
+
+namespace {
+
+/// SplitMix64 step, used to spread the seed over the states.
+quint64 splitMix(quint64 &x)
+{
+    quint64 z = (x += Q_UINT64_C(0x9E3779B97F4A7C15));
+    z = (z ^ (z >> 30)) * Q_UINT64_C(0xBF58476D1CE4E5B9);
+    z = (z ^ (z >> 27)) * Q_UINT64_C(0x94D049BB133111EB);
+    return z ^ (z >> 31);
+}
+
+} // namespace
+
+NoiseGenerator::NoiseGenerator(quint64 seed)
+    : m_color(Color_White)
+{
+    setSeed(seed);
+}
+
+void NoiseGenerator::setSeed(quint64 seed)
+{
+    quint64 x = seed;
+    for (int i = 0; i < 4 * cLanes; i += 2) {
+        quint64 r = splitMix(x);
+        m_state[i] = quint32(r);
+        m_state[i + 1] = quint32(r >> 32);
+    }
+
+    // xorshift state must not be all zeros
+    for (int lane = 0; lane < cLanes; ++lane) {
+        if ((m_state[lane] | m_state[cLanes + lane] | m_state[2 * cLanes + lane] | m_state[3 * cLanes + lane]) == 0) {
+            m_state[lane] = 1;
+        }
+    }
+
+    m_pendingIndex = cLanes;
+
+    for (int i = 0; i < 7; ++i) {
+        m_pink[i] = 0.0f;
+    }
+    m_brown = 0.0f;
+}
+
+void NoiseGenerator::generate(float *pOut, int nFrames)
+{
+    Q_ASSERT(pOut != nullptr);
+
+    white(pOut, nFrames);
+
+    switch (m_color) {
+    case Color_Pink: {
+        float b0 = m_pink[0];
+        float b1 = m_pink[1];
+        float b2 = m_pink[2];
+        float b3 = m_pink[3];
+        float b4 = m_pink[4];
+        float b5 = m_pink[5];
+        float b6 = m_pink[6];
+        for (int i = 0; i < nFrames; ++i) {
+            const float w = pOut[i];
+            b0 = 0.99886f * b0 + w * 0.0555179f;
+            b1 = 0.99332f * b1 + w * 0.0750759f;
+            b2 = 0.96900f * b2 + w * 0.1538520f;
+            b3 = 0.86650f * b3 + w * 0.3104856f;
+            b4 = 0.55000f * b4 + w * 0.5329522f;
+            b5 = -0.7616f * b5 - w * 0.0168980f;
+            pOut[i] = (b0 + b1 + b2 + b3 + b4 + b5 + b6 + w * 0.5362f) * cPinkGain;
+            b6 = w * 0.115926f;
+        }
+        m_pink[0] = b0;
+        m_pink[1] = b1;
+        m_pink[2] = b2;
+        m_pink[3] = b3;
+        m_pink[4] = b4;
+        m_pink[5] = b5;
+        m_pink[6] = b6;
+        break;
+    }
+    case Color_Brown: {
+        float b = m_brown;
+        for (int i = 0; i < nFrames; ++i) {
+            b = (b + 0.02f * pOut[i]) * cBrownLeak;
+            pOut[i] = b * cBrownGain;
+        }
+        m_brown = b;
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+void NoiseGenerator::white(float *pOut, int nFrames)
+{
+    // Samples left over from the previous call come first
+    while (m_pendingIndex < cLanes && nFrames > 0) {
+        *pOut++ = m_pending[m_pendingIndex++];
+        --nFrames;
+    }
+
+    while (nFrames >= cLanes) {
+        step(pOut);
+        pOut += cLanes;
+        nFrames -= cLanes;
+    }
+
+    if (nFrames > 0) {
+        step(m_pending);
+        for (m_pendingIndex = 0; m_pendingIndex < nFrames; ++m_pendingIndex) {
+            pOut[m_pendingIndex] = m_pending[m_pendingIndex];
+        }
+    }
+}
+
+#if defined(QMUSIC_DSP_SSE2)
+
+void NoiseGenerator::step(float *pOut)
+{
+    __m128i *pState = reinterpret_cast<__m128i*>(m_state);
+    __m128i x = _mm_loadu_si128(pState);
+    __m128i w = _mm_loadu_si128(pState + 3);
+
+    __m128i t = _mm_xor_si128(x, _mm_slli_epi32(x, 11));
+    t = _mm_xor_si128(t, _mm_srli_epi32(t, 8));
+    __m128i r = _mm_xor_si128(_mm_xor_si128(w, _mm_srli_epi32(w, 19)), t);
+
+    _mm_storeu_si128(pState, _mm_loadu_si128(pState + 1));
+    _mm_storeu_si128(pState + 1, _mm_loadu_si128(pState + 2));
+    _mm_storeu_si128(pState + 2, w);
+    _mm_storeu_si128(pState + 3, r);
+
+    __m128i bits = _mm_or_si128(_mm_srli_epi32(r, 9), _mm_set1_epi32(cExponentTwo));
+    _mm_storeu_ps(pOut, _mm_sub_ps(_mm_castsi128_ps(bits), _mm_set1_ps(cOffset)));
+}
+
+#elif defined(QMUSIC_DSP_NEON)
+
+void NoiseGenerator::step(float *pOut)
+{
+    uint32x4_t x = vld1q_u32(m_state);
+    uint32x4_t w = vld1q_u32(m_state + 3 * cLanes);
+
+    uint32x4_t t = veorq_u32(x, vshlq_n_u32(x, 11));
+    t = veorq_u32(t, vshrq_n_u32(t, 8));
+    uint32x4_t r = veorq_u32(veorq_u32(w, vshrq_n_u32(w, 19)), t);
+
+    vst1q_u32(m_state, vld1q_u32(m_state + cLanes));
+    vst1q_u32(m_state + cLanes, vld1q_u32(m_state + 2 * cLanes));
+    vst1q_u32(m_state + 2 * cLanes, w);
+    vst1q_u32(m_state + 3 * cLanes, r);
+
+    uint32x4_t bits = vorrq_u32(vshrq_n_u32(r, 9), vdupq_n_u32(cExponentTwo));
+    vst1q_f32(pOut, vsubq_f32(vreinterpretq_f32_u32(bits), vdupq_n_f32(cOffset)));
+}
+
+#else
+
+void NoiseGenerator::step(float *pOut)
+{
+    for (int lane = 0; lane < cLanes; ++lane) {
+        quint32 &x = m_state[lane];
+        quint32 &y = m_state[cLanes + lane];
+        quint32 &z = m_state[2 * cLanes + lane];
+        quint32 &w = m_state[3 * cLanes + lane];
+
+        quint32 t = x ^ (x << 11);
+        t ^= t >> 8;
+        x = y;
+        y = z;
+        z = w;
+        w = w ^ (w >> 19) ^ t;
+
+        union {
+            quint32 i;
+            float f;
+        } bits;
+        bits.i = (w >> 9) | cExponentTwo;
+        pOut[lane] = bits.f - cOffset;
+    }
+}
+
+#endif
@@ -0,0 +1,350 @@
+/*
+                          qmusic
+
+    Copyright (C) 2015 Arthur Benilov,
+    arthur.benilov@gmail.com
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This software is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    Lesser General Public License for more details.
+*/
+
+#include <algorithm>
+#include <qmath.h>
+#include "RealFft.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   define QMUSIC_DSP_SSE2
+#   include <emmintrin.h>
+#endif
+
+/*
+ * Radix-4 passes twiddles layout.
+ *
+ * A pass merges the sub-transforms of span s into the ones of span 4s,
+ * which is equivalent to two radix-2 stages of lengths 2s and 4s.
+ * For every pair of butterflies (k, k + 1) the table keeps 16 floats:
+ *   (w2r, w2r, w2r', w2r'), (-w2i, w2i, -w2i', w2i'),
+ *   (w1r, w1r, w1r', w1r'), (-w1i, w1i, -w1i', w1i'),
+ * where w2 = W(2s)^k and w1 = W(4s)^k, so that a complex multiplication
+ * of two interleaved values is x * wr + swap(x) * wi.
+ */
+const int cPairStride(16);
+
+namespace {
+
+/// Complex multiplication by the twiddle k of a table block.
+inline void twiddle(const float *pW, int k, float &re, float &im)
+{
+    int o = (k >> 1) * cPairStride + (k & 1) * 2;
+    float wr = pW[o];
+    float wi = pW[o + 5];
+    float r = re * wr - im * wi;
+    im = re * wi + im * wr;
+    re = r;
+}
+
+} // namespace
+
+RealFft::RealFft(int size)
+    : m_size(size),
+      m_half(size / 2)
+{
+    Q_ASSERT(size >= 4);
+    Q_ASSERT((size & (size - 1)) == 0);
+
+    int nBits = 0;
+    while ((1 << nBits) < m_half) {
+        nBits++;
+    }
+
+    m_bitReverse.resize(m_half);
+    for (int i = 0; i < m_half; i++) {
+        int r = 0;
+        for (int b = 0; b < nBits; b++) {
+            r |= ((i >> b) & 1) << (nBits - 1 - b);
+        }
+        m_bitReverse[i] = r;
+    }
+
+    m_forwardTwiddles = makeTwiddles(-1.0);
+    m_inverseTwiddles = makeTwiddles(1.0);
+
+    // exp(-2*pi*i*k/N) for the split step
+    m_splitTwiddles.resize(m_half + 2);
+    for (int k = 0; k <= m_half / 2; k++) {
+        double phi = 2.0 * M_PI * k / m_size;
+        m_splitTwiddles[2 * k] = float(cos(phi));
+        m_splitTwiddles[2 * k + 1] = float(sin(phi));
+    }
+}
+
+void RealFft::forward(const float *pIn, float *pOut) const
+{
+    Q_ASSERT(pIn != nullptr);
+    Q_ASSERT(pOut != nullptr);
+
+    // Even samples as real and odd samples as imaginary parts
+    permute(pIn, pOut);
+    complexTransform(pOut, false);
+
+    // Split: X[k] = E[k] + W^k * O[k], where
+    // E[k] = (Z[k] + conj(Z[M-k])) / 2 and O[k] = (Z[k] - conj(Z[M-k])) / 2i
+    float re0 = pOut[0];
+    float im0 = pOut[1];
+    pOut[0] = re0 + im0;
+    pOut[1] = 0.0f;
+    pOut[2 * m_half] = re0 - im0;
+    pOut[2 * m_half + 1] = 0.0f;
+
+    const float *pW = m_splitTwiddles.constData();
+    for (int k = 1; k <= m_half / 2; k++) {
+        int j = m_half - k;
+        float zkr = pOut[2 * k];
+        float zki = pOut[2 * k + 1];
+        float zjr = pOut[2 * j];
+        float zji = pOut[2 * j + 1];
+
+        float er = 0.5f * (zkr + zjr);
+        float ei = 0.5f * (zki - zji);
+        float or_ = 0.5f * (zki + zji);
+        float oi = -0.5f * (zkr - zjr);
+
+        // W^k = cos - i sin
+        float c = pW[2 * k];
+        float s = pW[2 * k + 1];
+        float tr = or_ * c + oi * s;
+        float ti = oi * c - or_ * s;
+
+        pOut[2 * k] = er + tr;
+        pOut[2 * k + 1] = ei + ti;
+        // X[M-k] = conj(E[k]) - conj(W^k * O[k])
+        pOut[2 * j] = er - tr;
+        pOut[2 * j + 1] = ti - ei;
+    }
+}
+
+void RealFft::inverse(float *pIn, float *pOut) const
+{
+    Q_ASSERT(pIn != nullptr);
+    Q_ASSERT(pOut != nullptr);
+
+    // Merge: Z[k] = E[k] + i * O[k], where
+    // E[k] = (X[k] + conj(X[M-k])) / 2 and O[k] = (X[k] - conj(X[M-k])) * W^-k / 2.
+    // The 1/M normalization is applied here as well.
+    float scale = 1.0f / m_half;
+    float x0 = pIn[0];
+    float xm = pIn[2 * m_half];
+    pIn[0] = 0.5f * scale * (x0 + xm);
+    pIn[1] = 0.5f * scale * (x0 - xm);
+
+    const float *pW = m_splitTwiddles.constData();
+    for (int k = 1; k <= m_half / 2; k++) {
+        int j = m_half - k;
+        float xkr = pIn[2 * k];
+        float xki = pIn[2 * k + 1];
+        float xjr = pIn[2 * j];
+        float xji = pIn[2 * j + 1];
+
+        float h = 0.5f * scale;
+        float er = h * (xkr + xjr);
+        float ei = h * (xki - xji);
+        float dr = h * (xkr - xjr);
+        float di = h * (xki + xji);
+
+        // W^-k = cos + i sin
+        float c = pW[2 * k];
+        float s = pW[2 * k + 1];
+        float or_ = dr * c - di * s;
+        float oi = dr * s + di * c;
+
+        pIn[2 * k] = er - oi;
+        pIn[2 * k + 1] = ei + or_;
+        // Z[M-k] = conj(E[k]) + i * conj(O[k])
+        pIn[2 * j] = er + oi;
+        pIn[2 * j + 1] = or_ - ei;
+    }
+
+    permute(pIn, pOut);
+    complexTransform(pOut, true);
+}
+
+void RealFft::permute(const float *pSrc, float *pDst) const
+{
+    const int *pRev = m_bitReverse.constData();
+
+    if (pSrc == pDst) {
+        for (int i = 0; i < m_half; i++) {
+            int r = pRev[i];
+            if (r > i) {
+                std::swap(pDst[2 * i], pDst[2 * r]);
+                std::swap(pDst[2 * i + 1], pDst[2 * r + 1]);
+            }
+        }
+    } else {
+        for (int i = 0; i < m_half; i++) {
+            int r = pRev[i];
+            pDst[2 * r] = pSrc[2 * i];
+            pDst[2 * r + 1] = pSrc[2 * i + 1];
+        }
+    }
+}
+
+void RealFft::complexTransform(float *pData, bool inverse) const
+{
+    const int n = m_half;
+    const float *pW = inverse ? m_inverseTwiddles.constData() : m_forwardTwiddles.constData();
+
+    int span = 1;
+
+    // Odd number of stages: start with a radix-2 pass.
+    if ((n & 0x55555555) == 0) {
+        for (int i = 0; i < 2 * n; i += 4) {
+            float ar = pData[i];
+            float ai = pData[i + 1];
+            float br = pData[i + 2];
+            float bi = pData[i + 3];
+            pData[i] = ar + br;
+            pData[i + 1] = ai + bi;
+            pData[i + 2] = ar - br;
+            pData[i + 3] = ai - bi;
+        }
+        span = 2;
+    } else if (n >= 4) {
+        // First radix-4 pass has unit twiddles.
+        for (int i = 0; i < 2 * n; i += 8) {
+            float *p = pData + i;
+            float a1r = p[0] + p[2];
+            float a1i = p[1] + p[3];
+            float b1r = p[0] - p[2];
+            float b1i = p[1] - p[3];
+            float c1r = p[4] + p[6];
+            float c1i = p[5] + p[7];
+            float d1r = p[4] - p[6];
+            float d1i = p[5] - p[7];
+            // Multiply by -i (direct) or +i (inverse)
+            float dr = inverse ? -d1i : d1i;
+            float di = inverse ? d1r : -d1r;
+            p[0] = a1r + c1r;
+            p[1] = a1i + c1i;
+            p[4] = a1r - c1r;
+            p[5] = a1i - c1i;
+            p[2] = b1r + dr;
+            p[3] = b1i + di;
+            p[6] = b1r - dr;
+            p[7] = b1i - di;
+        }
+        span = 4;
+    }
+
+    for (; span < n; span *= 4) {
+        const int s2 = 2 * span;  // span in floats
+
+#ifdef QMUSIC_DSP_SSE2
+        // Multiply by -i (direct) or +i (inverse) after swapping real and imaginary parts
+        const __m128 rotSign = inverse ? _mm_set_ps(0.0f, -0.0f, 0.0f, -0.0f)
+                                       : _mm_set_ps(-0.0f, 0.0f, -0.0f, 0.0f);
+        for (int i = 0; i < 2 * n; i += 4 * s2) {
+            const float *pT = pW;
+            for (int k = 0; k < s2; k += 4, pT += cPairStride) {
+                float *p = pData + i + k;
+                __m128 a = _mm_loadu_ps(p);
+                __m128 b = _mm_loadu_ps(p + s2);
+                __m128 c = _mm_loadu_ps(p + 2 * s2);
+                __m128 d = _mm_loadu_ps(p + 3 * s2);
+
+                __m128 wr2 = _mm_loadu_ps(pT);
+                __m128 wi2 = _mm_loadu_ps(pT + 4);
+                __m128 wr1 = _mm_loadu_ps(pT + 8);
+                __m128 wi1 = _mm_loadu_ps(pT + 12);
+
+                // Stage of length 2s
+                b = _mm_add_ps(_mm_mul_ps(b, wr2), _mm_mul_ps(_mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 3, 0, 1)), wi2));
+                d = _mm_add_ps(_mm_mul_ps(d, wr2), _mm_mul_ps(_mm_shuffle_ps(d, d, _MM_SHUFFLE(2, 3, 0, 1)), wi2));
+                __m128 a1 = _mm_add_ps(a, b);
+                __m128 b1 = _mm_sub_ps(a, b);
+                __m128 c1 = _mm_add_ps(c, d);
+                __m128 d1 = _mm_sub_ps(c, d);
+
+                // Stage of length 4s
+                c1 = _mm_add_ps(_mm_mul_ps(c1, wr1), _mm_mul_ps(_mm_shuffle_ps(c1, c1, _MM_SHUFFLE(2, 3, 0, 1)), wi1));
+                d1 = _mm_add_ps(_mm_mul_ps(d1, wr1), _mm_mul_ps(_mm_shuffle_ps(d1, d1, _MM_SHUFFLE(2, 3, 0, 1)), wi1));
+                d1 = _mm_xor_ps(_mm_shuffle_ps(d1, d1, _MM_SHUFFLE(2, 3, 0, 1)), rotSign);
+
+                _mm_storeu_ps(p, _mm_add_ps(a1, c1));
+                _mm_storeu_ps(p + 2 * s2, _mm_sub_ps(a1, c1));
+                _mm_storeu_ps(p + s2, _mm_add_ps(b1, d1));
+                _mm_storeu_ps(p + 3 * s2, _mm_sub_ps(b1, d1));
+            }
+        }
+#else
+        for (int i = 0; i < 2 * n; i += 4 * s2) {
+            for (int k = 0; k < span; k++) {
+                float *p = pData + i + 2 * k;
+                float ar = p[0], ai = p[1];
+                float br = p[s2], bi = p[s2 + 1];
+                float cr = p[2 * s2], ci = p[2 * s2 + 1];
+                float dr = p[3 * s2], di = p[3 * s2 + 1];
+
+                // Stage of length 2s
+                twiddle(pW, k, br, bi);
+                twiddle(pW, k, dr, di);
+                float a1r = ar + br, a1i = ai + bi;
+                float b1r = ar - br, b1i = ai - bi;
+                float c1r = cr + dr, c1i = ci + di;
+                float d1r = cr - dr, d1i = ci - di;
+
+                // Stage of length 4s
+                twiddle(pW + 8, k, c1r, c1i);
+                twiddle(pW + 8, k, d1r, d1i);
+                float tr = inverse ? -d1i : d1i;
+                float ti = inverse ? d1r : -d1r;
+
+                p[0] = a1r + c1r;
+                p[1] = a1i + c1i;
+                p[2 * s2] = a1r - c1r;
+                p[2 * s2 + 1] = a1i - c1i;
+                p[s2] = b1r + tr;
+                p[s2 + 1] = b1i + ti;
+                p[3 * s2] = b1r - tr;
+                p[3 * s2 + 1] = b1i - ti;
+            }
+        }
+#endif // QMUSIC_DSP_SSE2
+
+        pW += span / 2 * cPairStride;
+    }
+}
+
+QVector<float> RealFft::makeTwiddles(double sign) const
+{
+    QVector<float> table;
+
+    int span = (m_half & 0x55555555) == 0 ? 2 : 4;
+    for (; span < m_half; span *= 4) {
+        for (int k = 0; k < span; k += 2) {
+            float block[cPairStride];
+            for (int j = 0; j < 2; j++) {
+                double phi2 = sign * 2.0 * M_PI * (k + j) / (2 * span);
+                double phi1 = sign * 2.0 * M_PI * (k + j) / (4 * span);
+                block[2 * j] = block[2 * j + 1] = float(cos(phi2));
+                block[4 + 2 * j] = float(-sin(phi2));
+                block[4 + 2 * j + 1] = float(sin(phi2));
+                block[8 + 2 * j] = block[8 + 2 * j + 1] = float(cos(phi1));
+                block[12 + 2 * j] = float(-sin(phi1));
+                block[12 + 2 * j + 1] = float(sin(phi1));
+            }
+            for (int j = 0; j < cPairStride; j++) {
+                table.append(block[j]);
+            }
+        }
+    }
+
+    return table;
+}
@@ -16,13 +16,18 @@
 */
 
 #include <qmath.h>
+#include "FastMath.h"
 #include "VAOnePoleFilter.h"
 
+/// Limit of the prewarped half angle, keeping it within (0, pi/2).
+const double cMinAngle(1.0e-6);
+
 VAOnePoleFilter::VAOnePoleFilter()
 {
     m_type = Type_LP;
 
     m_dAlpha = 1.0;
+    m_dTargetAlpha = 1.0;
     m_dBeta = 0.0;
     m_dZ1 = 0.0;
     m_dGamma = 1.0;
@@ -46,6 +51,8 @@ void VAOnePoleFilter::update()
 
 double VAOnePoleFilter::doFilter(double x)
 {
+    m_dAlpha = m_dTargetAlpha;
+
     double xn = x * m_dGamma + m_dFeedback + m_dEpsilon * getFeedbackOutput();
     double vn = (m_dA0 * xn - m_dZ1) * m_dAlpha;
     double lpf = vn + m_dZ1;
@@ -59,18 +66,63 @@ double VAOnePoleFilter::doFilter(double x)
     return hpf;
 }
 
+void VAOnePoleFilter::processBlock(const float *pIn, float *pOut, int nFrames)
+{
+    if (nFrames <= 0) {
+        return;
+    }
+
+    double alpha = m_dAlpha;
+    double dAlpha = (m_dTargetAlpha - m_dAlpha) / nFrames;
+    double z1 = m_dZ1;
+    double gamma = m_dGamma;
+    double a0 = m_dA0;
+    double offset = m_dFeedback + m_dEpsilon * getFeedbackOutput();
+    bool lowPass = m_type == Type_LP;
+
+    for (int i = 0; i < nFrames; i++) {
+        alpha += dAlpha;
+        double xn = pIn[i] * gamma + offset;
+        double vn = (a0 * xn - z1) * alpha;
+        double lpf = vn + z1;
+        z1 = vn + lpf;
+        pOut[i] = float(lowPass ? lpf : xn - lpf);
+    }
+
+    m_dAlpha = m_dTargetAlpha;
+    m_dZ1 = z1;
+}
+
+BiquadFilter::Coefficients VAOnePoleFilter::biquadCoefficients() const
+{
+    // H_lp(z) = alpha (1 + z^-1) / (1 + (2 alpha - 1) z^-1), H_hp = 1 - H_lp
+    double alpha = m_dTargetAlpha;
+    BiquadFilter::Coefficients c;
+    if (m_type == Type_LP) {
+        c.b0 = alpha;
+        c.b1 = alpha;
+    } else {
+        c.b0 = 1.0 - alpha;
+        c.b1 = alpha - 1.0;
+    }
+    c.b2 = 0.0;
+    c.a1 = 2.0 * alpha - 1.0;
+    c.a2 = 0.0;
+    return c;
+}
+
 void VAOnePoleFilter::resetFilter()
 {
+    m_dAlpha = m_dTargetAlpha;
     m_dZ1 = 0.0;
     m_dFeedback = 0.0;
 }
 
 void VAOnePoleFilter::updateFilter()
 {
-    double wd = 2 * M_PI * cutOffFrequency();
-    double T = 1.0 / sampleRate();
-    double wa = (2.0/T) * tan(wd * T/2);
-    double g = wa * T/2;
+    // g = wa * T / 2 with the prewarped frequency wa = (2 / T) tan(wd * T / 2)
+    double angle = M_PI * cutOffFrequency() / sampleRate();
+    double g = FastMath::tan(qBound(cMinAngle, angle, M_PI_2 - cMinAngle));
 
-    m_dAlpha = g / (1.0 + g);
+    m_dTargetAlpha = g / (1.0 + g);
 }
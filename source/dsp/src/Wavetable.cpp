@@ -0,0 +1,262 @@
+/*
+                          qmusic
+
+    Copyright (C) 2015 Arthur Benilov,
+    arthur.benilov@gmail.com
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This software is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    Lesser General Public License for more details.
+*/
+#include <qmath.h>
+#include "RealFft.h"
+#include "Wavetable.h"
+
+/// Fixed point phase bits below the table index.
+const int cFractionBits(32 - 11);
+const quint32 cFractionMask((1u << cFractionBits) - 1);
+const float cFractionScale(1.0f / float(1u << cFractionBits));
+
+static_assert(Wavetable::TableSize == 1 << 11, "Table index must take the 11 upper phase bits");
+
+/// Highest harmonic kept by the level.
+inline int maxHarmonic(int level)
+{
+    return (Wavetable::TableSize / 2 - 1) >> level;
+}
+
+/// Magnitude of a phase increment: negative increments run at the same frequency.
+inline quint32 absIncrement(quint32 increment)
+{
+    const qint32 s = qint32(increment);
+    return quint32(s < 0 ? -qint64(s) : s);
+}
+
+Wavetable::Wavetable()
+    : m_tables(Levels * cStride, 0.0f)
+{
+}
+
+Wavetable::Wavetable(Shape shape)
+    : m_tables(Levels * cStride, 0.0f)
+{
+    setShape(shape);
+}
+
+void Wavetable::setShape(Shape shape)
+{
+    const int nHarmonics = maxHarmonic(0);
+    QVector<double> cosines(nHarmonics + 1, 0.0);
+    QVector<double> sines(nHarmonics + 1, 0.0);
+
+    switch (shape) {
+    case Shape_Sine:
+        sines[1] = 1.0;
+        break;
+    case Shape_Sawtooth:
+        for (int k = 1; k <= nHarmonics; ++k) {
+            sines[k] = -2.0 / (M_PI * k);
+        }
+        break;
+    case Shape_Square:
+        for (int k = 1; k <= nHarmonics; k += 2) {
+            sines[k] = 4.0 / (M_PI * k);
+        }
+        break;
+    case Shape_Triangle:
+        for (int k = 1; k <= nHarmonics; k += 2) {
+            cosines[k] = 8.0 / (M_PI * M_PI * k * k);
+        }
+        break;
+    default:
+        Q_ASSERT(false);
+        break;
+    }
+
+    build(cosines, sines, false);
+}
+
+bool Wavetable::setWaveform(const float *pSamples, int nSamples)
+{
+    Q_ASSERT(pSamples != nullptr);
+    if (nSamples < 2) {
+        return false;
+    }
+
+    // Harmonics up to the cycle Nyquist frequency (excluded)
+    const int nHarmonics = qMin((nSamples - 1) / 2, maxHarmonic(0));
+
+    QVector<double> cosTable(nSamples);
+    QVector<double> sinTable(nSamples);
+    for (int n = 0; n < nSamples; ++n) {
+        cosTable[n] = cos(2.0 * M_PI * n / nSamples);
+        sinTable[n] = sin(2.0 * M_PI * n / nSamples);
+    }
+
+    QVector<double> cosines(nHarmonics + 1, 0.0);
+    QVector<double> sines(nHarmonics + 1, 0.0);
+
+    double dc = 0.0;
+    for (int n = 0; n < nSamples; ++n) {
+        dc += pSamples[n];
+    }
+    cosines[0] = dc / nSamples;
+
+    for (int k = 1; k <= nHarmonics; ++k) {
+        double a = 0.0;
+        double b = 0.0;
+        int j = 0;  // k * n modulo nSamples
+        for (int n = 0; n < nSamples; ++n) {
+            a += pSamples[n] * cosTable[j];
+            b += pSamples[n] * sinTable[j];
+            j += k;
+            if (j >= nSamples) {
+                j -= nSamples;
+            }
+        }
+        cosines[k] = 2.0 * a / nSamples;
+        sines[k] = 2.0 * b / nSamples;
+    }
+
+    build(cosines, sines, true);
+    return true;
+}
+
+void Wavetable::render(float *pOut, int nFrames, quint32 &phase, quint32 increment,
+                       Interpolation interpolation) const
+{
+    Q_ASSERT(pOut != nullptr);
+
+    const float *pTable = table(level(absIncrement(increment)));
+    quint32 phases[cChunk];
+
+    while (nFrames > 0) {
+        const int n = qMin(nFrames, cChunk);
+        const quint32 p = phase;
+        for (int i = 0; i < n; ++i) {
+            phases[i] = p + quint32(i) * increment;
+        }
+        phase = p + quint32(n) * increment;
+
+        lookup(pTable, phases, pOut, n, interpolation);
+        pOut += n;
+        nFrames -= n;
+    }
+}
+
+void Wavetable::render(float *pOut, int nFrames, quint32 &phase, const quint32 *pIncrements,
+                       Interpolation interpolation) const
+{
+    Q_ASSERT(pOut != nullptr);
+    Q_ASSERT(pIncrements != nullptr);
+
+    quint32 phases[cChunk];
+
+    while (nFrames > 0) {
+        const int n = qMin(nFrames, cChunk);
+        quint32 p = phase;
+        quint32 maxIncrement = 0;
+        for (int i = 0; i < n; ++i) {
+            phases[i] = p;
+            p += pIncrements[i];
+            maxIncrement = qMax(maxIncrement, absIncrement(pIncrements[i]));
+        }
+        phase = p;
+
+        lookup(table(level(maxIncrement)), phases, pOut, n, interpolation);
+        pOut += n;
+        pIncrements += n;
+        nFrames -= n;
+    }
+}
+
+void Wavetable::build(const QVector<double> &cosines, const QVector<double> &sines, bool normalize)
+{
+    Q_ASSERT(cosines.size() == sines.size());
+    Q_ASSERT(!cosines.isEmpty());
+
+    const int nHarmonics = cosines.size() - 1;
+    const float scale = TableSize / 2;
+
+    RealFft fft(TableSize);
+    QVector<float> spectrum(fft.spectrumSize());
+    float peak = 0.0f;
+
+    for (int l = 0; l < Levels; ++l) {
+        spectrum.fill(0.0f);
+        spectrum[0] = cosines[0] * TableSize;
+        const int n = qMin(nHarmonics, maxHarmonic(l));
+        for (int k = 1; k <= n; ++k) {
+            spectrum[2 * k] = cosines[k] * scale;
+            spectrum[2 * k + 1] = -sines[k] * scale;
+        }
+
+        float *pTable = m_tables.data() + l * cStride + 1;
+        fft.inverse(spectrum.data(), pTable);
+
+        for (int i = 0; i < TableSize; ++i) {
+            peak = qMax(peak, qAbs(pTable[i]));
+        }
+    }
+
+    // Keep the levels at the same gain, so that the loudness
+    // does not jump when the frequency crosses an octave.
+    const float gain = normalize && peak > 1.0f ? 1.0f / peak : 1.0f;
+
+    for (int l = 0; l < Levels; ++l) {
+        float *pTable = m_tables.data() + l * cStride + 1;
+        for (int i = 0; i < TableSize; ++i) {
+            pTable[i] *= gain;
+        }
+        // Wrap around samples for the interpolation
+        pTable[-1] = pTable[TableSize - 1];
+        pTable[TableSize] = pTable[0];
+        pTable[TableSize + 1] = pTable[1];
+    }
+}
+
+int Wavetable::level(quint32 increment) const
+{
+    // Highest harmonic must stay below Nyquist (half a cycle per sample)
+    const quint64 nyquist = quint64(1) << 31;
+    for (int l = 0; l < Levels - 1; ++l) {
+        if (quint64(maxHarmonic(l)) * increment <= nyquist) {
+            return l;
+        }
+    }
+    return Levels - 1;
+}
+
+void Wavetable::lookup(const float *pTable, const quint32 *pPhases, float *pOut, int nFrames,
+                       Interpolation interpolation)
+{
+    if (interpolation == Interpolation_Cubic) {
+        // 4-points Hermite (Catmull-Rom) interpolation
+        for (int i = 0; i < nFrames; ++i) {
+            const quint32 p = pPhases[i];
+            const float *pX = pTable + (p >> cFractionBits);
+            const float f = (p & cFractionMask) * cFractionScale;
+            const float xm1 = pX[-1];
+            const float x0 = pX[0];
+            const float x1 = pX[1];
+            const float x2 = pX[2];
+            const float c1 = 0.5f * (x1 - xm1);
+            const float c2 = xm1 - 2.5f * x0 + 2.0f * x1 - 0.5f * x2;
+            const float c3 = 0.5f * (x2 - xm1) + 1.5f * (x0 - x1);
+            pOut[i] = ((c3 * f + c2) * f + c1) * f + x0;
+        }
+    } else {
+        for (int i = 0; i < nFrames; ++i) {
+            const quint32 p = pPhases[i];
+            const float *pX = pTable + (p >> cFractionBits);
+            const float f = (p & cFractionMask) * cFractionScale;
+            pOut[i] = pX[0] + f * (pX[1] - pX[0]);
+        }
+    }
+}
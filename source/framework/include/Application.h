@@ -27,6 +27,7 @@ class Logger;
 class AudioDevicesManager;
 class AudioUnitsManager;
 class IEventRouter;
+class RenderThreadPool;
 
 /**
  * @brief The main application class.
@@ -64,6 +65,7 @@ public:
     AudioDevicesManager* audioDevicesManager() const { return m_pAudioDevicesManager; }
     AudioUnitsManager* audioUnitsManager() const { return m_pAudioUnitsManager; }
     IEventRouter* eventRouter() const { return m_pEventRouter; }
+    RenderThreadPool* renderThreadPool() const { return m_pRenderThreadPool; }
 
     void setMainWindow(QMainWindow *pMainWindow);
     QMainWindow* mainWindow() const { return m_pMainWindow; }
@@ -123,6 +125,9 @@ private:
 
     /// Events router.
     IEventRouter *m_pEventRouter;
+
+    /// Threads used for parallel rendering.
+    RenderThreadPool *m_pRenderThreadPool;
 };
 
 QMUSIC_FRAMEWORK_API void logDebug0(const QString &text);
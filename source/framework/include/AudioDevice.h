@@ -18,8 +18,10 @@
 #ifndef AUDIODEVICE_H
 #define AUDIODEVICE_H
 
+#include <atomic>
 #include <QList>
 #include "FrameworkApi.h"
+#include "AudioDeviceStats.h"
 
 /**
  * @brief Audio device listener interface.
@@ -49,6 +51,13 @@ public:
                               float *pOutputBuffer,
                               long nSamples) = 0;
 
+    /**
+     * Returns additional latency introduced by this listener, e.g.
+     * due to intermediate buffering of the audio data.
+     * @return Latency in seconds.
+     */
+    virtual double latency() const { return 0.0; }
+
     virtual ~IAudioDeviceListener() {}
 };
 
@@ -159,6 +168,58 @@ public:
                       float *pOutputBuffer,
                       long nSamples);
 
+    /**
+     * Returns interleaved input buffer of the callback being processed.
+     * This is only valid within processAudio() call, for the listeners
+     * rendering synchronously in the callback, so that the input samples
+     * can be used without extra buffering.
+     * @return Pointer to the input samples or nullptr if none.
+     */
+    const float* callbackInput() const { return m_pCallbackInput; }
+
+    /**
+     * Returns number of frames in the current callback buffer.
+     * @return
+     */
+    long callbackFrames() const { return m_callbackFrames; }
+
+    /**
+     * Returns sequential number of the current callback.
+     * This allows telling the consecutive callbacks apart.
+     * @return
+     */
+    quint64 callbackSequence() const { return m_callbackSequence; }
+
+    /**
+     * Update measured stream latencies.
+     * This is called from the audio callback with the values derived from
+     * the stream timing information.
+     * @param inputLatency Time elapsed since the input buffer has been captured, in seconds.
+     * @param outputLatency Time until the output buffer reaches the DAC, in seconds.
+     */
+    void updateLatency(double inputLatency, double outputLatency);
+
+    /**
+     * Returns measured input latency of the open stream.
+     * @return Input latency in seconds.
+     */
+    double inputLatency() const { return m_inputLatency.load(std::memory_order_relaxed); }
+
+    /**
+     * Returns measured output latency of the open stream,
+     * including the latency added by the listeners during the last callback.
+     * @return Output latency in seconds.
+     */
+    double outputLatency() const;
+
+    /**
+     * Returns the stream statistics, collected since the stream start.
+     * Listeners may record their own events (like underruns) there.
+     * @return Pointer to the statistics.
+     */
+    AudioDeviceStats* stats() { return &m_stats; }
+    const AudioDeviceStats* stats() const { return &m_stats; }
+
 private:
 
     /**
@@ -171,6 +232,16 @@ private:
     PaStream *m_pStream;                ///< Portaudio stream.
     struct Info m_openDeviceInfo;       ///< Info of currently open device.
     QList<IAudioDeviceListener*> m_listeners;   ///< Registered listeners.
+
+    std::atomic<double> m_inputLatency;     ///< Measured input latency, in seconds.
+    std::atomic<double> m_outputLatency;    ///< Measured output latency, in seconds.
+    std::atomic<double> m_listenersLatency; ///< Latency added by the listeners, in seconds.
+
+    AudioDeviceStats m_stats;   ///< Stream telemetry.
+
+    const float *m_pCallbackInput;  ///< Input of the callback being processed.
+    long m_callbackFrames;          ///< Size of the callback being processed.
+    quint64 m_callbackSequence;     ///< Number of the callback being processed.
 };
 
 #endif // AUDIODEVICE_H
@@ -0,0 +1,165 @@
+/*
+                          qmusic
+
+    Copyright (C) 2015 Arthur Benilov,
+    arthur.benilov@gmail.com
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This software is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    Lesser General Public License for more details.
+*/
+
+#ifndef AUDIODEVICESTATS_H
+#define AUDIODEVICESTATS_H
+
+#include <atomic>
+#include <QtGlobal>
+#include "FrameworkApi.h"
+
+/**
+ * @brief Audio stream telemetry.
+ *
+ * The statistics are recorded from the audio callback and read from
+ * the GUI thread. Every counter has a single writer (the audio callback,
+ * or the rendering thread for the render time), so that writes are
+ * plain relaxed atomic stores: recording never locks nor allocates.
+ *
+ * Times are collected into logarithmic histograms (eight bins per octave
+ * starting at 1 us), that give the percentiles with about 10% precision.
+ */
+class QMUSIC_FRAMEWORK_API AudioDeviceStats
+{
+public:
+
+    /// Stream status flags, in the order of PortAudio callback flags bits.
+    enum Flag {
+        Flag_InputUnderflow,
+        Flag_InputOverflow,
+        Flag_OutputUnderflow,
+        Flag_OutputOverflow,
+        Flag_PrimingOutput,
+        Flag_Count
+    };
+
+    /// Statistics of a time distribution, microseconds.
+    struct Summary {
+        quint64 count;
+        double min;
+        double avg;
+        double max;
+        double p99;
+    };
+
+    /// Statistics collected since the last reset.
+    struct Snapshot {
+        quint64 callbacks;          ///< Number of callbacks.
+        quint64 frames;             ///< Number of frames processed by callbacks.
+        double callbackSeconds;     ///< Total time spent in callbacks.
+        Summary duration;           ///< Callback duration.
+        Summary jitter;             ///< Deviation of callback interval from the buffer period.
+        quint64 flags[Flag_Count];  ///< Number of callbacks the flags were raised in.
+        quint64 underruns;          ///< Number of callbacks that ran out of rendered samples.
+        quint64 underrunFrames;     ///< Number of frames filled with silence.
+        quint64 renderFrames;       ///< Frames rendered outside of the callback.
+        double renderSeconds;       ///< Time spent rendering outside of the callback.
+
+        /// Total number of glitches: underflows, overflows and underruns.
+        quint64 xruns() const
+        {
+            return flags[Flag_InputOverflow] + flags[Flag_OutputUnderflow] + underruns;
+        }
+    };
+
+    AudioDeviceStats();
+
+    /**
+     * Clear the statistics.
+     * This must not be called while the stream is running.
+     * @param sampleRate Stream sample rate.
+     */
+    void reset(double sampleRate);
+
+    /**
+     * Record an audio callback (called from the callback only).
+     * @param startTicks Callback start time, ProfilingClock ticks.
+     * @param endTicks Callback end time, ProfilingClock ticks.
+     * @param nFrames Number of frames in the buffer.
+     * @param statusFlags PortAudio status flags.
+     */
+    void recordCallback(quint64 startTicks, quint64 endTicks, long nFrames, unsigned long statusFlags);
+
+    /**
+     * Record a buffer underrun: the callback had no samples ready (called from the callback only).
+     * @param nFrames Number of missing frames.
+     */
+    void recordUnderrun(long nFrames);
+
+    /**
+     * Record rendering done outside of the callback (called from a single rendering thread).
+     * @param ticks Rendering time, ProfilingClock ticks.
+     * @param nFrames Number of frames rendered.
+     */
+    void recordRender(quint64 ticks, long nFrames);
+
+    /**
+     * Returns current statistics (may be called from any thread).
+     * @return
+     */
+    Snapshot snapshot() const;
+
+private:
+
+    Q_DISABLE_COPY(AudioDeviceStats)
+
+    /**
+     * @brief Histogram of times, with a single writer.
+     */
+    class Histogram
+    {
+    public:
+        static const int cBinsPerOctave = 8;
+        static const int cBins = 20 * cBinsPerOctave;   ///< Up to about 1 s.
+
+        void reset();
+        void record(double us);
+        Summary summary() const;
+
+    private:
+        std::atomic<quint32> m_bins[cBins];
+        std::atomic<quint64> m_count;
+        std::atomic<double> m_sum;
+        std::atomic<double> m_min;
+        std::atomic<double> m_max;
+    };
+
+    /// Increment a counter that has a single writer.
+    template <typename T>
+    static inline void add(std::atomic<T> &counter, T value)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    double m_timeStep;          ///< Sample period, seconds.
+    double m_secondsPerTick;    ///< ProfilingClock tick, seconds.
+    quint64 m_lastStartTicks;   ///< Previous callback start, written by the callback only.
+    long m_lastFrames;          ///< Previous callback size, written by the callback only.
+
+    std::atomic<quint64> m_callbacks;
+    std::atomic<quint64> m_frames;
+    std::atomic<quint64> m_callbackTicks;
+    Histogram m_duration;
+    Histogram m_jitter;
+    std::atomic<quint64> m_flags[Flag_Count];
+    std::atomic<quint64> m_underruns;
+    std::atomic<quint64> m_underrunFrames;
+    std::atomic<quint64> m_renderTicks;
+    std::atomic<quint64> m_renderFrames;
+};
+
+#endif // AUDIODEVICESTATS_H
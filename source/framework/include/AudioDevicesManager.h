@@ -24,6 +24,8 @@
 class AudioDevice;
 class MidiInputDevice;
 class MidiEventTranslator;
+class MidiMessage;
+class SignalChainEvent;
 
 /**
  * @brief Single point of access to the audio devices.
@@ -62,6 +64,41 @@ public:
      */
     bool isStarted() const { return m_started; }
 
+    /**
+     * Tells whether the input and output share the same duplex stream.
+     * In this case the input is delivered by the output device callback.
+     * @return true if a single device is used for both input and output.
+     */
+    bool isDuplex() const { return m_duplex; }
+
+    /**
+     * Translate a MIDI message into a signal chain event.
+     * @param msg MIDI message.
+     * @return Pointer to a new event (owned by the caller), or nullptr
+     *         if the message has no corresponding event.
+     */
+    static SignalChainEvent* createEvent(const MidiMessage &msg);
+
+    /**
+     * Tells whether the signal chain should be rendered directly
+     * in the audio output device callback rather than in a separate thread.
+     * @return true if callback rendering is enabled.
+     */
+    bool isCallbackRenderEnabled() const { return m_callbackRender; }
+
+    /**
+     * Enable or disable rendering in the audio callback.
+     * This value is reloaded from the settings each time the devices are started.
+     * @param enable true to render in the audio callback.
+     */
+    void setCallbackRenderEnabled(bool enable) { m_callbackRender = enable; }
+
+    /**
+     * Returns measured round-trip latency (from audio input to audio output).
+     * @return Latency in seconds, or zero if the devices are not started.
+     */
+    double roundTripLatency() const;
+
 public slots:
 
     /**
@@ -98,6 +135,12 @@ private:
 
     /// Audio devices started flag.
     bool m_started;
+
+    /// Single duplex device is used for input and output.
+    bool m_duplex;
+
+    /// Render signal chain in the audio callback.
+    bool m_callbackRender;
 };
 
 #endif // AUDIODEVICESMANAGER_H
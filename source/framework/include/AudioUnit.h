@@ -18,6 +18,7 @@
 #ifndef AUDIOUNIT_H
 #define AUDIOUNIT_H
 
+#include <atomic>
 #include <QMap>
 #include "FrameworkApi.h"
 #include "IEventRouter.h"
@@ -53,12 +54,18 @@ class QMUSIC_FRAMEWORK_API AudioUnit : public IAudioUnit
     friend class SignalChain;
 public:
 
+    /**
+     * @brief Accumulated processing time of the unit.
+     */
+    struct ProfilingCounters {
+        quint64 ticks;  ///< Processing time, in ProfilingClock ticks.
+        quint64 frames; ///< Number of frames processed (including skipped ones).
+    };
+
     AudioUnit(AudioUnitPlugin *pPlugin);
     ~AudioUnit();
 
     // IAudioUnit interface
-    void prepareUpdate() override final;
-    void update() override final;
     void start() override final;
     void stop() override final;
     bool isStarted() const override final { return m_started; }   
@@ -73,18 +80,11 @@ public:
     void handleEvent(SignalChainEvent *pEvent) override;
 
     /**
-     * Construct an update chain starting from this audio unit
-     * and moving backwards from its inputs to source units etc.
-     * The returned list of audio units can be directly updated in specified
-     * order without unsing recursive update mechanism.
-     * @return
-     */
-    QList<AudioUnit*> updateChain(const QList<AudioUnit*> chain = QList<AudioUnit*>());
-
-    /**
-     * Perform fast update without recursive update propagation.
+     * Perform block update without recursive update propagation.
+     * All the units this one depends on must be already updated.
+     * @param nFrames Number of samples to process, up to Port::MaxBlockSize.
      */
-    void fastUpdate();
+    void updateBlock(int nFrames);
 
     /**
      * Returns pointer to the audio unit plugin.
@@ -173,8 +173,73 @@ public:
      */
     virtual void process() = 0;
 
+    /**
+     * @brief Process a block of samples.
+     *
+     * Block processing takes the samples from the input ports buffers
+     * and writes the results into the output ports buffers.
+     * Default implementation falls back to calling process() for
+     * every sample of the block, so that audio units that do not
+     * implement block processing keep working unchanged.
+     * @param nFrames Number of samples in the block.
+     */
+    virtual void processBlock(int nFrames);
+
+    /**
+     * @brief Returns the audio unit tail length.
+     *
+     * Tail is the time, in seconds, the audio unit keeps producing
+     * output once its input has gone silent (e.g. reverberation or delay time).
+     * When input stays silent longer than the tail, the unit is put to sleep:
+     * its processing is skipped and silence is written to its outputs.
+     * Negative value (default) means the unit never sleeps, which is required
+     * for sources generating signal on their own.
+     * @return Tail length in seconds.
+     */
+    virtual float tailLength() const { return -1.0f; }
+
+    /**
+     * @brief Tells whether the input signal of this unit is silent.
+     * Default implementation checks all the input ports.
+     * Units having control inputs should only check their audio inputs.
+     * @return
+     */
+    virtual bool isInputSilent() const;
+
+    /**
+     * Tells whether this unit is sleeping on silent input.
+     * @return
+     */
+    bool isSleeping() const { return m_sleeping; }
+
+    /**
+     * Returns processing time counters of this unit.
+     * The counters are never reset, so the load is to be computed
+     * out of the difference of two snapshots.
+     * This method may be called from any thread.
+     * @return
+     */
+    ProfilingCounters profilingCounters() const;
+
+    /**
+     * @brief Returns the rate this unit is evaluated at.
+     * Units declaring all their outputs at constant or control rate
+     * are evaluated via a single process() call once per start or
+     * once per block, unless any of their inputs is at a higher rate.
+     * Units without outputs are always evaluated at audio rate.
+     * @return
+     */
+    Port::Rate processingRate() const;
+
 protected:
 
+    /**
+     * Request re-evaluation of the constant rate outputs on the next block.
+     * This is to be called when a unit changes its constant output value,
+     * e.g. on a property change. This method may be called from any thread.
+     */
+    void updateConstantOutputs() { m_updateConstants.store(true, std::memory_order_release); }
+
     /**
      * @brief Notify processing start.
      * This method is called upon audio unit start.
@@ -206,10 +271,25 @@ private:
      */
     void setSignalChain(ISignalChain *pSignalChain) { m_pSignalChain = pSignalChain; }
 
-#ifdef PROFILING
-    void profilingReset();
-    void profilingRegister(double processTimeUs);
-#endif
+    /**
+     * Update the silent input time and check whether the unit can sleep.
+     * @param nFrames Number of samples in the block.
+     * @return true if the processing of the block can be skipped.
+     */
+    bool updateSleeping(int nFrames);
+
+    /**
+     * Write silence to all outputs.
+     * @param nFrames Number of samples in the block.
+     */
+    void writeSilence(int nFrames);
+
+    /**
+     * Evaluate the unit once and fill its outputs with the values.
+     * @param rate Processing rate, either constant or control.
+     * @param nFrames Number of samples in the block.
+     */
+    void processOnce(Port::Rate rate, int nFrames);
 
     /// Pointer to corresponding plugin
     AudioUnitPlugin *m_pPlugin;
@@ -223,15 +303,27 @@ private:
     /// Output ports.
     QList<OutputPort*> m_outputs;
 
-    /// Flag telling that this unit has been already updated.
-    bool m_updated;
-
     /// Properties container.
     QtVariantPropertyManager *m_pPropertyManager;
     QtVariantProperty *m_pRootProperty;
 
     /// Whether the unit processing has been started.
     bool m_started;
+
+    /// Number of samples the input has been silent for.
+    long m_silentFrames;
+
+    /// Whether the unit processing is skipped on silent input.
+    bool m_sleeping;
+
+    /// Constant outputs have to be evaluated again.
+    std::atomic<bool> m_updateConstants;
+
+    /// Processing time, written by the rendering thread only.
+    std::atomic<quint64> m_processTicks;
+
+    /// Number of processed frames, written by the rendering thread only.
+    std::atomic<quint64> m_processFrames;
 };
 
 #endif // AUDIOUNIT_H
@@ -0,0 +1,139 @@
+/*
+                          qmusic
+
+    Copyright (C) 2015 Arthur Benilov,
+    arthur.benilov@gmail.com
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This software is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    Lesser General Public License for more details.
+*/
+
+#ifndef EVENTQUEUE_H
+#define EVENTQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include "FrameworkApi.h"
+#include "SignalChainEvent.h"
+
+class IEventHandler;
+class MidiMessage;
+
+/**
+ * @brief Lock-free queue of timestamped signal chain events.
+ *
+ * This queue is used to deliver events from MIDI and user input to the
+ * audio rendering thread. Events are stored as fixed-size records in a
+ * preallocated ring, so that neither pushing nor popping an event
+ * allocates memory or takes a lock. Any number of threads may push
+ * and pop concurrently (bounded MPMC queue after D. Vyukov).
+ *
+ * Event timestamps are expressed in seconds of the monotonic clock
+ * returned by currentTime(), which is the clock MIDI messages are
+ * timestamped with. A negative timestamp means that the event
+ * has to be handled as soon as possible.
+ */
+class QMUSIC_FRAMEWORK_API EventQueue
+{
+public:
+
+    /**
+     * @brief Plain event record.
+     */
+    struct Record {
+        SignalChainEvent::Type type;    ///< Event type.
+        int number;         ///< Note or controller number, or pitch bend value.
+        int value;          ///< Note velocity or controller value.
+        double timestamp;   ///< Event time, negative for immediate events.
+    };
+
+    /**
+     * Construct events queue.
+     * @param capacity Maximum number of pending events, must be a power of two.
+     */
+    EventQueue(int capacity = 1024);
+    ~EventQueue();
+
+    /**
+     * Push an event record to the queue.
+     * @param record Event record.
+     * @return false if the queue is full and the event has been dropped.
+     */
+    bool push(const Record &record);
+
+    /**
+     * Pop the oldest event record from the queue.
+     * @param record Record to be filled in.
+     * @return false if the queue is empty.
+     */
+    bool pop(Record &record);
+
+    /**
+     * Remove all pending events.
+     */
+    void clear();
+
+    /**
+     * Returns current time of the clock used for events timestamps,
+     * this is MidiMessage::currentTime().
+     * @return Time in seconds.
+     */
+    static double currentTime();
+
+    /**
+     * Create a record out of a signal chain event.
+     * @param pEvent Event to be recorded.
+     * @param timestamp Event timestamp.
+     * @return Event record.
+     */
+    static Record recordFromEvent(const SignalChainEvent *pEvent, double timestamp = -1.0);
+
+    /**
+     * Create a record out of a MIDI message, without creating an event.
+     * The record is given the message timestamp.
+     * @param msg MIDI message.
+     * @param record Record to be filled in.
+     * @return false if the message does not map to a signal chain event.
+     */
+    static bool recordFromMidiMessage(const MidiMessage &msg, Record &record);
+
+    /**
+     * Restore a signal chain event out of the record and send it to the handler.
+     * The event is created on the stack, so no memory allocation occurs.
+     * @param record Event record.
+     * @param pHandler Event handler.
+     */
+    static void dispatch(const Record &record, IEventHandler *pHandler);
+
+private:
+
+    EventQueue(const EventQueue&) = delete;
+    EventQueue& operator =(const EventQueue&) = delete;
+
+    /// Ring cell.
+    struct Cell {
+        std::atomic<size_t> sequence;
+        Record record;
+    };
+
+    /// Cache line size used to separate the positions.
+    static const int cCacheLineSize = 64;
+
+    Cell *m_pCells;
+    size_t m_mask;
+
+    char m_padding0[cCacheLineSize];
+    std::atomic<size_t> m_enqueuePos;
+    char m_padding1[cCacheLineSize];
+    std::atomic<size_t> m_dequeuePos;
+    char m_padding2[cCacheLineSize];
+};
+
+#endif // EVENTQUEUE_H
@@ -18,17 +18,25 @@
 #ifndef EVENTROUTER_H
 #define EVENTROUTER_H
 
+#include <atomic>
 #include <QList>
 #include <QMutex>
 #include <QObject>
 #include "IEventRouter.h"
 
+class QTimer;
+
 /**
  * @brief Signal chain events router implementation.
  *
  * Event router accepts signal chain events and distributes
  * them to the rigistered listeners.
  *
+ * Posted events are also recorded into the lock-free audio events
+ * queue, which is consumed by the audio rendering thread.
+ * Records posted from other threads (MIDI input) are passed to the
+ * handlers through a second lock-free queue polled by the main thread.
+ *
  * There is normally a global event router residing in the
  * main \ref Application class.
  */
@@ -48,6 +56,9 @@ public:
     // IEventRouter interface
     void sendEvent(SignalChainEvent *pEvent);
     void postEvent(SignalChainEvent *pEvent);
+    void postEvent(SignalChainEvent *pEvent, double timestamp);
+    void postRecord(const EventQueue::Record &record);
+    EventQueue* audioEventQueue() const { return m_pAudioEventQueue; }
     void processEvents();
     void registerHandler(IEventHandler *pHandler);
     void unregisterHandler(IEventHandler *pHandler);
@@ -63,6 +74,9 @@ private slots:
     /// Internal slot used to perform queued event processing.
     void doPprocessEvents();
 
+    /// Pass posted records to the handlers and report dropped events.
+    void pollRecords();
+
 private:
 
     /**
@@ -84,6 +98,21 @@ private:
 
     /// Protective mutex.
     mutable QMutex m_mutex;
+
+    /// Events to be handled by the audio thread.
+    EventQueue *m_pAudioEventQueue;
+
+    /// Posted records to be passed to the handlers.
+    EventQueue *m_pRecordsQueue;
+
+    /// Main thread timer polling the records queue.
+    QTimer *m_pPollTimer;
+
+    /// Number of events dropped by the audio queue since the last report.
+    std::atomic<int> m_droppedEvents;
+
+    /// Number of polls left before dropped events can be reported again.
+    int m_reportCountdown;
 };
 
 #endif // EVENTROUTER_H
@@ -47,6 +47,7 @@ protected:
     void processStart() override;
     void processStop() override;
     void process() override;
+    void processBlock(int nFrames) override;
     void reset() override;
 
     QGraphicsItem* graphicsItem() override;
@@ -40,15 +40,20 @@ public:
     ~ExposedOutput();
 
     QString exposedOutputName() const;
-    void setRefOutputPort(OutputPort *pOutputPort);
 
-    void fastUpdate();
+    /**
+     * Assign the buffer the input samples are copied to.
+     * The buffer must hold at least Port::MaxBlockSize samples.
+     * @param pBuffer Output buffer, normally allocated per voice by the container.
+     */
+    void setOutputBuffer(float *pBuffer);
 
 protected:
 
     void processStart() override;
     void processStop() override;
     void process() override;
+    void processBlock(int nFrames) override;
     void reset() override;
 
     QGraphicsItem* graphicsItem() override;
@@ -63,14 +68,12 @@ private:
 
     void createProperties();
 
-    OutputPort *m_pReferencedOutputPort;
+    float *m_pOutputBuffer;
 
     QGraphicsSimpleTextItem *m_pNameItem;
 
     InputPort *m_pInput;
     QtVariantProperty *m_pPropName;
-
-    QList<AudioUnit*> m_updateChain;
 };
 
 #endif // EXPOSEDOUTPUT_H
@@ -54,16 +54,6 @@ public:
     // Destructor.
     virtual ~IAudioUnit() {}
 
-    /**
-     * Prepare for the update.
-     */
-    virtual void prepareUpdate() = 0;
-
-    /**
-     * Perform processing on the current state.
-     */
-    virtual void update() = 0;
-
     /**
      * Start processing.
      */
@@ -18,6 +18,8 @@
 #ifndef IEVENTROUTER_H
 #define IEVENTROUTER_H
 
+#include "EventQueue.h"
+
 class SignalChainEvent;
 
 /**
@@ -63,6 +65,31 @@ public:
      */
     virtual void postEvent(SignalChainEvent *pEvent) = 0;
 
+    /**
+     * Post a timestamped event.
+     * The event is delivered to the audio events queue and to
+     * the registered handlers.
+     * @param pEvent Event to be posted.
+     * @param timestamp Event time as given by EventQueue::currentTime(),
+     *                  negative for immediate handling.
+     */
+    virtual void postEvent(SignalChainEvent *pEvent, double timestamp) = 0;
+
+    /**
+     * Post an event record.
+     * Neither memory allocation nor locking occurs, so that this can be
+     * called from a real-time thread like the MIDI input callback.
+     * The registered handlers receive the event later on from the main thread.
+     * @param record Event record, timestamped as given by EventQueue::currentTime().
+     */
+    virtual void postRecord(const EventQueue::Record &record) = 0;
+
+    /**
+     * Returns the queue of events to be handled by the audio rendering thread.
+     * @return Audio events queue.
+     */
+    virtual EventQueue* audioEventQueue() const = 0;
+
     /**
      * Process all events waiting in the events queue.
      */
@@ -70,6 +97,8 @@ public:
 
     /**
      * Register event handler with with router.
+     * Registered handlers are called from the main application thread,
+     * the signal chain consumes events from the audio events queue instead.
      * @param pHandler
      */
     virtual void registerHandler(IEventHandler *pHandler) = 0;
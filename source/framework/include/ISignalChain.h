@@ -93,6 +93,20 @@ public:
      */
     virtual void setTimeStep(double dt) = 0;
 
+    /**
+     * @brief Returns index of this chain among the voices of a polyphonic container.
+     * Units use it to derive per-voice state that must be reproducible,
+     * like random numbers seeds.
+     * @return Voice index, 0 for a chain that is not a voice.
+     */
+    virtual int voiceIndex() const = 0;
+
+    /**
+     * @brief Set index of this chain among the voices of a polyphonic container.
+     * @param index
+     */
+    virtual void setVoiceIndex(int index) = 0;
+
     /**
      * @brief Add an audio unit to this chain.
      * @param pAudioUnit
@@ -112,9 +126,11 @@ public:
     virtual QList<IAudioUnit*> audioUnits() const = 0;
 
     /**
-     * @brief Prepare all audio units for update.
+     * @brief Process a block of samples.
+     * This executes the processing plan compiled when the chain was started.
+     * @param nFrames Number of samples to process, up to Port::MaxBlockSize.
      */
-    virtual void prepareUpdate() = 0;
+    virtual void processBlock(int nFrames) = 0;
 
     /**
      * @brief Clone this signal chain.
@@ -31,7 +31,9 @@ class OutputPort;
  * The data (value) provided by the input port comed from
  * connected output port.
  *
- * Input port does not perform any caching of sugnal data.
+ * Input port does not perform any caching of sugnal data: the block of samples
+ * is read directly from the connected output port buffer. A disconnected input
+ * provides a block filled with its default value.
  *
  * @see OutputPort
  */
@@ -63,10 +65,25 @@ public:
     inline float getValue() const { return *m_pValue; }
 
     /**
-     * Update the input.
-     * This will trigger update of connected output port (if any).
+     * Returns pointer to the block of input samples.
+     * @return
      */
-    void update() override;
+    inline const float* buffer() const { return m_pBuffer; }
+
+    /**
+     * Shift the buffer returned by this port within the samples block.
+     * A negative offset gives access to the last sample of the
+     * previous block (used by feedback connections).
+     * @param offset Offset of the first sample.
+     */
+    inline void setBlockOffset(int offset) { m_pBuffer = m_pSource + offset; m_pValue = m_pBuffer; }
+
+    /**
+     * Select the sample of the current block returned by getValue().
+     * This is used when an audio unit is processed sample by sample.
+     * @param i Sample index within the block.
+     */
+    inline void setSampleIndex(int i) { m_pValue = m_pBuffer + i; }
 
     /**
      * Returns this input port index (within the list of all inut ports of this audio unit).
@@ -85,7 +102,23 @@ public:
      * Assign port default value.
      * @param v Value to be set.
      */
-    void setDefaultValue(float v) { m_defaultValue = v; }
+    void setDefaultValue(float v);
+
+    /**
+     * Tells whether the signal received by this port is silent.
+     * A disconnected port is silent when its default value is zero.
+     * @return
+     */
+    bool isSilent() const;
+
+    /**
+     * Returns rate of the signal received by this port.
+     * A disconnected port provides a constant signal.
+     * Audio units may use this to process the signals
+     * not changing within a block as scalars.
+     * @return
+     */
+    Rate rate() const;
 
     /**
      * Connect to an output port.
@@ -110,14 +143,23 @@ private:
     OutputPort *m_pConnectedOutputPort;
 
     /**
-     * Pointer to the value holder.
-     * This will point to the connected output port value holder
-     * or to the default value of this port if not connected.
+     * Pointer to the samples block.
+     * This will point to the connected output port samples
+     * or to the default block of this port if not connected.
      */
+    const float *m_pSource;
+
+    /// Pointer to the current position within the samples block.
+    const float *m_pBuffer;
+
+    /// Pointer to the current sample within the block.
     const float *m_pValue;
 
     /// Default value used when port is not connected.
     float m_defaultValue;
+
+    /// Block filled with the default value.
+    float m_defaultBuffer[MaxBlockSize];
 };
 
 #endif // INPUTPORT_H
@@ -18,6 +18,7 @@
 #ifndef OUTPUTPORT_H
 #define OUTPUTPORT_H
 
+#include <algorithm>
 #include "FrameworkApi.h"
 #include "IAudioUnit.h"
 #include "Port.h"
@@ -26,8 +27,9 @@
  * @brief Output port.
  *
  * Outgoing signal port.
- * Output port keeps the value stored by its audio unit.
- * This value is then supplied to all connected input ports.
+ * Output port keeps the block of samples generated by its audio unit.
+ * This block is then supplied to all connected input ports.
+ * The single value is used by audio units processing sample by sample.
  *
  * @see InputPort
  */
@@ -66,16 +68,97 @@ public:
     inline float getValue() const { return m_value; }
 
     /**
-     * @brief Reset the value help by the output port.
+     * Returns pointer to the samples block of this port.
+     * Audio units processing blocks write their output samples here.
+     * @return
+     */
+    inline float* buffer() { return m_pBuffer; }
+    inline const float* buffer() const { return m_pBuffer; }
+
+    /**
+     * Shift the buffer returned by this port within the samples block.
+     * This is used by the signal chain to process feedback loops
+     * sample by sample.
+     * @param offset Offset of the first sample.
+     */
+    inline void setBlockOffset(int offset) { m_pBuffer = m_samples + 1 + offset; }
+
+    /**
+     * Keep the last sample of the block so that it can be accessed
+     * at offset -1 during the next block processing.
+     * @param nFrames Number of samples in the block.
+     */
+    inline void holdLastSample(int nFrames) { m_samples[0] = m_samples[nFrames]; }
+
+    /**
+     * Fill the current samples block with a single value.
+     * @param value Value to be set.
+     * @param nFrames Number of samples in the block.
      */
-    inline void reset() { m_value = 0.0; }
+    inline void fill(float value, int nFrames)
+    {
+        m_value = value;
+        std::fill(m_pBuffer, m_pBuffer + nFrames, value);
+    }
 
     /**
-     * Update the port.
-     * This will trigger corresponding audio unit update that eventually
-     * will assign the output port value.
+     * Fill the whole samples block, including the held sample, with a value.
+     * This is used for constant signals, which blocks are not updated anymore.
+     * @param value Value to be set.
      */
-    void update() override;
+    void fillAll(float value);
+
+    /**
+     * Returns rate this port signal may change at.
+     * The rate is declared by the audio unit, Rate_Audio by default.
+     * @return
+     */
+    inline Rate rate() const { return m_rate; }
+
+    /**
+     * Declare the rate of this port signal.
+     * Audio units declaring all their outputs at constant or control rate
+     * are evaluated once per start or once per block respectively,
+     * as long as their inputs are not at audio rate.
+     * @param rate Signal rate.
+     */
+    inline void setRate(Rate rate) { m_rate = rate; }
+
+    /**
+     * Tells whether the last processed block of samples is silent.
+     * Audio units use this flag to skip processing of silent input.
+     * @return
+     */
+    inline bool isSilent() const { return m_silent; }
+
+    /**
+     * Mark the current samples block as silent or not.
+     * @param v
+     */
+    inline void setSilent(bool v) { m_silent = v; }
+
+    /**
+     * Enable the silence tracking of the samples blocks.
+     * This is only needed when the port feeds a unit that sleeps
+     * on silent input (a unit declaring a tail length).
+     * @param v
+     */
+    inline void setSilenceTracked(bool v) { m_silenceTracked = v; }
+
+    /**
+     * Update the silence flag by scanning the current samples block.
+     * Untracked blocks are not scanned and never reported silent.
+     * @param nFrames Number of samples in the block.
+     */
+    inline void updateSilence(int nFrames)
+    {
+        m_silent = m_silenceTracked && isSilentBlock(m_pBuffer, nFrames);
+    }
+
+    /**
+     * @brief Reset the value and the samples block held by the output port.
+     */
+    void reset();
 
     /**
      * Returns this output port index (within the list of all outputs of the audio unit).
@@ -86,16 +169,31 @@ public:
 private:
 
     /**
-     * Returns pointer to internal value holder.
+     * Returns pointer to the first sample of the block.
      * This is used to speed-up processing and should be used
      * by connected input port only.
      * @return
      */
-    const float* valuePtr() const { return &m_value; }
-
+    const float* samples() const { return m_samples + 1; }
 
     /// Value stored in this output port.
     float m_value;
+
+    /// Block of samples generated by the audio unit,
+    /// preceded by the last sample of the previous block.
+    float m_samples[MaxBlockSize + 1];
+
+    /// Pointer to the current position within the samples block.
+    float *m_pBuffer;
+
+    /// Whether the current samples block is silent.
+    bool m_silent;
+
+    /// Whether the samples blocks are scanned for silence.
+    bool m_silenceTracked;
+
+    /// Declared signal rate.
+    Rate m_rate;
 };
 
 #endif // OUTPUTPORT_H
@@ -33,6 +33,23 @@ class QMUSIC_FRAMEWORK_API Port
 {
 public:
 
+    /// Maximum number of samples processed within a single block update.
+    static const int MaxBlockSize = 256;
+
+    /// Absolute amplitude below which a signal is considered silent (-100 dB).
+    static const float SilenceThreshold;
+
+    /**
+     * Rate at which the port signal may change.
+     * Rates are ordered, so that the rate of a signal depending
+     * on several others is the highest of their rates.
+     */
+    enum Rate {
+        Rate_Constant,  ///< Changes only on start or explicit update (e.g. a constant).
+        Rate_Control,   ///< Changes at most once per block (e.g. a slider or a MIDI controller).
+        Rate_Audio      ///< Changes every sample.
+    };
+
     /// Port data flow direction.
     enum Direction {
         Direction_Input,    ///< Input port.
@@ -71,20 +88,18 @@ public:
     IAudioUnit* audioUnit() const { return m_pAudioUnit; }
 
     /**
-     * @brief Returns value currently set on this port.
-     * @return Signal data value.
+     * Tells whether all the samples of a block are below the silence threshold.
+     * @param pSamples Pointer to the samples block.
+     * @param nFrames Number of samples in the block.
+     * @return true if the block is silent.
      */
-    virtual float value() const = 0;
-
-    /**
-     * @brief Update signal chain.
-     */
-    virtual void update() = 0;
+    static bool isSilentBlock(const float *pSamples, int nFrames);
 
     /**
-     * Direct update of the audio unit.
+     * @brief Returns value currently set on this port.
+     * @return Signal data value.
      */
-    inline void updateAudioUnit() { Q_ASSERT(m_pAudioUnit != nullptr); m_pAudioUnit->update(); }
+    virtual float value() const = 0;
 
 private:
 
@@ -0,0 +1,67 @@
+/*
+                          qmusic
+
+    Copyright (C) 2015 Arthur Benilov,
+    arthur.benilov@gmail.com
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This software is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    Lesser General Public License for more details.
+*/
+
+#ifndef PROFILINGCLOCK_H
+#define PROFILINGCLOCK_H
+
+#include <QtGlobal>
+#if defined(Q_PROCESSOR_X86)
+#   ifdef _MSC_VER
+#       include <intrin.h>
+#   else
+#       include <x86intrin.h>
+#   endif
+#else
+#   include <chrono>
+#endif
+#include "FrameworkApi.h"
+
+/**
+ * @brief Cheap clock used for DSP profiling.
+ *
+ * On x86 the time stamp counter is read directly, which costs a few
+ * nanoseconds and does not enter the kernel. Elsewhere the steady clock
+ * is used, with ticks being nanoseconds.
+ */
+class QMUSIC_FRAMEWORK_API ProfilingClock
+{
+public:
+
+    /**
+     * Returns current clock value.
+     * @return Clock ticks.
+     */
+    static inline quint64 ticks()
+    {
+#if defined(Q_PROCESSOR_X86)
+        return __rdtsc();
+#else
+        return quint64(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    /**
+     * Returns duration of a single tick.
+     * The clock is calibrated on the first call, which takes a few milliseconds,
+     * so this should not be called from the audio thread.
+     * @return Tick duration in seconds.
+     */
+    static double secondsPerTick();
+};
+
+#endif // PROFILINGCLOCK_H
@@ -0,0 +1,136 @@
+/*
+                          qmusic
+
+    Copyright (C) 2015 Arthur Benilov,
+    arthur.benilov@gmail.com
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This software is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    Lesser General Public License for more details.
+*/
+
+#ifndef RENDERTHREADPOOL_H
+#define RENDERTHREADPOOL_H
+
+#include <atomic>
+#include <QList>
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+#include "FrameworkApi.h"
+
+/**
+ * @brief Fixed pool of threads used to render independent jobs in parallel.
+ *
+ * The pool is used by the audio rendering thread to spread independent pieces
+ * of work (like polyphonic voices) over multiple cores. Jobs of a batch are
+ * claimed dynamically by the workers via an atomic counter, so that idle
+ * workers pick the remaining jobs. The calling thread participates in the
+ * rendering, then blocks until the jobs taken by the workers are done.
+ *
+ * Workers spin for a short time after a batch, so that the next one is
+ * picked up without a wake up, and then go to sleep. Waking them up and
+ * waiting for the last job take a lock, no memory is allocated.
+ *
+ * Batches do not nest: if a batch is already running (e.g. a job itself
+ * requests parallel rendering), the jobs are executed by the calling thread.
+ */
+class QMUSIC_FRAMEWORK_API RenderThreadPool
+{
+public:
+
+    /// Job function, called with the user context and the job index.
+    typedef void (*Job)(void *pContext, int index);
+
+    /**
+     * Construct the pool and start the workers.
+     * @param nThreads Number of worker threads, negative to use
+     *                 one less than the number of cores.
+     */
+    RenderThreadPool(int nThreads = -1);
+    ~RenderThreadPool();
+
+    /**
+     * Returns number of worker threads, not including the calling thread.
+     * @return
+     */
+    int numberOfThreads() const { return m_workers.count(); }
+
+    /**
+     * Returns the slot of the current thread: 1 to numberOfThreads()
+     * for the workers, 0 for any other thread (like the one running
+     * the batches). Jobs may use it to pick per thread resources.
+     * @return
+     */
+    static int threadSlot();
+
+    /**
+     * Set the workers priority, which should be the one of the
+     * thread running the batches (the audio thread).
+     * @param priority Thread priority.
+     */
+    void setPriority(QThread::Priority priority);
+
+    /**
+     * Run a batch of jobs and wait for their completion.
+     * @param nJobs Number of jobs in the batch.
+     * @param job Job function.
+     * @param pContext Context passed to the job function.
+     */
+    void run(int nJobs, Job job, void *pContext);
+
+private:
+
+    RenderThreadPool(const RenderThreadPool&) = delete;
+    RenderThreadPool& operator =(const RenderThreadPool&) = delete;
+
+    class Worker;
+    friend class Worker;
+
+    /// Workers main loop.
+    void workerLoop();
+
+    /**
+     * Claim and execute jobs of a batch until none are left.
+     * @param generation Batch generation.
+     */
+    void executeJobs(quint32 generation);
+
+    QList<Worker*> m_workers;
+
+    /// Current batch: generation, number of jobs and next job index.
+    std::atomic<quint64> m_batch;
+
+    /// Number of completed jobs of the current batch.
+    std::atomic<int> m_completedJobs;
+
+    /// Set while a batch is running.
+    std::atomic<bool> m_busy;
+
+    /// Cleared when the pool is being destroyed.
+    std::atomic<bool> m_running;
+
+    /// Number of workers waiting on the wake up condition.
+    std::atomic<int> m_sleepingWorkers;
+
+    /// Clock ticks a worker spins for before going to sleep.
+    quint64 m_spinTicks;
+
+    Job m_job;
+    void *m_pContext;
+
+    QMutex m_mutex;
+    QWaitCondition m_wakeUp;
+
+    /// Signaled when the last job of a batch is done.
+    QMutex m_doneMutex;
+    QWaitCondition m_done;
+};
+
+#endif // RENDERTHREADPOOL_H
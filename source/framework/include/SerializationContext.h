@@ -81,6 +81,14 @@ public:
         return dynamic_cast<T*>(deserialize(handle));
     }
 
+    /**
+     * Initialize this context with serialized data of another context.
+     * This is equivalent to transferring the context via a byte array,
+     * but the serialized data is shared in memory instead of being encoded.
+     * @param context Context holding serialized objects.
+     */
+    void copyRecords(const SerializationContext &context);
+
     /**
      * Convert this serialization context to byte array.
      * @return
@@ -41,7 +41,8 @@ public:
         Setting_MidiInChannel,  ///< MIDI input channel number.
         Setting_MidiOutIndex,   ///< Index of MIDI output device.
         Setting_SampleRate,     ///< Processing sample rate.
-        Setting_BufferSize      ///< Audio buffer size.
+        Setting_BufferSize,     ///< Audio buffer size.
+        Setting_CallbackRender  ///< Render signal chain directly in the audio callback.
     };
 
     Settings();
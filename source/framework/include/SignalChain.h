@@ -19,12 +19,16 @@
 #define SIGNALCHAIN_H
 
 #include <QList>
+#include <QVector>
 #include <QMutex>
 #include "FrameworkApi.h"
 #include "ISignalChain.h"
 
 class QThread;
 class IAudioUnit;
+class AudioUnit;
+class InputPort;
+class OutputPort;
 class SignalChainEvent;
 
 /**
@@ -34,6 +38,11 @@ class SignalChainEvent;
  * This is a data model implementation, the view is implemented by
  * signal chain scene.
  *
+ * When started, the signal chain compiles a processing plan: a flat,
+ * topologically sorted list of audio units to be updated block by block.
+ * Feedback loops are detected at this stage and processed sample by sample
+ * with a one-sample delay on the connections closing the loop.
+ *
  * @see SignalChainScene
  */
 class QMUSIC_FRAMEWORK_API SignalChain : public ISignalChain
@@ -55,10 +64,12 @@ public:
     float timeStep() const override { return m_timeStep; }
     void setTimeStep(double dt) override { m_timeStep = dt; }
     float sampleRate() const override { return 1.0f / m_timeStep; }
+    int voiceIndex() const override { return m_voiceIndex; }
+    void setVoiceIndex(int index) override { m_voiceIndex = index; }
     void addAudioUnit(IAudioUnit *pAudioUnit) override;
     void removeAudioUnit(IAudioUnit *pAudioUnit) override;
     QList<IAudioUnit*> audioUnits() const override { return m_audioUnits; }
-    void prepareUpdate() override;
+    void processBlock(int nFrames) override;
     QList<ISignalChain*> clone(int instances = 1) override;
 
     // IEventHandler interface
@@ -70,12 +81,58 @@ public:
     void deserialize(const QVariantMap &data, SerializationContext *pContext) override;
     static ISerializable* create() { return new SignalChain(); }
 
-#ifdef PROFILING
-    void profilingLog();
-#endif // PROFILING
-
 private:
 
+    /**
+     * @brief Group of audio units forming a feedback loop.
+     *
+     * Units of the group are processed sample by sample.
+     * Connections closing the loop are delayed by one sample.
+     */
+    struct FeedbackGroup {
+        QVector<AudioUnit*> audioUnits; ///< Units in processing order.
+        QVector<InputPort*> inputs;     ///< All inputs of the group units.
+        QVector<int> inputDelays;       ///< Delay of each input, 0 or 1 sample.
+        QVector<OutputPort*> outputs;   ///< All outputs of the group units.
+    };
+
+    /**
+     * @brief Processing plan step.
+     * A step either updates a single audio unit or a feedback group.
+     */
+    struct PlanStep {
+        AudioUnit *pAudioUnit;  ///< Audio unit to update, or null for a group.
+        int feedbackGroup;      ///< Index of the feedback group, -1 if none.
+    };
+
+    /**
+     * Compile processing plan.
+     * Only the units contributing to the chain terminal units (the ones
+     * without outputs, like speaker or exposed outputs) are scheduled.
+     */
+    void compile();
+
+    /**
+     * Enable the silence tracking of the outputs feeding units
+     * that declare a tail length (evaluated once the units are started).
+     * Other outputs are not scanned for silence.
+     */
+    void trackSilence();
+
+    /**
+     * Append a strongly connected set of units to the processing plan.
+     * @param units Audio units of the set.
+     * @param discoveryOrder Order in which the units have been discovered.
+     * @param sources Indices of the units connected to each unit's inputs.
+     * @param component Indices of the units in the set.
+     */
+    void schedule(const QVector<AudioUnit*> &units,
+                  const QVector<int> &discoveryOrder,
+                  const QVector<QVector<int>> &sources,
+                  QVector<int> component);
+
+    void processFeedbackGroup(const FeedbackGroup &group, int nFrames);
+
     void startAllAudioUnits();
     void stopAllAudioUnits();
     void resetAllAudioUnits();
@@ -83,6 +140,9 @@ private:
     /// Current global time, s
     float m_timeStep;
 
+    /// Index of the voice this chain renders.
+    int m_voiceIndex;
+
     /// Signal chain processing has been started.
     bool m_started;
 
@@ -94,6 +154,12 @@ private:
 
     /// Audio units in this chain.
     QList<IAudioUnit*> m_audioUnits;
+
+    /// Compiled processing plan.
+    QVector<PlanStep> m_plan;
+
+    /// Feedback groups referenced by the processing plan.
+    QVector<FeedbackGroup> m_feedbackGroups;
 };
 
 #endif // SIGNALCHAIN_H
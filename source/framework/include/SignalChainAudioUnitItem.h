@@ -55,6 +55,14 @@ public:
     const QList<SignalChainInputPortItem*> inputPortItems() const { return m_inputPortItems; }
     const QList<SignalChainOutputPortItem*> outputPortItems() const { return m_outputPortItems; }
 
+    /**
+     * Set the measured DSP load of the audio unit.
+     * The load is shown as a heat overlay over the item.
+     * @param load Fraction of the real-time budget spent by the unit.
+     */
+    void setDspLoad(float load);
+    float dspLoad() const { return m_dspLoad; }
+
     // ISerializable interface
     QString uid() const override { return UID; }
     void serialize(QVariantMap &data, SerializationContext *pContext) const override;
@@ -81,6 +89,9 @@ private:
 
     QList<SignalChainInputPortItem*> m_inputPortItems;
     QList<SignalChainOutputPortItem*> m_outputPortItems;
+
+    /// Last measured DSP load.
+    float m_dspLoad;
 };
 
 #endif // SIGNALCHAINAUDIOUNITITEM_H
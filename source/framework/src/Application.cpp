@@ -32,6 +32,7 @@
 #include "AudioDevicesManager.h"
 #include "AudioUnitsManager.h"
 #include "EventRouter.h"
+#include "RenderThreadPool.h"
 #include "CrashReporter.h"
 #include "Application.h"
 
@@ -85,6 +86,7 @@ Application::Application(int &argc, char **argv)
     m_pAudioDevicesManager = new AudioDevicesManager(this);
     m_pAudioUnitsManager = new AudioUnitsManager(this);
     m_pEventRouter = new EventRouter(this);
+    m_pRenderThreadPool = new RenderThreadPool();
 
     loadStylesheet();
 
@@ -97,6 +99,8 @@ Application::~Application()
         m_pAudioUnitsManager->cleanup();
     }
 
+    delete m_pRenderThreadPool;
+
     s_pApplicationInstance = nullptr;
 }
 
@@ -19,6 +19,7 @@
 #include <QMap>
 #include "portaudio.h"
 #include "Application.h"
+#include "ProfilingClock.h"
 #include "AudioDevice.h"
 
 static int audioDeviceCallback(const void *pInputBuffer,
@@ -28,19 +29,41 @@ static int audioDeviceCallback(const void *pInputBuffer,
                                 PaStreamCallbackFlags statusFlags,
                                 void *pData)
 {
+    quint64 startTicks = ProfilingClock::ticks();
+
     AudioDevice *pAudioDevice = static_cast<AudioDevice*>(pData);
 
+    // Some host APIs do not provide timing information, in which case
+    // the latencies reported by the stream info are used instead.
+    if (pTimeInfo != nullptr && pTimeInfo->currentTime > 0.0) {
+        double inputLatency = pInputBuffer != nullptr && pTimeInfo->inputBufferAdcTime > 0.0
+                ? pTimeInfo->currentTime - pTimeInfo->inputBufferAdcTime
+                : 0.0;
+        double outputLatency = pOutputBuffer != nullptr && pTimeInfo->outputBufferDacTime > 0.0
+                ? pTimeInfo->outputBufferDacTime - pTimeInfo->currentTime
+                : 0.0;
+        pAudioDevice->updateLatency(inputLatency, outputLatency);
+    }
+
     const float* pIn = static_cast<const float*>(pInputBuffer);
     float *pOut = static_cast<float*>(pOutputBuffer);
 
     pAudioDevice->processAudio(pIn, pOut, framesPerBuffer);
 
+    pAudioDevice->stats()->recordCallback(startTicks, ProfilingClock::ticks(), long(framesPerBuffer), statusFlags);
+
     return 0;
 }
 
 
 AudioDevice::AudioDevice()
-    : m_pStream(nullptr)
+    : m_pStream(nullptr),
+      m_inputLatency(0.0),
+      m_outputLatency(0.0),
+      m_listenersLatency(0.0),
+      m_pCallbackInput(nullptr),
+      m_callbackFrames(0),
+      m_callbackSequence(0)
 {
     int err = Pa_Initialize();
     if (err != paNoError) {
@@ -92,7 +115,7 @@ bool AudioDevice::open(int index, int nInputs, int nOutputs, double sampleRate,
     outputParameters.device = index;
     outputParameters.channelCount = nOutputs;
     outputParameters.sampleFormat = paFloat32;
-    outputParameters.suggestedLatency = Pa_GetDeviceInfo(index)->defaultLowInputLatency;
+    outputParameters.suggestedLatency = Pa_GetDeviceInfo(index)->defaultLowOutputLatency;
     outputParameters.hostApiSpecificStreamInfo = NULL;
 
     PaStreamParameters *pOutputParameters = nOutputs > 0 ? &outputParameters : NULL;
@@ -119,6 +142,12 @@ bool AudioDevice::open(int index, int nInputs, int nOutputs, double sampleRate,
         return false;
     }
 
+    // Initial latency estimate until the callback provides measured values
+    const PaStreamInfo *pStreamInfo = Pa_GetStreamInfo(m_pStream);
+    if (pStreamInfo != nullptr) {
+        m_inputLatency = nInputs > 0 ? pStreamInfo->inputLatency : 0.0;
+        m_outputLatency = nOutputs > 0 ? pStreamInfo->outputLatency : 0.0;
+    }
 
     return true;
 }
@@ -138,6 +167,9 @@ bool AudioDevice::close()
     }
 
     m_pStream = nullptr;
+    m_inputLatency = 0.0;
+    m_outputLatency = 0.0;
+    m_listenersLatency = 0.0;
     return true;
 }
 
@@ -153,6 +185,9 @@ bool AudioDevice::start()
         return false;
     }
 
+    // The callback is not running yet
+    m_stats.reset(m_openDeviceInfo.sampleRate);
+
     int err = Pa_StartStream(m_pStream);
     if (err != paNoError) {
         qCritical() << "Unable to start audio stream:" << Pa_GetErrorText(err)
@@ -192,9 +227,33 @@ void AudioDevice::removeListener(IAudioDeviceListener *pListener)
 
 void AudioDevice::processAudio(const float *pInputBuffer, float *pOutputBuffer, long nSamples)
 {
+    m_pCallbackInput = pInputBuffer;
+    m_callbackFrames = nSamples;
+    m_callbackSequence++;
+
+    double listenersLatency = 0.0;
     for (IAudioDeviceListener *pListener : m_listeners) {
         pListener->processAudio(pInputBuffer, pOutputBuffer, nSamples);
+        listenersLatency = qMax(listenersLatency, pListener->latency());
     }
+
+    // Listeners are only walked by the audio thread, their latency
+    // is published for the outputLatency() readers.
+    m_listenersLatency.store(listenersLatency, std::memory_order_relaxed);
+
+    m_pCallbackInput = nullptr;
+}
+
+void AudioDevice::updateLatency(double inputLatency, double outputLatency)
+{
+    m_inputLatency.store(inputLatency, std::memory_order_relaxed);
+    m_outputLatency.store(outputLatency, std::memory_order_relaxed);
+}
+
+double AudioDevice::outputLatency() const
+{
+    return m_outputLatency.load(std::memory_order_relaxed)
+            + m_listenersLatency.load(std::memory_order_relaxed);
 }
 
 AudioDevice::Info AudioDevice::getInfo(int index) const
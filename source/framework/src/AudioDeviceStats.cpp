@@ -0,0 +1,165 @@
+/*
+                          qmusic
+
+    Copyright (C) 2015 Arthur Benilov,
+    arthur.benilov@gmail.com
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This software is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    Lesser General Public License for more details.
+*/
+
+#include <cmath>
+#include <limits>
+#include "ProfilingClock.h"
+#include "AudioDeviceStats.h"
+
+/// Percentile reported by the histograms.
+const double cPercentile(0.99);
+
+void AudioDeviceStats::Histogram::reset()
+{
+    for (int i = 0; i < cBins; i++) {
+        m_bins[i].store(0, std::memory_order_relaxed);
+    }
+    m_count.store(0, std::memory_order_relaxed);
+    m_sum.store(0.0, std::memory_order_relaxed);
+    m_min.store(std::numeric_limits<double>::max(), std::memory_order_relaxed);
+    m_max.store(0.0, std::memory_order_relaxed);
+}
+
+void AudioDeviceStats::Histogram::record(double us)
+{
+    int bin = us > 1.0 ? int(std::log2(us) * cBinsPerOctave) : 0;
+    bin = qMin(bin, cBins - 1);
+
+    add(m_bins[bin], quint32(1));
+    add(m_sum, us);
+    if (us < m_min.load(std::memory_order_relaxed)) {
+        m_min.store(us, std::memory_order_relaxed);
+    }
+    if (us > m_max.load(std::memory_order_relaxed)) {
+        m_max.store(us, std::memory_order_relaxed);
+    }
+
+    // Count is published last, so that a reader never sees more samples than in bins
+    m_count.store(m_count.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+AudioDeviceStats::Summary AudioDeviceStats::Histogram::summary() const
+{
+    Summary s;
+    s.count = m_count.load(std::memory_order_acquire);
+    if (s.count == 0) {
+        s.min = s.avg = s.max = s.p99 = 0.0;
+        return s;
+    }
+
+    s.min = m_min.load(std::memory_order_relaxed);
+    s.max = m_max.load(std::memory_order_relaxed);
+    s.avg = m_sum.load(std::memory_order_relaxed) / s.count;
+
+    // Upper edge of the bin containing the percentile
+    quint64 threshold = quint64(std::ceil(s.count * cPercentile));
+    quint64 accumulated = 0;
+    int bin = 0;
+    while (bin < cBins - 1) {
+        accumulated += m_bins[bin].load(std::memory_order_relaxed);
+        if (accumulated >= threshold) {
+            break;
+        }
+        bin++;
+    }
+    s.p99 = qBound(s.min, std::exp2(double(bin + 1) / cBinsPerOctave), s.max);
+
+    return s;
+}
+
+AudioDeviceStats::AudioDeviceStats()
+{
+    reset(44100.0);
+}
+
+void AudioDeviceStats::reset(double sampleRate)
+{
+    Q_ASSERT(sampleRate > 0.0);
+
+    m_timeStep = 1.0 / sampleRate;
+    m_secondsPerTick = ProfilingClock::secondsPerTick();
+    m_lastStartTicks = 0;
+    m_lastFrames = 0;
+
+    m_callbacks.store(0, std::memory_order_relaxed);
+    m_frames.store(0, std::memory_order_relaxed);
+    m_callbackTicks.store(0, std::memory_order_relaxed);
+    m_duration.reset();
+    m_jitter.reset();
+    for (int i = 0; i < Flag_Count; i++) {
+        m_flags[i].store(0, std::memory_order_relaxed);
+    }
+    m_underruns.store(0, std::memory_order_relaxed);
+    m_underrunFrames.store(0, std::memory_order_relaxed);
+    m_renderTicks.store(0, std::memory_order_relaxed);
+    m_renderFrames.store(0, std::memory_order_relaxed);
+}
+
+void AudioDeviceStats::recordCallback(quint64 startTicks, quint64 endTicks, long nFrames, unsigned long statusFlags)
+{
+    quint64 ticks = endTicks - startTicks;
+    m_duration.record(ticks * m_secondsPerTick * 1.0e6);
+
+    if (m_lastStartTicks != 0) {
+        // The callback is expected once per the previous buffer duration
+        double intervalUs = (startTicks - m_lastStartTicks) * m_secondsPerTick * 1.0e6;
+        double periodUs = m_lastFrames * m_timeStep * 1.0e6;
+        m_jitter.record(std::fabs(intervalUs - periodUs));
+    }
+    m_lastStartTicks = startTicks;
+    m_lastFrames = nFrames;
+
+    for (int i = 0; i < Flag_Count; i++) {
+        if (statusFlags & (1ul << i)) {
+            add(m_flags[i], quint64(1));
+        }
+    }
+
+    add(m_callbackTicks, ticks);
+    add(m_frames, quint64(nFrames));
+    add(m_callbacks, quint64(1));
+}
+
+void AudioDeviceStats::recordUnderrun(long nFrames)
+{
+    add(m_underruns, quint64(1));
+    add(m_underrunFrames, quint64(nFrames));
+}
+
+void AudioDeviceStats::recordRender(quint64 ticks, long nFrames)
+{
+    add(m_renderTicks, ticks);
+    add(m_renderFrames, quint64(nFrames));
+}
+
+AudioDeviceStats::Snapshot AudioDeviceStats::snapshot() const
+{
+    Snapshot s;
+    s.callbacks = m_callbacks.load(std::memory_order_relaxed);
+    s.frames = m_frames.load(std::memory_order_relaxed);
+    s.callbackSeconds = m_callbackTicks.load(std::memory_order_relaxed) * m_secondsPerTick;
+    s.duration = m_duration.summary();
+    s.jitter = m_jitter.summary();
+    for (int i = 0; i < Flag_Count; i++) {
+        s.flags[i] = m_flags[i].load(std::memory_order_relaxed);
+    }
+    s.underruns = m_underruns.load(std::memory_order_relaxed);
+    s.underrunFrames = m_underrunFrames.load(std::memory_order_relaxed);
+    s.renderFrames = m_renderFrames.load(std::memory_order_relaxed);
+    s.renderSeconds = m_renderTicks.load(std::memory_order_relaxed) * m_secondsPerTick;
+    return s;
+}
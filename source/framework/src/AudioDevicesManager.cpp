@@ -21,6 +21,7 @@
 #include "AudioDevice.h"
 #include "MidiInputDevice.h"
 #include "IEventRouter.h"
+#include "EventQueue.h"
 #include "ISignalChain.h"
 #include "SignalChainEvent.h"
 #include "NoteOnEvent.h"
@@ -55,34 +56,11 @@ public:
             return;
         }
 
-        SignalChainEvent *pEvent = nullptr;
-
-        switch (msg.status()) {
-        case MidiMessage::Status_NoteOn:
-            if (msg.velocity() == 0) {
-                pEvent = new NoteOffEvent(msg.noteNumber(), 64);
-            } else {
-                pEvent = new NoteOnEvent(msg.noteNumber(), msg.velocity());
-            }
-            break;
-        case MidiMessage::Status_NoteOff:
-            pEvent = new NoteOffEvent(msg.noteNumber(), msg.velocity());
-            break;
-        case MidiMessage::Status_PitchBend: {
-            pEvent = new PitchBendEvent(msg.pitchBend());
-            break;
-        }
-        case MidiMessage::Status_ControlChange: {
-            pEvent = new ControllerEvent(msg.controllerNumber(), msg.controllerValue());
-            break;
-        }
-        default:
-            break;
-        }
-
-        if (pEvent != nullptr) {
-            // Route MIDI event via the global router
-            Application::instance()->eventRouter()->postEvent(pEvent);
+        // This is called from the MIDI input thread: only a plain
+        // record is routed, no event object is allocated.
+        EventQueue::Record record;
+        if (EventQueue::recordFromMidiMessage(msg, record)) {
+            Application::instance()->eventRouter()->postRecord(record);
         }
     }
 
@@ -106,6 +84,8 @@ AudioDevicesManager::AudioDevicesManager(QObject *pParent)
     m_pMidiEventTranslator = new MidiEventTranslator();
     m_pMidiInputDevice->addListener(m_pMidiEventTranslator);
     m_started = false;
+    m_duplex = false;
+    m_callbackRender = false;
 }
 
 AudioDevicesManager::~AudioDevicesManager()
@@ -139,8 +119,10 @@ void AudioDevicesManager::startAudioDevices()
 
     double sampleRate = settings.get(Settings::Setting_SampleRate).toDouble();
     int bufferSize = settings.get(Settings::Setting_BufferSize).toInt();
+    m_callbackRender = settings.get(Settings::Setting_CallbackRender).toBool();
 
-    if (waveInDeviceIndex == waveOutDeviceIndex) {
+    m_duplex = waveInDeviceIndex == waveOutDeviceIndex;
+    if (m_duplex) {
         // Open only one device
         if (m_pAudioOutputDevice->open(waveOutDeviceIndex, cNumberOfChannels, cNumberOfChannels, sampleRate, bufferSize)) {
             m_pAudioOutputDevice->start();
@@ -200,3 +182,50 @@ void AudioDevicesManager::stopAudioDevices()
 
     m_started = false;
 }
+
+double AudioDevicesManager::roundTripLatency() const
+{
+    if (!m_started) {
+        return 0.0;
+    }
+
+    double latency = m_pAudioOutputDevice->outputLatency();
+    if (m_pAudioInputDevice->isOpen()) {
+        latency += m_pAudioInputDevice->inputLatency();
+    } else {
+        // Duplex stream
+        latency += m_pAudioOutputDevice->inputLatency();
+    }
+
+    return latency;
+}
+
+SignalChainEvent* AudioDevicesManager::createEvent(const MidiMessage &msg)
+{
+    SignalChainEvent *pEvent = nullptr;
+
+    switch (msg.status()) {
+    case MidiMessage::Status_NoteOn:
+        if (msg.velocity() == 0) {
+            pEvent = new NoteOffEvent(msg.noteNumber(), 64);
+        } else {
+            pEvent = new NoteOnEvent(msg.noteNumber(), msg.velocity());
+        }
+        break;
+    case MidiMessage::Status_NoteOff:
+        pEvent = new NoteOffEvent(msg.noteNumber(), msg.velocity());
+        break;
+    case MidiMessage::Status_PitchBend: {
+        pEvent = new PitchBendEvent(msg.pitchBend());
+        break;
+    }
+    case MidiMessage::Status_ControlChange: {
+        pEvent = new ControllerEvent(msg.controllerNumber(), msg.controllerValue());
+        break;
+    }
+    default:
+        break;
+    }
+
+    return pEvent;
+}
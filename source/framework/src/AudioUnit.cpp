@@ -15,12 +15,11 @@
     Lesser General Public License for more details.
 */
 
-#ifdef PROFILING
-#   include <chrono>
-#endif
+#include <algorithm>
 #include <QtVariantPropertyManager>
 #include <QtVariantProperty>
 #include "Application.h"
+#include "ProfilingClock.h"
 #include "SerializationContext.h"
 #include "SignalChain.h"
 #include "SignalChainEvent.h"
@@ -39,7 +38,12 @@ AudioUnit::AudioUnit(AudioUnitPlugin *pPlugin)
       m_pPlugin(pPlugin),
       m_inputs(),
       m_outputs(),
-      m_started(false)
+      m_started(false),
+      m_silentFrames(0),
+      m_sleeping(false),
+      m_updateConstants(true),
+      m_processTicks(0),
+      m_processFrames(0)
 {
     Q_ASSERT(pPlugin != nullptr);
 
@@ -61,49 +65,15 @@ AudioUnit::~AudioUnit()
     delete m_pPropertyManager;
 }
 
-void AudioUnit::prepareUpdate()
-{
-    m_updated = false;
-}
-
-void AudioUnit::update()
-{
-    if (m_updated) {
-        // Already updated.
-        return;
-    }
-
-    if (!m_pSignalChain->isEnabled()) {
-        // Signal chain is disabled
-        return;
-    }
-
-    // Activate already the updated flag to prevent loop recursion
-    m_updated = true;
-
-    for (InputPort *pInput : m_inputs) {
-        pInput->update();
-    }
-#ifdef PROFILING
-    auto startTime = std::chrono::high_resolution_clock::now();
-#endif // PROFILING
-    process();
-#ifdef PROFILING
-    auto processTime = std::chrono::high_resolution_clock::now() - startTime;
-    double processTimeUs = double(std::chrono::duration_cast<std::chrono::microseconds>(processTime).count());
-    profilingRegister(processTimeUs);
-#endif // PROFILING
-}
-
 void AudioUnit::start()
 {
     if (isStarted()) {
         return;
     }
 
-#ifdef PROFILING
-    profilingReset();
-#endif // PROFILING
+    m_silentFrames = 0;
+    m_sleeping = false;
+    m_updateConstants = true;
 
     processStart();
     m_started = true;
@@ -123,6 +93,9 @@ void AudioUnit::resetUnitAndPorts()
 {
     reset();
     resetAllOutputs();
+
+    // Outputs have been cleared
+    m_updateConstants = true;
 }
 
 void AudioUnit::handleEvent(SignalChainEvent *pEvent)
@@ -157,55 +130,146 @@ QString AudioUnit::title() const
     return m_pPlugin->name();
 }
 
-QList<AudioUnit*> AudioUnit::updateChain(const QList<AudioUnit *> chain)
+void AudioUnit::updateBlock(int nFrames)
 {
-    QList<AudioUnit*> newChain(chain);
+    Q_ASSERT(nFrames <= Port::MaxBlockSize);
 
-    if (newChain.contains(this)) {
-        return newChain;
+    // Only this thread writes the counters, so that plain
+    // relaxed stores are enough (no read-modify-write needed).
+    m_processFrames.store(m_processFrames.load(std::memory_order_relaxed) + nFrames,
+                          std::memory_order_relaxed);
+
+    if (updateSleeping(nFrames)) {
+        writeSilence(nFrames);
+        return;
+    }
+
+    quint64 startTicks = ProfilingClock::ticks();
+
+    Port::Rate rate = processingRate();
+    if (rate == Port::Rate_Audio) {
+        processBlock(nFrames);
+        for (OutputPort *pOutput : m_outputs) {
+            pOutput->updateSilence(nFrames);
+        }
     } else {
-        newChain.prepend(this);
+        processOnce(rate, nFrames);
+    }
+
+    quint64 ticks = ProfilingClock::ticks() - startTicks;
+    m_processTicks.store(m_processTicks.load(std::memory_order_relaxed) + ticks,
+                         std::memory_order_relaxed);
+}
+
+AudioUnit::ProfilingCounters AudioUnit::profilingCounters() const
+{
+    ProfilingCounters counters;
+    counters.ticks = m_processTicks.load(std::memory_order_relaxed);
+    counters.frames = m_processFrames.load(std::memory_order_relaxed);
+    return counters;
+}
+
+Port::Rate AudioUnit::processingRate() const
+{
+    if (m_outputs.isEmpty()) {
+        return Port::Rate_Audio;
     }
 
-    // Scan all the inputs of this unit
-    for (InputPort *pInputPort : m_inputs) {
-        OutputPort *pOutput = pInputPort->connectedOutputPort();
-        if (pOutput != nullptr) {
-            AudioUnit *pConnectedAu = dynamic_cast<AudioUnit*>(pOutput->audioUnit());
-            if (pConnectedAu != nullptr) {
-                // Update chain recursively
-                newChain = pConnectedAu->updateChain(newChain);
-            }
+    Port::Rate rate = Port::Rate_Constant;
+    for (const OutputPort *pOutput : m_outputs) {
+        rate = qMax(rate, pOutput->rate());
+    }
+    if (rate == Port::Rate_Audio) {
+        return rate;
+    }
+
+    for (const InputPort *pInput : m_inputs) {
+        rate = qMax(rate, pInput->rate());
+    }
+    return rate;
+}
+
+bool AudioUnit::isInputSilent() const
+{
+    for (const InputPort *pInput : m_inputs) {
+        if (!pInput->isSilent()) {
+            return false;
         }
     }
+    return true;
+}
+
+bool AudioUnit::updateSleeping(int nFrames)
+{
+    float tail = m_pSignalChain != nullptr ? tailLength() : -1.0f;
+    if (tail < 0.0f || !isInputSilent()) {
+        m_silentFrames = 0;
+        m_sleeping = false;
+        return false;
+    }
+
+    if (!m_sleeping) {
+        m_silentFrames += nFrames;
+        long tailFrames = long(double(tail) / m_pSignalChain->timeStep());
+        m_sleeping = m_silentFrames > tailFrames;
+    }
 
-    return newChain;
+    return m_sleeping;
 }
 
-void AudioUnit::fastUpdate()
+void AudioUnit::writeSilence(int nFrames)
 {
-    if (m_updated) {
-        // Already updated.
-        return;
+    for (OutputPort *pOutput : m_outputs) {
+        std::fill(pOutput->buffer(), pOutput->buffer() + nFrames, 0.0f);
+        pOutput->setValue(0.0f);
+        pOutput->setSilent(true);
     }
+}
 
-    if (!m_pSignalChain->isEnabled()) {
-        // Signal chain is disabled
+void AudioUnit::processOnce(Port::Rate rate, int nFrames)
+{
+    if (rate == Port::Rate_Constant
+            && !m_updateConstants.exchange(false, std::memory_order_acquire)) {
+        // Output blocks still hold the values
         return;
     }
 
-    // Activate already the updated flag to prevent loop recursion
-    m_updated = true;
+    // Inputs do not change within the block, take their first sample
+    for (InputPort *pInput : m_inputs) {
+        pInput->setSampleIndex(0);
+    }
 
-#ifdef PROFILING
-    auto startTime = std::chrono::high_resolution_clock::now();
-#endif // PROFILING
     process();
-#ifdef PROFILING
-    auto processTime = std::chrono::high_resolution_clock::now() - startTime;
-    double processTimeUs = double(std::chrono::duration_cast<std::chrono::microseconds>(processTime).count());
-    profilingRegister(processTimeUs);
-#endif // PROFILING
+
+    for (OutputPort *pOutput : m_outputs) {
+        float value = pOutput->getValue();
+        if (rate == Port::Rate_Constant) {
+            pOutput->fillAll(value);
+        } else {
+            pOutput->fill(value, nFrames);
+        }
+        pOutput->setSilent(qAbs(value) < Port::SilenceThreshold);
+    }
+}
+
+void AudioUnit::processBlock(int nFrames)
+{
+    // Per-sample fallback: feed the process() method with
+    // the block samples one by one and collect the output values.
+    const QList<InputPort*> &inputs = m_inputs;
+    const QList<OutputPort*> &outputs = m_outputs;
+
+    for (int i = 0; i < nFrames; ++i) {
+        for (InputPort *pInput : inputs) {
+            pInput->setSampleIndex(i);
+        }
+
+        process();
+
+        for (OutputPort *pOutput : outputs) {
+            pOutput->buffer()[i] = pOutput->getValue();
+        }
+    }
 }
 
 InputPort *AudioUnit::addInput(const QString &name, float defaultValue)
@@ -296,14 +360,3 @@ void AudioUnit::resetAllOutputs()
     }
 }
 
-#ifdef PROFILING
-void AudioUnit::profilingReset()
-{
-    m_pPlugin->profilingReset();
-}
-
-void AudioUnit::profilingRegister(double processTimeUs)
-{
-    m_pPlugin->profilingRegister(processTimeUs);
-}
-#endif // PROFILING
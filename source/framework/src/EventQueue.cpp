@@ -0,0 +1,219 @@
+/*
+                          qmusic
+
+    Copyright (C) 2015 Arthur Benilov,
+    arthur.benilov@gmail.com
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This software is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    Lesser General Public License for more details.
+*/
+
+#include <cstdint>
+#include <QtGlobal>
+#include "MidiMessage.h"
+#include "IEventRouter.h"
+#include "NoteOnEvent.h"
+#include "NoteOffEvent.h"
+#include "PitchBendEvent.h"
+#include "ControllerEvent.h"
+#include "EventQueue.h"
+
+EventQueue::EventQueue(int capacity)
+{
+    Q_ASSERT(capacity >= 2 && (capacity & (capacity - 1)) == 0);
+
+    m_pCells = new Cell[capacity];
+    m_mask = size_t(capacity - 1);
+    for (int i = 0; i < capacity; i++) {
+        m_pCells[i].sequence.store(size_t(i), std::memory_order_relaxed);
+    }
+    m_enqueuePos.store(0, std::memory_order_relaxed);
+    m_dequeuePos.store(0, std::memory_order_relaxed);
+}
+
+EventQueue::~EventQueue()
+{
+    delete[] m_pCells;
+}
+
+bool EventQueue::push(const Record &record)
+{
+    Cell *pCell = nullptr;
+    size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+
+    for (;;) {
+        pCell = &m_pCells[pos & m_mask];
+        size_t seq = pCell->sequence.load(std::memory_order_acquire);
+        intptr_t diff = intptr_t(seq) - intptr_t(pos);
+        if (diff == 0) {
+            if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // Queue is full
+            return false;
+        } else {
+            pos = m_enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    pCell->record = record;
+    pCell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool EventQueue::pop(Record &record)
+{
+    Cell *pCell = nullptr;
+    size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+
+    for (;;) {
+        pCell = &m_pCells[pos & m_mask];
+        size_t seq = pCell->sequence.load(std::memory_order_acquire);
+        intptr_t diff = intptr_t(seq) - intptr_t(pos + 1);
+        if (diff == 0) {
+            if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // Queue is empty
+            return false;
+        } else {
+            pos = m_dequeuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    record = pCell->record;
+    pCell->sequence.store(pos + m_mask + 1, std::memory_order_release);
+    return true;
+}
+
+void EventQueue::clear()
+{
+    Record record;
+    while (pop(record)) {
+    }
+}
+
+double EventQueue::currentTime()
+{
+    // Single clock shared with the MIDI input timestamps
+    return MidiMessage::currentTime();
+}
+
+EventQueue::Record EventQueue::recordFromEvent(const SignalChainEvent *pEvent, double timestamp)
+{
+    Q_ASSERT(pEvent != nullptr);
+
+    Record record;
+    record.type = pEvent->type();
+    record.number = 0;
+    record.value = 0;
+    record.timestamp = timestamp;
+
+    switch (pEvent->type()) {
+    case SignalChainEvent::NoteOn: {
+        const NoteOnEvent *pNoteOnEvent = static_cast<const NoteOnEvent*>(pEvent);
+        record.number = pNoteOnEvent->noteNumber();
+        record.value = pNoteOnEvent->velocity();
+        break;
+    }
+    case SignalChainEvent::NoteOff: {
+        const NoteOffEvent *pNoteOffEvent = static_cast<const NoteOffEvent*>(pEvent);
+        record.number = pNoteOffEvent->noteNumber();
+        record.value = pNoteOffEvent->velocity();
+        break;
+    }
+    case SignalChainEvent::PitchBend: {
+        const PitchBendEvent *pPitchBendEvent = static_cast<const PitchBendEvent*>(pEvent);
+        record.number = pPitchBendEvent->bend();
+        break;
+    }
+    case SignalChainEvent::Controller: {
+        const ControllerEvent *pControllerEvent = static_cast<const ControllerEvent*>(pEvent);
+        record.number = pControllerEvent->controlNumber();
+        record.value = pControllerEvent->controlValue();
+        break;
+    }
+    default:
+        break;
+    }
+
+    return record;
+}
+
+bool EventQueue::recordFromMidiMessage(const MidiMessage &msg, Record &record)
+{
+    record.number = 0;
+    record.value = 0;
+    record.timestamp = msg.timestamp();
+
+    switch (msg.status()) {
+    case MidiMessage::Status_NoteOn:
+        if (msg.velocity() == 0) {
+            record.type = SignalChainEvent::NoteOff;
+            record.number = msg.noteNumber();
+            record.value = 64;
+        } else {
+            record.type = SignalChainEvent::NoteOn;
+            record.number = msg.noteNumber();
+            record.value = msg.velocity();
+        }
+        break;
+    case MidiMessage::Status_NoteOff:
+        record.type = SignalChainEvent::NoteOff;
+        record.number = msg.noteNumber();
+        record.value = msg.velocity();
+        break;
+    case MidiMessage::Status_PitchBend:
+        record.type = SignalChainEvent::PitchBend;
+        record.number = msg.pitchBend();
+        break;
+    case MidiMessage::Status_ControlChange:
+        record.type = SignalChainEvent::Controller;
+        record.number = msg.controllerNumber();
+        record.value = msg.controllerValue();
+        break;
+    default:
+        return false;
+    }
+
+    return true;
+}
+
+void EventQueue::dispatch(const Record &record, IEventHandler *pHandler)
+{
+    Q_ASSERT(pHandler != nullptr);
+
+    switch (record.type) {
+    case SignalChainEvent::NoteOn: {
+        NoteOnEvent event(record.number, record.value);
+        pHandler->handleEvent(&event);
+        break;
+    }
+    case SignalChainEvent::NoteOff: {
+        NoteOffEvent event(record.number, record.value);
+        pHandler->handleEvent(&event);
+        break;
+    }
+    case SignalChainEvent::PitchBend: {
+        PitchBendEvent event(record.number);
+        pHandler->handleEvent(&event);
+        break;
+    }
+    case SignalChainEvent::Controller: {
+        ControllerEvent event(record.number, record.value);
+        pHandler->handleEvent(&event);
+        break;
+    }
+    default:
+        break;
+    }
+}
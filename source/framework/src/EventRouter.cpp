@@ -15,22 +15,41 @@
     Lesser General Public License for more details.
 */
 
+#include <QDebug>
+#include <QTimer>
 #include "Application.h"
 #include "SignalChainEvent.h"
+#include "EventQueue.h"
 #include "EventRouter.h"
 
+/// Interval the posted records are passed to the handlers at, ms.
+const int cPollIntervalMs(20);
+
+/// Dropped events are reported at most once per this number of polls.
+const int cReportIntervalPolls(50);
+
 EventRouter::EventRouter(QObject *pParent)
     : QObject(pParent),
       m_handlers(),
       m_events(),
-      m_mutex()
+      m_mutex(),
+      m_droppedEvents(0),
+      m_reportCountdown(0)
 {
+    m_pAudioEventQueue = new EventQueue();
+    m_pRecordsQueue = new EventQueue();
     connect(this, SIGNAL(triggerProcessEvents()), this, SLOT(doPprocessEvents()), Qt::QueuedConnection);
+
+    m_pPollTimer = new QTimer(this);
+    connect(m_pPollTimer, SIGNAL(timeout()), this, SLOT(pollRecords()));
+    m_pPollTimer->start(cPollIntervalMs);
 }
 
 EventRouter::~EventRouter()
 {
     purgeUnsafe();
+    delete m_pAudioEventQueue;
+    delete m_pRecordsQueue;
 }
 
 void EventRouter::sendEvent(SignalChainEvent *pEvent)
@@ -42,14 +61,36 @@ void EventRouter::sendEvent(SignalChainEvent *pEvent)
 }
 
 void EventRouter::postEvent(SignalChainEvent *pEvent)
+{
+    postEvent(pEvent, -1.0);
+}
+
+void EventRouter::postEvent(SignalChainEvent *pEvent, double timestamp)
 {
     Q_ASSERT(pEvent != nullptr);
+
+    if (!m_pAudioEventQueue->push(EventQueue::recordFromEvent(pEvent, timestamp))) {
+        // Nobody is draining the queue (e.g. no speaker), reported by pollRecords()
+        m_droppedEvents.fetch_add(1, std::memory_order_relaxed);
+    }
+
     QMutexLocker lock(&m_mutex);
     m_events.append(pEvent);
 
     emit triggerProcessEvents();
 }
 
+void EventRouter::postRecord(const EventQueue::Record &record)
+{
+    if (!m_pAudioEventQueue->push(record)) {
+        m_droppedEvents.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Handlers only reflect the events (e.g. piano keys),
+    // a record that does not fit is simply not shown.
+    m_pRecordsQueue->push(record);
+}
+
 void EventRouter::processEvents()
 {
     emit triggerProcessEvents();
@@ -70,6 +111,9 @@ void EventRouter::unregisterHandler(IEventHandler *pHandler)
 
 void EventRouter::purge()
 {
+    m_pAudioEventQueue->clear();
+    m_pRecordsQueue->clear();
+
     QMutexLocker lock(&m_mutex);
     purgeUnsafe();
 }
@@ -97,6 +141,27 @@ void EventRouter::doPprocessEvents()
     }
 }
 
+void EventRouter::pollRecords()
+{
+    EventQueue::Record record;
+    while (m_pRecordsQueue->pop(record)) {
+        for (IEventHandler *pHandler : m_handlers) {
+            EventQueue::dispatch(record, pHandler);
+        }
+    }
+
+    if (m_reportCountdown > 0) {
+        m_reportCountdown--;
+        return;
+    }
+
+    int dropped = m_droppedEvents.exchange(0, std::memory_order_relaxed);
+    if (dropped > 0) {
+        qWarning() << "Audio events queue overflow," << dropped << "events dropped";
+        m_reportCountdown = cReportIntervalPolls;
+    }
+}
+
 void EventRouter::purgeUnsafe()
 {
     qDeleteAll(m_events);
@@ -15,6 +15,7 @@
     Lesser General Public License for more details.
 */
 
+#include <algorithm>
 #include <QtVariantPropertyManager>
 #include <QtVariantProperty>
 #include <QGraphicsWidget>
@@ -56,6 +57,15 @@ void ExposedInput::process()
     }
 }
 
+void ExposedInput::processBlock(int nFrames)
+{
+    if (m_pReferencedInputPort != nullptr) {
+        // Take the samples of the container's input port.
+        const float *pIn = m_pReferencedInputPort->buffer();
+        std::copy(pIn, pIn + nFrames, m_pOutput->buffer());
+    }
+}
+
 void ExposedInput::reset()
 {
 }
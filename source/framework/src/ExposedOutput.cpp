@@ -15,6 +15,7 @@
     Lesser General Public License for more details.
 */
 
+#include <algorithm>
 #include <QtVariantPropertyManager>
 #include <QtVariantProperty>
 #include <QGraphicsWidget>
@@ -27,7 +28,7 @@ const QColor cItemColor(180, 120, 220);
 
 ExposedOutput::ExposedOutput(AudioUnitPlugin *pPlugin)
     : AudioUnit(pPlugin),
-      m_pReferencedOutputPort(nullptr)
+      m_pOutputBuffer(nullptr)
 {
     m_pInput = addInput();
     createProperties();
@@ -39,18 +40,9 @@ ExposedOutput::~ExposedOutput()
 {
 }
 
-void ExposedOutput::fastUpdate()
-{
-    for (AudioUnit *pAu : m_updateChain) {
-        pAu->fastUpdate();
-    }
-}
-
 void ExposedOutput::processStart()
 {
-    Q_ASSERT(m_pReferencedOutputPort != nullptr);
-
-    m_updateChain = updateChain();
+    Q_ASSERT(m_pOutputBuffer != nullptr);
 }
 
 void ExposedOutput::processStop()
@@ -59,12 +51,15 @@ void ExposedOutput::processStop()
 
 void ExposedOutput::process()
 {
-    Q_ASSERT(m_pReferencedOutputPort != nullptr);
+    // Samples are copied by blocks, see processBlock().
+}
+
+void ExposedOutput::processBlock(int nFrames)
+{
+    Q_ASSERT(m_pOutputBuffer != nullptr);
 
-    float value = m_pReferencedOutputPort->getValue();
-    // Mix the input with whatever has been already assigned to referenced port
-    m_pInput->update();
-    m_pReferencedOutputPort->setValue(value + m_pInput->getValue());
+    // The container sums up the voices buffers once all of them are rendered
+    std::copy(m_pInput->buffer(), m_pInput->buffer() + nFrames, m_pOutputBuffer);
 }
 
 void ExposedOutput::reset()
@@ -102,10 +97,10 @@ QString ExposedOutput::exposedOutputName() const
     return m_pPropName->valueText();
 }
 
-void ExposedOutput::setRefOutputPort(OutputPort *pOutputPort)
+void ExposedOutput::setOutputBuffer(float *pBuffer)
 {
-    Q_ASSERT(pOutputPort);
-    m_pReferencedOutputPort = pOutputPort;
+    Q_ASSERT(pBuffer != nullptr);
+    m_pOutputBuffer = pBuffer;
 }
 
 void ExposedOutput::serialize(QVariantMap &data, SerializationContext *pContext) const
@@ -15,6 +15,7 @@
     Lesser General Public License for more details.
 */
 
+#include <algorithm>
 #include "SerializationContext.h"
 #include "AudioUnit.h"
 #include "OutputPort.h"
@@ -23,37 +24,53 @@
 InputPort::InputPort()
     : Port(Direction_Input),
       m_pConnectedOutputPort(nullptr),
-      m_defaultValue(0.0f),
-      m_pValue(&m_defaultValue)
+      m_pSource(m_defaultBuffer),
+      m_pBuffer(m_defaultBuffer),
+      m_pValue(m_defaultBuffer)
 {
+    setDefaultValue(0.0f);
 }
 
 InputPort::InputPort(const QString &name, float defaultValue)
     : Port(Direction_Input, name),
       m_pConnectedOutputPort(nullptr),
-      m_defaultValue(defaultValue),
-      m_pValue(&m_defaultValue)
+      m_pSource(m_defaultBuffer),
+      m_pBuffer(m_defaultBuffer),
+      m_pValue(m_defaultBuffer)
 {
+    setDefaultValue(defaultValue);
 }
 
 float InputPort::value() const
 {
     // NOTE: This is a clean way to access the connected output port.
     // However in order to improve the performance we keep the direct pointer
-    // to the connected output port value or to this class' default value
+    // to the connected output port samples or to this class' default samples
     // if not connected.
     // return m_pConnectedOutputPort == nullptr ? m_defaultValue : m_pConnectedOutputPort->value();
     return *m_pValue;
 }
 
-void InputPort::update()
+void InputPort::setDefaultValue(float v)
+{
+    m_defaultValue = v;
+    std::fill(m_defaultBuffer, m_defaultBuffer + MaxBlockSize, v);
+}
+
+bool InputPort::isSilent() const
 {
     if (m_pConnectedOutputPort != nullptr) {
-        //m_pConnectedOutputPort->update();
+        return m_pConnectedOutputPort->isSilent();
+    }
+    return m_defaultValue == 0.0f;
+}
 
-        // Update audio unit directly bypassing the port chain.
-        m_pConnectedOutputPort->updateAudioUnit();
+Port::Rate InputPort::rate() const
+{
+    if (m_pConnectedOutputPort != nullptr) {
+        return m_pConnectedOutputPort->rate();
     }
+    return Rate_Constant;
 }
 
 int InputPort::index() const
@@ -74,11 +91,15 @@ void InputPort::connect(OutputPort *pOutput)
 {
     Q_ASSERT(pOutput != nullptr);
     m_pConnectedOutputPort = pOutput;
-    m_pValue = pOutput->valuePtr();
+    m_pSource = pOutput->samples();
+    m_pBuffer = m_pSource;
+    m_pValue = m_pBuffer;
 }
 
 void InputPort::disconnect()
 {
     m_pConnectedOutputPort = nullptr;
-    m_pValue = &m_defaultValue;
+    m_pSource = m_defaultBuffer;
+    m_pBuffer = m_pSource;
+    m_pValue = m_pBuffer;
 }
@@ -15,25 +15,44 @@
     Lesser General Public License for more details.
 */
 
+#include <algorithm>
 #include "SerializationContext.h"
 #include "AudioUnit.h"
 #include "OutputPort.h"
 
 OutputPort::OutputPort()
     : Port(Direction_Output),
-      m_value()
+      m_value(),
+      m_pBuffer(m_samples + 1),
+      m_silent(true),
+      m_silenceTracked(false),
+      m_rate(Rate_Audio)
 {
+    reset();
 }
 
 OutputPort::OutputPort(const QString &name)
     : Port(Direction_Output, name),
-      m_value()
+      m_value(),
+      m_pBuffer(m_samples + 1),
+      m_silent(true),
+      m_silenceTracked(false),
+      m_rate(Rate_Audio)
 {
+    reset();
 }
 
-void OutputPort::update()
+void OutputPort::reset()
 {
-    updateAudioUnit();
+    m_value = 0.0f;
+    std::fill(m_samples, m_samples + MaxBlockSize + 1, 0.0f);
+    m_silent = true;
+}
+
+void OutputPort::fillAll(float value)
+{
+    m_value = value;
+    std::fill(m_samples, m_samples + MaxBlockSize + 1, value);
 }
 
 int OutputPort::index() const
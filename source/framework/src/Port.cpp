@@ -15,11 +15,27 @@
     Lesser General Public License for more details.
 */
 
+#include <algorithm>
+#include <cmath>
 #include "Port.h"
 
+const int Port::MaxBlockSize;
+const float Port::SilenceThreshold = 1.0e-5f;
+
 Port::Port(Direction dir, const QString &name)
     : m_direction(dir),
       m_name(name),
       m_pAudioUnit(nullptr)
 {
 }
+
+bool Port::isSilentBlock(const float *pSamples, int nFrames)
+{
+    Q_ASSERT(pSamples != nullptr);
+
+    float peak = 0.0f;
+    for (int i = 0; i < nFrames; ++i) {
+        peak = std::max(peak, std::fabs(pSamples[i]));
+    }
+    return peak < SilenceThreshold;
+}
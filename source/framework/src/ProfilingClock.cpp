@@ -0,0 +1,47 @@
+/*
+                          qmusic
+
+    Copyright (C) 2015 Arthur Benilov,
+    arthur.benilov@gmail.com
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This software is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    Lesser General Public License for more details.
+*/
+
+#include <chrono>
+#include <thread>
+#include "ProfilingClock.h"
+
+namespace {
+
+/// Time used to calibrate the time stamp counter.
+const std::chrono::milliseconds cCalibrationTime(20);
+
+double calibrate()
+{
+#if defined(Q_PROCESSOR_X86)
+    auto startTime = std::chrono::steady_clock::now();
+    quint64 startTicks = ProfilingClock::ticks();
+    std::this_thread::sleep_for(cCalibrationTime);
+    quint64 ticks = ProfilingClock::ticks() - startTicks;
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    return ticks > 0 ? seconds / ticks : 0.0;
+#else
+    return 1.0e-9;
+#endif
+}
+
+} // namespace
+
+double ProfilingClock::secondsPerTick()
+{
+    static const double s_secondsPerTick = calibrate();
+    return s_secondsPerTick;
+}
@@ -0,0 +1,204 @@
+/*
+                          qmusic
+
+    Copyright (C) 2015 Arthur Benilov,
+    arthur.benilov@gmail.com
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This software is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    Lesser General Public License for more details.
+*/
+
+#include <QThread>
+#include "ProfilingClock.h"
+#include "RenderThreadPool.h"
+
+// The batch word is split into the generation, number of jobs and next job index.
+const int cJobBits(20);
+const quint64 cJobMask((quint64(1) << cJobBits) - 1);
+const int cMaxJobs = int(cJobMask);
+
+// Time an idle worker spins for before going to sleep, seconds.
+// This is well below a block period, so idle workers do not load the cores.
+const double cSpinTime(50.0e-6);
+
+// Default workers priority, until set to the audio thread one.
+const QThread::Priority cDefaultPriority(QThread::HighPriority);
+
+// Slot of the current thread, set by the workers.
+static thread_local int s_threadSlot = 0;
+
+static inline quint32 batchGeneration(quint64 batch) { return quint32(batch >> (2 * cJobBits)); }
+static inline int batchJobs(quint64 batch) { return int((batch >> cJobBits) & cJobMask); }
+static inline int batchNextJob(quint64 batch) { return int(batch & cJobMask); }
+
+class RenderThreadPool::Worker : public QThread
+{
+public:
+    Worker(RenderThreadPool *pPool, int slot)
+        : QThread(),
+          m_pPool(pPool),
+          m_slot(slot)
+    {
+    }
+
+protected:
+    void run() override
+    {
+        s_threadSlot = m_slot;
+        m_pPool->workerLoop();
+    }
+
+private:
+    RenderThreadPool *m_pPool;
+    int m_slot;
+};
+
+RenderThreadPool::RenderThreadPool(int nThreads)
+    : m_workers(),
+      m_batch(0),
+      m_completedJobs(0),
+      m_busy(false),
+      m_running(true),
+      m_sleepingWorkers(0),
+      m_spinTicks(quint64(cSpinTime / ProfilingClock::secondsPerTick())),
+      m_job(nullptr),
+      m_pContext(nullptr)
+{
+    if (nThreads < 0) {
+        nThreads = qMax(0, QThread::idealThreadCount() - 1);
+    }
+
+    for (int i = 0; i < nThreads; i++) {
+        Worker *pWorker = new Worker(this, i + 1);
+        m_workers.append(pWorker);
+        pWorker->start(cDefaultPriority);
+    }
+}
+
+RenderThreadPool::~RenderThreadPool()
+{
+    m_running = false;
+    m_mutex.lock();
+    m_wakeUp.wakeAll();
+    m_mutex.unlock();
+
+    for (Worker *pWorker : m_workers) {
+        pWorker->wait();
+    }
+    qDeleteAll(m_workers);
+}
+
+int RenderThreadPool::threadSlot()
+{
+    return s_threadSlot;
+}
+
+void RenderThreadPool::setPriority(QThread::Priority priority)
+{
+    for (Worker *pWorker : m_workers) {
+        pWorker->setPriority(priority);
+    }
+}
+
+void RenderThreadPool::run(int nJobs, Job job, void *pContext)
+{
+    Q_ASSERT(job != nullptr);
+    Q_ASSERT(nJobs <= cMaxJobs);
+
+    bool expected = false;
+    if (nJobs <= 1 || m_workers.isEmpty()
+            || !m_busy.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+        // Render in the calling thread
+        for (int i = 0; i < nJobs; i++) {
+            job(pContext, i);
+        }
+        return;
+    }
+
+    m_job = job;
+    m_pContext = pContext;
+    m_completedJobs.store(0, std::memory_order_relaxed);
+
+    // Publish the batch
+    quint32 generation = batchGeneration(m_batch.load(std::memory_order_relaxed)) + 1;
+    m_batch.store((quint64(generation) << (2 * cJobBits)) | (quint64(nJobs) << cJobBits),
+                  std::memory_order_seq_cst);
+
+    if (m_sleepingWorkers.load(std::memory_order_seq_cst) > 0) {
+        QMutexLocker lock(&m_mutex);
+        m_wakeUp.wakeAll();
+    }
+
+    // Participate, then wait for the jobs taken by the workers.
+    executeJobs(generation);
+    if (m_completedJobs.load(std::memory_order_acquire) < nJobs) {
+        QMutexLocker lock(&m_doneMutex);
+        while (m_completedJobs.load(std::memory_order_acquire) < nJobs) {
+            m_done.wait(&m_doneMutex);
+        }
+    }
+
+    m_busy.store(false, std::memory_order_release);
+}
+
+void RenderThreadPool::workerLoop()
+{
+    quint32 seenGeneration = batchGeneration(m_batch.load(std::memory_order_acquire));
+    quint64 idleStart = ProfilingClock::ticks();
+
+    while (m_running.load(std::memory_order_relaxed)) {
+        quint32 generation = batchGeneration(m_batch.load(std::memory_order_acquire));
+        if (generation != seenGeneration) {
+            seenGeneration = generation;
+            executeJobs(generation);
+            idleStart = ProfilingClock::ticks();
+            continue;
+        }
+
+        if (ProfilingClock::ticks() - idleStart < m_spinTicks) {
+            QThread::yieldCurrentThread();
+            continue;
+        }
+
+        // Idle for too long, go to sleep
+        QMutexLocker lock(&m_mutex);
+        m_sleepingWorkers.fetch_add(1, std::memory_order_seq_cst);
+        while (m_running.load(std::memory_order_relaxed)
+               && batchGeneration(m_batch.load(std::memory_order_seq_cst)) == seenGeneration) {
+            m_wakeUp.wait(&m_mutex);
+        }
+        m_sleepingWorkers.fetch_sub(1, std::memory_order_seq_cst);
+        idleStart = ProfilingClock::ticks();
+    }
+}
+
+void RenderThreadPool::executeJobs(quint32 generation)
+{
+    quint64 batch = m_batch.load(std::memory_order_acquire);
+
+    for (;;) {
+        if (batchGeneration(batch) != generation || batchNextJob(batch) >= batchJobs(batch)) {
+            // Batch is over or all its jobs have been claimed
+            break;
+        }
+
+        if (m_batch.compare_exchange_weak(batch, batch + 1, std::memory_order_acq_rel)) {
+            // The job is claimed: the batch cannot complete before it is done,
+            // so the job function and the context are stable here.
+            m_job(m_pContext, batchNextJob(batch));
+            if (m_completedJobs.fetch_add(1, std::memory_order_acq_rel) + 1 == batchJobs(batch)) {
+                // Last job of the batch: wake up the caller in case it waits
+                QMutexLocker lock(&m_doneMutex);
+                m_done.wakeAll();
+            }
+            batch = m_batch.load(std::memory_order_acquire);
+        }
+    }
+}
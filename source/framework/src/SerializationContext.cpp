@@ -109,6 +109,18 @@ ISerializable* SerializationContext::deserialize(const QVariant &handle)
     return pObject;
 }
 
+void SerializationContext::copyRecords(const SerializationContext &context)
+{
+    m_records.reserve(m_records.count() + context.m_records.count());
+    for (const Record &record : context.m_records) {
+        Record copy;
+        copy.pObject = nullptr;
+        copy.uid = record.uid;
+        copy.data = record.data;    // Implicitly shared
+        m_records.append(copy);
+    }
+}
+
 QByteArray SerializationContext::toByteArray() const
 {
     QByteArray buffer;
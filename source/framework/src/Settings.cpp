@@ -28,7 +28,8 @@ const QMap<Settings::Setting, QVariant> cDefaultSettings {
     {Settings::Setting_MidiInChannel, 1},
     {Settings::Setting_MidiOutIndex, -1},
     {Settings::Setting_SampleRate, 44100.0},
-    {Settings::Setting_BufferSize, 1024}
+    {Settings::Setting_BufferSize, 1024},
+    {Settings::Setting_CallbackRender, false}
 };
 
 const QMap<Settings::Setting, QString> cSettingsNameMap {
@@ -38,7 +39,8 @@ const QMap<Settings::Setting, QString> cSettingsNameMap {
     {Settings::Setting_MidiInChannel, "midiInChannel"},
     {Settings::Setting_MidiOutIndex, "midiOutIndex"},
     {Settings::Setting_SampleRate, "sampleRate"},
-    {Settings::Setting_BufferSize, "bufferSize"}
+    {Settings::Setting_BufferSize, "bufferSize"},
+    {Settings::Setting_CallbackRender, "callbackRender"}
 };
 
 Settings::Settings()
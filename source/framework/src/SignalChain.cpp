@@ -15,6 +15,9 @@
     Lesser General Public License for more details.
 */
 
+#include <functional>
+#include <algorithm>
+#include <QHash>
 #include <QThread>
 #include "Application.h"
 #include "MidiInputDevice.h"
@@ -30,10 +33,13 @@ const QString SignalChain::UID("SignalChain");
 
 SignalChain::SignalChain()
     : m_timeStep(0.0),
+      m_voiceIndex(0),
       m_started(false),
       m_enabled(false),
       m_updateEventsCounter(0),
-      m_audioUnits()
+      m_audioUnits(),
+      m_plan(),
+      m_feedbackGroups()
 {
 }
 
@@ -51,7 +57,9 @@ void SignalChain::start()
 
     // Make sure we reset the audio units before starting
     resetAllAudioUnits();
+    compile();
     startAllAudioUnits();
+    trackSilence();
     m_enabled = false;
     m_started = true;
 }
@@ -63,6 +71,8 @@ void SignalChain::stop()
     }
 
     stopAllAudioUnits();
+    m_plan.clear();
+    m_feedbackGroups.clear();
     m_started = false;
 }
 
@@ -106,22 +116,23 @@ void SignalChain::removeAudioUnit(IAudioUnit *pAudioUnit)
     m_audioUnits.removeOne(pAudioUnit);
 }
 
-void SignalChain::prepareUpdate()
+void SignalChain::processBlock(int nFrames)
 {
-    if (!m_enabled) {
-        return;
-    }
-
-    // Prepare audio units update
-    for (IAudioUnit *pAudioUnit : m_audioUnits) {
-        pAudioUnit->prepareUpdate();
+    const QVector<PlanStep> &plan = m_plan;
+    for (const PlanStep &step : plan) {
+        if (step.pAudioUnit != nullptr) {
+            step.pAudioUnit->updateBlock(nFrames);
+        } else {
+            processFeedbackGroup(m_feedbackGroups.at(step.feedbackGroup), nFrames);
+        }
     }
 }
 
 QList<ISignalChain *> SignalChain::clone(int instances)
 {
-    // Clone signal chain by serializing and then
-    // deserializing it back.
+    // Clone signal chain by serializing the prototype once and then
+    // deserializing each instance from the in-memory records: audio units
+    // are created by their plugins and restore their state from the copy.
 
     // Helper structure to keep track of connections
     struct Connection {
@@ -163,14 +174,16 @@ QList<ISignalChain *> SignalChain::clone(int instances)
     //
 
     QList<ISignalChain*> list;
+    list.reserve(instances);
 
     SignalChainFactory factory;
 
     // Create instances
     for (int i = 0; i < instances; i++) {
 
+        // Each instance is created out of the in-memory serialized prototype
         SerializationContext deserContext(&factory);
-        deserContext.fromByteArray(serContext.toByteArray());
+        deserContext.copyRecords(serContext);
 
         SignalChain *pSignalChainClone = deserContext.deserialize<SignalChain>();
 
@@ -197,28 +210,6 @@ void SignalChain::handleEvent(SignalChainEvent *pEvent)
     }
 }
 
-#ifdef PROFILING
-void SignalChain::profilingLog()
-{
-    QList<AudioUnitPlugin*> plugins;
-    for (IAudioUnit *pAudioUnit : m_audioUnits) {
-        AudioUnit *pAu = dynamic_cast<AudioUnit*>(pAudioUnit);
-        if (pAu != nullptr) {
-            AudioUnitPlugin *pPlugin = pAu->plugin();
-            if (!plugins.contains(pPlugin)) {
-                plugins.append(pPlugin);
-            }
-        }
-    }
-
-    logInfo("========= profiling =========");
-    for (AudioUnitPlugin *pPlugin : plugins) {
-        pPlugin->profilingLog();
-    }
-
-}
-#endif // PROFILING
-
 void SignalChain::serialize(QVariantMap &data, SerializationContext *pContext) const
 {
     Q_ASSERT(pContext != nullptr);
@@ -245,6 +236,205 @@ void SignalChain::deserialize(const QVariantMap &data, SerializationContext *pCo
     }
 }
 
+void SignalChain::compile()
+{
+    m_plan.clear();
+    m_feedbackGroups.clear();
+
+    QVector<AudioUnit*> units;
+    QHash<AudioUnit*, int> indices;
+    for (IAudioUnit *pIAu : m_audioUnits) {
+        AudioUnit *pAu = dynamic_cast<AudioUnit*>(pIAu);
+        if (pAu != nullptr) {
+            indices.insert(pAu, units.count());
+            units.append(pAu);
+        }
+    }
+
+    int n = units.count();
+
+    // Resolve units connected to the inputs of every unit
+    QVector<QVector<int>> sources(n);
+    for (int i = 0; i < n; ++i) {
+        for (InputPort *pInput : units.at(i)->inputs()) {
+            OutputPort *pOutput = pInput->connectedOutputPort();
+            if (pOutput == nullptr) {
+                continue;
+            }
+            QHash<AudioUnit*, int>::const_iterator it = indices.constFind(static_cast<AudioUnit*>(pOutput->audioUnit()));
+            if (it != indices.constEnd() && !sources[i].contains(it.value())) {
+                sources[i].append(it.value());
+            }
+        }
+    }
+
+    // Mark units contributing to the terminal units
+    QVector<bool> used(n, false);
+    QVector<int> stack;
+    for (int i = 0; i < n; ++i) {
+        if (units.at(i)->outputs().isEmpty()) {
+            used[i] = true;
+            stack.append(i);
+        }
+    }
+    while (!stack.isEmpty()) {
+        int i = stack.takeLast();
+        for (int s : sources.at(i)) {
+            if (!used.at(s)) {
+                used[s] = true;
+                stack.append(s);
+            }
+        }
+    }
+
+    // Find strongly connected units (Tarjan's algorithm).
+    // Traversing from units to their sources, the sets of units
+    // are completed in topological order (sources first).
+    QVector<int> discoveryOrder(n, -1);
+    QVector<int> lowLink(n, 0);
+    QVector<bool> onStack(n, false);
+    int counter = 0;
+
+    std::function<void(int)> connect = [&](int v) {
+        discoveryOrder[v] = counter;
+        lowLink[v] = counter;
+        ++counter;
+        stack.append(v);
+        onStack[v] = true;
+
+        for (int s : sources.at(v)) {
+            if (discoveryOrder.at(s) < 0) {
+                connect(s);
+                lowLink[v] = qMin(lowLink.at(v), lowLink.at(s));
+            } else if (onStack.at(s)) {
+                lowLink[v] = qMin(lowLink.at(v), discoveryOrder.at(s));
+            }
+        }
+
+        if (lowLink.at(v) == discoveryOrder.at(v)) {
+            QVector<int> component;
+            int u = -1;
+            do {
+                u = stack.takeLast();
+                onStack[u] = false;
+                component.append(u);
+            } while (u != v);
+            schedule(units, discoveryOrder, sources, component);
+        }
+    };
+
+    for (int i = 0; i < n; ++i) {
+        if (used.at(i) && discoveryOrder.at(i) < 0) {
+            connect(i);
+        }
+    }
+}
+
+void SignalChain::trackSilence()
+{
+    QList<AudioUnit*> units;
+    for (IAudioUnit *pIAu : m_audioUnits) {
+        AudioUnit *pAu = dynamic_cast<AudioUnit*>(pIAu);
+        if (pAu != nullptr) {
+            units.append(pAu);
+            for (OutputPort *pOutput : pAu->outputs()) {
+                pOutput->setSilenceTracked(false);
+            }
+        }
+    }
+
+    for (AudioUnit *pAu : units) {
+        if (pAu->tailLength() < 0.0f) {
+            continue;
+        }
+        for (InputPort *pInput : pAu->inputs()) {
+            OutputPort *pOutput = pInput->connectedOutputPort();
+            if (pOutput != nullptr) {
+                pOutput->setSilenceTracked(true);
+            }
+        }
+    }
+}
+
+void SignalChain::schedule(const QVector<AudioUnit*> &units,
+                           const QVector<int> &discoveryOrder,
+                           const QVector<QVector<int>> &sources,
+                           QVector<int> component)
+{
+    PlanStep step;
+
+    if (component.count() == 1 && !sources.at(component.first()).contains(component.first())) {
+        // Regular unit, updated by blocks
+        step.pAudioUnit = units.at(component.first());
+        step.feedbackGroup = -1;
+        m_plan.append(step);
+        return;
+    }
+
+    // Feedback loop: units discovered last are closer to the loop's sources
+    std::sort(component.begin(), component.end(), [&discoveryOrder](int a, int b) {
+        return discoveryOrder.at(a) > discoveryOrder.at(b);
+    });
+
+    FeedbackGroup group;
+    for (int i : component) {
+        group.audioUnits.append(units.at(i));
+    }
+
+    for (int position = 0; position < component.count(); ++position) {
+        AudioUnit *pAu = units.at(component.at(position));
+        for (InputPort *pInput : pAu->inputs()) {
+            // Connections from the units that are updated later
+            // within the group (or from the unit itself) are delayed.
+            int delay = 0;
+            if (pInput->connectedOutputPort() != nullptr) {
+                AudioUnit *pSource = static_cast<AudioUnit*>(pInput->connectedOutputPort()->audioUnit());
+                int sourcePosition = group.audioUnits.indexOf(pSource);
+                if (sourcePosition >= position) {
+                    delay = 1;
+                }
+            }
+            group.inputs.append(pInput);
+            group.inputDelays.append(delay);
+        }
+        for (OutputPort *pOutput : pAu->outputs()) {
+            group.outputs.append(pOutput);
+        }
+    }
+
+    step.pAudioUnit = nullptr;
+    step.feedbackGroup = m_feedbackGroups.count();
+    m_feedbackGroups.append(group);
+    m_plan.append(step);
+}
+
+void SignalChain::processFeedbackGroup(const FeedbackGroup &group, int nFrames)
+{
+    int nInputs = group.inputs.count();
+
+    for (int i = 0; i < nFrames; ++i) {
+        for (int k = 0; k < nInputs; ++k) {
+            group.inputs.at(k)->setBlockOffset(i - group.inputDelays.at(k));
+        }
+        for (OutputPort *pOutput : group.outputs) {
+            pOutput->setBlockOffset(i);
+        }
+        for (AudioUnit *pAu : group.audioUnits) {
+            pAu->updateBlock(1);
+        }
+    }
+
+    // Restore ports and keep the last samples for the delayed connections.
+    for (InputPort *pInput : group.inputs) {
+        pInput->setBlockOffset(0);
+    }
+    for (OutputPort *pOutput : group.outputs) {
+        pOutput->setBlockOffset(0);
+        pOutput->holdLastSample(nFrames);
+        pOutput->updateSilence(nFrames);
+    }
+}
+
 void SignalChain::startAllAudioUnits()
 {
     for (IAudioUnit *pAudioUnit : m_audioUnits) {
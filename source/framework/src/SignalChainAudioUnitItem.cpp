@@ -35,6 +35,12 @@ const QSize cIconSize(16, 16);
 const QColor cTitleColor(92, 170, 200);
 const QColor cSelectionColor(255, 159, 40);
 
+/// DSP load below which no overlay is shown.
+const float cDspLoadMin(0.001f);
+
+/// DSP load shown with the hottest color.
+const float cDspLoadMax(0.25f);
+
 const QString SignalChainAudioUnitItem::UID("SignalChainAudioUnitItem");
 
 SignalChainAudioUnitItem::SignalChainAudioUnitItem(QGraphicsItem *pParent)
@@ -234,6 +240,15 @@ void SignalChainAudioUnitItem::paint(QPainter *pPainter, const QStyleOptionGraph
         }
     }
 
+    if (m_dspLoad >= cDspLoadMin) {
+        // Heat overlay, from transparent green to opaque red
+        float level = qMin(1.0f, m_dspLoad / cDspLoadMax);
+        QColor heatColor = QColor::fromHsvF((1.0 - level) / 3.0, 1.0, 1.0, 0.15 + 0.45 * level);
+        pPainter->setPen(Qt::NoPen);
+        pPainter->setBrush(heatColor);
+        pPainter->drawPath(path());
+    }
+
     // Draw icon if there is header present
     if (m_pTitleTextItem != nullptr) {
         // But only if not disabled
@@ -253,6 +268,18 @@ void SignalChainAudioUnitItem::init()
 
     m_pTitleTextItem = nullptr;
     m_pAudioUnitGraphicsItem = nullptr;
+    m_dspLoad = 0.0f;
+}
+
+void SignalChainAudioUnitItem::setDspLoad(float load)
+{
+    if (qFuzzyCompare(1.0f + load, 1.0f + m_dspLoad)) {
+        return;
+    }
+
+    m_dspLoad = load;
+    setToolTip(load >= cDspLoadMin ? QObject::tr("DSP load: %1%").arg(load * 100.0, 0, 'f', 1) : QString());
+    update();
 }
 
 void SignalChainAudioUnitItem::createDecoration()
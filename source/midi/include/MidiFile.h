@@ -0,0 +1,108 @@
+/*
+                          qmusic
+
+    Copyright (C) 2015 Arthur Benilov,
+    arthur.benilov@gmail.com
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This software is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    Lesser General Public License for more details.
+*/
+
+#ifndef MIDIFILE_H
+#define MIDIFILE_H
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include "MidiApi.h"
+#include "MidiMessage.h"
+
+/**
+ * @brief Standard MIDI File reader.
+ *
+ * This class parses format 0 and format 1 MIDI files.
+ * Channel messages of all the tracks are merged into a single
+ * list ordered by time. The tempo changes are applied, so that
+ * the event times are given in seconds.
+ * Meta events (except the tempo) and system exclusive messages are skipped.
+ */
+class QMUSIC_MIDI_API MidiFile
+{
+public:
+
+    /// Timed MIDI message.
+    struct Event {
+        double time;            ///< Time from the file start, seconds.
+        MidiMessage message;    ///< MIDI message.
+    };
+
+    /**
+     * Construct MIDI file reader.
+     * @param path Path to the file.
+     */
+    MidiFile(const QString &path);
+
+    /**
+     * Load and parse the file.
+     * @return true if loaded successfully.
+     */
+    bool load();
+
+    /**
+     * Returns the file format (0, 1 or 2).
+     * @return
+     */
+    int format() const { return m_format; }
+
+    /**
+     * Returns number of tracks in the file.
+     * @return
+     */
+    int numberOfTracks() const { return m_nTracks; }
+
+    /**
+     * Returns all channel messages ordered by time.
+     * @return
+     */
+    const QList<Event>& events() const { return m_events; }
+
+    /**
+     * Returns time of the last event, including end of track meta events.
+     * @return Duration in seconds.
+     */
+    double duration() const { return m_duration; }
+
+    QString errorText() const { return m_errorText; }
+
+private:
+
+    /// Event time in ticks, before applying the tempo map.
+    struct TickEvent {
+        qint64 tick;            ///< Absolute time in ticks.
+        int order;              ///< Order within the file, to keep sorting stable.
+        bool isTempo;           ///< Whether this is a tempo change.
+        unsigned int data;      ///< Raw MIDI message, or tempo in microseconds per quarter note.
+    };
+
+    bool parse(const QByteArray &data);
+    bool parseTrack(const char *pData, int size, QList<TickEvent> &events);
+    void applyTempoMap(QList<TickEvent> &events, qint64 lastTick);
+    void setError(const QString &text);
+
+    QString m_path;
+    int m_format;
+    int m_nTracks;
+    int m_division;     ///< Ticks per quarter note, or SMPTE ticks per second if negative.
+    QList<Event> m_events;
+    double m_duration;
+    QString m_errorText;
+};
+
+#endif // MIDIFILE_H
@@ -65,7 +65,12 @@ public:
     void addListener(IMidiInputListener *pListener);
     void removeListener(IMidiInputListener *pListener);
 
-    void acceptMessage(unsigned int msg);
+    /**
+     * Accept a raw MIDI message.
+     * @param msg Raw message data.
+     * @param deltaTime Time elapsed since the previous message, in seconds.
+     */
+    void acceptMessage(unsigned int msg, double deltaTime = 0.0);
 
 private:
 
@@ -75,6 +80,13 @@ private:
      */
     bool validateDevice();
 
+    /**
+     * Compute the timestamp of a received message.
+     * @param deltaTime Time elapsed since the previous message, in seconds.
+     * @return Message timestamp, as given by MidiMessage::currentTime().
+     */
+    double updateTimestamp(double deltaTime);
+
     void notifyListeners(const MidiMessage &msg);
 
     MidiInputDevicePrivate *m;
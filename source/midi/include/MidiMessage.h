@@ -105,6 +105,14 @@ public:
     bool operator !=(const MidiMessage &msg) const;
 
     unsigned int rawData() const { return m_rawData; }
+
+    /**
+     * Returns the time this message has been received at.
+     * @see currentTime()
+     * @return Time in seconds, or negative value if unknown.
+     */
+    double timestamp() const { return m_timestamp; }
+    void setTimestamp(double t) { m_timestamp = t; }
     unsigned int dataFirstByte() const;
     unsigned int dataSecondByte() const;
     unsigned int dataWord() const;
@@ -145,8 +153,15 @@ public:
     static QString controllerNumberToString(unsigned int ctrl);
     static MidiMessage programChange(unsigned int channel, unsigned int prog);
 
+    /**
+     * Returns current time of the monotonic clock used for messages timestamps.
+     * @return Time in seconds.
+     */
+    static double currentTime();
+
 private:
     unsigned int m_rawData;
+    double m_timestamp; ///< Reception time, seconds.
 };
 
 Q_DECLARE_METATYPE(MidiMessage)
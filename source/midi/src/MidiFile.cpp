@@ -0,0 +1,297 @@
+/*
+                          qmusic
+
+    Copyright (C) 2015 Arthur Benilov,
+    arthur.benilov@gmail.com
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This software is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    Lesser General Public License for more details.
+*/
+
+#include <algorithm>
+#include <QFile>
+#include "MidiFile.h"
+
+/// Default tempo, microseconds per quarter note (120 BPM).
+const unsigned int cDefaultTempo(500000);
+
+namespace {
+
+unsigned int readBigEndian(const char *p, int nBytes)
+{
+    unsigned int v = 0;
+    for (int i = 0; i < nBytes; i++) {
+        v = (v << 8) | (unsigned char)p[i];
+    }
+    return v;
+}
+
+/**
+ * Read a variable-length quantity.
+ * @param p Data pointer, advanced past the value.
+ * @param pEnd End of the data.
+ * @param value Decoded value.
+ * @return false if the data is truncated.
+ */
+bool readVariableLength(const char *&p, const char *pEnd, unsigned int &value)
+{
+    value = 0;
+    for (int i = 0; i < 4; i++) {
+        if (p >= pEnd) {
+            return false;
+        }
+        unsigned char c = (unsigned char)*p++;
+        value = (value << 7) | (c & 0x7F);
+        if ((c & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+MidiFile::MidiFile(const QString &path)
+    : m_path(path),
+      m_format(0),
+      m_nTracks(0),
+      m_division(0),
+      m_events(),
+      m_duration(0.0),
+      m_errorText()
+{
+}
+
+bool MidiFile::load()
+{
+    m_events.clear();
+    m_duration = 0.0;
+    m_errorText.clear();
+
+    QFile file(m_path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        setError(QString("Unable to open %1").arg(m_path));
+        return false;
+    }
+
+    return parse(file.readAll());
+}
+
+bool MidiFile::parse(const QByteArray &data)
+{
+    const char *p = data.constData();
+    const char *pEnd = p + data.size();
+
+    if (data.size() < 14 || qstrncmp(p, "MThd", 4) != 0) {
+        setError("Not a standard MIDI file");
+        return false;
+    }
+
+    unsigned int headerSize = readBigEndian(p + 4, 4);
+    if (headerSize < 6 || p + 8 + headerSize > pEnd) {
+        setError("Invalid MIDI file header");
+        return false;
+    }
+
+    m_format = int(readBigEndian(p + 8, 2));
+    m_nTracks = int(readBigEndian(p + 10, 2));
+    m_division = qint16(readBigEndian(p + 12, 2));
+    if (m_division == 0) {
+        setError("Invalid MIDI file time division");
+        return false;
+    }
+    p += 8 + headerSize;
+
+    QList<TickEvent> events;
+    qint64 lastTick = 0;
+    qint64 trackOffset = 0;
+    for (int track = 0; track < m_nTracks; track++) {
+        // Skip unknown chunks
+        while (p + 8 <= pEnd && qstrncmp(p, "MTrk", 4) != 0) {
+            p += 8 + readBigEndian(p + 4, 4);
+        }
+        if (p + 8 > pEnd) {
+            setError(QString("Missing MIDI track %1").arg(track));
+            return false;
+        }
+
+        int size = int(readBigEndian(p + 4, 4));
+        if (p + 8 + size > pEnd) {
+            setError(QString("Truncated MIDI track %1").arg(track));
+            return false;
+        }
+
+        QList<TickEvent> trackEvents;
+        if (!parseTrack(p + 8, size, trackEvents)) {
+            return false;
+        }
+
+        qint64 trackLength = trackEvents.isEmpty() ? 0 : trackEvents.last().tick;
+
+        if (m_format == 2) {
+            // Format 2 tracks are independent sequences played one after another:
+            // shift the track by the length of the previous ones.
+            for (TickEvent &event : trackEvents) {
+                event.tick += trackOffset;
+            }
+            trackOffset += trackLength;
+            lastTick = trackOffset;
+        } else {
+            lastTick = qMax(lastTick, trackLength);
+        }
+
+        for (TickEvent &event : trackEvents) {
+            event.order = events.count();
+            events.append(event);
+        }
+        p += 8 + size;
+    }
+
+    applyTempoMap(events, lastTick);
+    return true;
+}
+
+bool MidiFile::parseTrack(const char *pData, int size, QList<TickEvent> &events)
+{
+    const char *p = pData;
+    const char *pEnd = pData + size;
+    qint64 tick = 0;
+    unsigned char runningStatus = 0;
+
+    while (p < pEnd) {
+        unsigned int delta;
+        if (!readVariableLength(p, pEnd, delta) || p >= pEnd) {
+            setError("Truncated MIDI event");
+            return false;
+        }
+        tick += delta;
+
+        unsigned char status = (unsigned char)*p;
+        if (status == 0xFF) {
+            // Meta event
+            if (p + 2 > pEnd) {
+                setError("Truncated MIDI meta event");
+                return false;
+            }
+            unsigned char type = (unsigned char)p[1];
+            p += 2;
+            unsigned int length;
+            if (!readVariableLength(p, pEnd, length) || p + length > pEnd) {
+                setError("Truncated MIDI meta event");
+                return false;
+            }
+            if (type == 0x51 && length == 3) {
+                TickEvent event;
+                event.tick = tick;
+                event.order = 0;
+                event.isTempo = true;
+                event.data = readBigEndian(p, 3);
+                events.append(event);
+            } else if (type == 0x2F) {
+                // End of track
+                TickEvent event;
+                event.tick = tick;
+                event.order = 0;
+                event.isTempo = true;
+                event.data = 0;
+                events.append(event);
+                break;
+            }
+            p += length;
+        } else if (status == 0xF0 || status == 0xF7) {
+            // System exclusive
+            p++;
+            unsigned int length;
+            if (!readVariableLength(p, pEnd, length) || p + length > pEnd) {
+                setError("Truncated MIDI system exclusive event");
+                return false;
+            }
+            p += length;
+            runningStatus = 0;
+        } else {
+            // Channel message, possibly using the running status
+            if (status & 0x80) {
+                runningStatus = status;
+                p++;
+            } else if (runningStatus == 0) {
+                setError("MIDI data byte without status");
+                return false;
+            }
+
+            unsigned char type = runningStatus & 0xF0;
+            int nDataBytes = (type == 0xC0 || type == 0xD0) ? 1 : 2;
+            if (p + nDataBytes > pEnd) {
+                setError("Truncated MIDI channel message");
+                return false;
+            }
+
+            unsigned int d1 = (unsigned char)p[0] & 0x7F;
+            unsigned int d2 = nDataBytes == 2 ? ((unsigned char)p[1] & 0x7F) : 0;
+            p += nDataBytes;
+
+            TickEvent event;
+            event.tick = tick;
+            event.order = 0;
+            event.isTempo = false;
+            event.data = (runningStatus << 16) | (d1 << 8) | d2;
+            events.append(event);
+        }
+    }
+
+    return true;
+}
+
+void MidiFile::applyTempoMap(QList<TickEvent> &events, qint64 lastTick)
+{
+    std::stable_sort(events.begin(), events.end(), [](const TickEvent &a, const TickEvent &b) {
+        return a.tick < b.tick;
+    });
+
+    double time = 0.0;
+    qint64 tick = 0;
+    double secondsPerTick;
+
+    if (m_division > 0) {
+        secondsPerTick = cDefaultTempo * 1.0e-6 / m_division;
+    } else {
+        // SMPTE: frames per second in the upper byte (negative), ticks per frame in the lower one.
+        int fps = -(m_division >> 8);
+        int ticksPerFrame = m_division & 0xFF;
+        if (fps == 29) {
+            fps = 30;   // 29.97 drop frame is 30 frames per second in tick time
+        }
+        secondsPerTick = 1.0 / (fps * qMax(1, ticksPerFrame));
+    }
+
+    for (const TickEvent &event : events) {
+        time += (event.tick - tick) * secondsPerTick;
+        tick = event.tick;
+
+        if (event.isTempo) {
+            // Tempo changes only apply to the metrical time
+            if (event.data > 0 && m_division > 0) {
+                secondsPerTick = event.data * 1.0e-6 / m_division;
+            }
+        } else {
+            Event e;
+            e.time = time;
+            e.message = MidiMessage(event.data);
+            e.message.setTimestamp(time);
+            m_events.append(e);
+        }
+    }
+
+    m_duration = time + (lastTick - tick) * secondsPerTick;
+}
+
+void MidiFile::setError(const QString &text)
+{
+    m_errorText = text;
+}
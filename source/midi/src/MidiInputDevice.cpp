@@ -28,12 +28,15 @@ struct MidiInputDevicePrivate
     RtMidiIn *pMidiIn;
     bool deviceIsOpen;
     QList<IMidiInputListener*> listeners;
+    double timestamp;   ///< Last message timestamp.
 };
 
+/// Maximal allowed drift of accumulated message time from the system clock, in seconds.
+const double cMaxTimestampDrift(0.05);
+
 /// MIDI input callback function
 void midiInCallback(double deltatime, std::vector<unsigned char> *pMessage, void *pUserData )
 {
-    Q_UNUSED(deltatime);
     Q_ASSERT(pUserData != nullptr);
     MidiInputDevice *pDev = static_cast<MidiInputDevice*>(pUserData);
 
@@ -44,7 +47,7 @@ void midiInCallback(double deltatime, std::vector<unsigned char> *pMessage, void
             msg = (msg << 8) |((unsigned char)pMessage->at(i));
         }
 
-        pDev->acceptMessage(msg);
+        pDev->acceptMessage(msg, deltatime);
     }
 }
 
@@ -54,6 +57,7 @@ MidiInputDevice::MidiInputDevice(int number)
     m = new MidiInputDevicePrivate;
     m->pMidiIn = new RtMidiIn();
     m->deviceIsOpen = false;
+    m->timestamp = -1.0;
     setValid(validateDevice());
 }
 
@@ -98,6 +102,7 @@ bool MidiInputDevice::start()
         return false;
     }
 
+    m->timestamp = -1.0;
     m->pMidiIn->setCallback(&midiInCallback, this);
     return true;
 }
@@ -137,7 +142,7 @@ void MidiInputDevice::removeListener(IMidiInputListener *pListener)
     m->listeners.removeAll(pListener);
 }
 
-void MidiInputDevice::acceptMessage(unsigned int msg)
+void MidiInputDevice::acceptMessage(unsigned int msg, double deltaTime)
 {
     if (!m->deviceIsOpen) {
         return;
@@ -145,6 +150,7 @@ void MidiInputDevice::acceptMessage(unsigned int msg)
 
     // Message received.
     MidiMessage midiMessage(msg);
+    midiMessage.setTimestamp(updateTimestamp(deltaTime));
 
     // Pass the message in case of the channel match.
     if (midiMessage.channel() == channel()) {
@@ -164,6 +170,24 @@ bool MidiInputDevice::validateDevice()
     return true;
 }
 
+double MidiInputDevice::updateTimestamp(double deltaTime)
+{
+    // RtMidi provides the time elapsed since the previous message, which is
+    // more accurate than the callback invocation time. Accumulated deltas are
+    // anchored to the system clock and re-synchronized if they drift away.
+    double now = MidiMessage::currentTime();
+    if (m->timestamp < 0.0) {
+        m->timestamp = now;
+    } else {
+        m->timestamp += deltaTime;
+        if (qAbs(now - m->timestamp) > cMaxTimestampDrift) {
+            m->timestamp = now;
+        }
+    }
+
+    return m->timestamp;
+}
+
 void MidiInputDevice::notifyListeners(const MidiMessage &msg)
 {
     for (IMidiInputListener *pListener : m->listeners) {
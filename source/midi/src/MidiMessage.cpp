@@ -15,6 +15,7 @@
     Lesser General Public License for more details.
 */
 
+#include <chrono>
 #include <QHash>
 #include "MidiMessage.h"
 
@@ -40,17 +41,20 @@ const QHash<MidiMessage::Status, QString> midiStatusToString {
 };
 
 MidiMessage::MidiMessage()
-    : m_rawData(0)
+    : m_rawData(0),
+      m_timestamp(-1.0)
 {
 }
 
 MidiMessage::MidiMessage(unsigned int raw)
-    : m_rawData(raw)
+    : m_rawData(raw),
+      m_timestamp(-1.0)
 {
 }
 
 MidiMessage::MidiMessage(const MidiMessage &msg)
-    : m_rawData(msg.m_rawData)
+    : m_rawData(msg.m_rawData),
+      m_timestamp(msg.m_timestamp)
 {
 }
 
@@ -58,6 +62,7 @@ MidiMessage& MidiMessage::operator =(const MidiMessage &msg)
 {
     if (this != &msg) {
         m_rawData = msg.m_rawData;
+        m_timestamp = msg.m_timestamp;
     }
     return *this;
 }
@@ -221,6 +226,12 @@ MidiMessage MidiMessage::programChange(unsigned int channel, unsigned int prog)
     return MidiMessage(raw);
 }
 
+double MidiMessage::currentTime()
+{
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::duration<double>>(now).count();
+}
+
 QDebug operator <<(QDebug dbg, const MidiMessage &msg)
 {
     dbg.nospace() << msg.channel() << " ";
@@ -47,6 +47,26 @@ void Adder::process()
     m_pOutput->setValue(m_pInputA->getValue() + m_pInputB->getValue());
 }
 
+void Adder::processBlock(int nFrames)
+{
+    const float *pA = m_pInputA->buffer();
+    const float *pB = m_pInputB->buffer();
+    float *pOut = m_pOutput->buffer();
+
+    if (m_pInputB->rate() != Port::Rate_Audio) {
+        // Offset does not change within the block
+        const float b = pB[0];
+        for (int i = 0; i < nFrames; ++i) {
+            pOut[i] = pA[i] + b;
+        }
+        return;
+    }
+
+    for (int i = 0; i < nFrames; ++i) {
+        pOut[i] = pA[i] + pB[i];
+    }
+}
+
 QGraphicsItem* Adder::graphicsItem()
 {
     QGraphicsPathItem *pItem = new QGraphicsPathItem();
@@ -50,6 +50,7 @@ protected:
     void processStart();
     void processStop();
     void process();
+    void processBlock(int nFrames) override;
     void reset();
 
 private:
@@ -59,7 +60,6 @@ private:
 
     BiquadFilter m_filter;
     Type m_filterType;
-    float m_f;
 
     InputPort *m_pInput;
     InputPort *m_pInputCutOffFreq;
@@ -68,6 +68,7 @@ private:
     QtVariantProperty *m_pFilterType;
     QtVariantProperty *m_pQFactor;
     QtVariantProperty *m_pDbGain;
+    QtVariantProperty *m_pModulationInterval;
 };
 
 #endif // AU_BIQUAD_H
@@ -23,7 +23,6 @@
 #include "ISignalChain.h"
 #include "BiQuadFilterUnit.h"
 
-
 BiQuadFilterUnit::BiQuadFilterUnit(AudioUnitPlugin *pPlugin)
     : AudioUnit(pPlugin),
       m_filter()
@@ -44,6 +43,7 @@ void BiQuadFilterUnit::serialize(QVariantMap &data, SerializationContext *pConte
     data["filterType"] = m_pFilterType->value();
     data["filterQ"] = m_pQFactor->value();
     data["filterDB"] = m_pDbGain->value();
+    data["modulationInterval"] = m_pModulationInterval->value();
     AudioUnit::serialize(data, pContext);
 }
 
@@ -53,6 +53,9 @@ void BiQuadFilterUnit::deserialize(const QVariantMap &data, SerializationContext
     m_pFilterType->setValue(data["filterType"]);
     m_pQFactor->setValue(data["filterQ"]);
     m_pDbGain->setValue(data["filterDB"]);
+    if (data.contains("modulationInterval")) {
+        m_pModulationInterval->setValue(data["modulationInterval"]);
+    }
     AudioUnit::deserialize(data, pContext);
 }
 
@@ -60,6 +63,7 @@ void BiQuadFilterUnit::processStart()
 {
     m_filter.setSampleRate(signalChain()->sampleRate());
     setValues();
+    m_filter.reset();
 }
 
 void BiQuadFilterUnit::processStop()
@@ -68,14 +72,18 @@ void BiQuadFilterUnit::processStop()
 
 void BiQuadFilterUnit::process()
 {
-    float f = m_pInputCutOffFreq->getValue();
-    if (m_f != f) {
-        m_filter.setCutOffFrequency(f);
-        m_f = f;
-    }
+    m_filter.setCutOffFrequency(m_pInputCutOffFreq->getValue());
     m_pOutput->setValue(m_filter.doFilter(m_pInput->getValue()));
 }
 
+void BiQuadFilterUnit::processBlock(int nFrames)
+{
+    // Cut-off frequency is sampled at the modulation interval,
+    // the filter interpolates the coefficients in between.
+    m_filter.processModulatedBlock(m_pInput->buffer(), m_pInputCutOffFreq->buffer(), m_pOutput->buffer(), nFrames,
+                                   m_pInputCutOffFreq->rate() == Port::Rate_Audio);
+}
+
 void BiQuadFilterUnit::reset()
 {
     m_filter.reset();
@@ -99,9 +107,14 @@ void BiQuadFilterUnit::createProperties()
     m_pDbGain->setValue(1.0);
     m_pDbGain->setAttribute("singleStep", 0.1);
 
+    m_pModulationInterval = propertyManager()->addProperty(QtVariantPropertyManager::enumTypeId(), "Modulation interval");
+    m_pModulationInterval->setAttribute("enumNames", BiquadFilter::modulationIntervalNames());
+    m_pModulationInterval->setValue(BiquadFilter::cDefaultModulationInterval);
+
     pRoot->addSubProperty(m_pFilterType);
     pRoot->addSubProperty(m_pQFactor);
     pRoot->addSubProperty(m_pDbGain);
+    pRoot->addSubProperty(m_pModulationInterval);
 
     // Properties change handler
     QObject::connect (propertyManager(), &QtVariantPropertyManager::propertyChanged, [this](QtProperty *pProperty){
@@ -127,4 +140,5 @@ void BiQuadFilterUnit::setValues()
     m_filter.setType(cType.at(m_pFilterType->value().toInt()));
     m_filter.setQFactor(m_pQFactor->value().toFloat());
     m_filter.setDBGain(m_pDbGain->value().toFloat());
+    m_filter.setModulationInterval(m_pModulationInterval->value().toInt());
 }
@@ -29,6 +29,7 @@ Constant::Constant(AudioUnitPlugin *pPlugin)
     : AudioUnit(pPlugin)
 {
     m_pOutput = addOutput();
+    m_pOutput->setRate(Port::Rate_Constant);
     createProperties();
 
     m_pValueItem = nullptr;
@@ -49,7 +50,8 @@ void Constant::processStop()
 
 void Constant::process()
 {
-    // Constant does not change while processing
+    // Constant does not change while processing,
+    // its output is only evaluated on start or value change.
 }
 
 void Constant::reset()
@@ -107,6 +109,7 @@ void Constant::createProperties()
                 // Update the output immediately
                 // TODO: This operation in not atomic
                 m_pOutput->setValue(pV->value().toFloat());
+                updateConstantOutputs();
             }
         }
     });
@@ -19,8 +19,8 @@
 #define AU_DELAY_H
 
 #include "AudioUnit.h"
+#include "DelayLine.h"
 
-class DelayLine;
 class QtVariantProperty;
 
 class Delay : public AudioUnit
@@ -34,26 +34,40 @@ public:
     void serialize(QVariantMap &data, SerializationContext *pContext) const;
     void deserialize(const QVariantMap &data, SerializationContext *pContext);
 
+    float tailLength() const override;
+    bool isInputSilent() const override;
+
 protected:
 
     void processStart();
     void processStop();
     void process();
+    void processBlock(int nFrames) override;
     void reset();
 
 private:
 
     void createProperties();
+    void setValues();
+
+    /// Returns the delay in samples for a fraction of the maximum delay.
+    float delay(float ratio) const;
 
     InputPort *m_pInput;
     InputPort *m_pDelayRatioInput;
     OutputPort *m_pOutput;
 
     DelayLine *m_pDelayLine;
+    DelayLine::Interpolation m_interpolation;
+    DelayLine::Tap m_tap;
 
     int m_delaySamples;
 
+    /// Delays of the block when modulated at audio rate, in samples.
+    float m_delays[Port::MaxBlockSize];
+
     QtVariantProperty *m_pPropDelay;
+    QtVariantProperty *m_pPropInterpolation;
 };
 
 #endif // AU_DELAY_H
@@ -31,6 +31,8 @@ Delay::Delay(AudioUnitPlugin *pPlugin)
     m_pOutput = addOutput("out");
 
     m_pDelayLine = nullptr;
+    m_interpolation = DelayLine::Interpolation_Linear;
+    m_delaySamples = 0;
 
     createProperties();
 }
@@ -44,6 +46,7 @@ void Delay::serialize(QVariantMap &data, SerializationContext *pContext) const
 {
     Q_ASSERT(pContext != nullptr);
     data["delay"] = m_pPropDelay->value();
+    data["interpolation"] = m_pPropInterpolation->value();
     AudioUnit::serialize(data, pContext);
 }
 
@@ -51,19 +54,35 @@ void Delay::deserialize(const QVariantMap &data, SerializationContext *pContext)
 {
     Q_ASSERT(pContext != nullptr);
     m_pPropDelay->setValue(data["delay"]);
+    m_pPropInterpolation->setValue(data.value("interpolation", 1));
     AudioUnit::deserialize(data, pContext);
 }
 
+float Delay::tailLength() const
+{
+    // Delay line has no feedback: it is flushed after the maximum delay time.
+    return m_delaySamples * float(signalChain()->timeStep());
+}
+
+bool Delay::isInputSilent() const
+{
+    return m_pInput->isSilent();
+}
+
 void Delay::processStart()
 {
     float delayMs = m_pPropDelay->value().toFloat();
     m_delaySamples = delayMs / 1000.0 / signalChain()->timeStep() + 1;
-    if (m_pDelayLine == nullptr || m_pDelayLine->samplesMax() != m_delaySamples) {
-        // (re-)allocate delay line object
-        delete m_pDelayLine;
-        m_pDelayLine = new DelayLine(m_delaySamples);
+    if (m_pDelayLine == nullptr) {
+        m_pDelayLine = new DelayLine(m_delaySamples, Port::MaxBlockSize);
+    } else {
+        // The buffer is only reallocated if the delay does not fit anymore
+        m_pDelayLine->allocate(m_delaySamples, Port::MaxBlockSize);
     }
-    m_pDelayLine->reset();
+
+    // Start at the current delay, without sliding to it
+    m_tap = DelayLine::Tap();
+    m_tap.delay = delay(m_pDelayRatioInput->getValue());
 }
 
 void Delay::processStop()
@@ -74,19 +93,47 @@ void Delay::processStop()
 
 void Delay::process()
 {
-    float delayRatio = qMin(1.0f, qMax(0.0f, m_pDelayRatioInput->getValue()));
+    float in = m_pInput->getValue();
+    float delaySamples = delay(m_pDelayRatioInput->getValue());
+    float out;
 
-    m_pDelayLine->setDelayFraction(delayRatio);
+    m_pDelayLine->setInterpolation(m_interpolation);
+    m_pDelayLine->write(&in, 1);
+    m_pDelayLine->read(m_tap, &out, &delaySamples, 1);
 
-    float out = m_pDelayLine->process(m_pInput->getValue());
     m_pOutput->setValue(out);
 }
 
+void Delay::processBlock(int nFrames)
+{
+    const float *pDelayRatio = m_pDelayRatioInput->buffer();
+    float *pOut = m_pOutput->buffer();
+
+    m_pDelayLine->setInterpolation(m_interpolation);
+    m_pDelayLine->write(m_pInput->buffer(), nFrames);
+
+    if (m_pDelayRatioInput->rate() != Port::Rate_Audio) {
+        // Delay changes are smoothed over the block
+        m_pDelayLine->read(m_tap, pOut, nFrames, delay(pDelayRatio[0]));
+    } else {
+        for (int i = 0; i < nFrames; ++i) {
+            m_delays[i] = delay(pDelayRatio[i]);
+        }
+        m_pDelayLine->read(m_tap, pOut, m_delays, nFrames);
+    }
+}
+
 void Delay::reset()
 {
     if (m_pDelayLine != nullptr) {
         m_pDelayLine->reset();
     }
+    m_tap.allpassOut = 0.0f;
+}
+
+float Delay::delay(float ratio) const
+{
+    return qMin(1.0f, qMax(0.0f, ratio)) * float(m_pDelayLine->samplesMax() - 1);
 }
 
 void Delay::createProperties()
@@ -99,5 +146,26 @@ void Delay::createProperties()
     m_pPropDelay->setAttribute("maximum", 5000.0);
     m_pPropDelay->setAttribute("decimals", 2);
     m_pPropDelay->setAttribute("singleStep", 1.0);
+
+    m_pPropInterpolation = propertyManager()->addProperty(QtVariantPropertyManager::enumTypeId(), "Interpolation");
+    QVariantList interpolations;
+    interpolations << "None" << "Linear" << "Lagrange" << "Allpass";
+    m_pPropInterpolation->setAttribute("enumNames", interpolations);
+    m_pPropInterpolation->setValue(1);
+    m_pPropInterpolation->setToolTip("Fractional delay interpolation. "
+                                     "Allpass has a flat response but smears fast delay changes.");
+
     pRoot->addSubProperty(m_pPropDelay);
+    pRoot->addSubProperty(m_pPropInterpolation);
+
+    // Properties change handler
+    QObject::connect(propertyManager(), &QtVariantPropertyManager::propertyChanged, [this](QtProperty *pProperty){
+        Q_UNUSED(pProperty);
+        setValues();
+    });
+}
+
+void Delay::setValues()
+{
+    m_interpolation = static_cast<DelayLine::Interpolation>(m_pPropInterpolation->value().toInt());
 }
@@ -31,6 +31,7 @@ Dial::Dial(AudioUnitPlugin *pPlugin)
 {
     m_pDial = nullptr;
     m_pOutput = addOutput();
+    m_pOutput->setRate(Port::Rate_Control);
     createProperties();
 }
 
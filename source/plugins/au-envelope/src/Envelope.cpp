@@ -157,6 +157,15 @@ void Envelope::doEnvelope()
 void Envelope::noteOnEvent(NoteOnEvent *pEvent)
 {
     m_noteNumber = pEvent->noteNumber();
+
+    if (!signalChain()->isEnabled()) {
+        // The chain has been disabled (e.g. a stolen voice faded out by its
+        // container) while the envelope was still running: restart from zero,
+        // as the level left over would make the attack click.
+        m_state = State_Off;
+        m_output = 0.0f;
+    }
+
     // Previous note has no been released - do legato (keel sustain state).
     if (m_state != State_Sustain) {
         setState(State_Attack);
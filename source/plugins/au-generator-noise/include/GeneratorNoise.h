@@ -19,12 +19,15 @@
 #define AU_GENERATOR_NOISE_H
 
 #include "AudioUnit.h"
+#include "NoiseGenerator.h"
 
 class QtVariantProperty;
 
 /*
- *  Primitive noise generator based on radnom
- *  numbers.
+ *  White, pink or brown noise generator.
+ *  Each instance has its own random numbers sequence, seeded from
+ *  the seed property and the voice index. New instances are given
+ *  distinct seeds, which are saved with the patch.
  */
 
 class GeneratorNoise : public AudioUnit
@@ -44,12 +47,21 @@ protected:
     void processStart();
     void processStop();
     void process();
+    void processBlock(int nFrames) override;
     void reset();
 
 private:
 
+    void createProperties();
+    void setValues();
+    void restartSequence();
+
+    NoiseGenerator m_noise;
+
     OutputPort *m_pOutput;
 
+    QtVariantProperty *m_pPropColor;
+    QtVariantProperty *m_pPropSeed;
 };
 
 #endif // AU_GENERATOR_NOISE_H
@@ -31,4 +31,15 @@ public:
     QIcon icon() const override;
 
     AudioUnit* createInstance() override;
+
+    /**
+     * Returns a new default seed, so that the generators added to
+     * a patch do not play the same sequence.
+     * @return Seed.
+     */
+    int nextSeed() { return m_nextSeed++; }
+
+private:
+
+    int m_nextSeed;
 };
@@ -20,29 +20,40 @@
 #include <qmath.h>
 #include "Application.h"
 #include "ISignalChain.h"
+#include "GeneratorNoisePlugin.h"
 #include "GeneratorNoise.h"
 
 GeneratorNoise::GeneratorNoise(AudioUnitPlugin *pPlugin)
-    : AudioUnit(pPlugin)
+    : AudioUnit(pPlugin),
+      m_noise()
 {
     m_pOutput = addOutput();
+
+    createProperties();
 }
 
 
 void GeneratorNoise::serialize(QVariantMap &data, SerializationContext *pContext) const
 {
     Q_ASSERT(pContext != nullptr);
+    data["color"] = m_pPropColor->value();
+    data["seed"] = m_pPropSeed->value();
     AudioUnit::serialize(data, pContext);
 }
 
 void GeneratorNoise::deserialize(const QVariantMap &data, SerializationContext *pContext)
 {
     Q_ASSERT(pContext != nullptr);
+    m_pPropColor->setValue(data.value("color", 0));
+    // Patches saved without seeds keep the distinct instance ones
+    m_pPropSeed->setValue(data.value("seed", m_pPropSeed->value()));
     AudioUnit::deserialize(data, pContext);
 }
 
 void GeneratorNoise::processStart()
 {
+    setValues();
+    restartSequence();
 }
 
 void GeneratorNoise::processStop()
@@ -52,11 +63,57 @@ void GeneratorNoise::processStop()
 
 void GeneratorNoise::process()
 {
-    float out = (float)(2.0 * rand()/(RAND_MAX + 1.0) - 1.0);
+    float out;
+    m_noise.generate(&out, 1);
     m_pOutput->setValue(out);
 }
 
+void GeneratorNoise::processBlock(int nFrames)
+{
+    m_noise.generate(m_pOutput->buffer(), nFrames);
+}
+
 void GeneratorNoise::reset()
 {
-    srand(0);
+    restartSequence();
+}
+
+void GeneratorNoise::createProperties()
+{
+    QtVariantProperty *pRoot = rootProperty();
+
+    m_pPropColor = propertyManager()->addProperty(QtVariantPropertyManager::enumTypeId(), "Color");
+    QVariantList list;
+    list << "White" << "Pink" << "Brown";
+    m_pPropColor->setAttribute("enumNames", list);
+    m_pPropColor->setValue(0);
+
+    m_pPropSeed = propertyManager()->addProperty(QVariant::Int, "Seed");
+    m_pPropSeed->setAttribute("minimum", 0);
+    m_pPropSeed->setValue(static_cast<GeneratorNoisePlugin*>(plugin())->nextSeed());
+    m_pPropSeed->setToolTip("Random sequence seed, combined with the voice index. "
+                            "Generators sharing a seed play the same noise.");
+
+    pRoot->addSubProperty(m_pPropColor);
+    pRoot->addSubProperty(m_pPropSeed);
+
+    // Properties change handler
+    QObject::connect(propertyManager(), &QtVariantPropertyManager::propertyChanged, [this](QtProperty *pProperty){
+        Q_UNUSED(pProperty);
+        setValues();
+    });
+}
+
+void GeneratorNoise::setValues()
+{
+    m_noise.setColor(static_cast<NoiseGenerator::Color>(m_pPropColor->value().toInt()));
+}
+
+void GeneratorNoise::restartSequence()
+{
+    // The sequence only depends on the seed and the voice,
+    // so that the renders are reproducible.
+    int voiceIndex = signalChain() != nullptr ? signalChain()->voiceIndex() : 0;
+    quint64 seed = (quint64(m_pPropSeed->value().toUInt()) << 32) | quint32(voiceIndex);
+    m_noise.setSeed(seed);
 }
@@ -19,7 +19,8 @@
 #include "GeneratorNoise.h"
 
 GeneratorNoisePlugin::GeneratorNoisePlugin(QObject *pParent)
-    : AudioUnitPlugin(pParent)
+    : AudioUnitPlugin(pParent),
+      m_nextSeed(1)
 {
 }
 
@@ -43,6 +43,7 @@ protected:
     void processStart();
     void processStop();
     void process();
+    void processBlock(int nFrames) override;
     void reset();
 
 private:
@@ -50,11 +51,14 @@ private:
     void createProperties();
     void setValues();
 
-    float m_phase;
+    quint32 m_phase;    ///< Fixed point phase, see Wavetable.
     float m_amp;
     float m_freqScale;
     float m_dt;
 
+    /// Phase increments of the current block.
+    quint32 m_increments[Port::MaxBlockSize];
+
     InputPort *m_pInputFreq;
     OutputPort *m_pOutput;
 
@@ -17,6 +17,7 @@
 
 #include <QtPlugin>
 #include "AudioUnitPlugin.h"
+#include "Wavetable.h"
 
 class GeneratorSinePlugin : public AudioUnitPlugin
 {
@@ -30,5 +31,16 @@ public:
 
     QIcon icon() const override;
 
+    void initialize() override;
     AudioUnit* createInstance() override;
+
+    /**
+     * Returns sine wavetable shared by all generators.
+     * @return
+     */
+    const Wavetable& wavetable() const { return m_wavetable; }
+
+private:
+
+    Wavetable m_wavetable;
 };
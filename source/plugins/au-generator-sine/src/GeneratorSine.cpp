@@ -20,15 +20,14 @@
 #include <qmath.h>
 #include "Application.h"
 #include "ISignalChain.h"
+#include "GeneratorSinePlugin.h"
 #include "GeneratorSine.h"
 
-#define RAD(x) ((x) * M_PI / 180.0);
-
 const QColor cDefaultColor(180, 250, 220);
 
 GeneratorSine::GeneratorSine(AudioUnitPlugin *pPlugin)
     : AudioUnit(pPlugin),
-      m_phase(0.0)
+      m_phase(0)
 {
     m_pInputFreq = addInput("f");
     m_pOutput = addOutput();
@@ -71,17 +70,38 @@ void GeneratorSine::processStop()
 
 void GeneratorSine::process()
 {
-    float out = m_amp * sin(m_phase * 2.0 * M_PI);
-    float f = m_pInputFreq->getValue();
-    float dPhase = f * m_freqScale;
-    m_phase = fmod(m_phase + dPhase, 1.0);
+    const Wavetable &wavetable = static_cast<GeneratorSinePlugin*>(plugin())->wavetable();
+
+    float out = 0.0f;
+    wavetable.render(&out, 1, m_phase, Wavetable::increment(m_pInputFreq->getValue() * m_freqScale));
+
+    m_pOutput->setValue(m_amp * out);
+}
+
+void GeneratorSine::processBlock(int nFrames)
+{
+    const Wavetable &wavetable = static_cast<GeneratorSinePlugin*>(plugin())->wavetable();
+    const float *pFreq = m_pInputFreq->buffer();
+    float *pOut = m_pOutput->buffer();
+
+    if (m_pInputFreq->rate() != Port::Rate_Audio) {
+        // Frequency does not change within the block
+        wavetable.render(pOut, nFrames, m_phase, Wavetable::increment(pFreq[0] * m_freqScale));
+    } else {
+        for (int i = 0; i < nFrames; ++i) {
+            m_increments[i] = Wavetable::increment(pFreq[i] * m_freqScale);
+        }
+        wavetable.render(pOut, nFrames, m_phase, m_increments);
+    }
 
-    m_pOutput->setValue(out);
+    for (int i = 0; i < nFrames; ++i) {
+        pOut[i] *= m_amp;
+    }
 }
 
 void GeneratorSine::reset()
 {
-    m_phase = RAD(m_pPropPhase->value().toFloat());
+    m_phase = Wavetable::phase(m_pPropPhase->value().toDouble() / 360.0);
     m_pOutput->setValue(0.0f);
 }
 
@@ -118,7 +138,7 @@ void GeneratorSine::createProperties()
 
 void GeneratorSine::setValues()
 {
-    m_phase = RAD(m_pPropPhase->value().toFloat());
+    m_phase = Wavetable::phase(m_pPropPhase->value().toDouble() / 360.0);
     m_amp = m_pPropAmplitude->value().toFloat();
     if (signalChain() != nullptr) {
         m_freqScale = signalChain()->timeStep() * m_pPropFreqScale->value().toFloat();
@@ -28,6 +28,11 @@ QIcon GeneratorSinePlugin::icon() const
     return QIcon(":/au-generator-sine/icon.png");
 }
 
+void GeneratorSinePlugin::initialize()
+{
+    m_wavetable.setShape(Wavetable::Shape_Sine);
+}
+
 AudioUnit* GeneratorSinePlugin::createInstance()
 {
     return new GeneratorSine(this);
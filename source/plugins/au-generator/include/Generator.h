@@ -18,12 +18,16 @@
 #ifndef AU_GENERATOR_H
 #define AU_GENERATOR_H
 
+#include <QSharedPointer>
 #include "AudioUnit.h"
+#include "Wavetable.h"
 
 class QtVariantProperty;
 
 /*
- *  Universal waveform generator
+ *  Universal waveform generator.
+ *  Band-limited waveforms are read from the wavetables
+ *  shared by the plugin, or from a single cycle loaded from a file.
  */
 
 class Generator : public AudioUnit
@@ -44,6 +48,7 @@ protected:
     void processStart() override;
     void processStop() override;
     void process() override;
+    void processBlock(int nFrames) override;
     void reset() override;
 
     void noteOnEvent(NoteOnEvent *pEvent) override;
@@ -52,12 +57,22 @@ private:
 
     void createProperties();
     void setValues();
+    void loadWaveform();
+    const Wavetable* wavetable() const;
 
-    float m_phase;
+    quint32 m_phase;    ///< Fixed point phase, see Wavetable.
     float m_dt;
     int m_waveform;
     bool m_bandlimit;
     bool m_trigger;
+    Wavetable::Interpolation m_interpolation;
+
+    /// Single cycle waveform loaded from file, shared via the plugin.
+    QSharedPointer<const Wavetable> m_pCustomWavetable;
+    QString m_customWaveformFile;
+
+    /// Phase increments of the current block.
+    quint32 m_increments[Port::MaxBlockSize];
 
     InputPort *m_pInputFreq;
     OutputPort *m_pOutput;
@@ -65,6 +80,8 @@ private:
     QtVariantProperty *m_pPropWaveform;
     QtVariantProperty *m_pPropBandPassLimit;
     QtVariantProperty *m_pPropTrigger;
+    QtVariantProperty *m_pPropInterpolation;
+    QtVariantProperty *m_pPropWaveformFile;
 };
 
 #endif // AU_GENERATOR_H
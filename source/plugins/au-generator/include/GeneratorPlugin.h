@@ -16,7 +16,11 @@
 */
 
 #include <QtPlugin>
+#include <QHash>
+#include <QSharedPointer>
+#include <QWeakPointer>
 #include "AudioUnitPlugin.h"
+#include "Wavetable.h"
 
 class GeneratorPlugin : public AudioUnitPlugin
 {
@@ -30,5 +34,30 @@ public:
 
     QIcon icon() const override;
 
+    void initialize() override;
     AudioUnit* createInstance() override;
+
+    /**
+     * Returns band-limited wavetable of a standard waveform.
+     * @param shape
+     * @return
+     */
+    const Wavetable& wavetable(Wavetable::Shape shape) const;
+
+    /**
+     * Returns band-limited wavetable of a single cycle waveform file.
+     * The wavetable is loaded once and shared by all the generators
+     * playing the file, as long as any of them keeps it.
+     * @param fileName Mono PCM WAV file.
+     * @return Wavetable, or null if the file cannot be loaded.
+     */
+    QSharedPointer<const Wavetable> customWavetable(const QString &fileName);
+
+private:
+
+    /// Wavetables of the standard shapes, shared by all generators.
+    QVector<Wavetable> m_wavetables;
+
+    /// Wavetables loaded from files, by file name.
+    QHash<QString, QWeakPointer<const Wavetable>> m_customWavetables;
 };
@@ -15,140 +15,47 @@
     Lesser General Public License for more details.
 */
 
-#include <QDebug>
 #include <QtVariantPropertyManager>
 #include <QtVariantProperty>
 #include <qmath.h>
 #include "Application.h"
 #include "ISignalChain.h"
+#include "GeneratorPlugin.h"
 #include "Generator.h"
 
 const QColor cDefaultColor(140, 200, 180);
 
-const int cMaxHarmonics(32);
-
-/**
- * Polynomial BLEP function.
- * @param t Time (phase), 0 <= t <= 1.0
- * @param dt Time step.
- * @return
- */
-double poly_blep(double t, float dt)
-{
-    // 0 <= t < 1
-    if (t < dt) {
-        t /= dt;
-        return t+t - t*t - 1.0;
-    }
-    // -1 < t < 0
-    else if (t > 1.0 - dt) {
-        t = (t - 1.0) / dt;
-        return t*t + t+t + 1.0;
-    }
-    // 0 otherwise
-    else return 0.0;
-}
+/// Waveforms, in the order of the property enumeration.
+enum Waveform {
+    Waveform_Sine,
+    Waveform_Sawtooth,
+    Waveform_Square,
+    Waveform_Triangle,
+    Waveform_Custom
+};
 
 // Naive sawtooth generator implementation
-float sawtooth(float phase)
+inline float sawtooth(float phase)
 {
     return 2.0f * phase - 1.0f;
 }
 
-// Poly-BLEP sawtooth
-float blep_sawtooth(float phase, float dt)
-{
-    return sawtooth(phase) - poly_blep(phase, dt);
-}
-
-// Bandpass-limited sawtooth using Fourier series
-float bpl_sawtooth(float phase, float delta)
-{
-    int n = 0.5 / delta;
-    n = qMin(n, cMaxHarmonics);
-    float k = M_PI / 2.0 / n;
-
-    float x = phase * 2.0 * M_PI;
-    float o = 0.0;
-    for (int i = 1; i <= n; i++) {
-        // Limit harmonics amplitude to prevent overflow
-        float a = cos((i - 1) * k);
-        o += a * a * (1.0 / float(i)) * sin(float(i) * x);
-    }
-    return -o;
-}
-
-// Native triangle waveform generator
-float triangle(float phase)
+// Naive triangle waveform generator
+inline float triangle(float phase)
 {
     return 2.0f * fabs(sawtooth(phase)) - 1.0f;
 }
 
-// Poly-BLEP triangle
-float blep_triangle(float phase, float dPhase, float prev = 0.0f)
-{
-    float value = -1.0 + (2.0 * phase);
-    value = 2.0 * (fabs(value) - 0.5);
-    dPhase = dPhase * 3.1415926 * 8;
-    value = dPhase * value + (1 - dPhase) * prev;
-    return value;
-}
-
-// Bandpass limited triangle waveform using Fourier series
-float bpl_triangle(float phase, float delta)
-{
-    int n = 0.25 / delta;
-    n = qMin(n, cMaxHarmonics);
-    float k = M_PI / 2.0 / n;
-
-    float x = phase * 2.0 * M_PI;
-    float o = 0.0;
-    for (int i = 0; i < n; i++) {
-        float a = cos(i * k);
-        float d = float(2*i + 1);
-        float h = (i % 2 == 0) ? 1.0f : -1.0f;
-        o += a*a* h * sin(d * x) / d / d;
-    }
-    o *= float(8.0f / M_PI / M_PI);
-    return o;
-}
-
 // Naive square waveform generator
-float square(float phase)
-{
-    return phase - 0.5f > 0.0f ? 1.0f : -1.0f;
-}
-
-// Poly-BLEP square
-float blep_square(float phase, float dt)
+inline float square(float phase)
 {
-    float pwm = 0.5f;
-    float value = phase < pwm ? 1.0 : -1.0;
-    value += poly_blep(phase, dt);
-    value -= poly_blep(fmod(phase + 1.0 - pwm, 1.0), dt);
-    return value;
-}
-
-// Bandpass limited square waveform using Fourier series
-float bpl_square(float phase, float delta)
-{
-    int n = 0.25 / delta;
-    n = qMin(n, 2*cMaxHarmonics);
-    float k = M_PI / 2.0 / n;
-
-    float x = phase * 2.0 * M_PI;
-    float o = 0.0;
-    for (int i = 1; i <= n; i+=2) {
-        // Limit harmonics amplitude to prevent overflow
-        float a = cos((i - 1) * k);
-        o += a * a * (1 / float(i)) * sin(float(i) * x);
-    }
-    return o;
+    return phase < 0.5f ? 1.0f : -1.0f;
 }
 
 Generator::Generator(AudioUnitPlugin *pPlugin)
     : AudioUnit(pPlugin),
-      m_phase(0.0f)
+      m_phase(0),
+      m_interpolation(Wavetable::Interpolation_Linear)
 {
     m_pInputFreq = addInput("f");
     m_pOutput = addOutput();
@@ -171,6 +78,8 @@ void Generator::serialize(QVariantMap &data, SerializationContext *pContext) con
     data["waveform"] = m_pPropWaveform->value();
     data["BandPassLimit"] = m_pPropBandPassLimit->value();
     data["trigger"] = m_pPropTrigger->value();
+    data["interpolation"] = m_pPropInterpolation->value();
+    data["waveformFile"] = m_pPropWaveformFile->value();
     AudioUnit::serialize(data, pContext);
 }
 
@@ -180,6 +89,8 @@ void Generator::deserialize(const QVariantMap &data, SerializationContext *pCont
     m_pPropWaveform->setValue(data["waveform"]);
     m_pPropBandPassLimit->setValue(data["BandPassLimit"]);
     m_pPropTrigger->setValue(data.value("trigger", false));
+    m_pPropInterpolation->setValue(data.value("interpolation", 0));
+    m_pPropWaveformFile->setValue(data.value("waveformFile", QString()));
     AudioUnit::deserialize(data, pContext);
 }
 
@@ -188,6 +99,12 @@ void Generator::processStart()
     setValues();
 
     m_dt = signalChain()->timeStep();
+
+    QString fileName = m_pPropWaveformFile->value().toString();
+    if (fileName != m_customWaveformFile) {
+        m_customWaveformFile = fileName;
+        loadWaveform();
+    }
 }
 
 void Generator::processStop()
@@ -197,32 +114,74 @@ void Generator::processStop()
 
 void Generator::process()
 {
-    ISignalChain* chain = signalChain();
-    float dPhase = m_pInputFreq->getValue() * m_dt;
-
-    float out = 0.0;
-    switch (m_waveform) {
-    case 0:
-        out = sin(m_phase * 2 * M_PI);
-        break;
-    case 1:
-        out = m_bandlimit ? blep_sawtooth(m_phase, dPhase) : sawtooth(m_phase);
-        break;
-    case 2:
-        out = m_bandlimit ? blep_square(m_phase, dPhase) : square(m_phase);
-        break;
-    case 3:
-        out = m_bandlimit ? bpl_triangle(m_phase, dPhase) : triangle(m_phase);
-        break;
-    default:
-        break;
+    float out = 0.0f;
+    quint32 increment = Wavetable::increment(m_pInputFreq->getValue() * m_dt);
+
+    const Wavetable *pWavetable = wavetable();
+    if (pWavetable != nullptr) {
+        pWavetable->render(&out, 1, m_phase, increment, m_interpolation);
+    } else {
+        float phase = Wavetable::cycles(m_phase);
+        switch (m_waveform) {
+        case Waveform_Sawtooth:
+            out = sawtooth(phase);
+            break;
+        case Waveform_Square:
+            out = square(phase);
+            break;
+        case Waveform_Triangle:
+            out = triangle(phase);
+            break;
+        default:
+            break;
+        }
+        m_phase += increment;
     }
 
-    m_phase = fmod(m_phase + dPhase, 1.0);
-
     m_pOutput->setValue(out);
 }
 
+void Generator::processBlock(int nFrames)
+{
+    const float *pFreq = m_pInputFreq->buffer();
+    float *pOut = m_pOutput->buffer();
+
+    const Wavetable *pWavetable = wavetable();
+    if (pWavetable != nullptr) {
+        if (m_pInputFreq->rate() != Port::Rate_Audio) {
+            // Frequency does not change within the block
+            quint32 increment = Wavetable::increment(pFreq[0] * m_dt);
+            pWavetable->render(pOut, nFrames, m_phase, increment, m_interpolation);
+        } else {
+            for (int i = 0; i < nFrames; ++i) {
+                m_increments[i] = Wavetable::increment(pFreq[i] * m_dt);
+            }
+            pWavetable->render(pOut, nFrames, m_phase, m_increments, m_interpolation);
+        }
+        return;
+    }
+
+    // Naive waveforms
+    for (int i = 0; i < nFrames; ++i) {
+        float phase = Wavetable::cycles(m_phase);
+        switch (m_waveform) {
+        case Waveform_Sawtooth:
+            pOut[i] = sawtooth(phase);
+            break;
+        case Waveform_Square:
+            pOut[i] = square(phase);
+            break;
+        case Waveform_Triangle:
+            pOut[i] = triangle(phase);
+            break;
+        default:
+            pOut[i] = 0.0f;
+            break;
+        }
+        m_phase += Wavetable::increment(pFreq[i] * m_dt);
+    }
+}
+
 void Generator::reset()
 {
     m_phase = 0;
@@ -246,10 +205,14 @@ void Generator::createProperties()
 
     m_pPropWaveform = propertyManager()->addProperty(QtVariantPropertyManager::enumTypeId(), "Waveform");
     QVariantList list;
-    list << "Sine" << "Sawtooth" << "Square" << "Triangle";
+    list << "Sine" << "Sawtooth" << "Square" << "Triangle" << "Custom";
     m_pPropWaveform->setAttribute("enumNames", list);
     m_pPropWaveform->setValue(0);
 
+    m_pPropWaveformFile = propertyManager()->addProperty(QVariant::String, "Waveform file");
+    m_pPropWaveformFile->setValue(QString());
+    m_pPropWaveformFile->setToolTip("Single cycle waveform (mono PCM WAV file) played by the custom waveform");
+
     m_pPropBandPassLimit = propertyManager()->addProperty(QVariant::Bool, "Limit bandpass");
     m_pPropBandPassLimit->setValue(false);
 
@@ -257,9 +220,18 @@ void Generator::createProperties()
     m_pPropTrigger->setValue(false);
     m_pPropTrigger->setToolTip("Reset generator phase to zero when key is pressed");
 
+    m_pPropInterpolation = propertyManager()->addProperty(QtVariantPropertyManager::enumTypeId(), "Interpolation");
+    QVariantList interpolations;
+    interpolations << "Linear" << "Cubic";
+    m_pPropInterpolation->setAttribute("enumNames", interpolations);
+    m_pPropInterpolation->setValue(0);
+    m_pPropInterpolation->setToolTip("Wavetable interpolation");
+
     pRoot->addSubProperty(m_pPropWaveform);
+    pRoot->addSubProperty(m_pPropWaveformFile);
     pRoot->addSubProperty(m_pPropBandPassLimit);
     pRoot->addSubProperty(m_pPropTrigger);
+    pRoot->addSubProperty(m_pPropInterpolation);
 
     // Properties change handler
     QObject::connect(propertyManager(), &QtVariantPropertyManager::propertyChanged, [this](QtProperty *pProperty){
@@ -273,4 +245,37 @@ void Generator::setValues()
     m_waveform = m_pPropWaveform->value().toInt();
     m_bandlimit = m_pPropBandPassLimit->value().toBool();
     m_trigger = m_pPropTrigger->value().toBool();
+    m_interpolation = m_pPropInterpolation->value().toInt() == 1 ? Wavetable::Interpolation_Cubic
+                                                                 : Wavetable::Interpolation_Linear;
+}
+
+void Generator::loadWaveform()
+{
+    m_pCustomWavetable.clear();
+
+    if (!m_customWaveformFile.isEmpty()) {
+        GeneratorPlugin *pPlugin = static_cast<GeneratorPlugin*>(plugin());
+        m_pCustomWavetable = pPlugin->customWavetable(m_customWaveformFile);
+    }
+}
+
+const Wavetable* Generator::wavetable() const
+{
+    const GeneratorPlugin *pPlugin = static_cast<const GeneratorPlugin*>(plugin());
+
+    switch (m_waveform) {
+    case Waveform_Sine:
+        return &pPlugin->wavetable(Wavetable::Shape_Sine);
+    case Waveform_Sawtooth:
+        return m_bandlimit ? &pPlugin->wavetable(Wavetable::Shape_Sawtooth) : nullptr;
+    case Waveform_Square:
+        return m_bandlimit ? &pPlugin->wavetable(Wavetable::Shape_Square) : nullptr;
+    case Waveform_Triangle:
+        return m_bandlimit ? &pPlugin->wavetable(Wavetable::Shape_Triangle) : nullptr;
+    case Waveform_Custom:
+        return m_pCustomWavetable.data();
+    default:
+        break;
+    }
+    return nullptr;
 }
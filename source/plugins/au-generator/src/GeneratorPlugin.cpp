@@ -15,6 +15,8 @@
     Lesser General Public License for more details.
 */
 
+#include <QDebug>
+#include "WavFile.h"
 #include "GeneratorPlugin.h"
 #include "Generator.h"
 
@@ -28,7 +30,52 @@ QIcon GeneratorPlugin::icon() const
     return QIcon(":/au-generator/icon.png");
 }
 
+void GeneratorPlugin::initialize()
+{
+    m_wavetables.clear();
+    m_wavetables.append(Wavetable(Wavetable::Shape_Sine));
+    m_wavetables.append(Wavetable(Wavetable::Shape_Sawtooth));
+    m_wavetables.append(Wavetable(Wavetable::Shape_Square));
+    m_wavetables.append(Wavetable(Wavetable::Shape_Triangle));
+}
+
 AudioUnit* GeneratorPlugin::createInstance()
 {
     return new Generator(this);
 }
+
+const Wavetable& GeneratorPlugin::wavetable(Wavetable::Shape shape) const
+{
+    Q_ASSERT(shape >= 0 && shape < m_wavetables.size());
+    return m_wavetables.at(shape);
+}
+
+QSharedPointer<const Wavetable> GeneratorPlugin::customWavetable(const QString &fileName)
+{
+    QSharedPointer<const Wavetable> pWavetable = m_customWavetables.value(fileName).toStrongRef();
+    if (!pWavetable.isNull()) {
+        return pWavetable;
+    }
+
+    WavFile wf(fileName);
+    if (!wf.open() || !wf.readHeader()) {
+        qWarning() << "Unable to open waveform file" << fileName << wf.errorText();
+        return pWavetable;
+    }
+
+    if (wf.format() != WavFile::Format_PCM || wf.numberOfChannels() != 1) {
+        qWarning() << "Waveform file must be mono PCM" << fileName;
+        return pWavetable;
+    }
+
+    QVector<float> cycle;
+    QSharedPointer<Wavetable> pLoaded(new Wavetable());
+    if (!wf.readSingleChannelData(cycle) || !pLoaded->setWaveform(cycle.constData(), cycle.size())) {
+        qWarning() << "Unable to read waveform file" << fileName;
+        return pWavetable;
+    }
+
+    pWavetable = pLoaded;
+    m_customWavetables.insert(fileName, pWavetable);
+    return pWavetable;
+}
@@ -22,8 +22,21 @@
 #include "AudioUnit.h"
 
 class AudioBuffer;
+class AdaptiveResampler;
 typedef void PaStream;
 
+/**
+ * @brief Audio input unit.
+ *
+ * Brings the audio input device signal into the signal chain.
+ * Delivery depends on how the audio devices are configured:
+ * - Duplex device rendered in the callback: the samples are taken
+ *   directly from the callback input buffer, without extra buffering.
+ * - Duplex device rendered in a separate thread: the samples are
+ *   passed via the ring buffers, the clocks of both sides are the same.
+ * - Separate input and output devices: the clocks drift apart, so
+ *   the ring buffers fill is kept constant by resampling the input.
+ */
 class Input : public AudioUnit,
               public IAudioDeviceListener
 {
@@ -43,9 +56,29 @@ protected:
     void processStart() override;
     void processStop() override;
     void process() override;
+    void processBlock(int nFrames) override;
 
 private:
 
+    /// Input delivery modes.
+    enum Mode {
+        Mode_Direct,    ///< Read from duplex callback input buffer.
+        Mode_Ring,      ///< Read from the ring buffers.
+        Mode_Resampled  ///< Read from the ring buffers with drift compensation.
+    };
+
+    void processDirect(float *pLeft, float *pRight, int nFrames);
+    void processRing(float *pLeft, float *pRight, int nFrames);
+    void processResampled(float *pLeft, float *pRight, int nFrames);
+
+    /**
+     * Check buffers fill before reading.
+     * This waits until the buffers are filled up to the target after
+     * starting or running dry, and drops the samples on overflow.
+     * @return Number of samples available for reading, or zero when prebuffering.
+     */
+    long checkFill();
+
     void allocateBuffers();
     void releaseBuffers();
     inline bool isBufferAllocated() const { return m_bufferAllocated; }
@@ -56,11 +89,26 @@ private:
     OutputPort *m_pOutputLeft;
     OutputPort *m_pOutputRight;
 
+    /// Deinterleaving buffers used by the audio callback.
     float *m_pLeft;
     float *m_pRight;
+    long m_scratchSize;
+
+    /// Buffers for the samples fed to the resampler.
+    float *m_pResampleLeft;
+    float *m_pResampleRight;
+
+    AdaptiveResampler *m_pResampler;
 
     bool m_bufferAllocated;
+
+    Mode m_mode;
+    long m_targetFill;      ///< Buffers fill to maintain.
+    long m_maxFill;         ///< Buffers fill considered as overflow.
+    bool m_prebuffering;    ///< Waiting for the buffers to fill up.
+
+    quint64 m_callbackSequence; ///< Callback being read in direct mode.
+    long m_callbackOffset;      ///< Read position within the callback buffer.
 };
 
 #endif // AU_INPUT_H
-
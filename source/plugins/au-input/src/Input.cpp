@@ -15,17 +15,22 @@
     Lesser General Public License for more details.
 */
 
+#include <algorithm>
 #include <QGraphicsPixmapItem>
 #include "portaudio.h"
 #include "Application.h"
 #include "Settings.h"
 #include "AudioDevicesManager.h"
 #include "AudioBuffer.h"
+#include "AdaptiveResampler.h"
 #include "ISignalChain.h"
 #include "Input.h"
 
 const QColor cDefaultColor(210, 230, 240);
 
+/// Size of the resampler input buffers, enough for any ratio.
+const int cResampleBufferSize(2 * Port::MaxBlockSize + 4);
+
 Input::Input(AudioUnitPlugin *pPlugin)
     : AudioUnit(pPlugin)
 {
@@ -37,15 +42,34 @@ Input::Input(AudioUnitPlugin *pPlugin)
 
     m_pLeft = nullptr;
     m_pRight = nullptr;
+    m_scratchSize = 0;
+
+    m_pResampleLeft = nullptr;
+    m_pResampleRight = nullptr;
+    m_pResampler = nullptr;
 
     m_bufferAllocated = false;
 
-    Application::instance()->audioDevicesManager()->audioInputDevice()->addListener(this);
+    m_mode = Mode_Ring;
+    m_targetFill = 0;
+    m_maxFill = 0;
+    m_prebuffering = true;
+
+    m_callbackSequence = 0;
+    m_callbackOffset = 0;
+
+    // Duplex stream input is delivered by the output device,
+    // so listen to both devices: only one of them provides the input.
+    AudioDevicesManager *pManager = Application::instance()->audioDevicesManager();
+    pManager->audioInputDevice()->addListener(this);
+    pManager->audioOutputDevice()->addListener(this);
 }
 
 Input::~Input()
 {
-    Application::instance()->audioDevicesManager()->audioInputDevice()->removeListener(this);
+    AudioDevicesManager *pManager = Application::instance()->audioDevicesManager();
+    pManager->audioInputDevice()->removeListener(this);
+    pManager->audioOutputDevice()->removeListener(this);
 
     releaseBuffers();
 }
@@ -70,31 +94,54 @@ QGraphicsItem* Input::graphicsItem()
 
 void Input::processAudio(const float *pInputBuffer, float *pOutputBuffer, long nSamples)
 {
+    Q_UNUSED(pOutputBuffer);
+
     if (pInputBuffer == nullptr
             || !isBufferAllocated()
+            || m_mode == Mode_Direct
             || nSamples <= 0) {
         // Nothing to process
         return;
     }
 
-    long length = qMin(nSamples, m_pLeftBuffer->availableToWrite());
-    length = qMin(length, m_pRightBuffer->availableToWrite());
+    while (nSamples > 0) {
+        long length = qMin(nSamples, m_scratchSize);
+        length = qMin(length, m_pLeftBuffer->availableToWrite());
+        length = qMin(length, m_pRightBuffer->availableToWrite());
+        if (length <= 0) {
+            // Overflow, the samples are lost
+            break;
+        }
 
-    for (long i = 0; i < length; i++) {
-        m_pLeft[i] = *pInputBuffer++;
-        m_pRight[i] = *pInputBuffer++;
-    }
+        for (long i = 0; i < length; i++) {
+            m_pLeft[i] = *pInputBuffer++;
+            m_pRight[i] = *pInputBuffer++;
+        }
 
-    m_pLeftBuffer->write(m_pLeft, length);
-    m_pRightBuffer->write(m_pRight, length);
+        m_pLeftBuffer->write(m_pLeft, length);
+        m_pRightBuffer->write(m_pRight, length);
+        nSamples -= length;
+    }
 }
 
 void Input::processStart()
 {
+    AudioDevicesManager *pManager = Application::instance()->audioDevicesManager();
+    if (pManager->isDuplex()) {
+        m_mode = pManager->isCallbackRenderEnabled() ? Mode_Direct : Mode_Ring;
+    } else {
+        m_mode = Mode_Resampled;
+    }
+
     allocateBuffers();
 
     m_pLeftBuffer->clear();
     m_pRightBuffer->clear();
+    m_pResampler->reset();
+    m_prebuffering = true;
+
+    m_callbackSequence = 0;
+    m_callbackOffset = 0;
 }
 
 void Input::processStop()
@@ -103,16 +150,128 @@ void Input::processStop()
 
 void Input::process()
 {
-    float l = 0.0f;
-    float r = 0.0f;
+    // All the processing is done in processBlock()
+}
+
+void Input::processBlock(int nFrames)
+{
+    float *pLeft = m_pOutputLeft->buffer();
+    float *pRight = m_pOutputRight->buffer();
 
-    if (m_pLeftBuffer->availableToRead() > 0 && m_pRightBuffer->availableToRead() > 0) {
-        m_pLeftBuffer->read(&l, 1);
-        m_pRightBuffer->read(&r, 1);
+    switch (m_mode) {
+    case Mode_Direct:
+        processDirect(pLeft, pRight, nFrames);
+        break;
+    case Mode_Ring:
+        processRing(pLeft, pRight, nFrames);
+        break;
+    case Mode_Resampled:
+        processResampled(pLeft, pRight, nFrames);
+        break;
+    default:
+        Q_ASSERT(!"Unknown input mode");
+        break;
+    }
+}
+
+void Input::processDirect(float *pLeft, float *pRight, int nFrames)
+{
+    // The chain is rendered in the output device callback in consecutive
+    // blocks, so the callback input is read sequentially.
+    AudioDevice *pDevice = Application::instance()->audioDevicesManager()->audioOutputDevice();
+    const float *pInput = pDevice->callbackInput();
+    if (pInput == nullptr) {
+        // Not rendering in the callback
+        std::fill(pLeft, pLeft + nFrames, 0.0f);
+        std::fill(pRight, pRight + nFrames, 0.0f);
+        return;
+    }
+
+    if (pDevice->callbackSequence() != m_callbackSequence) {
+        m_callbackSequence = pDevice->callbackSequence();
+        m_callbackOffset = 0;
     }
 
-    m_pOutputLeft->setValue(l);
-    m_pOutputRight->setValue(r);
+    long length = qBound(0L, pDevice->callbackFrames() - m_callbackOffset, long(nFrames));
+    pInput += 2 * m_callbackOffset;
+    for (long i = 0; i < length; i++) {
+        pLeft[i] = *pInput++;
+        pRight[i] = *pInput++;
+    }
+    std::fill(pLeft + length, pLeft + nFrames, 0.0f);
+    std::fill(pRight + length, pRight + nFrames, 0.0f);
+
+    m_callbackOffset += nFrames;
+}
+
+void Input::processRing(float *pLeft, float *pRight, int nFrames)
+{
+    long length = qMin(checkFill(), long(nFrames));
+
+    if (length > 0) {
+        m_pLeftBuffer->read(pLeft, length);
+        m_pRightBuffer->read(pRight, length);
+    }
+
+    if (length < nFrames) {
+        // Ran dry, wait for the buffers to fill up again
+        std::fill(pLeft + length, pLeft + nFrames, 0.0f);
+        std::fill(pRight + length, pRight + nFrames, 0.0f);
+        m_prebuffering = true;
+    }
+}
+
+void Input::processResampled(float *pLeft, float *pRight, int nFrames)
+{
+    long available = checkFill();
+    if (available == 0) {
+        std::fill(pLeft, pLeft + nFrames, 0.0f);
+        std::fill(pRight, pRight + nFrames, 0.0f);
+        return;
+    }
+
+    m_pResampler->control(double(available - m_targetFill), nFrames * signalChain()->timeStep());
+
+    long required = qMin(long(m_pResampler->inputFrames(nFrames)), long(cResampleBufferSize));
+    long length = qMin(available, required);
+    m_pLeftBuffer->read(m_pResampleLeft, length);
+    m_pRightBuffer->read(m_pResampleRight, length);
+
+    const float *ppInput[] = { m_pResampleLeft, m_pResampleRight };
+    float *ppOutput[] = { pLeft, pRight };
+    m_pResampler->process(ppInput, int(length), ppOutput, nFrames);
+
+    if (length < required) {
+        // Ran dry, the resampler has been holding the last sample
+        m_pResampler->reset();
+        m_prebuffering = true;
+    }
+}
+
+long Input::checkFill()
+{
+    long available = qMin(m_pLeftBuffer->availableToRead(), m_pRightBuffer->availableToRead());
+
+    if (m_prebuffering) {
+        if (available < m_targetFill) {
+            return 0;
+        }
+        m_prebuffering = false;
+    }
+
+    if (available > m_maxFill) {
+        // Reader has been stalled, drop the excess to restore the latency
+        long excess = available - m_targetFill;
+        while (excess > 0) {
+            long length = qMin(excess, long(cResampleBufferSize));
+            m_pLeftBuffer->read(m_pResampleLeft, length);
+            m_pRightBuffer->read(m_pResampleRight, length);
+            excess -= length;
+        }
+        available = m_targetFill;
+    }
+
+    return available;
 }
 
 void Input::allocateBuffers()
@@ -126,10 +285,26 @@ void Input::allocateBuffers()
     if (!ok || bufferSize <= 0) {
         bufferSize = 1024;
     }
-    m_pLeftBuffer = new AudioBuffer(2 * bufferSize);
-    m_pRightBuffer = new AudioBuffer(2 * bufferSize);
-    m_pLeft = new float[2 * bufferSize];
-    m_pRight = new float[2 * bufferSize];
+
+    // Ring buffer size must be a power of two
+    long ringSize = 1;
+    while (ringSize < 4 * bufferSize) {
+        ringSize <<= 1;
+    }
+
+    m_pLeftBuffer = new AudioBuffer(ringSize);
+    m_pRightBuffer = new AudioBuffer(ringSize);
+    m_scratchSize = bufferSize;
+    m_pLeft = new float[m_scratchSize];
+    m_pRight = new float[m_scratchSize];
+    m_pResampleLeft = new float[cResampleBufferSize];
+    m_pResampleRight = new float[cResampleBufferSize];
+    m_pResampler = new AdaptiveResampler(2, Port::MaxBlockSize);
+
+    // Keep one and a half device buffer queued, which covers
+    // the input arriving in whole device buffers.
+    m_targetFill = bufferSize + bufferSize / 2;
+    m_maxFill = ringSize - bufferSize / 2;
 
     m_bufferAllocated = true;
 }
@@ -142,8 +317,14 @@ void Input::releaseBuffers()
     delete m_pRightBuffer;
     delete[] m_pLeft;
     delete[] m_pRight;
+    delete[] m_pResampleLeft;
+    delete[] m_pResampleRight;
+    delete m_pResampler;
     m_pLeftBuffer = nullptr;
     m_pRightBuffer = nullptr;
     m_pLeft = nullptr;
     m_pRight = nullptr;
+    m_pResampleLeft = nullptr;
+    m_pResampleRight = nullptr;
+    m_pResampler = nullptr;
 }
@@ -40,6 +40,7 @@ protected:
     void processStart();
     void processStop();
     void process();
+    void processBlock(int nFrames) override;
     void reset();
 
 private:
@@ -54,6 +55,7 @@ private:
     OutputPort *m_pOutput;
 
     QtVariantProperty *m_pFilterType;
+    QtVariantProperty *m_pModulationInterval;
 };
 
 #endif // AU_LHPFILTER_H
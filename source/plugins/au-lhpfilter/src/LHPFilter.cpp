@@ -23,7 +23,6 @@
 #include "ISignalChain.h"
 #include "LHPFilter.h"
 
-
 LHPFilter::LHPFilter(AudioUnitPlugin *pPlugin)
     : AudioUnit(pPlugin),
       m_filter()
@@ -44,6 +43,7 @@ void LHPFilter::serialize(QVariantMap &data, SerializationContext *pContext) con
 {
     Q_ASSERT(pContext != nullptr);
     data["filterType"] = m_pFilterType->value();
+    data["modulationInterval"] = m_pModulationInterval->value();
     AudioUnit::serialize(data, pContext);
 }
 
@@ -51,6 +51,9 @@ void LHPFilter::deserialize(const QVariantMap &data, SerializationContext *pCont
 {
     Q_ASSERT(pContext != nullptr);
     m_pFilterType->setValue(data["filterType"]);
+    if (data.contains("modulationInterval")) {
+        m_pModulationInterval->setValue(data["modulationInterval"]);
+    }
     AudioUnit::deserialize(data, pContext);
 }
 
@@ -70,6 +73,14 @@ void LHPFilter::process()
     m_pOutput->setValue(m_filter.doFilter(m_pInput->getValue()));
 }
 
+void LHPFilter::processBlock(int nFrames)
+{
+    // Cut-off frequency is sampled at the modulation interval
+    // and interpolated by the filter in between.
+    m_filter.processModulatedBlock(m_pInput->buffer(), m_pInputCutOffFreq->buffer(), m_pOutput->buffer(), nFrames,
+                                   m_pInputCutOffFreq->rate() == Port::Rate_Audio);
+}
+
 void LHPFilter::reset()
 {
     m_filter.reset();
@@ -86,6 +97,11 @@ void LHPFilter::createProperties()
     m_pFilterType->setValue(0);
     pRoot->addSubProperty(m_pFilterType);
 
+    m_pModulationInterval = propertyManager()->addProperty(QtVariantPropertyManager::enumTypeId(), "Modulation interval");
+    m_pModulationInterval->setAttribute("enumNames", VAOnePoleFilter::modulationIntervalNames());
+    m_pModulationInterval->setValue(VAOnePoleFilter::cDefaultModulationInterval);
+    pRoot->addSubProperty(m_pModulationInterval);
+
     QObject::connect(propertyManager(), &QtVariantPropertyManager::propertyChanged, [this](QtProperty *pProperty){
         Q_UNUSED(pProperty);
         setValues();
@@ -96,4 +112,5 @@ void LHPFilter::setValues()
 {
     int type = m_pFilterType->value().toInt();
     m_filter.setType(type == 0 ? VAOnePoleFilter::Type_LP : VAOnePoleFilter::Type_HP);
+    m_filter.setModulationInterval(m_pModulationInterval->value().toInt());
 }
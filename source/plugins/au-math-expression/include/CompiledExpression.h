@@ -0,0 +1,115 @@
+/*
+                          qmusic
+
+    Copyright (C) 2015 Arthur Benilov,
+    arthur.benilov@gmail.com
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This software is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    Lesser General Public License for more details.
+*/
+
+#ifndef AU_COMPILED_EXPRESSION_H
+#define AU_COMPILED_EXPRESSION_H
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include <QtGlobal>
+#include "exprtk.hpp"
+
+/**
+ * @brief Compiled math expression script.
+ *
+ * The expression tree references the script variables (x, y, t, sr)
+ * stored in this object. A unit does not own the variables: it provides
+ * its own bindings for each evaluation, so that the same compiled
+ * expression can be used by several units (e.g. the clones of a voice)
+ * one at a time.
+ */
+class CompiledExpression
+{
+public:
+
+    typedef exprtk::symbol_table<float> SymbolTable;
+    typedef exprtk::expression<float> Expression;
+    typedef exprtk::parser<float> Parser;
+
+    /**
+     * Variables of a unit evaluating the expression.
+     */
+    struct Binding
+    {
+        const float* const *ppInputs;   ///< Input buffers, one per x.
+        float* const *ppOutputs;        ///< Output buffers, one per y.
+        float *pOutputValues;           ///< Values of y kept between the evaluations.
+        qint64 timeStep;                ///< Time step of the first sample, advanced by the evaluation.
+        float dt;                       ///< Time step duration, seconds.
+        float sampleRate;
+    };
+
+    /**
+     * Compile the script.
+     * @param script Script text, without comments.
+     * @param nInputs Number of inputs (size of x).
+     * @param nOutputs Number of outputs (size of y).
+     */
+    CompiledExpression(const std::string &script, int nInputs, int nOutputs);
+
+    bool isValid() const { return m_valid; }
+
+    /**
+     * Returns the compilation error message.
+     * @return
+     */
+    const std::string& errorMessage() const { return m_errorMessage; }
+
+    /**
+     * Try to claim this expression for an evaluation.
+     * @return true if the expression was not in use.
+     */
+    bool tryLock() { return !m_busy.exchange(true, std::memory_order_acquire); }
+
+    /**
+     * Release the expression claimed by tryLock().
+     */
+    void unlock() { m_busy.store(false, std::memory_order_release); }
+
+    /**
+     * Evaluate the expression over a block of samples.
+     * The expression must be claimed by the caller.
+     * @param binding Variables of the evaluating unit.
+     * @param nFrames Number of samples to evaluate.
+     * @return false if the evaluation has failed.
+     */
+    bool evaluate(Binding &binding, int nFrames);
+
+private:
+
+    Q_DISABLE_COPY(CompiledExpression)
+
+    int m_nInputs;
+    int m_nOutputs;
+
+    // Variables referenced by the expression tree
+    float m_t;
+    float m_sampleRate;
+    std::vector<float> m_x;
+    std::vector<float> m_y;
+
+    SymbolTable m_symbolTable;
+    Expression m_expression;
+    bool m_valid;
+    std::string m_errorMessage;
+
+    /// Set while the expression is being evaluated.
+    std::atomic<bool> m_busy;
+};
+
+#endif // AU_COMPILED_EXPRESSION_H
@@ -18,21 +18,19 @@
 #ifndef AU_MATH_EXPRESSION_H
 #define AU_MATH_EXPRESSION_H
 
+#include <memory>
 #include <vector>
 #include <QVector>
-#include "exprtk.hpp"
 #include "AudioUnit.h"
+#include "CompiledExpression.h"
 
 class QtVariantProperty;
+class SharedExpression;
 
 class MathExpression : public AudioUnit
 {
 public:
 
-    typedef exprtk::symbol_table<float> SymbolTable;
-    typedef exprtk::expression<float> Expression;
-    typedef exprtk::parser<float> Parser;
-
     MathExpression(AudioUnitPlugin *pPlugin);
     ~MathExpression();
 
@@ -51,6 +49,7 @@ protected:
     void processStart();
     void processStop();
     void process();
+    void processBlock(int nFrames) override;
     void reset();
 
 private slots:
@@ -64,16 +63,20 @@ private:
     QVector<InputPort*> m_inputs;
     QVector<OutputPort*> m_outputs;
 
-    // exprtk
-    SymbolTable m_symbolTable;
-    Expression m_expression;
-    float m_sampleRate; // Sample rate.
-    float m_t;  // Time.
-    float m_dt; // Time stamp (1/sample_rate)
-    std::vector<float> m_xVector;
-    std::vector<float> m_yVector;
-    long long m_timeStep;
-    bool m_compiledOk;
+    /// Compiled script, shared with the units running the same script.
+    std::shared_ptr<SharedExpression> m_expression;
+
+    // Unit's variables bound to the expression on evaluation
+    CompiledExpression::Binding m_binding;
+    std::vector<const float*> m_inputBuffers;
+    std::vector<float*> m_outputBuffers;
+    std::vector<float> m_yVector;   ///< Script outputs, kept between samples.
+
+    // Single sample evaluation
+    std::vector<float> m_xValues;
+    std::vector<float> m_yValues;
+    std::vector<const float*> m_xPointers;
+    std::vector<float*> m_yPointers;
 
     QString m_script;
 };
@@ -15,9 +15,15 @@
     Lesser General Public License for more details.
 */
 
+#include <memory>
 #include <QtPlugin>
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
 #include "AudioUnitPlugin.h"
 
+class SharedExpression;
+
 class MathExpressionPlugin : public AudioUnitPlugin
 {
     Q_OBJECT
@@ -32,4 +38,21 @@ public:
 
     AudioUnit* createInstance() override;
     AudioUnit* createInstanceInteractive() override;
+
+    /**
+     * Returns the compiled expression for a script.
+     * Units running the same script with the same number of inputs
+     * and outputs share the compiled expression, which is compiled
+     * on first request and released with its last user.
+     * @param script Script text, without comments.
+     * @param nInputs Number of inputs.
+     * @param nOutputs Number of outputs.
+     * @return
+     */
+    std::shared_ptr<SharedExpression> acquireExpression(const QString &script, int nInputs, int nOutputs);
+
+private:
+
+    QMutex m_mutex;
+    QHash<QByteArray, std::weak_ptr<SharedExpression>> m_expressions;   ///< Compiled expressions by script hash.
 };
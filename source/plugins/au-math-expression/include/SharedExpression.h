@@ -0,0 +1,86 @@
+/*
+                          qmusic
+
+    Copyright (C) 2015 Arthur Benilov,
+    arthur.benilov@gmail.com
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This software is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    Lesser General Public License for more details.
+*/
+
+#ifndef AU_SHARED_EXPRESSION_H
+#define AU_SHARED_EXPRESSION_H
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <QMutex>
+#include "CompiledExpression.h"
+
+/**
+ * @brief Compiled script shared by the units running it.
+ *
+ * All the math expression units with the same script (typically the
+ * clones of a polyphonic voice) share the compiled expression.
+ * Since the voices are rendered concurrently, a shared expression used
+ * by several units holds one compiled instance per render thread slot
+ * (see RenderThreadPool::threadSlot()). A thread only evaluates one unit
+ * at a time, so that it always finds the instance of its slot free.
+ */
+class SharedExpression
+{
+public:
+
+    /**
+     * Construct a shared expression.
+     * @param script Script text, without comments.
+     * @param nInputs Number of inputs.
+     * @param nOutputs Number of outputs.
+     * @param maxInstances Number of render thread slots.
+     */
+    SharedExpression(const std::string &script, int nInputs, int nOutputs, int maxInstances);
+
+    /**
+     * Register a new unit running this expression.
+     * A single unit evaluates one instance, as soon as there are more units
+     * the instances of all the render thread slots are compiled.
+     * Must not be called while the expression is being evaluated.
+     */
+    void addUser();
+
+    bool isValid() const;
+
+    const std::string& errorMessage() const;
+
+    /**
+     * Evaluate the expression over a block of samples using
+     * the instance of the current render thread slot.
+     * @param binding Variables of the evaluating unit.
+     * @param nFrames Number of samples to evaluate.
+     * @return false if the evaluation has failed.
+     */
+    bool evaluate(CompiledExpression::Binding &binding, int nFrames);
+
+private:
+
+    Q_DISABLE_COPY(SharedExpression)
+
+    std::string m_script;
+    int m_nInputs;
+    int m_nOutputs;
+    int m_maxInstances;
+    int m_nUsers;
+
+    QMutex m_mutex;
+    std::vector<std::unique_ptr<CompiledExpression>> m_instances;
+    std::atomic<int> m_nInstances;  ///< Number of instances available to evaluate.
+};
+
+#endif // AU_SHARED_EXPRESSION_H
@@ -0,0 +1,98 @@
+/*
+                          qmusic
+
+    Copyright (C) 2015 Arthur Benilov,
+    arthur.benilov@gmail.com
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This software is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    Lesser General Public License for more details.
+*/
+
+#include <algorithm>
+#include "CompiledExpression.h"
+
+CompiledExpression::CompiledExpression(const std::string &script, int nInputs, int nOutputs)
+    : m_nInputs(nInputs),
+      m_nOutputs(nOutputs),
+      m_t(0.0f),
+      m_sampleRate(44100.0f),
+      m_x(nInputs, 0.0f),
+      m_y(nOutputs, 0.0f),
+      m_valid(false),
+      m_busy(false)
+{
+    Q_ASSERT(nOutputs > 0);
+
+    m_symbolTable.add_variable("t", m_t);
+    m_symbolTable.add_variable("sr", m_sampleRate);
+    m_symbolTable.add_constants();
+
+    if (nInputs > 1) {
+        m_symbolTable.add_vector("x", m_x);
+    } else if (nInputs == 1) {
+        m_symbolTable.add_variable("x", m_x[0]);
+    }
+
+    if (nOutputs > 1) {
+        m_symbolTable.add_vector("y", m_y);
+    } else {
+        m_symbolTable.add_variable("y", m_y[0]);
+    }
+
+    m_expression.register_symbol_table(m_symbolTable);
+
+    Parser parser;
+    m_valid = parser.compile(script, m_expression);
+    if (!m_valid) {
+        m_errorMessage = parser.error();
+    }
+}
+
+bool CompiledExpression::evaluate(Binding &binding, int nFrames)
+{
+    Q_ASSERT(m_valid);
+
+    // Load the unit's variables
+    m_sampleRate = binding.sampleRate;
+    for (int k = 0; k < m_nOutputs; ++k) {
+        m_y[k] = binding.pOutputValues[k];
+    }
+
+    bool ok = true;
+    int i = 0;
+    try {
+        for (; i < nFrames; ++i) {
+            for (int k = 0; k < m_nInputs; ++k) {
+                m_x[k] = binding.ppInputs[k][i];
+            }
+            m_t = (binding.timeStep + i) * binding.dt;
+
+            m_expression.value();
+
+            for (int k = 0; k < m_nOutputs; ++k) {
+                binding.ppOutputs[k][i] = m_y[k];
+            }
+        }
+    } catch (...) {
+        ok = false;
+        // Silence the rest of the block
+        for (int k = 0; k < m_nOutputs; ++k) {
+            std::fill(binding.ppOutputs[k] + i, binding.ppOutputs[k] + nFrames, 0.0f);
+        }
+    }
+
+    // Store the unit's variables back
+    for (int k = 0; k < m_nOutputs; ++k) {
+        binding.pOutputValues[k] = m_y[k];
+    }
+    binding.timeStep += nFrames;
+
+    return ok;
+}
@@ -15,6 +15,7 @@
     Lesser General Public License for more details.
 */
 
+#include <algorithm>
 #include <QDebug>
 #include <QGraphicsProxyWidget>
 #include <QPushButton>
@@ -23,21 +24,21 @@
 #include "Application.h"
 #include "ISignalChain.h"
 #include "ExprEditorDialog.h"
+#include "SharedExpression.h"
+#include "MathExpressionPlugin.h"
 #include "MathExpression.h"
 
 
 MathExpression::MathExpression(AudioUnitPlugin *pPlugin)
     : AudioUnit(pPlugin)
 {
-    m_t = 0.0f;
-    m_sampleRate = 44100.0f;    // does not matter, it will be reset on signal chain start.
-    m_symbolTable.add_variable("t", m_t);
-    m_symbolTable.add_variable("sr", m_sampleRate);
-    m_symbolTable.add_constants();
+    m_binding.ppInputs = nullptr;
+    m_binding.ppOutputs = nullptr;
+    m_binding.pOutputValues = nullptr;
+    m_binding.timeStep = 0;
+    m_binding.dt = 0.0f;
+    m_binding.sampleRate = 44100.0f;    // does not matter, it will be reset on signal chain start.
 
-    m_expression.register_symbol_table(m_symbolTable);
-
-    m_compiledOk = false;
     m_script = "y := 0;";
 }
 
@@ -51,28 +52,28 @@ void MathExpression::createPorts(int nInputs, int nOutputs)
         QString name = nInputs > 1 ? QString("x[%1]").arg(i) : "x";
         InputPort *pInput = addInput(name);
         m_inputs.append(pInput);
-        m_xVector.push_back(0.0f);
     }
 
     for (int i = 0; i < nOutputs; ++i) {
         QString name = nOutputs > 1 ? QString("y[%1]").arg(i) : "y";
         OutputPort *pOutput = addOutput(name);
         m_outputs.append(pOutput);
-        m_yVector.push_back(0.0f);
     }
 
-    if (nInputs > 1) {
-        m_symbolTable.add_vector("x", m_xVector);
-    } else if (nInputs == 1) {
-        m_symbolTable.add_variable("x", m_xVector[0]);
-    }
+    m_inputBuffers.assign(nInputs, nullptr);
+    m_outputBuffers.assign(nOutputs, nullptr);
+    m_yVector.assign(nOutputs, 0.0f);
 
-    if (nOutputs > 1) {
-        m_symbolTable.add_vector("y", m_yVector);
-    } else {
-        m_symbolTable.add_variable("y", m_yVector[0]);
+    m_xValues.assign(nInputs, 0.0f);
+    m_yValues.assign(nOutputs, 0.0f);
+    m_xPointers.clear();
+    for (float &x : m_xValues) {
+        m_xPointers.push_back(&x);
+    }
+    m_yPointers.clear();
+    for (float &y : m_yValues) {
+        m_yPointers.push_back(&y);
     }
-
 }
 
 QGraphicsItem* MathExpression::graphicsItem()
@@ -110,54 +111,73 @@ void MathExpression::deserialize(const QVariantMap &data, SerializationContext *
 
 void MathExpression::processStart()
 {
-    // Initialize and compile expression
-    Parser parser;
+    // Get the compiled expression, shared with the other units (voices) running the same script
+    MathExpressionPlugin *pPlugin = static_cast<MathExpressionPlugin*>(plugin());
     QString script = removeScriptComments(m_script);
-    m_compiledOk = parser.compile(script.toStdString(), m_expression);
-    if (!m_compiledOk) {
+    m_expression = pPlugin->acquireExpression(script, m_inputs.count(), m_outputs.count());
+    if (!m_expression->isValid()) {
         qCritical() << "Unable to evaluate expression:"
-                    << QString::fromStdString(parser.error());
+                    << QString::fromStdString(m_expression->errorMessage());
     }
 
-    m_sampleRate = signalChain()->sampleRate();
-
-    m_timeStep = 0;
-    m_dt = signalChain()->timeStep();
+    m_binding.pOutputValues = m_yVector.data();
+    m_binding.timeStep = 0;
+    m_binding.dt = signalChain()->timeStep();
+    m_binding.sampleRate = signalChain()->sampleRate();
 }
 
 void MathExpression::processStop()
 {
+    m_expression.reset();
 }
 
 void MathExpression::process()
 {
-    if (!m_compiledOk) {
+    if (!m_expression->isValid()) {
         return;
     }
 
     // Copy input values
     for (int i = 0; i < m_inputs.count(); i++) {
-        m_xVector[i] = m_inputs.at(i)->getValue();
+        m_xValues[i] = m_inputs.at(i)->getValue();
     }
 
-    // Set current time
-    m_t = m_timeStep * m_dt;
-
-    // Evaluate the expression
-    try {
-        m_expression.value();
-    } catch (...) {
+    m_binding.ppInputs = m_xPointers.data();
+    m_binding.ppOutputs = m_yPointers.data();
+    if (!m_expression->evaluate(m_binding, 1)) {
         qCritical() << "Signal processing stopped due to a faulty expression evaluation.";
         signalChain()->stop();
     }
 
     // Copy outputs from the script
     for (int i = 0; i < m_outputs.count(); i++) {
-        m_outputs[i]->setValue(m_yVector.at(i));
+        m_outputs[i]->setValue(m_yValues.at(i));
+    }
+}
+
+void MathExpression::processBlock(int nFrames)
+{
+    if (!m_expression->isValid()) {
+        for (OutputPort *pOutput : m_outputs) {
+            std::fill(pOutput->buffer(), pOutput->buffer() + nFrames, 0.0f);
+        }
+        return;
+    }
+
+    // Bind the ports buffers and evaluate the whole block at once
+    for (int i = 0; i < m_inputs.count(); i++) {
+        m_inputBuffers[i] = m_inputs.at(i)->buffer();
+    }
+    for (int i = 0; i < m_outputs.count(); i++) {
+        m_outputBuffers[i] = m_outputs.at(i)->buffer();
     }
 
-    // Advance time
-    ++m_timeStep;
+    m_binding.ppInputs = m_inputBuffers.data();
+    m_binding.ppOutputs = m_outputBuffers.data();
+    if (!m_expression->evaluate(m_binding, nFrames)) {
+        qCritical() << "Signal processing stopped due to a faulty expression evaluation.";
+        signalChain()->stop();
+    }
 }
 
 void MathExpression::reset()
@@ -15,12 +15,19 @@
     Lesser General Public License for more details.
 */
 
+#include <QCryptographicHash>
+#include <QMutexLocker>
+#include "Application.h"
+#include "RenderThreadPool.h"
 #include "ExprInputsOutputsDialog.h"
+#include "SharedExpression.h"
 #include "MathExpression.h"
 #include "MathExpressionPlugin.h"
 
 MathExpressionPlugin::MathExpressionPlugin(QObject *pParent)
-    : AudioUnitPlugin(pParent)
+    : AudioUnitPlugin(pParent),
+      m_mutex(),
+      m_expressions()
 {
 }
 
@@ -45,3 +52,29 @@ AudioUnit* MathExpressionPlugin::createInstanceInteractive()
     }
     return pUnit;
 }
+
+std::shared_ptr<SharedExpression> MathExpressionPlugin::acquireExpression(const QString &script, int nInputs, int nOutputs)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(script.toUtf8());
+    hash.addData(QString(" %1 %2").arg(nInputs).arg(nOutputs).toLatin1());
+    QByteArray key = hash.result();
+
+    QMutexLocker lock(&m_mutex);
+
+    std::shared_ptr<SharedExpression> expression = m_expressions.value(key).lock();
+    if (!expression) {
+        // Voices are rendered concurrently by the pool threads and the caller thread
+        int maxInstances = Application::instance()->renderThreadPool()->numberOfThreads() + 1;
+        expression = std::make_shared<SharedExpression>(script.toStdString(), nInputs, nOutputs, maxInstances);
+
+        // Drop the entries of the released expressions
+        for (auto it = m_expressions.begin(); it != m_expressions.end();) {
+            it = it.value().expired() ? m_expressions.erase(it) : it + 1;
+        }
+        m_expressions[key] = expression;
+    }
+    expression->addUser();
+
+    return expression;
+}
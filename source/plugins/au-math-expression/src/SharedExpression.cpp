@@ -0,0 +1,83 @@
+/*
+                          qmusic
+
+    Copyright (C) 2015 Arthur Benilov,
+    arthur.benilov@gmail.com
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This software is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    Lesser General Public License for more details.
+*/
+
+#include <QMutexLocker>
+#include "RenderThreadPool.h"
+#include "SharedExpression.h"
+
+SharedExpression::SharedExpression(const std::string &script, int nInputs, int nOutputs, int maxInstances)
+    : m_script(script),
+      m_nInputs(nInputs),
+      m_nOutputs(nOutputs),
+      m_maxInstances(qMax(1, maxInstances)),
+      m_nUsers(0),
+      m_mutex(),
+      m_instances(),
+      m_nInstances(0)
+{
+    // The instances are never reallocated while being evaluated
+    m_instances.reserve(m_maxInstances);
+    m_instances.emplace_back(new CompiledExpression(m_script, m_nInputs, m_nOutputs));
+    m_nInstances.store(1, std::memory_order_release);
+}
+
+void SharedExpression::addUser()
+{
+    QMutexLocker lock(&m_mutex);
+    ++m_nUsers;
+
+    if (!isValid()) {
+        // Do not compile a faulty script again
+        return;
+    }
+
+    int n = m_nInstances.load(std::memory_order_acquire);
+    if (m_nUsers > 1 && n < m_maxInstances) {
+        while (int(m_instances.size()) < m_maxInstances) {
+            m_instances.emplace_back(new CompiledExpression(m_script, m_nInputs, m_nOutputs));
+        }
+        m_nInstances.store(m_maxInstances, std::memory_order_release);
+    }
+}
+
+bool SharedExpression::isValid() const
+{
+    return m_instances.front()->isValid();
+}
+
+const std::string& SharedExpression::errorMessage() const
+{
+    return m_instances.front()->errorMessage();
+}
+
+bool SharedExpression::evaluate(CompiledExpression::Binding &binding, int nFrames)
+{
+    int n = m_nInstances.load(std::memory_order_acquire);
+
+    // With a single instance there is a single user, evaluated by one thread at a time
+    int slot = RenderThreadPool::threadSlot();
+    Q_ASSERT(n == 1 || slot < n);
+    CompiledExpression *pExpression = m_instances[slot % n].get();
+
+    bool locked = pExpression->tryLock();
+    Q_ASSERT(locked);
+    bool ok = pExpression->evaluate(binding, nFrames);
+    if (locked) {
+        pExpression->unlock();
+    }
+    return ok;
+}
@@ -46,6 +46,7 @@ MidiInCtrl::MidiInCtrl(AudioUnitPlugin *pPlugin)
     : AudioUnit(pPlugin)
 {
     m_pOutputValue = addOutput();
+    m_pOutputValue->setRate(Port::Rate_Control);
 
     m_pValueItem = nullptr;
     m_controllerValue = 100;
@@ -42,6 +42,7 @@ protected:
     void processStart() override;
     void processStop() override;
     void process() override;
+    void processBlock(int nFrames) override;
     void reset() override;
 
     void noteOnEvent(NoteOnEvent *pEvent) override;
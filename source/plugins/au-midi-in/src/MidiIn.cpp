@@ -32,12 +32,18 @@
 
 const QColor cDefaultColor(230, 240, 210);
 
+/// Velocity smoothing factor, per sample.
+const float cVelocitySmoothing(0.8f);
+
 MidiIn::MidiIn(AudioUnitPlugin *pPlugin)
     : AudioUnit(pPlugin)
 {
     m_pOutputFreq = addOutput("f");
     m_pOutputVelocity = addOutput("velocity");
 
+    // Frequency only changes on events, which are dispatched between blocks
+    m_pOutputFreq->setRate(Port::Rate_Control);
+
     createProperties();
 }
 
@@ -93,11 +99,25 @@ void MidiIn::process()
     m_pOutputFreq->setValue(m_frequency * m_frequencyBend);
 
     // Perform some filtering on velocity value to avoid glitches
-    const float f = 0.8f;
+    const float f = cVelocitySmoothing;
     m_pOutputVelocity->setValue(m_pOutputVelocity->getValue() * f +
                                 m_velocity * (1.0f - f));
 }
 
+void MidiIn::processBlock(int nFrames)
+{
+    m_pOutputFreq->fill(m_frequency * m_frequencyBend, nFrames);
+
+    const float f = cVelocitySmoothing;
+    float velocity = m_pOutputVelocity->getValue();
+    float *pVelocity = m_pOutputVelocity->buffer();
+    for (int i = 0; i < nFrames; ++i) {
+        velocity = velocity * f + m_velocity * (1.0f - f);
+        pVelocity[i] = velocity;
+    }
+    m_pOutputVelocity->setValue(velocity);
+}
+
 void MidiIn::reset()
 {
 }
@@ -15,6 +15,7 @@
     Lesser General Public License for more details.
 */
 
+#include <algorithm>
 #include <QDebug>
 #include <QtVariantProperty>
 #include "Application.h"
@@ -80,6 +81,23 @@ void Mixer::process()
     m_pOutput->setValue(sum * m_mixFactor);
 }
 
+void Mixer::processBlock(int nFrames)
+{
+    float *pOut = m_pOutput->buffer();
+    std::fill(pOut, pOut + nFrames, 0.0f);
+
+    for (const InputPort *pInput : m_inputs) {
+        const float *pIn = pInput->buffer();
+        for (int i = 0; i < nFrames; ++i) {
+            pOut[i] += pIn[i];
+        }
+    }
+
+    for (int i = 0; i < nFrames; ++i) {
+        pOut[i] *= m_mixFactor;
+    }
+}
+
 void Mixer::createProperties()
 {
     QtVariantProperty *pRoot = rootProperty();
@@ -50,6 +50,26 @@ void Multiplier::process()
     m_pOutput->setValue(m_pInput->getValue() * m_pGain->getValue());
 }
 
+void Multiplier::processBlock(int nFrames)
+{
+    const float *pIn = m_pInput->buffer();
+    const float *pGain = m_pGain->buffer();
+    float *pOut = m_pOutput->buffer();
+
+    if (m_pGain->rate() != Port::Rate_Audio) {
+        // Gain does not change within the block
+        const float gain = pGain[0];
+        for (int i = 0; i < nFrames; ++i) {
+            pOut[i] = pIn[i] * gain;
+        }
+        return;
+    }
+
+    for (int i = 0; i < nFrames; ++i) {
+        pOut[i] = pIn[i] * pGain[i];
+    }
+}
+
 void Multiplier::reset()
 {
 }
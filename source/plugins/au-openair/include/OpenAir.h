@@ -5,6 +5,7 @@
 
 class QtVariantProperty;
 class FIRFilter;
+class Convolver;
 
 class OpenAir : public AudioUnit
 {
@@ -17,11 +18,15 @@ public:
     void serialize(QVariantMap &data, SerializationContext *pContext) const;
     void deserialize(const QVariantMap &data, SerializationContext *pContext);
 
+    float tailLength() const override;
+    bool isInputSilent() const override;
+
 protected:
 
     void processStart();
     void processStop();
     void process();
+    void processBlock(int nFrames);
     void reset();
 
 private:
@@ -34,7 +39,14 @@ private:
 
     QtVariantProperty *m_pPropEnvironment;
 
+    /// Direct form filter used for short impulse responses.
     FIRFilter *m_pFIRFilter;
+
+    /// Partitioned convolution used for long impulse responses.
+    Convolver *m_pConvolver;
+
+    /// Impulse response duration, seconds.
+    float m_tailLength;
 };
 
 #endif // AU_OPENAIR_H
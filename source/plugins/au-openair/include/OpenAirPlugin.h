@@ -16,7 +16,7 @@ public:
 
     void initialize() override;
 
-    AudioUnit* createInstance();
+    AudioUnit* createInstance() override;
 
     QStringList environments() const;
     QVector<float> impulseResponse(const QString &env) const;
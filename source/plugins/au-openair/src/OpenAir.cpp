@@ -4,24 +4,30 @@
 #include "Application.h"
 #include "ISignalChain.h"
 #include "FIRFilter.h"
+#include "Convolver.h"
 #include "OpenAirPlugin.h"
 #include "OpenAir.h"
 
+/// Impulse responses longer than that are processed by FFT convolution.
+const int cDirectFormMaxTaps(256);
 
 OpenAir::OpenAir(AudioUnitPlugin *pPlugin)
     : AudioUnit(pPlugin)
 {
-    m_pInput = addInput("in", Signal::Type_Float);
-    m_pOutput = addOutput("out", Signal::Type_Float);
+    m_pInput = addInput("in");
+    m_pOutput = addOutput("out");
 
     createProperties();
 
     m_pFIRFilter = nullptr;
+    m_pConvolver = nullptr;
+    m_tailLength = 0.0f;
 }
 
 OpenAir::~OpenAir()
 {
     delete m_pFIRFilter;
+    delete m_pConvolver;
 }
 
 void OpenAir::serialize(QVariantMap &data, SerializationContext *pContext) const
@@ -38,6 +44,16 @@ void OpenAir::deserialize(const QVariantMap &data, SerializationContext *pContex
     AudioUnit::deserialize(data, pContext);
 }
 
+float OpenAir::tailLength() const
+{
+    return m_tailLength;
+}
+
+bool OpenAir::isInputSilent() const
+{
+    return m_pInput->isSilent();
+}
+
 void OpenAir::processStart()
 {
     createFIR();
@@ -49,11 +65,34 @@ void OpenAir::processStop()
 
 void OpenAir::process()
 {
-    m_pOutput->setFloatValue(m_pFIRFilter->process(m_pInput->value().asFloat));
+    float x = m_pInput->getValue();
+    float y = m_pConvolver != nullptr ? m_pConvolver->process(x) : m_pFIRFilter->process(x);
+    m_pOutput->setValue(y);
+}
+
+void OpenAir::processBlock(int nFrames)
+{
+    const float *pIn = m_pInput->buffer();
+    float *pOut = m_pOutput->buffer();
+
+    if (m_pConvolver != nullptr) {
+        m_pConvolver->process(pIn, pOut, nFrames);
+    } else {
+        for (int i = 0; i < nFrames; ++i) {
+            pOut[i] = m_pFIRFilter->process(pIn[i]);
+        }
+    }
+    m_pOutput->setValue(pOut[nFrames - 1]);
 }
 
 void OpenAir::reset()
 {
+    if (m_pConvolver != nullptr) {
+        m_pConvolver->reset();
+    }
+    if (m_pFIRFilter != nullptr) {
+        m_pFIRFilter->reset();
+    }
 }
 
 void OpenAir::createProperties()
@@ -75,8 +114,20 @@ void OpenAir::createProperties()
 void OpenAir::createFIR()
 {
     delete m_pFIRFilter;
+    delete m_pConvolver;
+    m_pFIRFilter = nullptr;
+    m_pConvolver = nullptr;
+
     OpenAirPlugin *pPlugin = dynamic_cast<OpenAirPlugin*>(plugin());
     QVector<float> ir = pPlugin->impulseResponse(m_pPropEnvironment->valueText());
 
-    m_pFIRFilter = new FIRFilter(ir);
+    // Direct form costs O(N) per sample, switch to
+    // the partitioned convolution for long responses.
+    if (ir.count() > cDirectFormMaxTaps) {
+        m_pConvolver = new Convolver(ir);
+    } else {
+        m_pFIRFilter = new FIRFilter(ir);
+    }
+
+    m_tailLength = float(ir.count() * signalChain()->timeStep());
 }
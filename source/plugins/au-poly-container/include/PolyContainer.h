@@ -19,8 +19,9 @@
 #define AU_POLY_CONTAINER_H
 
 #include <QPair>
-#include <QMutex>
+#include <QVector>
 #include "AudioUnit.h"
+#include "EventQueue.h"
 #include "ISignalChainSceneContainer.h"
 
 class QtVariantProperty;
@@ -34,6 +35,16 @@ public:
 
     typedef QPair<int, ISignalChain*> TheVoice;
 
+    /// Which voice is stolen when a note is played while all voices are busy.
+    /// A voice already playing the same note is always retriggered first.
+    enum StealingPolicy {
+        Stealing_Off,           ///< New notes are dropped.
+        Stealing_Oldest,        ///< Oldest released voice, otherwise oldest held one.
+        Stealing_Quietest,      ///< Voice with the lowest running RMS level.
+        Stealing_LowestNote,
+        Stealing_HighestNote
+    };
+
     PolyphonicContainer(AudioUnitPlugin *pPlugin);
     ~PolyphonicContainer();
 
@@ -49,6 +60,7 @@ protected:
     void processStart() override;
     void processStop() override;
     void process() override;
+    void processBlock(int nFrames) override;
     void reset() override;
 
     QColor color() const override;
@@ -64,8 +76,62 @@ private:
     void createProperties();
     void createVoices(int n);
     void createPorts();
-    void prepareVoicesUpdate();
     void manageVoices();
+
+    /**
+     * Allocate voices and route an event to them.
+     * This is called from the audio thread only.
+     * @param record Event record.
+     */
+    void handleEventRecord(const EventQueue::Record &record);
+
+    /**
+     * Disable the released voices that have been silent longer than the release time,
+     * so that they are not rendered anymore and can be reused.
+     * Voices which notes are still held are left alone.
+     * @param nFrames Number of samples in the rendered block.
+     */
+    void releaseSilentVoices(int nFrames);
+
+    /**
+     * Restart silence tracking of a voice that has been (re-)triggered.
+     * @param pVoice Pointer to the voice signal chain.
+     */
+    void resetVoiceSilence(ISignalChain *pVoice);
+
+    /**
+     * Choose the busy voice to steal according to the stealing policy.
+     * @return Index in the list of busy voices.
+     */
+    int voiceToSteal() const;
+
+    /**
+     * Start fading out a stolen voice, the voice keeps
+     * being rendered until the fade is complete.
+     * @param pVoice Pointer to the voice signal chain.
+     */
+    void startGhostVoice(ISignalChain *pVoice);
+
+    /**
+     * Advance ghost voices fade, and make the faded ones spare again.
+     * @param nFrames Number of samples in the rendered block.
+     */
+    void updateGhostVoices(int nFrames);
+
+    /**
+     * Render a single voice, called by the render thread pool.
+     * @param pContext Pointer to the container.
+     * @param index Index of the voice in the list of active voices.
+     */
+    static void renderVoice(void *pContext, int index);
+
+    /**
+     * Returns samples buffer of a voice output.
+     * @param voiceIndex Voice index.
+     * @param outputIndex Exposed output index.
+     * @return Pointer to the buffer of Port::MaxBlockSize samples.
+     */
+    float* voiceBuffer(int voiceIndex, int outputIndex);
     void freeAllVoices();
 
     void allocateVoices();
@@ -87,25 +153,59 @@ private:
     QList<OutputPort*> m_outputs;
     QList<ExposedOutput*> m_exposeOutputAudioUnits;
 
-    /// Locker mutex to manage access to the container
-    /// from the signal chain (process) and event loop (handleEvent).
-    QMutex m_containerMutex;
+    /// Incoming events, consumed by the audio thread at the block start.
+    /// This way the voices are managed from the audio thread only
+    /// without any locking.
+    EventQueue m_eventQueue;
 
     /// List of cloned signal chains
     QList<ISignalChain*> m_voices;
 
-    /// List of available voices to play
-    QList<ISignalChain*> m_freeVoices;
+    /// List of available voices to play (preallocated).
+    QVector<ISignalChain*> m_freeVoices;
+
+    /// Voices currently playing (preallocated).
+    QVector<TheVoice> m_busyVoices;
+
+    /// Voices kept aside to start a note while a stolen voice fades out.
+    QVector<ISignalChain*> m_spareVoices;
+    int m_nSpareVoices;
+
+    /// Output samples of all voices, a block per voice output.
+    QVector<float> m_voicesBuffer;
+
+    /// Indices of the voices rendered in the current block.
+    QVector<int> m_activeVoices;
+
+    /// Number of frames of the block being rendered.
+    int m_blockFrames;
+
+    /// Number of samples each voice output has been silent for.
+    QVector<long> m_voiceSilentFrames;
+
+    /// Running mean square level of each voice, updated by the render threads.
+    QVector<float> m_voiceLevels;
+    float m_levelSmoothing;
+
+    /// Whether each voice note has been released.
+    QVector<bool> m_voiceReleased;
 
-    /// Voices currently playing.
-    QList<TheVoice> m_busyVoices;
+    /// Number of samples left to fade out for each stolen (ghost) voice,
+    /// zero for the other voices.
+    QVector<int> m_ghostFrames;
+    int m_ghostFadeFrames;
 
     QGraphicsSimpleTextItem *m_pLabelItem;
 
     QtVariantProperty *m_pPropLabel;
     QtVariantProperty *m_pPropNumberOfVoices;
     QtVariantProperty *m_pPropStealVoice;
-    bool m_voiceStealing;
+    QtVariantProperty *m_pPropStealFadeTime;
+    StealingPolicy m_stealingPolicy;
+    QtVariantProperty *m_pPropAutoRelease;
+    QtVariantProperty *m_pPropReleaseTime;
+    bool m_autoRelease;
+    long m_releaseFrames;
 };
 
 #endif // AU_POLY_CONTAINER_H
@@ -15,20 +15,28 @@
     Lesser General Public License for more details.
 */
 
+#include <algorithm>
+#include <qmath.h>
 #include <QDebug>
 #include <QtVariantPropertyManager>
 #include <QtVariantProperty>
 #include "Application.h"
+#include "RenderThreadPool.h"
 #include "SerializationContext.h"
 #include "ExposedInput.h"
 #include "ExposedOutput.h"
 #include "SignalChain.h"
 #include "SignalChainScene.h"
-#include "NoteOnEvent.h"
 #include "NoteOffEvent.h"
 #include "PolyContainer.h"
 
 const int cNumberOfVoices(8);
+const int cMaxNumberOfVoices(128);
+const int cEventQueueCapacity(256);
+const double cReleaseTimeMs(100.0);
+const double cStealFadeTimeMs(5.0);
+const double cLevelTimeConstantMs(50.0);
+const int cGhostVoices(1);
 const QColor cItemColor(220, 200, 160);
 const QString cExposeInputUid("b12c76c4ee191b4452ed951a270b4645");
 const QString cExposeOutputUid("0a3872cffcd4f8d00843016dc031c5d4");
@@ -36,10 +44,25 @@ const QString cExposeOutputUid("0a3872cffcd4f8d00843016dc031c5d4");
 PolyphonicContainer::PolyphonicContainer(AudioUnitPlugin *pPlugin)
     : AudioUnit(pPlugin),
       m_pSignalChainScene(nullptr),
+      m_eventQueue(cEventQueueCapacity),
       m_voices(),
       m_freeVoices(),
       m_busyVoices(),
-      m_pLabelItem(nullptr)
+      m_spareVoices(),
+      m_nSpareVoices(0),
+      m_voicesBuffer(),
+      m_activeVoices(),
+      m_blockFrames(0),
+      m_voiceSilentFrames(),
+      m_voiceLevels(),
+      m_levelSmoothing(0.0f),
+      m_voiceReleased(),
+      m_ghostFrames(),
+      m_ghostFadeFrames(1),
+      m_pLabelItem(nullptr),
+      m_stealingPolicy(Stealing_Off),
+      m_autoRelease(false),
+      m_releaseFrames(0)
 {    
     createProperties();
 }
@@ -64,48 +87,9 @@ void PolyphonicContainer::handleEvent(SignalChainEvent *pEvent)
 {
     Q_ASSERT(pEvent);
 
-    QMutexLocker locker(&m_containerMutex);
-
-    switch (pEvent->type()) {
-    case SignalChainEvent::NoteOn: {
-        NoteOnEvent *pNoteOnEvent = dynamic_cast<NoteOnEvent*>(pEvent);
-        Q_ASSERT(pNoteOnEvent != nullptr);
-
-        int note = pNoteOnEvent->noteNumber();
-        ISignalChain *pVoice = findBusyVoice(note);
-        if (pVoice != nullptr) {
-            pVoice->handleEvent(pEvent);
-        } else {
-            // New note
-            ISignalChain *pVoice = pickFreeVoice();
-            if (pVoice != nullptr) {
-                pVoice->handleEvent(pEvent);
-                m_busyVoices.append(TheVoice(note, pVoice));
-            }
-        }
-        break;
-    }
-    case SignalChainEvent::NoteOff: {
-        NoteOffEvent *pNoteOffEvent = dynamic_cast<NoteOffEvent*>(pEvent);
-        Q_ASSERT(pNoteOffEvent != nullptr);
-
-        int note = pNoteOffEvent->noteNumber();
-        ISignalChain *pVoice = findBusyVoice(note);
-        if (pVoice != nullptr) {
-            pVoice->handleEvent(pEvent);
-        }
-        break;
-    }
-    default:
-        // Send all other events to all voices
-        for (ISignalChain *pSignalChain : m_voices) {
-            pSignalChain->handleEvent(pEvent);
-        }
-        break;
-    }
-
-    // Manager busy/free voices
-    manageVoices();
+    // Voices are allocated on the audio thread, at the next block start.
+    // Event is dropped if the queue is full.
+    m_eventQueue.push(EventQueue::recordFromEvent(pEvent));
 }
 
 void PolyphonicContainer::setLabel(const QString &text)
@@ -115,13 +99,21 @@ void PolyphonicContainer::setLabel(const QString &text)
 
 void PolyphonicContainer::processStart()
 {
-    // Re-allocate voices if required
+    m_stealingPolicy = static_cast<StealingPolicy>(m_pPropStealVoice->value().toInt());
+
+    // Re-allocate voices if required, spare voices are only needed for stealing
+    int nSpare = m_stealingPolicy != Stealing_Off ? cGhostVoices : 0;
     int n = m_pPropNumberOfVoices->value().toInt();
-    if (m_voices.count() != n) {
+    if (m_voices.count() != n + nSpare) {
         releaseVoices();
         allocateVoices();
     }
-    m_voiceStealing = m_pPropStealVoice->value().toBool();
+    m_autoRelease = m_pPropAutoRelease->value().toBool();
+    m_releaseFrames = long(m_pPropReleaseTime->value().toDouble() * 0.001 / signalChain()->timeStep());
+    m_ghostFadeFrames = qMax(1, int(m_pPropStealFadeTime->value().toDouble() * 0.001 / signalChain()->timeStep()));
+    m_voiceSilentFrames.fill(0, m_voices.count());
+    freeAllVoices();
+    m_eventQueue.clear();
 
     for (ISignalChain *pSignalChain : m_voices) {
         pSignalChain->setTimeStep(signalChain()->timeStep());
@@ -134,28 +126,55 @@ void PolyphonicContainer::processStop()
     for (ISignalChain *pSignalChain : m_voices) {
         pSignalChain->stop();
     }
+    m_eventQueue.clear();
     freeAllVoices();
 }
 
 void PolyphonicContainer::process()
 {
-    QMutexLocker locker(&m_containerMutex);
+    // Voices are rendered by blocks, see processBlock().
+}
 
-    prepareVoicesUpdate();
+void PolyphonicContainer::processBlock(int nFrames)
+{
+    // Handle pending events
+    EventQueue::Record record;
+    while (m_eventQueue.pop(record)) {
+        handleEventRecord(record);
+    }
 
-    // Set outputs to zero, since
-    // further all voices will add up to them
-    for (OutputPort *pOutputPort : m_outputs) {
-        pOutputPort->setValue(0.0f);
+    // Optimization: we only update the enabled (sounding) signal chains.
+    m_activeVoices.resize(0);
+    for (int i = 0; i < m_voices.count(); i++) {
+        if (m_voices.at(i)->isEnabled()) {
+            m_activeVoices.append(i);
+        }
     }
 
-    // The following will trigger update of internal signal chains.
-    for (ExposedOutput *pAu : m_exposeOutputAudioUnits) {
-        // Optimization: we only update the enabled (sounding) signal chains.
-        if (pAu->signalChain()->isEnabled()) {
-            pAu->fastUpdate();
+    // Voices are independent, render them in parallel
+    // into their own output buffers.
+    m_blockFrames = nFrames;
+    m_levelSmoothing = qExp(-nFrames * signalChain()->timeStep() * 1000.0 / cLevelTimeConstantMs);
+    Application::instance()->renderThreadPool()->run(m_activeVoices.count(), &PolyphonicContainer::renderVoice, this);
+
+    // Sum up the voices always in the same order, so that
+    // the result does not depend on the threads scheduling.
+    for (int outputIndex = 0; outputIndex < m_outputs.count(); outputIndex++) {
+        float *pOut = m_outputs.at(outputIndex)->buffer();
+        std::fill(pOut, pOut + nFrames, 0.0f);
+        for (int voiceIndex : m_activeVoices) {
+            const float *pIn = voiceBuffer(voiceIndex, outputIndex);
+            for (int i = 0; i < nFrames; ++i) {
+                pOut[i] += pIn[i];
+            }
         }
     }
+
+    updateGhostVoices(nFrames);
+
+    if (m_autoRelease) {
+        releaseSilentVoices(nFrames);
+    }
 }
 
 void PolyphonicContainer::reset()
@@ -195,6 +214,9 @@ void PolyphonicContainer::serialize(QVariantMap &data, SerializationContext *pCo
     data["label"] = m_pPropLabel->value();
     data["voices"] = m_pPropNumberOfVoices->value();
     data["voiceStealing"] = m_pPropStealVoice->value();
+    data["stealFadeTime"] = m_pPropStealFadeTime->value();
+    data["autoRelease"] = m_pPropAutoRelease->value();
+    data["releaseTime"] = m_pPropReleaseTime->value();
 }
 
 void PolyphonicContainer::deserialize(const QVariantMap &data, SerializationContext *pContext)
@@ -204,7 +226,15 @@ void PolyphonicContainer::deserialize(const QVariantMap &data, SerializationCont
     m_pSignalChainScene = pContext->deserialize<SignalChainScene>(data["signalChainScene"]);
     m_pPropLabel->setValue(data["label"]);
     m_pPropNumberOfVoices->setValue(data["voices"]);
-    m_pPropStealVoice->setValue(data["voiceStealing"]);
+    // Stealing used to be on/off, which maps to off/oldest
+    m_pPropStealVoice->setValue(data["voiceStealing"].toInt());
+    if (data.contains("stealFadeTime")) {
+        m_pPropStealFadeTime->setValue(data["stealFadeTime"]);
+    }
+    if (data.contains("autoRelease")) {
+        m_pPropAutoRelease->setValue(data["autoRelease"]);
+        m_pPropReleaseTime->setValue(data["releaseTime"]);
+    }
 
     createPorts();
 }
@@ -225,14 +255,36 @@ void PolyphonicContainer::createProperties()
 
     m_pPropNumberOfVoices = propertyManager()->addProperty(QVariant::Int, "Voices");
     m_pPropNumberOfVoices->setAttribute("minimum", 1);
-    m_pPropNumberOfVoices->setAttribute("maximum", 24);
-    m_pPropNumberOfVoices->setValue(8);
+    m_pPropNumberOfVoices->setAttribute("maximum", cMaxNumberOfVoices);
+    m_pPropNumberOfVoices->setValue(cNumberOfVoices);
     pPolyphony->addSubProperty(m_pPropNumberOfVoices);
 
-    m_pPropStealVoice = propertyManager()->addProperty(QVariant::Bool, "Voice stealing");
-    m_pPropStealVoice->setValue(false);
+    m_pPropStealVoice = propertyManager()->addProperty(QtVariantPropertyManager::enumTypeId(), "Voice stealing");
+    QVariantList policies;
+    policies << "Off" << "Oldest" << "Quietest" << "Lowest note" << "Highest note";
+    m_pPropStealVoice->setAttribute("enumNames", policies);
+    m_pPropStealVoice->setValue(Stealing_Off);
+    m_pPropStealVoice->setToolTip("Voice to reuse when a note is played while all voices are busy");
     pPolyphony->addSubProperty(m_pPropStealVoice);
 
+    m_pPropStealFadeTime = propertyManager()->addProperty(QVariant::Double, "Stolen voice fade, ms");
+    m_pPropStealFadeTime->setAttribute("minimum", 0.5);
+    m_pPropStealFadeTime->setAttribute("maximum", 50.0);
+    m_pPropStealFadeTime->setAttribute("singleStep", 1.0);
+    m_pPropStealFadeTime->setValue(cStealFadeTimeMs);
+    pPolyphony->addSubProperty(m_pPropStealFadeTime);
+
+    m_pPropAutoRelease = propertyManager()->addProperty(QVariant::Bool, "Auto release");
+    m_pPropAutoRelease->setValue(false);
+    pPolyphony->addSubProperty(m_pPropAutoRelease);
+
+    m_pPropReleaseTime = propertyManager()->addProperty(QVariant::Double, "Release after silence, ms");
+    m_pPropReleaseTime->setAttribute("minimum", 1.0);
+    m_pPropReleaseTime->setAttribute("maximum", 5000.0);
+    m_pPropReleaseTime->setAttribute("singleStep", 10.0);
+    m_pPropReleaseTime->setValue(cReleaseTimeMs);
+    pPolyphony->addSubProperty(m_pPropReleaseTime);
+
     pRoot->addSubProperty(m_pPropLabel);
     pRoot->addSubProperty(pPolyphony);
 }
@@ -244,11 +296,17 @@ void PolyphonicContainer::createVoices(int n)
     Q_ASSERT(n > 0);
 
     m_voices = m_pSignalChainScene->signalChain()->clone(n);
+    freeAllVoices();
 
-    for (ISignalChain *pVoice : m_voices) {
+    m_voicesBuffer = QVector<float>(m_voices.count() * m_outputs.count() * Port::MaxBlockSize, 0.0f);
+    m_activeVoices.resize(0);
+    m_activeVoices.reserve(m_voices.count());
 
-        // Add to the list of free voices
-        m_freeVoices.append(pVoice);
+    for (int voiceIndex = 0; voiceIndex < m_voices.count(); voiceIndex++) {
+        ISignalChain *pVoice = m_voices.at(voiceIndex);
+        // Per voice state is indexed by the voice index, so that
+        // the audio thread never searches the voices list.
+        pVoice->setVoiceIndex(voiceIndex);
 
         int inputIndex = 0;
         int outputIndex = 0;
@@ -264,7 +322,7 @@ void PolyphonicContainer::createVoices(int n)
             } else if (pAu->uid() == cExposeOutputUid) {
                 ExposedOutput *pExpOutput = dynamic_cast<ExposedOutput*>(pAu);
                 Q_ASSERT(pExpOutput != nullptr);
-                pExpOutput->setRefOutputPort(m_outputs.at(outputIndex++));
+                pExpOutput->setOutputBuffer(voiceBuffer(voiceIndex, outputIndex++));
                 m_exposeOutputAudioUnits.append(pExpOutput);
             }
         }
@@ -291,18 +349,54 @@ void PolyphonicContainer::createPorts()
     }
 }
 
-void PolyphonicContainer::prepareVoicesUpdate()
+void PolyphonicContainer::handleEventRecord(const EventQueue::Record &record)
 {
-    // Prepare updating the busy (playing) voices only.
-    for (auto voice : m_busyVoices) {
-        voice.second->prepareUpdate();
-   }
+    switch (record.type) {
+    case SignalChainEvent::NoteOn: {
+        int note = record.number;
+        ISignalChain *pVoice = findBusyVoice(note);
+        if (pVoice != nullptr) {
+            // Same note retrigger
+            EventQueue::dispatch(record, pVoice);
+            resetVoiceSilence(pVoice);
+        } else {
+            // New note
+            pVoice = pickFreeVoice();
+            if (pVoice != nullptr) {
+                EventQueue::dispatch(record, pVoice);
+                resetVoiceSilence(pVoice);
+                m_busyVoices.append(TheVoice(note, pVoice));
+            }
+        }
+        if (pVoice != nullptr) {
+            m_voiceReleased[pVoice->voiceIndex()] = false;
+        }
+        break;
+    }
+    case SignalChainEvent::NoteOff: {
+        ISignalChain *pVoice = findBusyVoice(record.number);
+        if (pVoice != nullptr) {
+            EventQueue::dispatch(record, pVoice);
+            m_voiceReleased[pVoice->voiceIndex()] = true;
+        }
+        break;
+    }
+    default:
+        // Send all other events to all voices
+        for (ISignalChain *pSignalChain : m_voices) {
+            EventQueue::dispatch(record, pSignalChain);
+        }
+        break;
+    }
+
+    // Manager busy/free voices
+    manageVoices();
 }
 
 void PolyphonicContainer::manageVoices()
 {
     // Move all already disabled voices from busy to free list
-    QList<TheVoice>::iterator it = m_busyVoices.begin();
+    QVector<TheVoice>::iterator it = m_busyVoices.begin();
     while (it != m_busyVoices.end()) {
         ISignalChain *pVoice = (*it).second;
         if (!pVoice->isEnabled()) {
@@ -315,10 +409,146 @@ void PolyphonicContainer::manageVoices()
     }
 }
 
+void PolyphonicContainer::releaseSilentVoices(int nFrames)
+{
+    bool released = false;
+
+    for (int voiceIndex : m_activeVoices) {
+        if (!m_voiceReleased.at(voiceIndex)) {
+            // A held note may still be sounding after a silence
+            continue;
+        }
+
+        bool silent = true;
+        for (int outputIndex = 0; outputIndex < m_outputs.count() && silent; outputIndex++) {
+            silent = Port::isSilentBlock(voiceBuffer(voiceIndex, outputIndex), nFrames);
+        }
+
+        long &silentFrames = m_voiceSilentFrames[voiceIndex];
+        if (!silent) {
+            silentFrames = 0;
+            continue;
+        }
+
+        silentFrames += nFrames;
+        if (silentFrames > m_releaseFrames) {
+            // The released note has faded out: stop rendering the voice
+            // and make it available.
+            m_voices.at(voiceIndex)->enable(false);
+            silentFrames = 0;
+            released = true;
+        }
+    }
+
+    if (released) {
+        manageVoices();
+    }
+}
+
+void PolyphonicContainer::resetVoiceSilence(ISignalChain *pVoice)
+{
+    int voiceIndex = pVoice->voiceIndex();
+    if (voiceIndex >= 0 && voiceIndex < m_voiceSilentFrames.count()) {
+        m_voiceSilentFrames[voiceIndex] = 0;
+    }
+}
+
+int PolyphonicContainer::voiceToSteal() const
+{
+    Q_ASSERT(!m_busyVoices.isEmpty());
+
+    int selected = 0;
+
+    switch (m_stealingPolicy) {
+    case Stealing_Oldest:
+        // Busy voices are kept in the order they have been started
+        for (int i = 0; i < m_busyVoices.count(); i++) {
+            if (m_voiceReleased.at(m_busyVoices.at(i).second->voiceIndex())) {
+                return i;
+            }
+        }
+        break;
+    case Stealing_Quietest: {
+        float minLevel = m_voiceLevels.at(m_busyVoices.first().second->voiceIndex());
+        for (int i = 1; i < m_busyVoices.count(); i++) {
+            float level = m_voiceLevels.at(m_busyVoices.at(i).second->voiceIndex());
+            if (level < minLevel) {
+                minLevel = level;
+                selected = i;
+            }
+        }
+        break;
+    }
+    case Stealing_LowestNote:
+        for (int i = 1; i < m_busyVoices.count(); i++) {
+            if (m_busyVoices.at(i).first < m_busyVoices.at(selected).first) {
+                selected = i;
+            }
+        }
+        break;
+    case Stealing_HighestNote:
+        for (int i = 1; i < m_busyVoices.count(); i++) {
+            if (m_busyVoices.at(i).first > m_busyVoices.at(selected).first) {
+                selected = i;
+            }
+        }
+        break;
+    default:
+        break;
+    }
+
+    return selected;
+}
+
+void PolyphonicContainer::startGhostVoice(ISignalChain *pVoice)
+{
+    int voiceIndex = pVoice->voiceIndex();
+    Q_ASSERT(m_voices.at(voiceIndex) == pVoice);
+    m_ghostFrames[voiceIndex] = m_ghostFadeFrames;
+}
+
+void PolyphonicContainer::updateGhostVoices(int nFrames)
+{
+    for (int voiceIndex = 0; voiceIndex < m_ghostFrames.count(); voiceIndex++) {
+        int &framesLeft = m_ghostFrames[voiceIndex];
+        if (framesLeft == 0) {
+            continue;
+        }
+
+        ISignalChain *pVoice = m_voices.at(voiceIndex);
+        framesLeft = qMax(0, framesLeft - nFrames);
+        if (framesLeft == 0 || !pVoice->isEnabled()) {
+            // Faded out: the voice note has been turned off when stolen,
+            // disable the voice and keep it for the next stealing.
+            // Envelopes restart from zero on a note played on a disabled voice.
+            framesLeft = 0;
+            pVoice->enable(false);
+            m_spareVoices.append(pVoice);
+        }
+    }
+}
+
 void PolyphonicContainer::freeAllVoices()
 {
-    m_busyVoices.clear();
-    m_freeVoices = m_voices;
+    // Keep the lists capacity, so that no allocation
+    // occurs while managing the voices.
+    m_busyVoices.resize(0);
+    m_freeVoices.resize(0);
+    m_spareVoices.resize(0);
+    m_busyVoices.reserve(m_voices.count());
+    m_freeVoices.reserve(m_voices.count());
+    m_spareVoices.reserve(m_voices.count());
+    for (int i = 0; i < m_voices.count(); i++) {
+        if (i < m_voices.count() - m_nSpareVoices) {
+            m_freeVoices.append(m_voices.at(i));
+        } else {
+            m_spareVoices.append(m_voices.at(i));
+        }
+    }
+
+    m_voiceLevels.fill(0.0f, m_voices.count());
+    m_voiceReleased.fill(false, m_voices.count());
+    m_ghostFrames.fill(0, m_voices.count());
 }
 
 void PolyphonicContainer::allocateVoices()
@@ -326,8 +556,9 @@ void PolyphonicContainer::allocateVoices()
     Q_ASSERT(m_voices.isEmpty());
 
     int n = m_pPropNumberOfVoices->value().toInt();
+    m_nSpareVoices = m_stealingPolicy != Stealing_Off ? cGhostVoices : 0;
 
-    createVoices(n);
+    createVoices(n + m_nSpareVoices);
 }
 
 void PolyphonicContainer::releaseVoices()
@@ -336,7 +567,54 @@ void PolyphonicContainer::releaseVoices()
     m_voices.clear();
     m_busyVoices.clear();
     m_freeVoices.clear();
+    m_spareVoices.clear();
+    m_nSpareVoices = 0;
     m_exposeOutputAudioUnits.clear();
+    m_voicesBuffer.clear();
+    m_activeVoices.clear();
+}
+
+void PolyphonicContainer::renderVoice(void *pContext, int index)
+{
+    PolyphonicContainer *pContainer = static_cast<PolyphonicContainer*>(pContext);
+    Q_ASSERT(pContainer != nullptr);
+
+    int voiceIndex = pContainer->m_activeVoices.at(index);
+    int nFrames = pContainer->m_blockFrames;
+    int nOutputs = pContainer->m_outputs.count();
+    pContainer->m_voices.at(voiceIndex)->processBlock(nFrames);
+
+    // Running level of the voice, used by the quietest voice stealing.
+    // Each thread only updates its own voice entries.
+    float sum = 0.0f;
+    for (int outputIndex = 0; outputIndex < nOutputs; outputIndex++) {
+        const float *pBuffer = pContainer->voiceBuffer(voiceIndex, outputIndex);
+        for (int i = 0; i < nFrames; ++i) {
+            sum += pBuffer[i] * pBuffer[i];
+        }
+    }
+    float meanSquare = nOutputs > 0 ? sum / (nFrames * nOutputs) : 0.0f;
+    float &level = pContainer->m_voiceLevels[voiceIndex];
+    level = meanSquare + pContainer->m_levelSmoothing * (level - meanSquare);
+
+    // Fade out a stolen voice
+    int framesLeft = pContainer->m_ghostFrames.at(voiceIndex);
+    if (framesLeft > 0) {
+        float step = 1.0f / pContainer->m_ghostFadeFrames;
+        for (int outputIndex = 0; outputIndex < nOutputs; outputIndex++) {
+            float *pBuffer = pContainer->voiceBuffer(voiceIndex, outputIndex);
+            for (int i = 0; i < nFrames; ++i) {
+                pBuffer[i] *= qMax(0.0f, (framesLeft - i) * step);
+            }
+        }
+    }
+}
+
+float* PolyphonicContainer::voiceBuffer(int voiceIndex, int outputIndex)
+{
+    int offset = (voiceIndex * m_outputs.count() + outputIndex) * Port::MaxBlockSize;
+    Q_ASSERT(offset + Port::MaxBlockSize <= m_voicesBuffer.size());
+    return m_voicesBuffer.data() + offset;
 }
 
 ISignalChain* PolyphonicContainer::findBusyVoice(int noteNumber)
@@ -352,22 +630,31 @@ ISignalChain* PolyphonicContainer::findBusyVoice(int noteNumber)
 ISignalChain* PolyphonicContainer::pickFreeVoice()
 {
     if (m_freeVoices.isEmpty()) {
-        if (m_voiceStealing && !m_busyVoices.isEmpty()) {
-            // Streal the oldest voice
-            TheVoice voice = m_busyVoices.first();
-            m_busyVoices.removeFirst();
+        if (m_stealingPolicy != Stealing_Off && !m_busyVoices.isEmpty()) {
+            int index = voiceToSteal();
+            TheVoice voice = m_busyVoices.at(index);
+            m_busyVoices.remove(index);
 
             // Make sure the voice note is turned off
             NoteOffEvent noteOffEvent(voice.first, 64);
             voice.second->handleEvent(&noteOffEvent);
 
+            if (!m_spareVoices.isEmpty()) {
+                // Let the stolen voice fade out while a spare one plays the new note
+                startGhostVoice(voice.second);
+                ISignalChain *pVoice = m_spareVoices.last();
+                m_spareVoices.removeLast();
+                return pVoice;
+            }
+
+            // No spare voice left (fast repeated stealing): retrigger the stolen voice
             return voice.second;
         }
         return nullptr;
     }
 
     ISignalChain *pVoice = m_freeVoices.first();
-    m_freeVoices.removeOne(pVoice);
+    m_freeVoices.remove(0);
 
     return pVoice;
 }
@@ -33,6 +33,7 @@ Slider::Slider(AudioUnitPlugin *pPlugin)
 {
     m_pSlider = nullptr;
     m_pOutput = addOutput();
+    m_pOutput->setRate(Port::Rate_Control);
     createProperties();
 }
 
@@ -18,6 +18,7 @@
 #ifndef AU_SPEAKER_H
 #define AU_SPEAKER_H
 
+#include <atomic>
 #include <QObject>
 #include "AudioBuffer.h"
 #include "AudioDevice.h"
@@ -48,6 +49,7 @@ public:
     QGraphicsItem* graphicsItem() override;
 
     void processAudio(const float *pInputBuffer, float *pOutputBuffer, long nSamples) override;
+    double latency() const override;
 
     AudioBuffer* leftBuffer() const;
     AudioBuffer* rightBuffer() const;
@@ -57,20 +59,51 @@ protected:
     void processStart() override;
     void processStop() override;
     void process() override;
+    void processBlock(int nFrames) override;
 
 private:
 
+    /**
+     * Render the signal chain directly into the interleaved output buffer.
+     * @param pOutputBuffer Interleaved stereo output buffer.
+     * @param nSamples Number of frames to render.
+     */
+    void renderInCallback(float *pOutputBuffer, long nSamples);
+
+    /**
+     * Copy samples prepared by the rendering thread into the interleaved output buffer.
+     * @param pOutputBuffer Interleaved stereo output buffer.
+     * @param nSamples Number of frames to copy.
+     */
+    void copyFromRenderThread(float *pOutputBuffer, long nSamples);
+
     void allocateBuffers();
     void releaseBuffers();
     static int bufferSizeFromSettings();
 
+    /// Audio device this speaker is rendering to.
+    AudioDevice *m_pAudioDevice;
+
     InputPort *m_pInputLeft;
     InputPort *m_pInputRight;
     QThread *m_pThread;
     SpeakerThreadObject *m_pThreadObject;
 
+    /// Polls the thread object for the collected signal to plot.
+    QTimer *m_pSignalTimer;
+
     float *m_pLeftBuffer;
     float *m_pRightBuffer;
+    long m_bufferCapacity;
+
+    /// Whether the signal chain is rendered in the audio callback.
+    std::atomic<bool> m_renderInCallback;
+
+    /// Whether the rendering thread is feeding the buffers.
+    std::atomic<bool> m_renderThreadRunning;
+
+    /// Whether the buffers have been filled once since the rendering thread start.
+    std::atomic<bool> m_buffersPrimed;
 };
 
 #endif // AU_SPEAKER_H
@@ -18,14 +18,16 @@
 #ifndef SPEAKERTHREADOBJECT_H
 #define SPEAKERTHREADOBJECT_H
 
+#include <atomic>
 #include <QObject>
 #include <QMutex>
 #include <QVector>
 #include "InputPort.h"
+#include "EventQueue.h"
 
 class ISignalChain;
-class AudioUnit;
 class AudioBuffer;
+class AudioDeviceStats;
 
 /**
  * This object is used to trigger the signal chain and it should reside in a
@@ -47,13 +49,52 @@ public:
     void setSignalChain(ISignalChain *pSignalChain);
     void setInputPorts(InputPort *pLeft, InputPort *pRight);
 
-    float dspLoad() const { return m_dspLoad; }
+    /**
+     * Set statistics block the rendering time is reported to.
+     * @param pStats Output device statistics.
+     */
+    void setStats(AudioDeviceStats *pStats) { m_pStats = pStats; }
+
+    /**
+     * Render samples by updating the whole signal chain block by block.
+     * This is used by the rendering thread and directly by the audio callback
+     * when rendering in the callback is enabled.
+     *
+     * Pending audio events are consumed at the beginning and the rendering
+     * is split at each event's sample offset within the rendered span.
+     * @param pLeft Left channel output samples.
+     * @param pRight Right channel output samples.
+     * @param nFrames Number of samples to render.
+     */
+    void render(float *pLeft, float *pRight, long nFrames);
+
+    /**
+     * Collect rendered samples for the spectrum plotting.
+     * This may be called from the audio callback: once the signal buffer
+     * is full it is only flagged as ready, the GUI polls isSignalReady().
+     * @param pLeft Left channel samples.
+     * @param pRight Right channel samples.
+     * @param nFrames Number of samples.
+     */
+    void collectSignal(const float *pLeft, const float *pRight, long nFrames);
+
+    /**
+     * Check whether the signal buffer is full and can be plotted.
+     * The buffer is not written until signalUpdateOver() is called.
+     * @return
+     */
+    bool isSignalReady() const { return m_signalReady.load(std::memory_order_acquire); }
 
 public slots:
 
-    void start(AudioUnit *pEndOfChain = nullptr);
+    void start();
     void stop();
 
+    /**
+     * Clear the buffered samples and the collected signal.
+     */
+    void reset();
+
     void signalUpdateOver();
 
 signals:
@@ -62,28 +103,27 @@ signals:
     void continueGenerateSamples();
     void bufferReady();
 
-    /**
-     * Notify DSP load update.
-     * @param l
-     */
-    void dspLoadChanged(float l);
-
-    void signalChanged();
-
 private slots:
 
-    void performChainUpdate();
-    float getNextLeftChannelSample();
-    float getNextRightChannelSample();
-
     void generateSamples();
 
 private:
 
-    void setDspLoad(float l);
+    /**
+     * Render a block of samples by updating the whole signal chain.
+     * @param pLeft Left channel output samples.
+     * @param pRight Right channel output samples.
+     * @param nFrames Number of samples to render, up to Port::MaxBlockSize.
+     */
+    void renderBlock(float *pLeft, float *pRight, int nFrames);
 
-    void requestSignalUpdate();
-    bool isSignalUpdateRequested() const { return m_singnalUpdateRequested; }
+    /**
+     * Render an arbitrary number of samples without handling events.
+     * @param pLeft Left channel output samples.
+     * @param pRight Right channel output samples.
+     * @param nFrames Number of samples to render.
+     */
+    void renderSpan(float *pLeft, float *pRight, long nFrames);
 
     QMutex m_mutex; ///< Protective mutex.
 
@@ -98,18 +138,25 @@ private:
     bool m_started;
     bool m_firstBuffer;
 
-    /// Processing load, [0..1]
-    float m_dspLoad;
+    /// Statistics the rendering time is recorded into.
+    AudioDeviceStats *m_pStats;
 
     /// Signal waveform used for spectrum update
     QVector<float> *m_pSignalBuffer;
     int m_signalIndex;
-    bool m_singnalUpdateRequested;
+
+    /// Signal buffer is full and owned by the GUI until the plotting is over.
+    std::atomic<bool> m_signalReady;
 
     InputPort *m_pLeftChannelInput;
     InputPort *m_pRightChannelInput;
 
-    QList<AudioUnit*> m_updateChain;
+    /// Queue of events to be handled by the signal chain.
+    EventQueue *m_pEventQueue;
+
+    /// Event fetched from the queue but scheduled for the next span.
+    EventQueue::Record m_pendingEvent;
+    bool m_hasPendingEvent;
 };
 
 #endif // SPEAKERTHREADOBJECT_H
@@ -15,10 +15,13 @@
     Lesser General Public License for more details.
 */
 
+#include <cstring>
 #include <QThread>
+#include <QTimer>
 #include <QGraphicsPixmapItem>
 #include "Application.h"
 #include "Settings.h"
+#include "RenderThreadPool.h"
 #include "AudioDevicesManager.h"
 #include "ISignalChain.h"
 #include "MainWindow.h"
@@ -28,6 +31,9 @@
 
 const QColor cDefaultColor(240, 230, 210);
 
+/// Interval the collected signal is checked for the spectrum plotting, ms.
+const int cSignalPollIntervalMs(50);
+
 Speaker::Speaker(AudioUnitPlugin *pPlugin)
     : AudioUnit(pPlugin)
 {
@@ -42,10 +48,17 @@ Speaker::Speaker(AudioUnitPlugin *pPlugin)
 
     m_pLeftBuffer = nullptr;
     m_pRightBuffer = nullptr;
+    m_bufferCapacity = 0;
+    m_pSignalTimer = nullptr;
+    m_renderInCallback = false;
+    m_renderThreadRunning = false;
+    m_buffersPrimed = false;
 
-    Application::instance()->audioDevicesManager()->audioOutputDevice()->addListener(this);
+    m_pAudioDevice = Application::instance()->audioDevicesManager()->audioOutputDevice();
+    m_pAudioDevice->addListener(this);
+    m_pThreadObject->setStats(m_pAudioDevice->stats());
 
-    // Connect DSP load signal and raw signal data (for spectrum plotting) with the main GUI
+    // Connect raw signal data (for spectrum plotting) with the main GUI
     MainWindow *pMainWindow = dynamic_cast<MainWindow*>(Application::instance()->mainWindow());
     if (pMainWindow != nullptr) {
         SpectrumWindow *pSpectrumWindow = pMainWindow->spectrumWindow();
@@ -53,18 +66,22 @@ Speaker::Speaker(AudioUnitPlugin *pPlugin)
 
         m_pThreadObject->setSignalBuffer(&pMainWindow->spectrumWindow()->signal());
 
-        QObject::connect(m_pThreadObject, SIGNAL(dspLoadChanged(float)),
-                         pMainWindow, SLOT(updateDspLoad(float)), Qt::QueuedConnection);
-        QObject::connect(m_pThreadObject, SIGNAL(signalChanged()),
-                         pSpectrumWindow, SLOT(updateSpectrum()));
-        QObject::connect(pSpectrumWindow, SIGNAL(spectrumUpdated()),
-                         m_pThreadObject, SLOT(signalUpdateOver()));
+        // The signal may be collected by the audio callback, which must not
+        // emit Qt signals: the GUI polls for the full buffer instead.
+        m_pSignalTimer = new QTimer(this);
+        QObject::connect(m_pSignalTimer, &QTimer::timeout, [this, pSpectrumWindow]() {
+            if (m_pThreadObject->isSignalReady()) {
+                pSpectrumWindow->updateSpectrum();
+                m_pThreadObject->signalUpdateOver();
+            }
+        });
+        m_pSignalTimer->start(cSignalPollIntervalMs);
     }
 }
 
 Speaker::~Speaker()
 {
-    Application::instance()->audioDevicesManager()->audioOutputDevice()->removeListener(this);
+    m_pAudioDevice->removeListener(this);
     m_pThreadObject->stop();
     m_pThread->quit();
     m_pThread->wait(3000);
@@ -96,27 +113,22 @@ void Speaker::processAudio(const float *pInputBuffer, float *pOutputBuffer, long
 {
     Q_UNUSED(pInputBuffer);
 
-    long length = leftBuffer()->availableToRead();
-    length = qMin(length, rightBuffer()->availableToRead());
-    length = qMin(length, nSamples);
-
-    leftBuffer()->read(m_pLeftBuffer, length);
-    rightBuffer()->read(m_pRightBuffer, length);
-
-    long i = 0;
-
-    while (i < length) {
-        *pOutputBuffer++ = m_pLeftBuffer[i];
-        *pOutputBuffer++ = m_pRightBuffer[i];
-        ++i;
+    if (m_renderInCallback.load(std::memory_order_acquire)) {
+        renderInCallback(pOutputBuffer, nSamples);
+    } else {
+        copyFromRenderThread(pOutputBuffer, nSamples);
     }
+}
 
-    // If not enough data, fill with zeroes
-    while (i < nSamples) {
-        *pOutputBuffer++ = 0.0f;
-        *pOutputBuffer++ = 0.0f;
-        ++i;
+double Speaker::latency() const
+{
+    if (m_renderInCallback.load(std::memory_order_relaxed) || signalChain() == nullptr) {
+        return 0.0;
     }
+
+    // Samples queued by the rendering thread
+    long queued = qMin(leftBuffer()->availableToRead(), rightBuffer()->availableToRead());
+    return queued * signalChain()->timeStep();
 }
 
 AudioBuffer* Speaker::leftBuffer() const
@@ -139,32 +151,115 @@ void Speaker::processStart()
 
     m_pThreadObject->setSignalChain(signalChain());
 
-    m_pThread->setPriority(QThread::TimeCriticalPriority);
-    m_pThreadObject->start(this);
+    if (Application::instance()->audioDevicesManager()->isCallbackRenderEnabled()) {
+        // The signal chain will be driven by the audio device callback,
+        // the rendering thread stays idle.
+        // The callback thread is not a QThread, assume it runs at a raised priority.
+        m_pThreadObject->reset();
+        Application::instance()->renderThreadPool()->setPriority(QThread::HighestPriority);
+        m_renderInCallback.store(true, std::memory_order_release);
+    } else {
+        // Voices rendered by the pool must not be preempted by the render thread.
+        m_pThread->setPriority(QThread::TimeCriticalPriority);
+        Application::instance()->renderThreadPool()->setPriority(m_pThread->priority());
+        m_pThreadObject->start();
+
+        // Underruns are only counted once the buffers have been filled
+        m_buffersPrimed.store(false, std::memory_order_relaxed);
+        m_renderThreadRunning.store(true, std::memory_order_release);
+    }
 }
 
 void Speaker::processStop()
 {
-    m_pThreadObject->stop();
-    m_pThread->setPriority(QThread::IdlePriority);
+    if (m_renderInCallback.load(std::memory_order_relaxed)) {
+        m_renderInCallback.store(false, std::memory_order_release);
+    } else {
+        m_renderThreadRunning.store(false, std::memory_order_release);
+        m_pThreadObject->stop();
+        m_pThread->setPriority(QThread::IdlePriority);
+    }
+    Application::instance()->renderThreadPool()->setPriority(QThread::HighPriority);
 }
 
 void Speaker::process()
 {
 }
 
+void Speaker::processBlock(int nFrames)
+{
+    // Input samples are collected by the thread object.
+    Q_UNUSED(nFrames);
+}
+
+void Speaker::renderInCallback(float *pOutputBuffer, long nSamples)
+{
+    long offset = 0;
+    while (offset < nSamples) {
+        long nFrames = qMin(nSamples - offset, m_bufferCapacity);
+        m_pThreadObject->render(m_pLeftBuffer, m_pRightBuffer, nFrames);
+        m_pThreadObject->collectSignal(m_pLeftBuffer, m_pRightBuffer, nFrames);
+
+        for (long i = 0; i < nFrames; ++i) {
+            *pOutputBuffer++ = m_pLeftBuffer[i];
+            *pOutputBuffer++ = m_pRightBuffer[i];
+        }
+        offset += nFrames;
+    }
+}
+
+void Speaker::copyFromRenderThread(float *pOutputBuffer, long nSamples)
+{
+    if (!m_renderThreadRunning.load(std::memory_order_acquire)) {
+        // The device runs before the signal chain is started and after it is stopped
+        memset(pOutputBuffer, 0, sizeof(float) * 2 * nSamples);
+        return;
+    }
+
+    long length = leftBuffer()->availableToRead();
+    length = qMin(length, rightBuffer()->availableToRead());
+    length = qMin(length, nSamples);
+
+    leftBuffer()->read(m_pLeftBuffer, length);
+    rightBuffer()->read(m_pRightBuffer, length);
+
+    long i = 0;
+
+    while (i < length) {
+        *pOutputBuffer++ = m_pLeftBuffer[i];
+        *pOutputBuffer++ = m_pRightBuffer[i];
+        ++i;
+    }
+
+    // If not enough data, fill with zeroes
+    if (!m_buffersPrimed.load(std::memory_order_relaxed)) {
+        // Initial fill of the buffers by the rendering thread
+        if (length == nSamples) {
+            m_buffersPrimed.store(true, std::memory_order_relaxed);
+        }
+    } else if (length < nSamples) {
+        m_pAudioDevice->stats()->recordUnderrun(nSamples - length);
+    }
+    while (i < nSamples) {
+        *pOutputBuffer++ = 0.0f;
+        *pOutputBuffer++ = 0.0f;
+        ++i;
+    }
+}
+
 void Speaker::allocateBuffers()
 {
     releaseBuffers();
     int bufferSize = bufferSizeFromSettings();
-    m_pLeftBuffer = new float[2 * bufferSize];
-    m_pRightBuffer = new float[2 * bufferSize];
+    m_bufferCapacity = 2 * bufferSize;
+    m_pLeftBuffer = new float[m_bufferCapacity];
+    m_pRightBuffer = new float[m_bufferCapacity];
 }
 
 void Speaker::releaseBuffers()
 {
-    delete m_pLeftBuffer;
-    delete m_pRightBuffer;
+    delete[] m_pLeftBuffer;
+    delete[] m_pRightBuffer;
     m_pLeftBuffer = nullptr;
     m_pRightBuffer = nullptr;
 }
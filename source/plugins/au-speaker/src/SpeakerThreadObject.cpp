@@ -15,12 +15,15 @@
     Lesser General Public License for more details.
 */
 
-#include <chrono>
+#include <algorithm>
 #include <QTimer>
 #include <QVector>
+#include "Application.h"
+#include "IEventRouter.h"
 #include "ISignalChain.h"
 #include "AudioBuffer.h"
-#include "AudioUnit.h"
+#include "AudioDeviceStats.h"
+#include "ProfilingClock.h"
 #include "SpeakerThreadObject.h"
 
 #define CLAMP(v)    qMax(-1.0f, qMin((v), 1.0f))
@@ -36,10 +39,12 @@ SpeakerThreadObject::SpeakerThreadObject(long bufferSize, QObject *pParent)
     m_pRightData = new float[bufferSize * 2];
     m_pSignalBuffer = nullptr;
     m_signalIndex = 0;
-    m_singnalUpdateRequested = false;
+    m_signalReady = false;
+    m_pEventQueue = Application::instance()->eventRouter()->audioEventQueue();
+    m_hasPendingEvent = false;
 
     m_started = false;
-    m_dspLoad = 0.0f;
+    m_pStats = nullptr;
 
     connect(this, SIGNAL(started()), this, SLOT(generateSamples()), Qt::QueuedConnection);
     connect(this, SIGNAL(continueGenerateSamples()),
@@ -68,72 +73,135 @@ void SpeakerThreadObject::setInputPorts(InputPort *pLeft, InputPort *pRight)
     m_pRightChannelInput = pRight;
 }
 
-void SpeakerThreadObject::start(AudioUnit *pEndOfChain)
+void SpeakerThreadObject::start()
 {
-    Q_ASSERT(m_pSignalBuffer != nullptr);
+    reset();
 
     QMutexLocker lock(&m_mutex);
     m_started = true;
     m_firstBuffer = true;
+
+    emit started();
+}
+
+void SpeakerThreadObject::reset()
+{
+    QMutexLocker lock(&m_mutex);
     m_pLeftBuffer->clear();
     m_pRightBuffer->clear();
-    m_dspLoad = 0.0;
-    setDspLoad(0.0f);
     m_signalIndex = 0;
-    m_pSignalBuffer->fill(0.0f);
-
-    // Build the update chain to avoid recursive updates
-    m_updateChain.clear();
-    if (pEndOfChain != nullptr) {
-        m_updateChain = pEndOfChain->updateChain();
+    m_signalReady.store(false, std::memory_order_release);
+    m_hasPendingEvent = false;
+    if (m_pSignalBuffer != nullptr) {
+        m_pSignalBuffer->fill(0.0f);
     }
-
-    emit started();
 }
 
 void SpeakerThreadObject::stop()
 {
     QMutexLocker lock(&m_mutex);
     m_started = false;
-    setDspLoad(0.0f);
     m_signalIndex = 0;
 }
 
 void SpeakerThreadObject::signalUpdateOver()
 {
+    // The signal index is not used by the rendering side until
+    // the buffer is given back.
     m_signalIndex = 0;
-    m_singnalUpdateRequested = false;
+    m_signalReady.store(false, std::memory_order_release);
 }
 
-void SpeakerThreadObject::performChainUpdate()
+void SpeakerThreadObject::renderBlock(float *pLeft, float *pRight, int nFrames)
 {
-    m_pSignalChain->prepareUpdate();
-    for (AudioUnit *pAu : m_updateChain) {
-        // Perform fast non-recursive update
-        pAu->fastUpdate();
+    if (!m_pSignalChain->isEnabled()) {
+        std::fill(pLeft, pLeft + nFrames, 0.0f);
+        std::fill(pRight, pRight + nFrames, 0.0f);
+        return;
+    }
+
+    // Execute the signal chain processing plan
+    m_pSignalChain->processBlock(nFrames);
+
+    // We do not update the inputs as they have been updated
+    // during the chain update.
+    const float *pLeftInput = m_pLeftChannelInput->buffer();
+    const float *pRightInput = m_pRightChannelInput->buffer();
+    for (int i = 0; i < nFrames; ++i) {
+        pLeft[i] = CLAMP(pLeftInput[i]);
+        pRight[i] = CLAMP(pRightInput[i]);
+    }
+}
+
+void SpeakerThreadObject::render(float *pLeft, float *pRight, long nFrames)
+{
+    Q_ASSERT(m_pSignalChain != nullptr);
+
+    // Events are placed relative to the time span covered by this call
+    // ending now. This delays them by one span, but preserves their
+    // relative timing down to a sample.
+    double timeStep = m_pSignalChain->timeStep();
+    double now = EventQueue::currentTime();
+    double spanStart = now - nFrames * timeStep;
+
+    long offset = 0;
+    while (offset < nFrames) {
+        if (!m_hasPendingEvent) {
+            if (!m_pEventQueue->pop(m_pendingEvent)) {
+                break;
+            }
+            m_hasPendingEvent = true;
+        }
+
+        if (m_pendingEvent.timestamp > now) {
+            // Arrived during rendering, keep it for the next span
+            break;
+        }
+
+        long eventOffset = offset;
+        if (m_pendingEvent.timestamp >= 0.0) {
+            eventOffset = long((m_pendingEvent.timestamp - spanStart) / timeStep);
+            eventOffset = qBound(offset, eventOffset, nFrames);
+        }
+
+        renderSpan(pLeft + offset, pRight + offset, eventOffset - offset);
+        offset = eventOffset;
+
+        if (m_pSignalChain->isEnabled()) {
+            EventQueue::dispatch(m_pendingEvent, m_pSignalChain);
+        }
+        m_hasPendingEvent = false;
     }
+
+    renderSpan(pLeft + offset, pRight + offset, nFrames - offset);
 }
 
-float SpeakerThreadObject::getNextLeftChannelSample()
+void SpeakerThreadObject::renderSpan(float *pLeft, float *pRight, long nFrames)
 {
-    if (m_pSignalChain->isEnabled()) {
-        // We do not update the input as it has been updated
-        // during the chain group update.
-        float value = m_pLeftChannelInput->getValue();
-        return CLAMP(value);
+    long offset = 0;
+    while (offset < nFrames) {
+        int n = int(qMin(nFrames - offset, long(Port::MaxBlockSize)));
+        renderBlock(pLeft + offset, pRight + offset, n);
+        offset += n;
     }
-    return 0.0f;
 }
 
-float SpeakerThreadObject::getNextRightChannelSample()
+void SpeakerThreadObject::collectSignal(const float *pLeft, const float *pRight, long nFrames)
 {
-    if (m_pSignalChain->isEnabled()) {
-        // We do not update the input as it has been updated
-        // during the chain group update.
-        float value = m_pRightChannelInput->getValue();
-        return CLAMP(value);
+    if (m_pSignalBuffer == nullptr || isSignalReady()) {
+        // No spectrum view attached, or the signal is being plotted
+        return;
+    }
+
+    for (long i = 0; i < nFrames && m_signalIndex < m_pSignalBuffer->size(); i++) {
+        float s = 0.5 * (pLeft[i] + pRight[i]);
+        (*m_pSignalBuffer)[m_signalIndex++] = s;
+    }
+
+    if (m_signalIndex >= m_pSignalBuffer->size()) {
+        // No Qt signal here, as this may run in the audio callback
+        m_signalReady.store(true, std::memory_order_release);
     }
-    return 0.0f;
 }
 
 void SpeakerThreadObject::generateSamples()
@@ -163,29 +231,18 @@ void SpeakerThreadObject::generateSamples()
         //
         // Windows 8 seems to provide accurate time measurements.
 
-        double realTimeUs = m_pSignalChain->timeStep() * available * 1.0e6;
+        quint64 startTicks = ProfilingClock::ticks();
 
-        auto startTime = std::chrono::high_resolution_clock::now();
-        for (long i = 0; i < available; i++) {
-            performChainUpdate();
-            m_pLeftData[i] = getNextLeftChannelSample();
-            m_pRightData[i] = getNextRightChannelSample();
-            if (m_signalIndex < m_pSignalBuffer->size()) {
-                float s = 0.5 * (m_pLeftData[i] + m_pRightData[i]);
-                (*m_pSignalBuffer)[m_signalIndex++] = s;
-            }
+        render(m_pLeftData, m_pRightData, available);
+
+        if (m_pStats != nullptr) {
+            m_pStats->recordRender(ProfilingClock::ticks() - startTicks, available);
         }
-        m_pLeftBuffer->write(m_pLeftData, available);
-        m_pRightBuffer->write(m_pRightData, available);
 
-        // Estimate DSP load as ratio of processing time vs real synthesis time.
-        auto processingTime = std::chrono::high_resolution_clock::now() - startTime;
-        double dspTimeUs = double(std::chrono::duration_cast<std::chrono::microseconds>(processingTime).count());
-        setDspLoad(dspTimeUs / realTimeUs);
+        collectSignal(m_pLeftData, m_pRightData, available);
 
-        if (m_signalIndex >= m_pSignalBuffer->size() && !isSignalUpdateRequested()) {
-            requestSignalUpdate();
-        }
+        m_pLeftBuffer->write(m_pLeftData, available);
+        m_pRightBuffer->write(m_pRightData, available);
 
         // Continue with the samples generation
         emit continueGenerateSamples();
@@ -196,18 +253,3 @@ void SpeakerThreadObject::generateSamples()
         emit bufferReady();
     }
 }
-
-void SpeakerThreadObject::setDspLoad(float l)
-{
-    float dl = qAbs(m_dspLoad - l);
-    if (dl >= 0.05) {
-        // Do some averaging to filter rapid changes
-        m_dspLoad = m_dspLoad * 0.9 + l * 0.1;
-        emit dspLoadChanged(m_dspLoad);
-    }
-}
-
-void SpeakerThreadObject::requestSignalUpdate()
-{
-    emit signalChanged();
-}
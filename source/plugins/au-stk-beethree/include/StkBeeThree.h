@@ -18,7 +18,7 @@
 #ifndef AU_STK_BEETHREE_H
 #define AU_STK_BEETHREE_H
 
-#include "AudioUnit.h"
+#include "StkInstrumentUnit.h"
 
 class QtVariantProperty;
 
@@ -26,7 +26,7 @@ namespace stk {
     class BeeThree;
 }
 
-class StkBeeThree : public AudioUnit
+class StkBeeThree : public StkInstrumentUnit
 {
 public:
 
@@ -51,21 +51,36 @@ protected:
 
     void processStart() override;
     void processStop() override;
-    void process() override;
     void reset() override;
 
     void noteOnEvent(NoteOnEvent *pEvent) override;
     void noteOffEvent(NoteOffEvent *pEvent) override;
 
+    bool updateControls() override;
+    void tick(stk::StkFrames &frames) override;
+
 private:
 
+    // Control inputs
+    enum {
+        Input_Frequency
+    };
+
+    // Property values
+    enum {
+        Value_Operator4,
+        Value_Operator3,
+        Value_LFOSpeed,
+        Value_LFODepth,
+        Value_Count
+    };
+
     void createProperties();
+    void setValues();
 
     InputPort *m_pInputFreq;
     InputPort *m_pInputVelocity;
 
-    OutputPort *m_pOutput;
-
     int m_note;
 
     QtVariantProperty *m_pPropOperator4;
@@ -15,6 +15,7 @@
     Lesser General Public License for more details.
 */
 
+#include <algorithm>
 #include <QtVariantPropertyManager>
 #include <QDebug>
 #include <QtVariantProperty>
@@ -37,16 +38,15 @@ void setCtrlPropertyAttrs(QtVariantProperty *pProp)
 }
 
 StkBeeThree::StkBeeThree(AudioUnitPlugin *pPlugin)
-    : AudioUnit(pPlugin)
+    : StkInstrumentUnit(pPlugin, Value_Count)
 {
-    m_pInputFreq = addInput("f");
+    m_pInputFreq = addControlInput("f");
     m_pInputVelocity = addInput("amp");
-    m_pOutput = addOutput("out");
 
     createProperties();
 
-    QString rawPath = QApplication::applicationDirPath() + "/rawwaves";
-    stk::Stk::setRawwavePath(rawPath.toStdString());
+    // Rawwaves path is set by the plugin, the waveforms are
+    // loaded once and shared by all instances (see stk::FileCache).
     m_pBeeThree = nullptr;
     try {
         m_pBeeThree = new stk::BeeThree();
@@ -86,6 +86,8 @@ void StkBeeThree::processStart()
         m_pBeeThree->setSampleRate(signalChain()->sampleRate());
     }
     m_note = -1;
+    setValues();
+    invalidateControls();
 }
 
 void StkBeeThree::processStop()
@@ -93,30 +95,6 @@ void StkBeeThree::processStop()
     reset();
 }
 
-void StkBeeThree::process()
-{
-    if (m_pBeeThree == nullptr) {
-        return;
-    }
-
-    float freq = m_pInputFreq->getValue();
-
-    if (freq < cMinFrequency) {
-        return;
-    }
-
-    m_pBeeThree->controlChange(Ctrl_Operator4, 128.0 * m_pPropOperator4->value().toDouble());
-    m_pBeeThree->controlChange(Ctrl_Operator3, 128.0 * m_pPropOperator3->value().toDouble());
-    m_pBeeThree->controlChange(Ctrl_LFOSpeed, 128.0 * m_pPropLFOSpeed->value().toDouble());
-    m_pBeeThree->controlChange(Ctrl_LFODepth, 128.0 * m_pPropLFODepth->value().toDouble());
-
-    m_pBeeThree->setFrequency(freq);
-
-    float sample = m_pBeeThree->tick();
-
-    m_pOutput->setValue(sample);
-}
-
 void StkBeeThree::reset()
 {
 }
@@ -129,6 +107,7 @@ void StkBeeThree::noteOnEvent(NoteOnEvent *pEvent)
     if (f > cMinFrequency) {
         m_note = pEvent->noteNumber();
         m_pBeeThree->noteOn(f, pEvent->normalizedVelocity());
+        invalidateControls();
     }
 }
 
@@ -159,4 +138,43 @@ void StkBeeThree::createProperties()
     pRoot->addSubProperty(m_pPropOperator3);
     pRoot->addSubProperty(m_pPropLFOSpeed);
     pRoot->addSubProperty(m_pPropLFODepth);
+
+    // Properties change handler
+    QObject::connect (propertyManager(), &QtVariantPropertyManager::propertyChanged, [this](QtProperty *pProperty){
+        Q_UNUSED(pProperty);
+        setValues();
+    });
+}
+
+void StkBeeThree::setValues()
+{
+    setPropertyValue(Value_Operator4, m_pPropOperator4->value().toDouble());
+    setPropertyValue(Value_Operator3, m_pPropOperator3->value().toDouble());
+    setPropertyValue(Value_LFOSpeed, m_pPropLFOSpeed->value().toDouble());
+    setPropertyValue(Value_LFODepth, m_pPropLFODepth->value().toDouble());
+}
+
+bool StkBeeThree::updateControls()
+{
+    if (m_pBeeThree == nullptr || control(Input_Frequency) < cMinFrequency) {
+        return false;
+    }
+
+    if (propertiesChanged()) {
+        m_pBeeThree->controlChange(Ctrl_Operator4, 128.0 * propertyValue(Value_Operator4));
+        m_pBeeThree->controlChange(Ctrl_Operator3, 128.0 * propertyValue(Value_Operator3));
+        m_pBeeThree->controlChange(Ctrl_LFOSpeed, 128.0 * propertyValue(Value_LFOSpeed));
+        m_pBeeThree->controlChange(Ctrl_LFODepth, 128.0 * propertyValue(Value_LFODepth));
+    }
+
+    if (controlChanged(Input_Frequency)) {
+        m_pBeeThree->setFrequency(control(Input_Frequency));
+    }
+
+    return true;
+}
+
+void StkBeeThree::tick(stk::StkFrames &frames)
+{
+    m_pBeeThree->tick(frames);
 }
@@ -15,6 +15,8 @@
     Lesser General Public License for more details.
 */
 
+#include <QApplication>
+#include <Stk.h>
 #include "StkBeeThreePlugin.h"
 #include "StkBeeThree.h"
 
@@ -28,6 +30,12 @@ QIcon StkBeeThreePlugin::icon() const
     return QIcon(":/au-stk-beethree/icon.png");
 }
 
+void StkBeeThreePlugin::initialize()
+{
+    QString rawPath = QApplication::applicationDirPath() + "/rawwaves";
+    stk::Stk::setRawwavePath(rawPath.toStdString());
+}
+
 AudioUnit* StkBeeThreePlugin::createInstance()
 {
     return new StkBeeThree(this);
@@ -20,6 +20,7 @@
 
 #include <BiQuad.h>
 #include "AudioUnit.h"
+#include "StkPropertyValues.h"
 
 class QtVariantProperty;
 
@@ -44,14 +45,36 @@ protected:
     void processStart();
     void processStop();
     void process();
+    void processBlock(int nFrames) override;
     void reset();
 
 private:
 
+    // Property values
+    enum {
+        Value_FilterType,
+        Value_Radius,
+        Value_Count
+    };
+
     void createProperties();
     void setValues();
+    void applyValues();
+
+    /**
+     * Update the filter coefficients if the frequency has changed.
+     * @param f Filter frequency, Hz.
+     */
+    void updateFrequency(float f);
 
     stk::BiQuad m_filter;
+
+    /// Block of samples processed by the filter.
+    stk::StkFrames m_frames;
+
+    /// Property values passed to the filter by the rendering thread.
+    StkPropertyValues m_values;
+
     Type m_filterType;
     float m_radius;
     float m_f;
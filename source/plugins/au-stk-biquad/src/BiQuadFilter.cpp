@@ -15,6 +15,7 @@
     Lesser General Public License for more details.
 */
 
+#include <algorithm>
 #include <QDebug>
 #include <QtVariantPropertyManager>
 #include <QtVariantProperty>
@@ -26,7 +27,9 @@
 
 BiQuadFilter::BiQuadFilter(AudioUnitPlugin *pPlugin)
     : AudioUnit(pPlugin),
-      m_filter()
+      m_filter(),
+      m_frames(Port::MaxBlockSize, 1),
+      m_values(Value_Count)
 {
     m_pInput = addInput("in");
     m_pInputCutOffFreq = addInput("f");
@@ -68,23 +71,35 @@ void BiQuadFilter::processStop()
 
 void BiQuadFilter::process()
 {
-    float f = m_pInputCutOffFreq->getValue();
-    if (m_f != f) {
-        switch(m_filterType) {
-        case Type_Resonance:
-            m_filter.setResonance(f, m_radius, true);
-            break;
-        case Type_Notch:
-            m_filter.setNotch(f, m_radius);
-            break;
-        default:
-            break;
-        }
-        m_f = f;
-    }
+    applyValues();
+    updateFrequency(m_pInputCutOffFreq->getValue());
     m_pOutput->setValue(m_filter.tick(m_pInput->getValue()));
 }
 
+void BiQuadFilter::processBlock(int nFrames)
+{
+    const float *pIn = m_pInput->buffer();
+    const float *pFreq = m_pInputCutOffFreq->buffer();
+    float *pOut = m_pOutput->buffer();
+
+    applyValues();
+
+    if (m_pInputCutOffFreq->rate() != Port::Rate_Audio) {
+        // Coefficients do not change within the block
+        updateFrequency(pFreq[0]);
+        m_frames.resize(nFrames);
+        std::copy(pIn, pIn + nFrames, &m_frames[0]);
+        m_filter.tick(m_frames);
+        std::copy(&m_frames[0], &m_frames[0] + nFrames, pOut);
+        return;
+    }
+
+    for (int i = 0; i < nFrames; ++i) {
+        updateFrequency(pFreq[i]);
+        pOut[i] = m_filter.tick(pIn[i]);
+    }
+}
+
 void BiQuadFilter::reset()
 {
 }
@@ -116,7 +131,33 @@ void BiQuadFilter::createProperties()
 
 void BiQuadFilter::setValues()
 {
-    m_filterType = m_pFilterType->value().toInt() == 0 ? Type_Resonance : Type_Notch;
-    m_radius = m_pFilterRadius->value().toFloat();
-    m_f = 0.0f;
+    m_values.set(Value_FilterType, m_pFilterType->value().toInt() == 0 ? Type_Resonance : Type_Notch);
+    m_values.set(Value_Radius, m_pFilterRadius->value().toDouble());
+}
+
+void BiQuadFilter::applyValues()
+{
+    if (m_values.fetchChanges()) {
+        m_filterType = Type(int(m_values.value(Value_FilterType)));
+        m_radius = float(m_values.value(Value_Radius));
+        // Force the coefficients update
+        m_f = 0.0f;
+    }
+}
+
+void BiQuadFilter::updateFrequency(float f)
+{
+    if (m_f != f) {
+        switch(m_filterType) {
+        case Type_Resonance:
+            m_filter.setResonance(f, m_radius, true);
+            break;
+        case Type_Notch:
+            m_filter.setNotch(f, m_radius);
+            break;
+        default:
+            break;
+        }
+        m_f = f;
+    }
 }
@@ -18,7 +18,7 @@
 #ifndef AU_STK_BOWED_H
 #define AU_STK_BOWED_H
 
-#include "AudioUnit.h"
+#include "StkInstrumentUnit.h"
 
 class QtVariantProperty;
 
@@ -26,7 +26,7 @@ namespace stk {
     class Bowed;
 }
 
-class StkBowed : public AudioUnit
+class StkBowed : public StkInstrumentUnit
 {
 public:
 
@@ -53,22 +53,37 @@ protected:
 
     void processStart() override;
     void processStop() override;
-    void process() override;
     void reset() override;
 
     void noteOnEvent(NoteOnEvent *pEvent) override;
     void noteOffEvent(NoteOffEvent *pEvent) override;
 
+    bool updateControls() override;
+    void tick(stk::StkFrames &frames) override;
+
 private:
 
+    // Control inputs
+    enum {
+        Input_Frequency,
+        Input_Amplitude
+    };
+
+    // Property values
+    enum {
+        Value_BowPressure,
+        Value_BowPosition,
+        Value_VibratoFrequency,
+        Value_VibratoGain,
+        Value_Count
+    };
+
     void createProperties();
     void setProperties();
 
     InputPort *m_pInputFreq;
     InputPort *m_pInputVelocity;
 
-    OutputPort *m_pOutput;
-
     int m_note;
 
     QtVariantProperty *m_pPropBowPressure;
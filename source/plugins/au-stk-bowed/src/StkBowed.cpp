@@ -15,6 +15,7 @@
     Lesser General Public License for more details.
 */
 
+#include <algorithm>
 #include <QDebug>
 #include <QtVariantPropertyManager>
 #include <QtVariantProperty>
@@ -37,12 +38,10 @@ void setCtrlPropertyAttrs(QtVariantProperty *pProp)
 }
 
 StkBowed::StkBowed(AudioUnitPlugin *pPlugin)
-    : AudioUnit(pPlugin)
+    : StkInstrumentUnit(pPlugin, Value_Count)
 {
-    m_pInputFreq = addInput("f");
-    m_pInputVelocity = addInput("amp");
-
-    m_pOutput = addOutput("out");
+    m_pInputFreq = addControlInput("f");
+    m_pInputVelocity = addControlInput("amp");
 
     m_note = -1;
 
@@ -85,9 +84,10 @@ void StkBowed::processStart()
 {
     if (m_pBowed != nullptr) {
         m_pBowed->setSampleRate(signalChain()->sampleRate());
-        setProperties();
     }
     m_note = -1;
+    setProperties();
+    invalidateControls();
 }
 
 void StkBowed::processStop()
@@ -95,28 +95,6 @@ void StkBowed::processStop()
     reset();
 }
 
-void StkBowed::process()
-{
-    if (m_pBowed == nullptr) {
-        return;
-    }
-
-    float freq = m_pInputFreq->getValue();
-    if (freq < cLowestFrequency) {
-        return;
-    }
-
-    float amp = m_pInputVelocity->getValue();
-
-    m_pBowed->setFrequency(freq);
-    // TODO: Should it be Ctrl_BowVelocity instead?
-    m_pBowed->controlChange(Ctrl_Volume, 128.0 * amp);
-
-    float sample = m_pBowed->tick();
-
-    m_pOutput->setValue(sample);
-}
-
 void StkBowed::reset()
 {
     m_note = -1;
@@ -130,6 +108,7 @@ void StkBowed::noteOnEvent(NoteOnEvent *pEvent)
     if (f > cLowestFrequency) {
         m_note = pEvent->noteNumber();
         m_pBowed->noteOn(f, pEvent->normalizedVelocity());
+        invalidateControls();
     }
 }
 
@@ -172,10 +151,38 @@ void StkBowed::createProperties()
 
 void StkBowed::setProperties()
 {
-    if (m_pBowed != nullptr) {
-        m_pBowed->controlChange(Ctrl_BowPressure, 128.0 * m_pPropBowPressure->value().toFloat());
-        m_pBowed->controlChange(Ctrl_BowPosition, 128.0 * m_pPropBowPosition->value().toFloat());
-        m_pBowed->controlChange(Ctrl_VibratoFrequency, 128.0 * m_pPropVibratoFrequency->value().toFloat());
-        m_pBowed->controlChange(Ctrl_VibratoGain, 128.0 * m_pPropVibratoGain->value().toFloat());
+    setPropertyValue(Value_BowPressure, m_pPropBowPressure->value().toDouble());
+    setPropertyValue(Value_BowPosition, m_pPropBowPosition->value().toDouble());
+    setPropertyValue(Value_VibratoFrequency, m_pPropVibratoFrequency->value().toDouble());
+    setPropertyValue(Value_VibratoGain, m_pPropVibratoGain->value().toDouble());
+}
+
+bool StkBowed::updateControls()
+{
+    if (m_pBowed == nullptr || control(Input_Frequency) < cLowestFrequency) {
+        return false;
+    }
+
+    if (controlChanged(Input_Frequency)) {
+        m_pBowed->setFrequency(control(Input_Frequency));
+    }
+
+    if (propertiesChanged()) {
+        m_pBowed->controlChange(Ctrl_BowPressure, 128.0 * propertyValue(Value_BowPressure));
+        m_pBowed->controlChange(Ctrl_BowPosition, 128.0 * propertyValue(Value_BowPosition));
+        m_pBowed->controlChange(Ctrl_VibratoFrequency, 128.0 * propertyValue(Value_VibratoFrequency));
+        m_pBowed->controlChange(Ctrl_VibratoGain, 128.0 * propertyValue(Value_VibratoGain));
     }
+
+    if (controlChanged(Input_Amplitude)) {
+        // TODO: Should it be Ctrl_BowVelocity instead?
+        m_pBowed->controlChange(Ctrl_Volume, 128.0 * control(Input_Amplitude));
+    }
+
+    return true;
+}
+
+void StkBowed::tick(stk::StkFrames &frames)
+{
+    m_pBowed->tick(frames);
 }
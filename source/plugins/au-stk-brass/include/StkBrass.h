@@ -18,7 +18,7 @@
 #ifndef AU_STK_BRASS_H
 #define AU_STK_BRASS_H
 
-#include "AudioUnit.h"
+#include "StkInstrumentUnit.h"
 
 class QtVariantProperty;
 
@@ -26,7 +26,7 @@ namespace stk {
     class Brass;
 }
 
-class StkBrass : public AudioUnit
+class StkBrass : public StkInstrumentUnit
 {
 public:
 
@@ -51,23 +51,37 @@ protected:
 
     void processStart() override;
     void processStop() override;
-    void process() override;
     void reset() override;
 
     void noteOnEvent(NoteOnEvent *pEvent) override;
     void noteOffEvent(NoteOffEvent *pEvent) override;
 
+    bool updateControls() override;
+    void tick(stk::StkFrames &frames) override;
+
 private:
 
+    // Control inputs
+    enum {
+        Input_Frequency,
+        Input_Breath
+    };
+
+    // Property values
+    enum {
+        Value_LipTension,
+        Value_SlideLength,
+        Value_Count
+    };
+
     void createProperties();
+    void setValues();
 
     InputPort *m_pInputFreq;
     InputPort *m_pInputVelocity;
     InputPort *m_pInputBreath;
     InputPort *m_pInputNoteOn;
 
-    OutputPort *m_pOutput;
-
     int m_note;
 
     QtVariantProperty *m_pPropLipTension;
@@ -15,6 +15,7 @@
     Lesser General Public License for more details.
 */
 
+#include <algorithm>
 #include <QDebug>
 #include <QtVariantPropertyManager>
 #include <QtVariantProperty>
@@ -37,13 +38,11 @@ void setCtrlPropertyAttrs(QtVariantProperty *pProp)
 }
 
 StkBrass::StkBrass(AudioUnitPlugin *pPlugin)
-    : AudioUnit(pPlugin)
+    : StkInstrumentUnit(pPlugin, Value_Count)
 {
-    m_pInputFreq = addInput("f");
+    m_pInputFreq = addControlInput("f");
     m_pInputVelocity = addInput("amp");
-    m_pInputBreath = addInput("breath");
-
-    m_pOutput = addOutput("out");
+    m_pInputBreath = addControlInput("breath");
 
     m_note = -1;
 
@@ -84,6 +83,8 @@ void StkBrass::processStart()
         m_pBrass->setSampleRate(signalChain()->sampleRate());
     }
     m_note = -1;
+    setValues();
+    invalidateControls();
 }
 
 void StkBrass::processStop()
@@ -91,29 +92,6 @@ void StkBrass::processStop()
     reset();
 }
 
-void StkBrass::process()
-{
-    if (m_pBrass == nullptr) {
-        return;
-    }
-
-    float freq = m_pInputFreq->getValue();
-    if (freq < cLowestFrequency) {
-        return;
-    }
-    float breath = m_pInputBreath->getValue();
-
-    m_pBrass->controlChange(Ctrl_LipTension, 128.0 * m_pPropLipTension->value().toDouble());
-    m_pBrass->controlChange(Ctrl_SlideLength, 128.0 * m_pPropSlideLength->value().toDouble());
-    m_pBrass->controlChange(Ctrl_BreathPressure, 128.0 * breath);
-
-    m_pBrass->setFrequency(freq);
-
-    float sample = m_pBrass->tick();
-
-    m_pOutput->setValue(sample);
-}
-
 void StkBrass::reset()
 {
     m_note = -1;
@@ -127,6 +105,7 @@ void StkBrass::noteOnEvent(NoteOnEvent *pEvent)
     if (f > cLowestFrequency) {
         m_note = pEvent->noteNumber();
         m_pBrass->noteOn(f, pEvent->normalizedVelocity());
+        invalidateControls();
     }
 }
 
@@ -150,4 +129,46 @@ void StkBrass::createProperties()
 
     pRoot->addSubProperty(m_pPropLipTension);
     pRoot->addSubProperty(m_pPropSlideLength);
+
+    // Properties change handler
+    QObject::connect (propertyManager(), &QtVariantPropertyManager::propertyChanged, [this](QtProperty *pProperty){
+        Q_UNUSED(pProperty);
+        setValues();
+    });
+}
+
+void StkBrass::setValues()
+{
+    setPropertyValue(Value_LipTension, m_pPropLipTension->value().toDouble());
+    setPropertyValue(Value_SlideLength, m_pPropSlideLength->value().toDouble());
+}
+
+bool StkBrass::updateControls()
+{
+    if (m_pBrass == nullptr || control(Input_Frequency) < cLowestFrequency) {
+        return false;
+    }
+
+    bool freqChanged = controlChanged(Input_Frequency);
+    if (freqChanged) {
+        m_pBrass->setFrequency(control(Input_Frequency));
+    }
+
+    // Lip tension and slide length are relative to the frequency,
+    // so they have to be applied again after it has changed.
+    if (propertiesChanged() || freqChanged) {
+        m_pBrass->controlChange(Ctrl_LipTension, 128.0 * propertyValue(Value_LipTension));
+        m_pBrass->controlChange(Ctrl_SlideLength, 128.0 * propertyValue(Value_SlideLength));
+    }
+
+    if (controlChanged(Input_Breath)) {
+        m_pBrass->controlChange(Ctrl_BreathPressure, 128.0 * control(Input_Breath));
+    }
+
+    return true;
+}
+
+void StkBrass::tick(stk::StkFrames &frames)
+{
+    m_pBrass->tick(frames);
 }
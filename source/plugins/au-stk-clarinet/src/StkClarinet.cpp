@@ -15,6 +15,7 @@
     Lesser General Public License for more details.
 */
 
+#include <algorithm>
 #include <QDebug>
 #include <QtVariantPropertyManager>
 #include <QtVariantProperty>
@@ -37,13 +38,11 @@ void setCtrlPropertyAttrs(QtVariantProperty *pProp)
 }
 
 StkClarinet::StkClarinet(AudioUnitPlugin *pPlugin)
-    : AudioUnit(pPlugin)
+    : StkInstrumentUnit(pPlugin, Value_Count)
 {
-    m_pInputFreq = addInput("f");
+    m_pInputFreq = addControlInput("f");
     m_pInputVelocity = addInput("amp");
-    m_pInputBreath = addInput("breath");
-
-    m_pOutput = addOutput("out");
+    m_pInputBreath = addControlInput("breath");
 
     m_note = -1;
 
@@ -84,6 +83,8 @@ void StkClarinet::processStart()
         m_pClarinet->setSampleRate(signalChain()->sampleRate());
     }
     m_note = -1;
+    setValues();
+    invalidateControls();
 }
 
 void StkClarinet::processStop()
@@ -91,31 +92,6 @@ void StkClarinet::processStop()
     reset();
 }
 
-void StkClarinet::process()
-{
-    if (m_pClarinet == nullptr) {
-        return;
-    }
-
-
-    float freq = m_pInputFreq->getValue();
-    if (freq < cLowestFrequency) {
-        return;
-    }
-
-    float breath = m_pInputBreath->getValue();
-
-    m_pClarinet->setFrequency(freq);
-
-    m_pClarinet->controlChange(Ctrl_ReedStiffness, 128.0 * m_pPropReedStiffness->value().toDouble());
-    m_pClarinet->controlChange(Ctrl_NoiseGain, 128.0 * m_pPropNoiseGain->value().toDouble());
-    m_pClarinet->controlChange(Ctrl_BreathPressure, 128.0 * breath);
-
-    float sample = m_pClarinet->tick();
-
-    m_pOutput->setValue(sample);
-}
-
 void StkClarinet::reset()
 {
     m_note = -1;
@@ -129,6 +105,7 @@ void StkClarinet::noteOnEvent(NoteOnEvent *pEvent)
     if (f > cLowestFrequency) {
         m_note = pEvent->noteNumber();
         m_pClarinet->noteOn(f, pEvent->normalizedVelocity());
+        invalidateControls();
     }
 }
 
@@ -152,4 +129,43 @@ void StkClarinet::createProperties()
 
     pRoot->addSubProperty(m_pPropReedStiffness);
     pRoot->addSubProperty(m_pPropNoiseGain);
+
+    // Properties change handler
+    QObject::connect (propertyManager(), &QtVariantPropertyManager::propertyChanged, [this](QtProperty *pProperty){
+        Q_UNUSED(pProperty);
+        setValues();
+    });
+}
+
+void StkClarinet::setValues()
+{
+    setPropertyValue(Value_ReedStiffness, m_pPropReedStiffness->value().toDouble());
+    setPropertyValue(Value_NoiseGain, m_pPropNoiseGain->value().toDouble());
+}
+
+bool StkClarinet::updateControls()
+{
+    if (m_pClarinet == nullptr || control(Input_Frequency) < cLowestFrequency) {
+        return false;
+    }
+
+    if (controlChanged(Input_Frequency)) {
+        m_pClarinet->setFrequency(control(Input_Frequency));
+    }
+
+    if (propertiesChanged()) {
+        m_pClarinet->controlChange(Ctrl_ReedStiffness, 128.0 * propertyValue(Value_ReedStiffness));
+        m_pClarinet->controlChange(Ctrl_NoiseGain, 128.0 * propertyValue(Value_NoiseGain));
+    }
+
+    if (controlChanged(Input_Breath)) {
+        m_pClarinet->controlChange(Ctrl_BreathPressure, 128.0 * control(Input_Breath));
+    }
+
+    return true;
+}
+
+void StkClarinet::tick(stk::StkFrames &frames)
+{
+    m_pClarinet->tick(frames);
 }
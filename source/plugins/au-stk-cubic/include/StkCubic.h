@@ -18,7 +18,9 @@
 #ifndef AU_STK_CUBIC_H
 #define AU_STK_CUBIC_H
 
+#include <Stk.h>
 #include "AudioUnit.h"
+#include "StkPropertyValues.h"
 
 class QtVariantProperty;
 
@@ -45,12 +47,23 @@ protected:
     void processStart();
     void processStop();
     void process();
+    void processBlock(int nFrames) override;
     void reset();
 
 private:
 
+    // Property values
+    enum {
+        Value_A1,
+        Value_A2,
+        Value_A3,
+        Value_Threshold,
+        Value_Count
+    };
+
     void createProperties();
     void setValues();
+    void applyValues();
 
     InputPort *m_pInput;
 
@@ -62,6 +75,12 @@ private:
     QtVariantProperty *m_pPropThreshold;
 
     stk::Cubic *m_pCubic;
+
+    /// Block of samples processed by the distortion.
+    stk::StkFrames m_frames;
+
+    /// Property values passed to the distortion by the rendering thread.
+    StkPropertyValues m_values;
 };
 
 #endif // AU_STK_CUBIC_H
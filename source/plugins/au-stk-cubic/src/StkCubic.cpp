@@ -15,6 +15,7 @@
     Lesser General Public License for more details.
 */
 
+#include <algorithm>
 #include <QtVariantPropertyManager>
 #include <QDebug>
 #include <QtVariantProperty>
@@ -26,7 +27,9 @@
 #include "StkCubic.h"
 
 StkCubic::StkCubic(AudioUnitPlugin *pPlugin)
-    : AudioUnit(pPlugin)
+    : AudioUnit(pPlugin),
+      m_frames(Port::MaxBlockSize, 1),
+      m_values(Value_Count)
 {
     m_pInput = addInput();
     m_pOutput = addOutput();
@@ -73,10 +76,30 @@ void StkCubic::processStop()
 
 void StkCubic::process()
 {
+    applyValues();
     float in = m_pInput->getValue();
     m_pOutput->setValue(m_pCubic->tick(in));
 }
 
+void StkCubic::processBlock(int nFrames)
+{
+    applyValues();
+
+    const float *pIn = m_pInput->buffer();
+    float *pOut = m_pOutput->buffer();
+
+    if (m_pInput->rate() != Port::Rate_Audio) {
+        // The distortion is memoryless, so the output is constant as well
+        std::fill(pOut, pOut + nFrames, float(m_pCubic->tick(pIn[0])));
+        return;
+    }
+
+    m_frames.resize(nFrames);
+    std::copy(pIn, pIn + nFrames, &m_frames[0]);
+    m_pCubic->tick(m_frames);
+    std::copy(&m_frames[0], &m_frames[0] + nFrames, pOut);
+}
+
 void StkCubic::reset()
 {
     m_pOutput->setValue(0.0f);
@@ -122,8 +145,18 @@ void StkCubic::createProperties()
 
 void StkCubic::setValues()
 {
-    m_pCubic->setA1(m_pPropA1->value().toFloat());
-    m_pCubic->setA2(m_pPropA2->value().toFloat());
-    m_pCubic->setA3(m_pPropA3->value().toFloat());
-    m_pCubic->setThreshold(m_pPropThreshold->value().toFloat());
+    m_values.set(Value_A1, m_pPropA1->value().toDouble());
+    m_values.set(Value_A2, m_pPropA2->value().toDouble());
+    m_values.set(Value_A3, m_pPropA3->value().toDouble());
+    m_values.set(Value_Threshold, m_pPropThreshold->value().toDouble());
+}
+
+void StkCubic::applyValues()
+{
+    if (m_values.fetchChanges()) {
+        m_pCubic->setA1(m_values.value(Value_A1));
+        m_pCubic->setA2(m_values.value(Value_A2));
+        m_pCubic->setA3(m_values.value(Value_A3));
+        m_pCubic->setThreshold(m_values.value(Value_Threshold));
+    }
 }
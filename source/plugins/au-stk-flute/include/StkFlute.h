@@ -18,7 +18,7 @@
 #ifndef AU_STK_FLUTE_H
 #define AU_STK_FLUTE_H
 
-#include "AudioUnit.h"
+#include "StkInstrumentUnit.h"
 
 class QtVariantProperty;
 
@@ -26,7 +26,7 @@ namespace stk {
     class Flute;
 }
 
-class StkFlute : public AudioUnit
+class StkFlute : public StkInstrumentUnit
 {
 public:
 
@@ -52,22 +52,36 @@ protected:
 
     void processStart() override;
     void processStop() override;
-    void process() override;
     void reset() override;
 
     void noteOnEvent(NoteOnEvent *pEvent) override;
     void noteOffEvent(NoteOffEvent *pEvent) override;
 
+    bool updateControls() override;
+    void tick(stk::StkFrames &frames) override;
+
 private:
 
+    // Control inputs
+    enum {
+        Input_Frequency,
+        Input_Breath
+    };
+
+    // Property values
+    enum {
+        Value_JetDelay,
+        Value_NoiseGain,
+        Value_Count
+    };
+
     void createProperties();
+    void setValues();
 
     InputPort *m_pInputFreq;
     InputPort *m_pInputVelocity;
     InputPort *m_pInputBreath;
 
-    OutputPort *m_pOutput;
-
     int m_note;
 
     QtVariantProperty *m_pPropJetDelay;
@@ -15,6 +15,7 @@
     Lesser General Public License for more details.
 */
 
+#include <algorithm>
 #include <QDebug>
 #include <QtVariantPropertyManager>
 #include <QtVariantProperty>
@@ -37,13 +38,11 @@ void setCtrlPropertyAttrs(QtVariantProperty *pProp)
 }
 
 StkFlute::StkFlute(AudioUnitPlugin *pPlugin)
-    : AudioUnit(pPlugin)
+    : StkInstrumentUnit(pPlugin, Value_Count)
 {
-    m_pInputFreq = addInput("f");
+    m_pInputFreq = addControlInput("f");
     m_pInputVelocity = addInput("amp");
-    m_pInputBreath = addInput("breath");
-
-    m_pOutput = addOutput("out");
+    m_pInputBreath = addControlInput("breath");
 
     m_note = -1;
 
@@ -84,6 +83,8 @@ void StkFlute::processStart()
         m_pFlute->setSampleRate(signalChain()->sampleRate());
     }
     m_note = -1;
+    setValues();
+    invalidateControls();
 }
 
 void StkFlute::processStop()
@@ -91,29 +92,6 @@ void StkFlute::processStop()
     reset();
 }
 
-void StkFlute::process()
-{
-    if (m_pFlute == nullptr) {
-        return;
-    }
-
-    float freq = m_pInputFreq->getValue();
-    if (freq < cLowestFrequency) {
-        return;
-    }
-
-    float breath = m_pInputBreath->getValue();
-
-    m_pFlute->setFrequency(freq);
-    m_pFlute->controlChange(Ctrl_BreathPressure, 128.0 * breath);
-    m_pFlute->controlChange(Ctrl_JetDelay, 128.0 * m_pPropJetDelay->value().toDouble());
-    m_pFlute->controlChange(Ctrl_NoiseGain, 128.0 * m_pPropNoiseGain->value().toDouble());
-
-    float sample = m_pFlute->tick();
-
-    m_pOutput->setValue(sample);
-}
-
 void StkFlute::reset()
 {
     m_note = -1;
@@ -127,6 +105,7 @@ void StkFlute::noteOnEvent(NoteOnEvent *pEvent)
     if (f > cLowestFrequency) {
         m_note = pEvent->noteNumber();
         m_pFlute->noteOn(f, pEvent->normalizedVelocity());
+        invalidateControls();
     }
 }
 
@@ -150,4 +129,43 @@ void StkFlute::createProperties()
 
     pRoot->addSubProperty(m_pPropJetDelay);
     pRoot->addSubProperty(m_pPropNoiseGain);
+
+    // Properties change handler
+    QObject::connect (propertyManager(), &QtVariantPropertyManager::propertyChanged, [this](QtProperty *pProperty){
+        Q_UNUSED(pProperty);
+        setValues();
+    });
+}
+
+void StkFlute::setValues()
+{
+    setPropertyValue(Value_JetDelay, m_pPropJetDelay->value().toDouble());
+    setPropertyValue(Value_NoiseGain, m_pPropNoiseGain->value().toDouble());
+}
+
+bool StkFlute::updateControls()
+{
+    if (m_pFlute == nullptr || control(Input_Frequency) < cLowestFrequency) {
+        return false;
+    }
+
+    if (controlChanged(Input_Frequency)) {
+        m_pFlute->setFrequency(control(Input_Frequency));
+    }
+
+    if (propertiesChanged()) {
+        m_pFlute->controlChange(Ctrl_JetDelay, 128.0 * propertyValue(Value_JetDelay));
+        m_pFlute->controlChange(Ctrl_NoiseGain, 128.0 * propertyValue(Value_NoiseGain));
+    }
+
+    if (controlChanged(Input_Breath)) {
+        m_pFlute->controlChange(Ctrl_BreathPressure, 128.0 * control(Input_Breath));
+    }
+
+    return true;
+}
+
+void StkFlute::tick(stk::StkFrames &frames)
+{
+    m_pFlute->tick(frames);
 }
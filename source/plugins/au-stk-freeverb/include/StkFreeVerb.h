@@ -18,7 +18,10 @@
 #ifndef AU_STK_FREEVERB_H
 #define AU_STK_FREEVERB_H
 
+#include <atomic>
+#include <Stk.h>
 #include "AudioUnit.h"
+#include "StkPropertyValues.h"
 
 class QtVariantProperty;
 
@@ -37,17 +40,32 @@ public:
     void serialize(QVariantMap &data, SerializationContext *pContext) const;
     void deserialize(const QVariantMap &data, SerializationContext *pContext);
 
+    float tailLength() const override;
+    bool isInputSilent() const override;
+
 protected:
 
     void processStart();
     void processStop();
     void process();
+    void processBlock(int nFrames) override;
     void reset();
 
 private:
 
+    // Property values
+    enum {
+        Value_RoomSize,
+        Value_Damping,
+        Value_Width,
+        Value_Frozen,
+        Value_EffectMix,
+        Value_Count
+    };
+
     void createProperties();
     void setValues();
+    void applyValues();
 
     InputPort *m_pInputLeft;
     InputPort *m_pInputRight;
@@ -62,6 +80,15 @@ private:
     QtVariantProperty *m_pPropEffectMix;    // 0..1
 
     stk::FreeVerb *m_pFreeVerb;
+
+    /// Reverberation tail length, seconds (set by the properties, read by the rendering thread).
+    std::atomic<float> m_tailLength;
+
+    /// Interleaved stereo block of samples processed by the reverb.
+    stk::StkFrames m_frames;
+
+    /// Property values passed to the reverb by the rendering thread.
+    StkPropertyValues m_values;
 };
 
 #endif // AU_STK_FREEVERB_H
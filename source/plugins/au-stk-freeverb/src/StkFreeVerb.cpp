@@ -15,6 +15,7 @@
     Lesser General Public License for more details.
 */
 
+#include <cmath>
 #include <QtVariantPropertyManager>
 #include <QDebug>
 #include <QtVariantProperty>
@@ -35,13 +36,17 @@ void setPropertyAttrs(QtVariantProperty *pProp, float min, float max, float step
 }
 
 StkFreeVerb::StkFreeVerb(AudioUnitPlugin *pPlugin)
-    : AudioUnit(pPlugin)
+    : AudioUnit(pPlugin),
+      m_frames(Port::MaxBlockSize, 2),
+      m_values(Value_Count)
 {
     m_pInputLeft = addInput("L");
     m_pInputRight = addInput("R");
     m_pOutputLeft = addOutput("L");
     m_pOutputRight = addOutput("R");
 
+    m_tailLength = -1.0f;
+
     createProperties();
 
     m_pFreeVerb = new stk::FreeVerb();
@@ -74,6 +79,16 @@ void StkFreeVerb::deserialize(const QVariantMap &data, SerializationContext *pCo
     AudioUnit::deserialize(data, pContext);
 }
 
+float StkFreeVerb::tailLength() const
+{
+    return m_tailLength;
+}
+
+bool StkFreeVerb::isInputSilent() const
+{
+    return m_pInputLeft->isSilent() && m_pInputRight->isSilent();
+}
+
 void StkFreeVerb::processStart()
 {
     m_pFreeVerb->clear();
@@ -87,12 +102,37 @@ void StkFreeVerb::processStop()
 
 void StkFreeVerb::process()
 {
+    applyValues();
     m_pOutputLeft->setValue(m_pFreeVerb->tick(m_pInputLeft->getValue(),
                                               m_pInputRight->getValue(),
                                               0));
     m_pOutputRight->setValue(m_pFreeVerb->lastOut(1));
 }
 
+void StkFreeVerb::processBlock(int nFrames)
+{
+    applyValues();
+
+    const float *pInLeft = m_pInputLeft->buffer();
+    const float *pInRight = m_pInputRight->buffer();
+    float *pOutLeft = m_pOutputLeft->buffer();
+    float *pOutRight = m_pOutputRight->buffer();
+
+    m_frames.resize(nFrames, 2);
+    for (int i = 0; i < nFrames; ++i) {
+        m_frames(i, 0) = pInLeft[i];
+        m_frames(i, 1) = pInRight[i];
+    }
+
+    // Stereo input is replaced by the stereo output
+    m_pFreeVerb->tick(m_frames);
+
+    for (int i = 0; i < nFrames; ++i) {
+        pOutLeft[i] = m_frames(i, 0);
+        pOutRight[i] = m_frames(i, 1);
+    }
+}
+
 void StkFreeVerb::reset()
 {
     m_pFreeVerb->clear();
@@ -133,9 +173,35 @@ void StkFreeVerb::createProperties()
 
 void StkFreeVerb::setValues()
 {
-    m_pFreeVerb->setRoomSize(m_pPropRoomSize->value().toFloat());
-    m_pFreeVerb->setDamping(m_pPropDamping->value().toFloat());
-    m_pFreeVerb->setWidth(m_pPropWidth->value().toFloat());
-    m_pFreeVerb->setMode(m_pPropFrozen->value().toBool());
-    m_pFreeVerb->setEffectMix(m_pPropEffectMix->value().toFloat());
+    m_values.set(Value_RoomSize, m_pPropRoomSize->value().toDouble());
+    m_values.set(Value_Damping, m_pPropDamping->value().toDouble());
+    m_values.set(Value_Width, m_pPropWidth->value().toDouble());
+    m_values.set(Value_Frozen, m_pPropFrozen->value().toBool() ? 1.0 : 0.0);
+    m_values.set(Value_EffectMix, m_pPropEffectMix->value().toDouble());
+
+    if (m_pPropFrozen->value().toBool()) {
+        // Frozen reverb sustains forever.
+        m_tailLength = -1.0f;
+    } else {
+        // FreeVerb comb filters feedback as a function of the room size,
+        // and the duration of the longest comb filter delay line (1617 samples at 44.1 kHz).
+        const double cScaleRoom = 0.28;
+        const double cOffsetRoom = 0.7;
+        const double cLongestCombDelay = 1617.0 / 44100.0;
+
+        double feedback = m_pPropRoomSize->value().toDouble() * cScaleRoom + cOffsetRoom;
+        double nLoops = std::log(double(Port::SilenceThreshold)) / std::log(feedback);
+        m_tailLength = float(nLoops * cLongestCombDelay);
+    }
+}
+
+void StkFreeVerb::applyValues()
+{
+    if (m_values.fetchChanges()) {
+        m_pFreeVerb->setRoomSize(m_values.value(Value_RoomSize));
+        m_pFreeVerb->setDamping(m_values.value(Value_Damping));
+        m_pFreeVerb->setWidth(m_values.value(Value_Width));
+        m_pFreeVerb->setMode(m_values.value(Value_Frozen) != 0.0);
+        m_pFreeVerb->setEffectMix(m_values.value(Value_EffectMix));
+    }
 }
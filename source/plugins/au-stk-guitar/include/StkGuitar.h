@@ -18,7 +18,7 @@
 #ifndef AU_STK_GUITAR_H
 #define AU_STK_GUITAR_H
 
-#include "AudioUnit.h"
+#include "StkInstrumentUnit.h"
 
 class QtVariantProperty;
 
@@ -26,7 +26,7 @@ namespace stk {
     class Guitar;
 }
 
-class StkGuitar : public AudioUnit
+class StkGuitar : public StkInstrumentUnit
 {
 public:
 
@@ -51,22 +51,34 @@ protected:
 
     void processStart() override;
     void processStop() override;
-    void process() override;
     void reset() override;
 
     void noteOnEvent(NoteOnEvent *pEvent) override;
     void noteOffEvent(NoteOffEvent *pEvent) override;
 
+    bool updateControls() override;
+    void tick(stk::StkFrames &frames) override;
+
 private:
 
+    // Control inputs
+    enum {
+        Input_Frequency
+    };
+
+    // Property values
+    enum {
+        Value_PickPosition,
+        Value_StringDamping,
+        Value_Count
+    };
+
     void createProperties();
     void setValues();
 
     InputPort *m_pInputFreq;
     InputPort *m_pInputVelocity;
 
-    OutputPort *m_pOutput;
-
     int m_note;
 
     QtVariantProperty *m_pPropPickPosition;
@@ -15,6 +15,7 @@
     Lesser General Public License for more details.
 */
 
+#include <algorithm>
 #include <QtVariantPropertyManager>
 #include <QtVariantProperty>
 #include <Guitar.h>
@@ -36,13 +37,11 @@ void setCtrlPropertyAttrs(QtVariantProperty *pProp, double v = 0.5, double min =
 }
 
 StkGuitar::StkGuitar(AudioUnitPlugin *pPlugin)
-    : AudioUnit(pPlugin)
+    : StkInstrumentUnit(pPlugin, Value_Count)
 {
-    m_pInputFreq = addInput("f");
+    m_pInputFreq = addControlInput("f");
     m_pInputVelocity = addInput("amp");
 
-    m_pOutput = addOutput("out");
-
     createProperties();
 
     m_pGuitar = new stk::Guitar();
@@ -74,6 +73,7 @@ void StkGuitar::processStart()
     m_pGuitar->setSampleRate(signalChain()->sampleRate());
     m_note = -1;
     setValues();
+    invalidateControls();
 }
 
 void StkGuitar::processStop()
@@ -81,19 +81,6 @@ void StkGuitar::processStop()
     reset();
 }
 
-void StkGuitar::process()
-{
-    float freq = m_pInputFreq->getValue();
-
-    if (freq < cMinFrequency) {
-        return;
-    }
-
-    m_pGuitar->setFrequency(freq);
-    float sample = m_pGuitar->tick();
-    m_pOutput->setValue(sample);
-}
-
 void StkGuitar::reset()
 {
     m_note = -1;
@@ -109,6 +96,7 @@ void StkGuitar::noteOnEvent(NoteOnEvent *pEvent)
     if (f > cMinFrequency) {
         m_note = pEvent->noteNumber();
         m_pGuitar->noteOn(f, pEvent->normalizedVelocity());
+        invalidateControls();
     }
 }
 
@@ -143,6 +131,30 @@ void StkGuitar::createProperties()
 
 void StkGuitar::setValues()
 {
-    m_pGuitar->controlChange(Ctrl_PickPosition, 128.0 * m_pPropPickPosition->value().toDouble());
-    m_pGuitar->controlChange(Ctrl_StringDamping, 128.0 * m_pPropStringDamping->value().toDouble());
+    setPropertyValue(Value_PickPosition, m_pPropPickPosition->value().toDouble());
+    setPropertyValue(Value_StringDamping, m_pPropStringDamping->value().toDouble());
+}
+
+bool StkGuitar::updateControls()
+{
+    if (control(Input_Frequency) < cMinFrequency) {
+        return false;
+    }
+
+    if (controlChanged(Input_Frequency)) {
+        m_pGuitar->setFrequency(control(Input_Frequency));
+    }
+
+    if (propertiesChanged()) {
+        m_pGuitar->controlChange(Ctrl_PickPosition, 128.0 * propertyValue(Value_PickPosition));
+        m_pGuitar->controlChange(Ctrl_StringDamping, 128.0 * propertyValue(Value_StringDamping));
+    }
+
+    return true;
+}
+
+void StkGuitar::tick(stk::StkFrames &frames)
+{
+    // The frames are the strings excitation input, they are kept silent.
+    m_pGuitar->tick(frames);
 }
@@ -18,7 +18,10 @@
 #ifndef AU_STK_JCREV_H
 #define AU_STK_JCREV_H
 
+#include <atomic>
+#include <Stk.h>
 #include "AudioUnit.h"
+#include "StkPropertyValues.h"
 
 class QtVariantProperty;
 
@@ -37,16 +40,30 @@ public:
     void serialize(QVariantMap &data, SerializationContext *pContext) const;
     void deserialize(const QVariantMap &data, SerializationContext *pContext);
 
+    float tailLength() const override;
+    bool isInputSilent() const override;
+
 protected:
 
     void processStart();
     void processStop();
     void process();
+    void processBlock(int nFrames) override;
     void reset();
 
 private:
 
+    // Property values
+    enum {
+        Value_DecayTime,
+        Value_EffectMix,
+        Value_Count
+    };
+
     void createProperties();
+    void setValues();
+    void applyValues();
+    void updateTailLength();
 
     InputPort *m_pInput;
 
@@ -57,6 +74,15 @@ private:
     QtVariantProperty *m_pPropEffectMix;
 
     stk::JCRev *m_pJCRev;
+
+    /// Reverberation tail length, seconds (set by the properties, read by the rendering thread).
+    std::atomic<float> m_tailLength;
+
+    /// Interleaved stereo block of samples processed by the reverb.
+    stk::StkFrames m_frames;
+
+    /// Property values passed to the reverb by the rendering thread.
+    StkPropertyValues m_values;
 };
 
 #endif // AU_STK_JCREV_H
@@ -26,12 +26,16 @@
 #include "StkJCRev.h"
 
 StkJCRev::StkJCRev(AudioUnitPlugin *pPlugin)
-    : AudioUnit(pPlugin)
+    : AudioUnit(pPlugin),
+      m_frames(Port::MaxBlockSize, 2),
+      m_values(Value_Count)
 {
     m_pInput = addInput("in");
     m_pOutputLeft = addOutput("L");
     m_pOutputRight = addOutput("R");
 
+    m_tailLength = -1.0f;
+
     createProperties();
 
     m_pJCRev = new stk::JCRev();
@@ -56,12 +60,21 @@ void StkJCRev::deserialize(const QVariantMap &data, SerializationContext *pConte
     AudioUnit::deserialize(data, pContext);
 }
 
+float StkJCRev::tailLength() const
+{
+    return m_tailLength;
+}
+
+bool StkJCRev::isInputSilent() const
+{
+    return m_pInput->isSilent();
+}
+
 void StkJCRev::processStart()
 {
     m_pJCRev->clear();
     m_pJCRev->setSampleRate(signalChain()->sampleRate());
-    m_pJCRev->setT60(m_pPropDecayTimeS->value().toFloat());
-    m_pJCRev->setEffectMix(m_pPropEffectMix->value().toFloat());
+    setValues();
 }
 
 void StkJCRev::processStop()
@@ -71,10 +84,33 @@ void StkJCRev::processStop()
 
 void StkJCRev::process()
 {
+    applyValues();
     m_pOutputLeft->setValue(m_pJCRev->tick(m_pInput->getValue(), 0));
     m_pOutputRight->setValue(m_pJCRev->lastOut(1));
 }
 
+void StkJCRev::processBlock(int nFrames)
+{
+    applyValues();
+
+    const float *pIn = m_pInput->buffer();
+    float *pOutLeft = m_pOutputLeft->buffer();
+    float *pOutRight = m_pOutputRight->buffer();
+
+    m_frames.resize(nFrames, 2);
+    for (int i = 0; i < nFrames; ++i) {
+        m_frames(i, 0) = pIn[i];
+    }
+
+    // Mono input in the left channel is replaced by the stereo output
+    m_pJCRev->tick(m_frames);
+
+    for (int i = 0; i < nFrames; ++i) {
+        pOutLeft[i] = m_frames(i, 0);
+        pOutRight[i] = m_frames(i, 1);
+    }
+}
+
 void StkJCRev::reset()
 {
     m_pJCRev->clear();
@@ -101,7 +137,27 @@ void StkJCRev::createProperties()
     // Properties change handler
     QObject::connect (propertyManager(), &QtVariantPropertyManager::propertyChanged, [this](QtProperty *pProperty){
         Q_UNUSED(pProperty);
-        m_pJCRev->setT60(m_pPropDecayTimeS->value().toFloat());
-        m_pJCRev->setEffectMix(m_pPropEffectMix->value().toFloat());
+        setValues();
     });
 }
+
+void StkJCRev::setValues()
+{
+    m_values.set(Value_DecayTime, m_pPropDecayTimeS->value().toDouble());
+    m_values.set(Value_EffectMix, m_pPropEffectMix->value().toDouble());
+    updateTailLength();
+}
+
+void StkJCRev::applyValues()
+{
+    if (m_values.fetchChanges()) {
+        m_pJCRev->setT60(m_values.value(Value_DecayTime));
+        m_pJCRev->setEffectMix(m_values.value(Value_EffectMix));
+    }
+}
+
+void StkJCRev::updateTailLength()
+{
+    // Decay time is given for -60 dB, extend it down to the silence threshold (-100 dB).
+    m_tailLength = m_pPropDecayTimeS->value().toFloat() * 100.0f / 60.0f;
+}
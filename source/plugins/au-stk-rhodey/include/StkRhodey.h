@@ -18,7 +18,7 @@
 #ifndef AU_STK_RHODEY_H
 #define AU_STK_RHODEY_H
 
-#include "AudioUnit.h"
+#include "StkInstrumentUnit.h"
 
 class QtVariantProperty;
 
@@ -26,7 +26,7 @@ namespace stk {
     class Rhodey;
 }
 
-class StkRhodey : public AudioUnit
+class StkRhodey : public StkInstrumentUnit
 {
 public:
 
@@ -43,21 +43,26 @@ protected:
 
     void processStart() override;
     void processStop() override;
-    void process() override;
     void reset() override;
 
     void noteOnEvent(NoteOnEvent *pEvent) override;
     void noteOffEvent(NoteOffEvent *pEvent) override;
 
+    bool updateControls() override;
+    void tick(stk::StkFrames &frames) override;
+
 private:
 
+    // Control inputs
+    enum {
+        Input_Frequency
+    };
+
     void createProperties();
 
     InputPort *m_pInputFreq;
     InputPort *m_pInputVelocity;
 
-    OutputPort *m_pOutput;
-
     int m_note;
 
     QtVariantProperty *m_pPropPluckPosition;
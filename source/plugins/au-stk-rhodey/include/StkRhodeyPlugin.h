@@ -30,5 +30,6 @@ public:
 
     QIcon icon() const override;
 
+    void initialize() override;
     AudioUnit* createInstance() override;
 };
@@ -15,6 +15,7 @@
     Lesser General Public License for more details.
 */
 
+#include <algorithm>
 #include <QtVariantPropertyManager>
 #include <QDebug>
 #include <QtVariantProperty>
@@ -26,19 +27,17 @@
 #include "StkRhodey.h"
 
 StkRhodey::StkRhodey(AudioUnitPlugin *pPlugin)
-    : AudioUnit(pPlugin)
+    : StkInstrumentUnit(pPlugin, 0)
 {
-    m_pInputFreq = addInput("f");
+    m_pInputFreq = addControlInput("f");
     m_pInputVelocity = addInput("amp");
 
-    m_pOutput = addOutput("out");
-
     m_note = -1;
 
     createProperties();
 
-    QString rawPath = QApplication::applicationDirPath() + "/rawwaves";
-    stk::Stk::setRawwavePath(rawPath.toStdString());
+    // Rawwaves path is set by the plugin, the waveforms are
+    // loaded once and shared by all instances (see stk::FileCache).
     m_pRhodey = nullptr;
     try {
         m_pRhodey = new stk::Rhodey();
@@ -70,6 +69,7 @@ void StkRhodey::processStart()
         m_pRhodey->setSampleRate(signalChain()->sampleRate());
     }
     m_note = -1;
+    invalidateControls();
 }
 
 void StkRhodey::processStop()
@@ -77,21 +77,6 @@ void StkRhodey::processStop()
     reset();
 }
 
-void StkRhodey::process()
-{
-    if (m_pRhodey == nullptr) {
-        return;
-    }
-
-    float freq = m_pInputFreq->getValue();
-
-    m_pRhodey->setFrequency(freq);
-
-    float sample = m_pRhodey->tick();
-
-    m_pOutput->setValue(sample);
-}
-
 void StkRhodey::reset()
 {
     m_note = -1;
@@ -103,6 +88,7 @@ void StkRhodey::noteOnEvent(NoteOnEvent *pEvent)
 
     m_note = pEvent->noteNumber();
     m_pRhodey->noteOn(pEvent->frequency(), pEvent->normalizedVelocity());
+    invalidateControls(); // Note frequency is overridden by the input
 }
 
 void StkRhodey::noteOffEvent(NoteOffEvent *pEvent)
@@ -118,3 +104,21 @@ void StkRhodey::createProperties()
 {
     QtVariantProperty *pRoot = rootProperty();
 }
+
+bool StkRhodey::updateControls()
+{
+    if (m_pRhodey == nullptr) {
+        return false;
+    }
+
+    if (controlChanged(Input_Frequency)) {
+        m_pRhodey->setFrequency(control(Input_Frequency));
+    }
+
+    return true;
+}
+
+void StkRhodey::tick(stk::StkFrames &frames)
+{
+    m_pRhodey->tick(frames);
+}
@@ -15,6 +15,8 @@
     Lesser General Public License for more details.
 */
 
+#include <QApplication>
+#include <Stk.h>
 #include "StkRhodeyPlugin.h"
 #include "StkRhodey.h"
 
@@ -28,6 +30,12 @@ QIcon StkRhodeyPlugin::icon() const
     return QIcon(":/au-stk-rhodey/icon.png");
 }
 
+void StkRhodeyPlugin::initialize()
+{
+    QString rawPath = QApplication::applicationDirPath() + "/rawwaves";
+    stk::Stk::setRawwavePath(rawPath.toStdString());
+}
+
 AudioUnit* StkRhodeyPlugin::createInstance()
 {
     return new StkRhodey(this);
@@ -18,7 +18,7 @@
 #ifndef AU_STK_SAXOFONY_H
 #define AU_STK_SAXOFONY_H
 
-#include "AudioUnit.h"
+#include "StkInstrumentUnit.h"
 
 class QtVariantProperty;
 
@@ -26,7 +26,7 @@ namespace stk {
     class Saxofony;
 }
 
-class StkSaxofony : public AudioUnit
+class StkSaxofony : public StkInstrumentUnit
 {
 public:
 
@@ -54,23 +54,39 @@ protected:
 
     void processStart() override;
     void processStop() override;
-    void process() override;
     void reset() override;
 
     void noteOnEvent(NoteOnEvent *pEvent) override;
     void noteOffEvent(NoteOffEvent *pEvent) override;
 
+    bool updateControls() override;
+    void tick(stk::StkFrames &frames) override;
+
 private:
 
+    // Control inputs
+    enum {
+        Input_Frequency,
+        Input_Breath
+    };
+
+    // Property values
+    enum {
+        Value_BlowPosition,
+        Value_ReedStiffness,
+        Value_ReedAperture,
+        Value_NoiseGain,
+        Value_Count
+    };
+
     void createProperties();
+    void setValues();
 
     InputPort *m_pInputFreq;
     InputPort *m_pInputVelocity;
     InputPort *m_pInputBreath;
     InputPort *m_pInputNoteOn;
 
-    OutputPort *m_pOutput;
-
     int m_note;
 
     QtVariantProperty *m_pPropBlowPosition;
@@ -15,6 +15,7 @@
     Lesser General Public License for more details.
 */
 
+#include <algorithm>
 #include <QDebug>
 #include <QtVariantPropertyManager>
 #include <QtVariantProperty>
@@ -37,13 +38,11 @@ void setCtrlPropertyAttrs(QtVariantProperty *pProp)
 }
 
 StkSaxofony::StkSaxofony(AudioUnitPlugin *pPlugin)
-    : AudioUnit(pPlugin)
+    : StkInstrumentUnit(pPlugin, Value_Count)
 {
-    m_pInputFreq = addInput("f");
+    m_pInputFreq = addControlInput("f");
     m_pInputVelocity = addInput("amp");
-    m_pInputBreath = addInput("breath");
-
-    m_pOutput = addOutput("out");
+    m_pInputBreath = addControlInput("breath");
 
     m_note = -1;
 
@@ -88,6 +87,8 @@ void StkSaxofony::processStart()
         m_pSaxofony->setSampleRate(signalChain()->sampleRate());
     }
     m_note = -1;
+    setValues();
+    invalidateControls();
 }
 
 void StkSaxofony::processStop()
@@ -95,32 +96,6 @@ void StkSaxofony::processStop()
     reset();
 }
 
-void StkSaxofony::process()
-{
-    if (m_pSaxofony == nullptr) {
-        return;
-    }
-
-    float freq = m_pInputFreq->getValue();
-    if (freq < cLowestFrequency) {
-        return;
-    }
-
-    float breath = m_pInputBreath->getValue();
-
-    m_pSaxofony->setFrequency(freq);
-
-    m_pSaxofony->setBlowPosition(m_pPropBlowPosition->value().toDouble());
-    m_pSaxofony->controlChange(Ctrl_ReedStiffness, 128.0 * m_pPropReedStiffness->value().toDouble());
-    m_pSaxofony->controlChange(Ctrl_ReedAperture, 128.0 * m_pPropReedAperture->value().toDouble());
-    m_pSaxofony->controlChange(Ctrl_NoiseGain, 128.0 * m_pPropNoiseGain->value().toDouble());
-    m_pSaxofony->controlChange(Ctrl_BreathPressure, 128.0 * breath);
-
-    float sample = m_pSaxofony->tick();
-
-    m_pOutput->setValue(sample);
-}
-
 void StkSaxofony::reset()
 {
     m_note = -1;
@@ -132,6 +107,7 @@ void StkSaxofony::noteOnEvent(NoteOnEvent *pEvent)
 
     m_note = pEvent->noteNumber();
     m_pSaxofony->noteOn(pEvent->frequency(), pEvent->normalizedVelocity());
+    invalidateControls();
 }
 
 void StkSaxofony::noteOffEvent(NoteOffEvent *pEvent)
@@ -160,4 +136,47 @@ void StkSaxofony::createProperties()
     pRoot->addSubProperty(m_pPropReedStiffness);
     pRoot->addSubProperty(m_pPropReedAperture);
     pRoot->addSubProperty(m_pPropNoiseGain);
+
+    // Properties change handler
+    QObject::connect (propertyManager(), &QtVariantPropertyManager::propertyChanged, [this](QtProperty *pProperty){
+        Q_UNUSED(pProperty);
+        setValues();
+    });
+}
+
+void StkSaxofony::setValues()
+{
+    setPropertyValue(Value_BlowPosition, m_pPropBlowPosition->value().toDouble());
+    setPropertyValue(Value_ReedStiffness, m_pPropReedStiffness->value().toDouble());
+    setPropertyValue(Value_ReedAperture, m_pPropReedAperture->value().toDouble());
+    setPropertyValue(Value_NoiseGain, m_pPropNoiseGain->value().toDouble());
+}
+
+bool StkSaxofony::updateControls()
+{
+    if (m_pSaxofony == nullptr || control(Input_Frequency) < cLowestFrequency) {
+        return false;
+    }
+
+    if (controlChanged(Input_Frequency)) {
+        m_pSaxofony->setFrequency(control(Input_Frequency));
+    }
+
+    if (propertiesChanged()) {
+        m_pSaxofony->setBlowPosition(propertyValue(Value_BlowPosition));
+        m_pSaxofony->controlChange(Ctrl_ReedStiffness, 128.0 * propertyValue(Value_ReedStiffness));
+        m_pSaxofony->controlChange(Ctrl_ReedAperture, 128.0 * propertyValue(Value_ReedAperture));
+        m_pSaxofony->controlChange(Ctrl_NoiseGain, 128.0 * propertyValue(Value_NoiseGain));
+    }
+
+    if (controlChanged(Input_Breath)) {
+        m_pSaxofony->controlChange(Ctrl_BreathPressure, 128.0 * control(Input_Breath));
+    }
+
+    return true;
+}
+
+void StkSaxofony::tick(stk::StkFrames &frames)
+{
+    m_pSaxofony->tick(frames);
 }
@@ -0,0 +1,140 @@
+/*
+                          qmusic
+
+    Copyright (C) 2015 Arthur Benilov,
+    arthur.benilov@gmail.com
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This software is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    Lesser General Public License for more details.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QVector>
+#include "Application.h"
+#include "AudioDevicesManager.h"
+#include "AudioDevice.h"
+#include "IEventRouter.h"
+#include "EventQueue.h"
+#include "SignalChain.h"
+#include "WavWriter.h"
+#include "OfflineRenderer.h"
+
+OfflineRenderer::OfflineRenderer(SignalChain *pSignalChain, double sampleRate)
+    : m_pSignalChain(pSignalChain),
+      m_sampleRate(sampleRate),
+      m_events(),
+      m_eventIndex(0),
+      m_renderTime(0.0),
+      m_peak(0.0f)
+{
+    Q_ASSERT(pSignalChain != nullptr);
+    Q_ASSERT(sampleRate > 0.0);
+}
+
+bool OfflineRenderer::render(WavWriter *pWriter, double duration)
+{
+    Q_ASSERT(pWriter != nullptr);
+
+    AudioDevicesManager *pDevicesManager = Application::instance()->audioDevicesManager();
+    IEventRouter *pRouter = Application::instance()->eventRouter();
+
+    // Speakers are to be driven directly by the output device callback
+    pDevicesManager->setCallbackRenderEnabled(true);
+
+    m_pSignalChain->setTimeStep(1.0 / m_sampleRate);
+    m_pSignalChain->start();
+    m_pSignalChain->enable(true);
+
+    m_eventIndex = 0;
+    m_renderTime = 0.0;
+    m_peak = 0.0f;
+
+    QVector<float> buffer(cBlockFrames * cChannels);
+    const long totalFrames = long(std::ceil(duration * m_sampleRate));
+    long frame = 0;
+    bool ok = true;
+
+    QElapsedTimer timer;
+
+    while (frame < totalFrames) {
+        postEvents(frame);
+
+        // Render up to the next event, so that it lands on its exact frame
+        long nFrames = qMin(cBlockFrames, totalFrames - frame);
+        if (m_eventIndex < m_events.count()) {
+            long eventFrame = long(m_events.at(m_eventIndex).time * m_sampleRate);
+            nFrames = qBound(1L, eventFrame - frame, nFrames);
+        }
+
+        timer.start();
+        renderFrames(buffer.data(), nFrames);
+        m_renderTime += timer.nsecsElapsed() * 1.0e-9;
+
+        for (long i = 0; i < nFrames * cChannels; i++) {
+            m_peak = qMax(m_peak, std::fabs(buffer[int(i)]));
+        }
+
+        if (!pWriter->write(buffer.constData(), nFrames)) {
+            ok = false;
+            break;
+        }
+        frame += nFrames;
+    }
+
+    m_pSignalChain->enable(false);
+    m_pSignalChain->stop();
+    pRouter->purge();
+    pDevicesManager->setCallbackRenderEnabled(false);
+
+    return ok;
+}
+
+void OfflineRenderer::postEvents(long frame)
+{
+    EventQueue *pQueue = Application::instance()->eventRouter()->audioEventQueue();
+    Q_ASSERT(pQueue != nullptr);
+
+    while (m_eventIndex < m_events.count()) {
+        const MidiFile::Event &event = m_events.at(m_eventIndex);
+        if (long(event.time * m_sampleRate) > frame) {
+            break;
+        }
+
+        EventQueue::Record record;
+        if (!EventQueue::recordFromMidiMessage(event.message, record)) {
+            m_eventIndex++;
+            continue;
+        }
+
+        // Negative timestamp: dispatch at the beginning of the next rendered span
+        record.timestamp = -1.0;
+
+        if (!pQueue->push(record)) {
+            // Queue is full: the remaining events are posted once the next
+            // rendered frame (written to the output as usual) has drained it.
+            qWarning() << "Events queue overflow at frame" << frame;
+            break;
+        }
+        m_eventIndex++;
+    }
+}
+
+void OfflineRenderer::renderFrames(float *pBuffer, long nFrames)
+{
+    AudioDevice *pDevice = Application::instance()->audioDevicesManager()->audioOutputDevice();
+    Q_ASSERT(pDevice != nullptr);
+
+    // Speakers overwrite the buffer; keep silence when there are none
+    std::fill(pBuffer, pBuffer + nFrames * cChannels, 0.0f);
+    pDevice->processAudio(nullptr, pBuffer, nFrames);
+}
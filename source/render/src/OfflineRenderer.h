@@ -0,0 +1,86 @@
+/*
+                          qmusic
+
+    Copyright (C) 2015 Arthur Benilov,
+    arthur.benilov@gmail.com
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This software is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    Lesser General Public License for more details.
+*/
+
+#ifndef OFFLINERENDERER_H
+#define OFFLINERENDERER_H
+
+#include <QList>
+#include "MidiFile.h"
+
+class SignalChain;
+class WavWriter;
+
+/**
+ * @brief Renders a signal chain into a file without audio devices.
+ *
+ * The signal chain is driven the same way the audio output callback does
+ * in callback rendering mode: the speaker units receive the buffers
+ * to fill from the output audio device. The output device itself is
+ * never opened, so rendering runs as fast as the CPU allows.
+ *
+ * MIDI events are pushed to the audio events queue right before the
+ * frame they belong to, so that they are dispatched sample-accurately.
+ */
+class OfflineRenderer
+{
+public:
+
+    OfflineRenderer(SignalChain *pSignalChain, double sampleRate);
+
+    /**
+     * Set MIDI events to be played.
+     * @param events Events ordered by time.
+     */
+    void setEvents(const QList<MidiFile::Event> &events) { m_events = events; }
+
+    /**
+     * Render the signal chain.
+     * @param pWriter Output file writer.
+     * @param duration Duration to be rendered, seconds.
+     * @return true on success.
+     */
+    bool render(WavWriter *pWriter, double duration);
+
+    /// Time spent on rendering (excluding file writing), seconds.
+    double renderTime() const { return m_renderTime; }
+
+    /// Tells whether all the rendered samples were zero.
+    bool isSilent() const { return m_peak == 0.0f; }
+
+    /// Peak absolute sample value.
+    float peak() const { return m_peak; }
+
+private:
+
+    /// Number of frames rendered per output callback.
+    static const long cBlockFrames = 1024;
+
+    /// Number of output channels.
+    static const int cChannels = 2;
+
+    void postEvents(long frame);
+    void renderFrames(float *pBuffer, long nFrames);
+
+    SignalChain *m_pSignalChain;
+    double m_sampleRate;
+    QList<MidiFile::Event> m_events;
+    int m_eventIndex;       ///< Next event to be posted.
+    double m_renderTime;
+    float m_peak;
+};
+
+#endif // OFFLINERENDERER_H
@@ -0,0 +1,146 @@
+/*
+                          qmusic
+
+    Copyright (C) 2015 Arthur Benilov,
+    arthur.benilov@gmail.com
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This software is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    Lesser General Public License for more details.
+*/
+
+#include <cstring>
+#include <QtEndian>
+#include "WavWriter.h"
+
+namespace {
+
+void appendTag(QByteArray &data, const char *tag)
+{
+    data.append(tag, 4);
+}
+
+void append16(QByteArray &data, quint16 value)
+{
+    char bytes[2];
+    qToLittleEndian(value, reinterpret_cast<uchar*>(bytes));
+    data.append(bytes, 2);
+}
+
+void append32(QByteArray &data, quint32 value)
+{
+    char bytes[4];
+    qToLittleEndian(value, reinterpret_cast<uchar*>(bytes));
+    data.append(bytes, 4);
+}
+
+} // namespace
+
+WavWriter::WavWriter(const QString &path, int nChannels, int sampleRate, Format format)
+    : m_file(path),
+      m_nChannels(nChannels),
+      m_sampleRate(sampleRate),
+      m_format(format),
+      m_nFrames(0),
+      m_buffer()
+{
+    Q_ASSERT(nChannels > 0);
+    Q_ASSERT(sampleRate > 0);
+}
+
+WavWriter::~WavWriter()
+{
+    close();
+}
+
+bool WavWriter::open()
+{
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    m_nFrames = 0;
+    return writeHeader();
+}
+
+bool WavWriter::write(const float *pSamples, long nFrames)
+{
+    Q_ASSERT(m_file.isOpen());
+
+    long nSamples = nFrames * m_nChannels;
+    m_buffer.resize(int(nSamples * bytesPerSample()));
+    uchar *pDst = reinterpret_cast<uchar*>(m_buffer.data());
+
+    if (m_format == Format_Float32) {
+        for (long i = 0; i < nSamples; i++) {
+            quint32 bits;
+            std::memcpy(&bits, &pSamples[i], sizeof(bits));
+            qToLittleEndian(bits, pDst);
+            pDst += 4;
+        }
+    } else {
+        for (long i = 0; i < nSamples; i++) {
+            float s = qBound(-1.0f, pSamples[i], 1.0f);
+            qint16 v = qint16(qRound(s * 32767.0f));
+            qToLittleEndian(v, pDst);
+            pDst += 2;
+        }
+    }
+
+    if (m_file.write(m_buffer) != m_buffer.size()) {
+        return false;
+    }
+
+    m_nFrames += nFrames;
+    return true;
+}
+
+void WavWriter::close()
+{
+    if (!m_file.isOpen()) {
+        return;
+    }
+
+    // Rewrite the header with the actual data size
+    m_file.seek(0);
+    writeHeader();
+    m_file.close();
+}
+
+bool WavWriter::writeHeader()
+{
+    quint32 dataSize = quint32(m_nFrames * m_nChannels * bytesPerSample());
+    quint16 blockAlign = quint16(m_nChannels * bytesPerSample());
+    bool isFloat = m_format == Format_Float32;
+
+    QByteArray header;
+    appendTag(header, "RIFF");
+    append32(header, 4 + (8 + 16) + (isFloat ? 12 : 0) + (8 + dataSize));
+    appendTag(header, "WAVE");
+
+    appendTag(header, "fmt ");
+    append32(header, 16);
+    append16(header, isFloat ? 3 : 1);  // WAVE_FORMAT_IEEE_FLOAT or WAVE_FORMAT_PCM
+    append16(header, quint16(m_nChannels));
+    append32(header, quint32(m_sampleRate));
+    append32(header, quint32(m_sampleRate) * blockAlign);
+    append16(header, blockAlign);
+    append16(header, quint16(bytesPerSample() * 8));
+
+    if (isFloat) {
+        // Non-PCM formats require a fact chunk
+        appendTag(header, "fact");
+        append32(header, 4);
+        append32(header, quint32(m_nFrames));
+    }
+
+    appendTag(header, "data");
+    append32(header, dataSize);
+
+    return m_file.write(header) == header.size();
+}
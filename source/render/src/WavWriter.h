@@ -0,0 +1,81 @@
+/*
+                          qmusic
+
+    Copyright (C) 2015 Arthur Benilov,
+    arthur.benilov@gmail.com
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This software is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    Lesser General Public License for more details.
+*/
+
+#ifndef WAVWRITER_H
+#define WAVWRITER_H
+
+#include <QFile>
+#include <QString>
+
+/**
+ * @brief Writer of RIFF WAVE files.
+ *
+ * Samples are written either as 16-bit PCM (with clipping)
+ * or as 32-bit IEEE floats. Data chunk size is patched in the header
+ * when the file gets closed.
+ */
+class WavWriter
+{
+public:
+
+    /// Sample format.
+    enum Format {
+        Format_Int16,
+        Format_Float32
+    };
+
+    WavWriter(const QString &path, int nChannels, int sampleRate, Format format = Format_Int16);
+    ~WavWriter();
+
+    /**
+     * Create the file and write the header.
+     * @return true on success.
+     */
+    bool open();
+
+    /**
+     * Write interleaved samples.
+     * @param pSamples Pointer to interleaved samples.
+     * @param nFrames Number of frames (samples per channel).
+     * @return true on success.
+     */
+    bool write(const float *pSamples, long nFrames);
+
+    /**
+     * Update the header and close the file.
+     */
+    void close();
+
+    /// Number of frames written so far.
+    long framesWritten() const { return m_nFrames; }
+
+    QString errorText() const { return m_file.errorString(); }
+
+private:
+
+    bool writeHeader();
+    int bytesPerSample() const { return m_format == Format_Float32 ? 4 : 2; }
+
+    QFile m_file;
+    int m_nChannels;
+    int m_sampleRate;
+    Format m_format;
+    long m_nFrames;
+    QByteArray m_buffer;    ///< Conversion buffer.
+};
+
+#endif // WAVWRITER_H
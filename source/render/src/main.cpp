@@ -0,0 +1,137 @@
+/*
+                          qmusic
+
+    Copyright (C) 2015 Arthur Benilov,
+    arthur.benilov@gmail.com
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This software is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    Lesser General Public License for more details.
+*/
+
+#include <QCommandLineParser>
+#include <QFileInfo>
+#include <QTextStream>
+#include "Application.h"
+#include "AudioUnitsManager.h"
+#include "SignalChainScene.h"
+#include "SignalChain.h"
+#include "MidiFile.h"
+#include "WavWriter.h"
+#include "OfflineRenderer.h"
+
+/*
+ * Headless renderer.
+ * Loads a signal chain and optionally a MIDI file, renders the result
+ * into a WAV file as fast as possible, and reports the real-time factor.
+ */
+int main(int argc, char **argv)
+{
+    // No windows are created, so the display is not required
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    Application app(argc, argv);
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Render a signal chain into a WAV file.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("patch", "Signal chain file (.sch).");
+    parser.addPositionalArgument("midi", "MIDI file to be played (optional).", "[midi]");
+
+    QCommandLineOption outputOption(QStringList() << "o" << "output", "Output WAV file.", "file", "out.wav");
+    QCommandLineOption rateOption("rate", "Sample rate, Hz.", "rate", "44100");
+    QCommandLineOption durationOption("duration", "Duration to render, seconds (defaults to the MIDI file length).", "seconds");
+    QCommandLineOption tailOption("tail", "Time rendered after the last MIDI event, seconds.", "seconds", "2");
+    QCommandLineOption floatOption("float", "Write 32-bit float samples instead of 16-bit integers.");
+    parser.addOption(outputOption);
+    parser.addOption(rateOption);
+    parser.addOption(durationOption);
+    parser.addOption(tailOption);
+    parser.addOption(floatOption);
+    parser.process(app);
+
+    const QStringList args = parser.positionalArguments();
+    if (args.isEmpty() || args.count() > 2) {
+        parser.showHelp(1);
+    }
+
+    double sampleRate = parser.value(rateOption).toDouble();
+    if (sampleRate <= 0.0) {
+        err << "Invalid sample rate " << parser.value(rateOption) << endl;
+        return 1;
+    }
+
+    // Load plugins before the signal chain, so that audio units can be created
+    app.audioUnitsManager()->initialize();
+
+    SignalChainScene *pScene = SignalChainScene::loadFromFile(args.at(0));
+    if (pScene == nullptr) {
+        err << "Unable to load " << args.at(0) << endl;
+        return 1;
+    }
+
+    QList<MidiFile::Event> events;
+    double duration = 0.0;
+    if (args.count() > 1) {
+        MidiFile midiFile(args.at(1));
+        if (!midiFile.load()) {
+            err << "Unable to load " << args.at(1) << ": " << midiFile.errorText() << endl;
+            delete pScene;
+            return 1;
+        }
+        events = midiFile.events();
+        duration = midiFile.duration() + parser.value(tailOption).toDouble();
+    }
+    if (parser.isSet(durationOption)) {
+        duration = parser.value(durationOption).toDouble();
+    }
+    if (duration <= 0.0) {
+        err << "Nothing to render: specify a MIDI file or --duration" << endl;
+        delete pScene;
+        return 1;
+    }
+
+    WavWriter writer(parser.value(outputOption), 2, int(sampleRate),
+                     parser.isSet(floatOption) ? WavWriter::Format_Float32 : WavWriter::Format_Int16);
+    if (!writer.open()) {
+        err << "Unable to create " << parser.value(outputOption) << ": " << writer.errorText() << endl;
+        delete pScene;
+        return 1;
+    }
+
+    OfflineRenderer renderer(pScene->signalChain(), sampleRate);
+    renderer.setEvents(events);
+    bool ok = renderer.render(&writer, duration);
+    writer.close();
+    delete pScene;
+
+    if (!ok) {
+        err << "Unable to write " << parser.value(outputOption) << endl;
+        return 1;
+    }
+
+    double audioTime = writer.framesWritten() / sampleRate;
+    out << QFileInfo(parser.value(outputOption)).fileName() << ": "
+        << QString::number(audioTime, 'f', 2) << " s rendered in "
+        << QString::number(renderer.renderTime(), 'f', 3) << " s";
+    if (renderer.renderTime() > 0.0) {
+        out << " (" << QString::number(audioTime / renderer.renderTime(), 'f', 1) << "x real-time)";
+    }
+    out << ", peak " << QString::number(renderer.peak(), 'f', 3) << endl;
+
+    if (renderer.isSilent()) {
+        err << "Warning: the output is silent, does the signal chain contain a speaker?" << endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,135 @@
+/*
+                          qmusic
+
+    Copyright (C) 2015 Arthur Benilov,
+    arthur.benilov@gmail.com
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This software is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    Lesser General Public License for more details.
+*/
+
+#ifndef STK_INSTRUMENT_UNIT_H
+#define STK_INSTRUMENT_UNIT_H
+
+#include <QVector>
+#include <Stk.h>
+#include "AudioUnit.h"
+#include "StkPropertyValues.h"
+
+/**
+ * @brief Base class of the audio units wrapping an STK instrument.
+ *
+ * The instrument is rendered by spans of samples over which its
+ * controls are held constant: the whole block, or cControlInterval
+ * samples when any control input changes at audio rate. At the start
+ * of every span the derived unit passes the controls that have changed
+ * to the instrument (see updateControls()), so that the STK setters,
+ * some of them costly or with side effects, are not called for every
+ * sample.
+ *
+ * Property values are handed over by the GUI thread with setPropertyValue()
+ * and read by the rendering thread with propertyValue() once
+ * propertiesChanged() has reported them.
+ */
+class StkInstrumentUnit : public AudioUnit
+{
+public:
+
+    /// Number of samples audio rate controls are held for.
+    static const int cControlInterval = 32;
+
+    /**
+     * Construct the audio unit.
+     * The "out" output port is created here.
+     * @param pPlugin Audio unit plugin.
+     * @param nProperties Number of property values passed to the instrument.
+     */
+    StkInstrumentUnit(AudioUnitPlugin *pPlugin, int nProperties);
+
+protected:
+
+    void process() override;
+    void processBlock(int nFrames) override;
+
+    /**
+     * Add an input port which value controls the instrument.
+     * @param name Port name.
+     * @return Pointer to the created port.
+     */
+    InputPort* addControlInput(const QString &name);
+
+    /**
+     * Pass the controls that have changed to the instrument.
+     * Called by the rendering thread at the start of every span of samples.
+     * @return false if the instrument has to be kept silent (e.g. the frequency is out of range).
+     */
+    virtual bool updateControls() = 0;
+
+    /**
+     * Render a span of samples.
+     * @param frames Single channel frames, filled with zeroes
+     * (instruments like the guitar take them as an excitation).
+     */
+    virtual void tick(stk::StkFrames &frames) = 0;
+
+    /**
+     * Returns the value of a control input for the current span.
+     * @param index Control input index, in the order the inputs have been added.
+     * @return
+     */
+    float control(int index) const { return m_controls.at(index); }
+
+    /**
+     * Check whether a control input value has changed since it has been
+     * passed to the instrument. The value is then considered passed.
+     * @param index Control input index.
+     * @return
+     */
+    bool controlChanged(int index);
+
+    /**
+     * Set a property value, called by the properties change handler.
+     * @param index Property value index.
+     * @param value
+     */
+    void setPropertyValue(int index, double value) { m_propertyValues.set(index, value); }
+
+    double propertyValue(int index) const { return m_propertyValues.value(index); }
+
+    /**
+     * Check whether the property values have to be passed to the instrument.
+     * @return
+     */
+    bool propertiesChanged() { return m_propertyValues.fetchChanges(); }
+
+    /**
+     * Force all the controls and properties to be passed to the instrument
+     * again, e.g. after a note event has reset them.
+     */
+    void invalidateControls();
+
+    OutputPort *m_pOutput;
+
+private:
+
+    /// Render a span of samples into the output buffer.
+    void render(float *pOut, int nFrames);
+
+    QVector<InputPort*> m_controlInputs;
+    QVector<float> m_controls;          ///< Control inputs values of the current span.
+    QVector<float> m_passedControls;    ///< Control values last passed to the instrument.
+
+    StkPropertyValues m_propertyValues;
+
+    /// Block of samples rendered by the instrument.
+    stk::StkFrames m_frames;
+};
+
+#endif // STK_INSTRUMENT_UNIT_H
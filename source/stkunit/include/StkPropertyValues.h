@@ -0,0 +1,86 @@
+/*
+                          qmusic
+
+    Copyright (C) 2015 Arthur Benilov,
+    arthur.benilov@gmail.com
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This software is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    Lesser General Public License for more details.
+*/
+
+#ifndef STK_PROPERTY_VALUES_H
+#define STK_PROPERTY_VALUES_H
+
+#include <atomic>
+#include <memory>
+#include <QtGlobal>
+
+/**
+ * @brief Property values handed over to the rendering thread.
+ *
+ * Audio unit properties are changed by the GUI thread, while the
+ * STK objects they control are used by the rendering thread.
+ * The values are stored here by the properties change handler and
+ * fetched by the rendering thread when they have changed. Every value
+ * is atomic, so that a property changed while a block is rendered
+ * is never read half-written; the values changed after a fetch are
+ * passed on the next one.
+ */
+class StkPropertyValues
+{
+public:
+
+    /**
+     * Construct the values storage.
+     * @param count Number of values.
+     */
+    explicit StkPropertyValues(int count);
+
+    int count() const { return m_count; }
+
+    /**
+     * Set a value, called by the GUI thread.
+     * @param index Value index.
+     * @param value
+     */
+    void set(int index, double value);
+
+    /**
+     * Returns a value.
+     * @param index Value index.
+     * @return
+     */
+    double value(int index) const;
+
+    /**
+     * Check whether any value has changed since the last call,
+     * called by the rendering thread before reading the values.
+     * @return true if the values have to be passed to the STK object.
+     */
+    bool fetchChanges();
+
+    /**
+     * Force the values to be reported as changed on next fetch,
+     * e.g. after the STK object has been reset.
+     */
+    void invalidate();
+
+private:
+
+    Q_DISABLE_COPY(StkPropertyValues)
+
+    int m_count;
+    std::unique_ptr<std::atomic<double>[]> m_values;
+
+    /// Values have to be passed to the STK object.
+    std::atomic<bool> m_changed;
+};
+
+#endif // STK_PROPERTY_VALUES_H
@@ -0,0 +1,103 @@
+/*
+                          qmusic
+
+    Copyright (C) 2015 Arthur Benilov,
+    arthur.benilov@gmail.com
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This software is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    Lesser General Public License for more details.
+*/
+
+#include <algorithm>
+#include <limits>
+#include "StkInstrumentUnit.h"
+
+StkInstrumentUnit::StkInstrumentUnit(AudioUnitPlugin *pPlugin, int nProperties)
+    : AudioUnit(pPlugin),
+      m_controlInputs(),
+      m_controls(),
+      m_passedControls(),
+      m_propertyValues(nProperties),
+      m_frames(Port::MaxBlockSize, 1)
+{
+    m_pOutput = addOutput("out");
+}
+
+void StkInstrumentUnit::process()
+{
+    for (int i = 0; i < m_controlInputs.count(); ++i) {
+        m_controls[i] = m_controlInputs.at(i)->getValue();
+    }
+
+    float out = 0.0f;
+    render(&out, 1);
+    m_pOutput->setValue(out);
+}
+
+void StkInstrumentUnit::processBlock(int nFrames)
+{
+    float *pOut = m_pOutput->buffer();
+
+    // Controls are passed once per block, or once per interval
+    // when any of them is changing at audio rate.
+    int interval = nFrames;
+    for (const InputPort *pInput : m_controlInputs) {
+        if (pInput->rate() == Port::Rate_Audio) {
+            interval = cControlInterval;
+            break;
+        }
+    }
+
+    for (int offset = 0; offset < nFrames; offset += interval) {
+        int n = qMin(interval, nFrames - offset);
+        for (int i = 0; i < m_controlInputs.count(); ++i) {
+            m_controls[i] = m_controlInputs.at(i)->buffer()[offset];
+        }
+        render(pOut + offset, n);
+    }
+}
+
+InputPort* StkInstrumentUnit::addControlInput(const QString &name)
+{
+    InputPort *pInput = addInput(name);
+    m_controlInputs.append(pInput);
+    m_controls.append(0.0f);
+    m_passedControls.append(std::numeric_limits<float>::quiet_NaN());
+    return pInput;
+}
+
+bool StkInstrumentUnit::controlChanged(int index)
+{
+    float value = m_controls.at(index);
+    if (value == m_passedControls.at(index)) {
+        return false;
+    }
+    m_passedControls[index] = value;
+    return true;
+}
+
+void StkInstrumentUnit::invalidateControls()
+{
+    // Not a number never compares equal to a control value
+    m_passedControls.fill(std::numeric_limits<float>::quiet_NaN());
+    m_propertyValues.invalidate();
+}
+
+void StkInstrumentUnit::render(float *pOut, int nFrames)
+{
+    if (!updateControls()) {
+        std::fill(pOut, pOut + nFrames, 0.0f);
+        return;
+    }
+
+    m_frames.resize(nFrames, 1, 0.0);
+    tick(m_frames);
+    std::copy(&m_frames[0], &m_frames[0] + nFrames, pOut);
+}
@@ -0,0 +1,52 @@
+/*
+                          qmusic
+
+    Copyright (C) 2015 Arthur Benilov,
+    arthur.benilov@gmail.com
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This software is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    Lesser General Public License for more details.
+*/
+
+#include "StkPropertyValues.h"
+
+StkPropertyValues::StkPropertyValues(int count)
+    : m_count(count),
+      m_values(new std::atomic<double>[count]),
+      m_changed(true)
+{
+    Q_ASSERT(count >= 0);
+    for (int i = 0; i < m_count; ++i) {
+        m_values[i].store(0.0, std::memory_order_relaxed);
+    }
+}
+
+void StkPropertyValues::set(int index, double value)
+{
+    Q_ASSERT(index >= 0 && index < m_count);
+    m_values[index].store(value, std::memory_order_relaxed);
+    m_changed.store(true, std::memory_order_release);
+}
+
+double StkPropertyValues::value(int index) const
+{
+    Q_ASSERT(index >= 0 && index < m_count);
+    return m_values[index].load(std::memory_order_relaxed);
+}
+
+bool StkPropertyValues::fetchChanges()
+{
+    return m_changed.exchange(false, std::memory_order_acquire);
+}
+
+void StkPropertyValues::invalidate()
+{
+    m_changed.store(true, std::memory_order_release);
+}
@@ -0,0 +1,63 @@
+/*
+                          qmusic
+
+    Copyright (C) 2015 Arthur Benilov,
+    arthur.benilov@gmail.com
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This software is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    Lesser General Public License for more details.
+*/
+
+#ifndef DSPPROFILERWINDOW_H
+#define DSPPROFILERWINDOW_H
+
+#include <QDockWidget>
+#include <QHash>
+#include "ViewApi.h"
+#include "AudioUnit.h"
+
+class QTableWidget;
+class SignalChainScene;
+
+/**
+ * @brief DSP load per audio unit.
+ *
+ * This window periodically samples the processing time counters of
+ * every audio unit in the scene, shows the load in a sortable table
+ * and as a heat overlay on the audio unit items.
+ */
+class QMUSIC_VIEW_API DspProfilerWindow : public QDockWidget
+{
+    Q_OBJECT
+public:
+
+    DspProfilerWindow(QWidget *pParent = nullptr);
+
+    /**
+     * Sample the audio units counters and update the view.
+     * @param pScene Scene containing the audio units.
+     */
+    void updateProfile(SignalChainScene *pScene);
+
+    /**
+     * Clear the measurements.
+     * @param pScene Scene containing the audio units.
+     */
+    void reset(SignalChainScene *pScene);
+
+private:
+
+    QTableWidget *m_pTable;
+
+    /// Counters at the previous update, used to compute the load.
+    QHash<const AudioUnit*, AudioUnit::ProfilingCounters> m_lastCounters;
+};
+
+#endif // DSPPROFILERWINDOW_H
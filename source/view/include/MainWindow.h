@@ -21,13 +21,17 @@
 #include <QMainWindow>
 #include <QDir>
 #include "ViewApi.h"
+#include "AudioDeviceStats.h"
 
 class QAction;
 class QProgressBar;
+class QLabel;
+class QTimer;
 class LogWindow;
 class AudioUnitsManagerWindow;
 class AudioUnitPropertiesWindow;
 class SpectrumWindow;
+class DspProfilerWindow;
 class PianoKeyboardWindow;
 class SignalChainWidget;
 
@@ -47,6 +51,7 @@ public:
     AudioUnitPropertiesWindow* audioUnitPropertiesWindow() const { return m_pAudioUnitPropertiesWindow; }
     SpectrumWindow* spectrumWindow() const { return m_pSpectrumWindow; }
     PianoKeyboardWindow* pianoKeyboardWindow() const { return m_pPianoKeyboardWindow; }
+    DspProfilerWindow* dspProfilerWindow() const { return m_pDspProfilerWindow; }
 
 public slots:
 
@@ -71,6 +76,13 @@ private slots:
     void stopSignalChain();
     void editSettings();
 
+    /**
+     * Poll the audio devices for measured latency and,
+     * when rendering in the audio callback, for the callback load.
+     */
+    void updateAudioStatus();
+    void updateDspProfile();
+
 private:
 
     void createDockingWindows();
@@ -78,6 +90,7 @@ private:
     void createMenu();
     void createToolBars();
     void updateActions();
+    void updateAudioStats(const AudioDeviceStats::Snapshot &stats);
     void saveSettings();
     void loadSettings();
 
@@ -86,6 +99,7 @@ private:
     AudioUnitPropertiesWindow *m_pAudioUnitPropertiesWindow;
     SpectrumWindow *m_pSpectrumWindow;
     PianoKeyboardWindow *m_pPianoKeyboardWindow;
+    DspProfilerWindow *m_pDspProfilerWindow;
 
     /// Central widget showing a signal chain.
     SignalChainWidget *m_pSignalChainWidget;
@@ -113,6 +127,21 @@ private:
     // Load bar
     QProgressBar *m_pDspLoadBar;
 
+    /// Measured round-trip latency.
+    QLabel *m_pLatencyLabel;
+
+    /// Number of audio glitches since start.
+    QLabel *m_pXrunsLabel;
+
+    /// Output stream statistics at the previous status update.
+    AudioDeviceStats::Snapshot m_lastAudioStats;
+
+    /// Timer used to poll audio devices status.
+    QTimer *m_pAudioStatusTimer;
+
+    /// Timer used to sample the audio units DSP load.
+    QTimer *m_pDspProfileTimer;
+
     // Previously used open/save path
     QDir m_lastUsedDir;
 };
@@ -23,6 +23,7 @@
 
 class QComboBox;
 class QSpinBox;
+class QCheckBox;
 
 /**
  * @brief Dialog box to present and edit global settings.
@@ -55,6 +56,7 @@ private:
     QComboBox *m_pWaveOutComboBox;
     QComboBox *m_pSampleRateComboBox;
     QSpinBox *m_pBufferSizeSpinBox;
+    QCheckBox *m_pCallbackRenderCheckBox;
 
     QComboBox *m_pMidiInComboBox;
     QComboBox *m_pMidiInChannelComboBox;
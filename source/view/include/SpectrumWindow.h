@@ -25,6 +25,7 @@
 class QwtPlot;
 class QwtPlotCurve;
 class QwtPlotPicker;
+class RealFft;
 
 class QMUSIC_VIEW_API SpectrumWindow : public QDockWidget
 {
@@ -63,6 +64,15 @@ private:
     /// Incoming signal.
     QVector<float> m_signal;
 
+    /// Spectrum transform plan.
+    RealFft *m_pFft;
+
+    /// Window applied to the signal before the transform.
+    QVector<float> m_window;
+
+    /// Transform buffer.
+    QVector<float> m_spectrum;
+
     QwtPlot *m_pWaveformPlot;
     QwtPlotCurve *m_pWaveformCurve;
     QwtPlotPicker *m_pWaveformPicker;
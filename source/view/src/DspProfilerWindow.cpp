@@ -0,0 +1,124 @@
+/*
+                          qmusic
+
+    Copyright (C) 2015 Arthur Benilov,
+    arthur.benilov@gmail.com
+
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This software is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    Lesser General Public License for more details.
+*/
+
+#include <QHeaderView>
+#include <QTableWidget>
+#include "AudioUnitPlugin.h"
+#include "SignalChain.h"
+#include "SignalChainScene.h"
+#include "SignalChainAudioUnitItem.h"
+#include "ProfilingClock.h"
+#include "DspProfilerWindow.h"
+
+enum Column {
+    Column_AudioUnit,
+    Column_Plugin,
+    Column_Load,
+    Column_TimePerSample,
+    Column_Count
+};
+
+namespace {
+
+QTableWidgetItem* numberItem(double value)
+{
+    QTableWidgetItem *pItem = new QTableWidgetItem();
+    pItem->setData(Qt::DisplayRole, value);
+    pItem->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+    return pItem;
+}
+
+} // namespace
+
+DspProfilerWindow::DspProfilerWindow(QWidget *pParent)
+    : QDockWidget(tr("DSP profiler"), pParent)
+{
+    setObjectName("DspProfilerWindow");
+
+    m_pTable = new QTableWidget(0, Column_Count, this);
+    m_pTable->setHorizontalHeaderLabels(QStringList() << tr("Audio unit")
+                                                      << tr("Plugin")
+                                                      << tr("Load, %")
+                                                      << tr("ns/sample"));
+    m_pTable->verticalHeader()->setVisible(false);
+    m_pTable->horizontalHeader()->setStretchLastSection(true);
+    m_pTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_pTable->setSelectionMode(QAbstractItemView::NoSelection);
+    m_pTable->setFrameStyle(QFrame::NoFrame);
+    m_pTable->setSortingEnabled(true);
+    m_pTable->sortByColumn(Column_Load, Qt::DescendingOrder);
+
+    setWidget(m_pTable);
+}
+
+void DspProfilerWindow::updateProfile(SignalChainScene *pScene)
+{
+    Q_ASSERT(pScene != nullptr);
+
+    const double secondsPerTick = ProfilingClock::secondsPerTick();
+    const double timeStep = pScene->signalChain()->timeStep();
+
+    QHash<const AudioUnit*, AudioUnit::ProfilingCounters> counters;
+
+    // Avoid re-sorting on every inserted item
+    m_pTable->setSortingEnabled(false);
+    m_pTable->setRowCount(0);
+
+    for (QGraphicsItem *pGraphicsItem : pScene->items()) {
+        SignalChainAudioUnitItem *pItem = dynamic_cast<SignalChainAudioUnitItem*>(pGraphicsItem);
+        if (pItem == nullptr) {
+            continue;
+        }
+
+        const AudioUnit *pAudioUnit = pItem->audioUnit();
+        AudioUnit::ProfilingCounters current = pAudioUnit->profilingCounters();
+        AudioUnit::ProfilingCounters last = m_lastCounters.value(pAudioUnit, current);
+        counters[pAudioUnit] = current;
+
+        quint64 frames = current.frames - last.frames;
+        double seconds = (current.ticks - last.ticks) * secondsPerTick;
+        double load = frames > 0 ? seconds / (frames * timeStep) : 0.0;
+        pItem->setDspLoad(float(load));
+
+        int row = m_pTable->rowCount();
+        m_pTable->insertRow(row);
+        m_pTable->setItem(row, Column_AudioUnit, new QTableWidgetItem(pAudioUnit->title()));
+        m_pTable->setItem(row, Column_Plugin, new QTableWidgetItem(pAudioUnit->plugin()->name()));
+        m_pTable->setItem(row, Column_Load, numberItem(qRound(load * 1000.0) / 10.0));
+        m_pTable->setItem(row, Column_TimePerSample, numberItem(frames > 0 ? qRound(seconds * 1.0e9 / frames) : 0));
+    }
+
+    m_pTable->setSortingEnabled(true);
+    m_lastCounters = counters;
+}
+
+void DspProfilerWindow::reset(SignalChainScene *pScene)
+{
+    m_lastCounters.clear();
+    m_pTable->setRowCount(0);
+
+    if (pScene == nullptr) {
+        return;
+    }
+
+    for (QGraphicsItem *pGraphicsItem : pScene->items()) {
+        SignalChainAudioUnitItem *pItem = dynamic_cast<SignalChainAudioUnitItem*>(pGraphicsItem);
+        if (pItem != nullptr) {
+            pItem->setDspLoad(0.0f);
+        }
+    }
+}
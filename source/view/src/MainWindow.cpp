@@ -23,17 +23,20 @@
 #include <QToolBar>
 #include <QProgressBar>
 #include <QLabel>
+#include <QTimer>
 #include <QStyle>
 #include <QMessageBox>
 #include <QFileDialog>
 #include "Application.h"
 #include "Settings.h"
 #include "LogWindow.h"
+#include "AudioDevice.h"
 #include "AudioDevicesManager.h"
 #include "AudioUnitsManagerWindow.h"
 #include "AudioUnitPropertiesWindow.h"
 #include "PianoKeyboardWindow.h"
 #include "SpectrumWindow.h"
+#include "DspProfilerWindow.h"
 #include "SignalChainWidget.h"
 #include "SignalChainScene.h"
 #include "SignalChain.h"
@@ -45,6 +48,10 @@
 // this value will limit it heigt (in pixels).
 #define OSX_TOOLBAR_HEIGHT  32
 
+// Audio devices status polling interval, in milliseconds.
+const int cAudioStatusInterval(500);
+const int cDspProfileInterval(250);
+
 MainWindow::MainWindow(QWidget *pParent, Qt::WindowFlags flags)
     : QMainWindow(pParent, flags)
 {
@@ -60,6 +67,14 @@ MainWindow::MainWindow(QWidget *pParent, Qt::WindowFlags flags)
     m_pSignalChainWidget = new SignalChainWidget();
     setCentralWidget(m_pSignalChainWidget);
 
+    m_pAudioStatusTimer = new QTimer(this);
+    m_pAudioStatusTimer->setInterval(cAudioStatusInterval);
+    connect(m_pAudioStatusTimer, SIGNAL(timeout()), this, SLOT(updateAudioStatus()));
+
+    m_pDspProfileTimer = new QTimer(this);
+    m_pDspProfileTimer->setInterval(cDspProfileInterval);
+    connect(m_pDspProfileTimer, SIGNAL(timeout()), this, SLOT(updateDspProfile()));
+
     connect(m_pSignalChainWidget, SIGNAL(audioUnitSelected(AudioUnit*)),
             m_pAudioUnitPropertiesWindow, SLOT(handleAudioUnitSelected(AudioUnit*)));
 
@@ -114,6 +129,69 @@ void MainWindow::updateDspLoad(float l)
     }
 }
 
+void MainWindow::updateAudioStatus()
+{
+    AudioDevicesManager *pManager = Application::instance()->audioDevicesManager();
+    Q_ASSERT(pManager != nullptr);
+
+    AudioDeviceStats::Snapshot stats = pManager->audioOutputDevice()->stats()->snapshot();
+    updateAudioStats(stats);
+    m_lastAudioStats = stats;
+
+    double latencyMs = pManager->roundTripLatency() * 1000.0;
+    m_pLatencyLabel->setText(tr("%1 ms").arg(latencyMs, 0, 'f', 1));
+}
+
+void MainWindow::updateAudioStats(const AudioDeviceStats::Snapshot &stats)
+{
+    double timeStep = m_pSignalChainWidget->scene()->signalChain()->timeStep();
+
+    // Load over the last update interval: time spent in the callback when rendering
+    // there, or in the rendering thread otherwise, vs. the duration of the processed audio.
+    quint64 frames = stats.frames - m_lastAudioStats.frames;
+    quint64 renderFrames = stats.renderFrames - m_lastAudioStats.renderFrames;
+    double load = 0.0;
+    if (frames > 0) {
+        load = (stats.callbackSeconds - m_lastAudioStats.callbackSeconds) / (frames * timeStep);
+    }
+    if (renderFrames > 0) {
+        load = qMax(load, (stats.renderSeconds - m_lastAudioStats.renderSeconds) / (renderFrames * timeStep));
+    }
+    updateDspLoad(float(load));
+
+    m_pXrunsLabel->setText(tr("%1 xruns").arg(stats.xruns()));
+
+    auto row = [](const QString &name, const AudioDeviceStats::Summary &summary) {
+        return QString("<tr><td>%1</td><td align=right>%2</td><td align=right>%3</td>"
+                       "<td align=right>%4</td><td align=right>%5</td></tr>")
+                .arg(name)
+                .arg(summary.min, 0, 'f', 0)
+                .arg(summary.avg, 0, 'f', 0)
+                .arg(summary.max, 0, 'f', 0)
+                .arg(summary.p99, 0, 'f', 0);
+    };
+
+    QString text = tr("<b>Audio callback, us</b>"
+                      "<table><tr><td></td><td>min</td><td>avg</td><td>max</td><td>p99</td></tr>");
+    text += row(tr("Duration"), stats.duration);
+    text += row(tr("Jitter"), stats.jitter);
+    text += "</table>";
+    text += tr("Callbacks: %1<br>").arg(stats.callbacks);
+    text += tr("Render underruns: %1 (%2 frames)<br>").arg(stats.underruns).arg(stats.underrunFrames);
+    text += tr("Output underflows: %1<br>").arg(stats.flags[AudioDeviceStats::Flag_OutputUnderflow]);
+    text += tr("Output overflows: %1<br>").arg(stats.flags[AudioDeviceStats::Flag_OutputOverflow]);
+    text += tr("Input underflows: %1<br>").arg(stats.flags[AudioDeviceStats::Flag_InputUnderflow]);
+    text += tr("Input overflows: %1").arg(stats.flags[AudioDeviceStats::Flag_InputOverflow]);
+
+    m_pDspLoadBar->setToolTip(text);
+    m_pXrunsLabel->setToolTip(text);
+}
+
+void MainWindow::updateDspProfile()
+{
+    m_pDspProfilerWindow->updateProfile(m_pSignalChainWidget->scene());
+}
+
 void MainWindow::closeEvent(QCloseEvent *pEvent)
 {
     int ret = QMessageBox::question(
@@ -213,29 +291,31 @@ void MainWindow::startSignalChain()
         return;
     }
 
-    // Subscribe signal chain for events
-    Application::instance()->eventRouter()->registerHandler(m_pSignalChainWidget->scene()->signalChain());
-
     // Start signal chain
     m_pSignalChainWidget->scene()->setAudioUnitsMovable(false);
     m_pSignalChainWidget->scene()->signalChain()->start();
     m_pSignalChainWidget->scene()->signalChain()->enable(true); // Enable signal chain by default
+    m_lastAudioStats = Application::instance()->audioDevicesManager()->audioOutputDevice()->stats()->snapshot();
+    m_pAudioStatusTimer->start();
+    m_pDspProfileTimer->start();
     updateActions();
     logInfo(tr("Synthesizer started"));
 }
 
 void MainWindow::stopSignalChain()
 {
-    // Unregister signal chain and purge event router
-    Application::instance()->eventRouter()->unregisterHandler(m_pSignalChainWidget->scene()->signalChain());
-
     SignalChain *pSignalChain = m_pSignalChainWidget->scene()->signalChain();
     Q_ASSERT(pSignalChain != nullptr);
 
-    pSignalChain->stop();
+    m_pAudioStatusTimer->stop();
+    m_pDspProfileTimer->stop();
+
+    // Stop audio devices first, so that the signal chain is not
+    // rendered by the audio callback while being stopped.
     pSignalChain->enable(false); // Disable signal chain
-    m_pSignalChainWidget->scene()->setAudioUnitsMovable(true);
     Application::instance()->audioDevicesManager()->stopAudioDevices();
+    pSignalChain->stop();
+    m_pSignalChainWidget->scene()->setAudioUnitsMovable(true);
 
     // Purge event router
     Application::instance()->eventRouter()->purge();
@@ -243,13 +323,11 @@ void MainWindow::stopSignalChain()
     // Clear piano keyboard
     m_pPianoKeyboardWindow->reset();
 
-#ifdef PROFILING
-    pSignalChain->profilingLog();
-#endif // PROFILING
-
     updateActions();
     m_pDspLoadBar->setValue(0);
+    m_pLatencyLabel->setText(tr("-- ms"));
     m_pSpectrumWindow->reset();
+    m_pDspProfilerWindow->reset(m_pSignalChainWidget->scene());
     logInfo(tr("Synthesizer stopped"));
 }
 
@@ -274,6 +352,10 @@ void MainWindow::createDockingWindows()
     addDockWidget(Qt::BottomDockWidgetArea, m_pPianoKeyboardWindow);
     tabifyDockWidget(m_pLogWindow, m_pPianoKeyboardWindow);
 
+    m_pDspProfilerWindow = new DspProfilerWindow(this);
+    addDockWidget(Qt::BottomDockWidgetArea, m_pDspProfilerWindow);
+    tabifyDockWidget(m_pLogWindow, m_pDspProfilerWindow);
+
     m_pAudioUnitsManagerWindow = new AudioUnitsManagerWindow(this);
     addDockWidget(Qt::LeftDockWidgetArea, m_pAudioUnitsManagerWindow);
 
@@ -353,6 +435,11 @@ void MainWindow::createToolBars()
     m_pDspLoadBar->setMaximum(1000);
     m_pDspLoadBar->setMaximumWidth(200);
 
+    m_pLatencyLabel = new QLabel(tr("-- ms"));
+    m_pLatencyLabel->setToolTip(tr("Measured round-trip audio latency"));
+
+    m_pXrunsLabel = new QLabel(tr("-- xruns"));
+
     m_pFileToolBar = addToolBar(tr("File"));
 #ifdef Q_OS_OSX
     m_pFileToolBar->setMaximumHeight(OSX_TOOLBAR_HEIGHT);
@@ -376,6 +463,11 @@ void MainWindow::createToolBars()
     m_pSignalChainToolBar->addSeparator();
     m_pSignalChainToolBar->addWidget(new QLabel(tr("DSP load ")));
     m_pSignalChainToolBar->addWidget(m_pDspLoadBar);
+    m_pSignalChainToolBar->addWidget(new QLabel(" "));
+    m_pSignalChainToolBar->addWidget(m_pXrunsLabel);
+    m_pSignalChainToolBar->addSeparator();
+    m_pSignalChainToolBar->addWidget(new QLabel(tr("Latency ")));
+    m_pSignalChainToolBar->addWidget(m_pLatencyLabel);
 }
 
 void MainWindow::updateActions()
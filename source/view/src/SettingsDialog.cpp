@@ -23,6 +23,7 @@
 #include <QPushButton>
 #include <QComboBox>
 #include <QSpinBox>
+#include <QCheckBox>
 #include <QLabel>
 #include "Settings.h"
 #include "AudioDevice.h"
@@ -72,6 +73,8 @@ void SettingsDialog::loadSettings()
         m_pBufferSizeSpinBox->setValue(bufferSize);
     }
 
+    m_pCallbackRenderCheckBox->setChecked(settings.get(Settings::Setting_CallbackRender).toBool());
+
     index = m_pMidiInComboBox->findData(settings.get(Settings::Setting_MidiInIndex).toInt());
     if (index >= 0) {
         m_pMidiInComboBox->setCurrentIndex(index);
@@ -97,6 +100,7 @@ void SettingsDialog::saveSettings()
         settings.set(Settings::Setting_SampleRate, sampleRate);
     }
     settings.set(Settings::Setting_BufferSize, m_pBufferSizeSpinBox->value());
+    settings.set(Settings::Setting_CallbackRender, m_pCallbackRenderCheckBox->isChecked());
 
     index = m_pMidiInComboBox->currentData().toInt(&ok);
     settings.set(Settings::Setting_MidiInIndex, ok ? index : -1);
@@ -115,6 +119,10 @@ void SettingsDialog::createLayout()
     m_pBufferSizeSpinBox = new QSpinBox();
     m_pBufferSizeSpinBox->setMinimum(16);
     m_pBufferSizeSpinBox->setMaximum(16 * 1024);
+    m_pCallbackRenderCheckBox = new QCheckBox(tr("Render in audio callback"));
+    m_pCallbackRenderCheckBox->setToolTip(tr("Render the signal chain directly in the audio device callback.\n"
+                                             "This lowers the latency, but requires the signal chain to be\n"
+                                             "processed within the audio buffer time."));
     m_pMidiInComboBox = new QComboBox();
     m_pMidiInChannelComboBox = new QComboBox();
 
@@ -122,6 +130,7 @@ void SettingsDialog::createLayout()
     pFormLayout->addRow(tr("Wave Out"), m_pWaveOutComboBox);
     pFormLayout->addRow(tr("Sample rate"), m_pSampleRateComboBox);
     pFormLayout->addRow(tr("Buffer size"), m_pBufferSizeSpinBox);
+    pFormLayout->addRow(QString(), m_pCallbackRenderCheckBox);
     pFormLayout->addRow(new QLabel());
     pFormLayout->addRow(tr("MIDI In"), m_pMidiInComboBox);
     pFormLayout->addRow(tr("MIDI In channel"), m_pMidiInChannelComboBox);
@@ -15,6 +15,7 @@
     Lesser General Public License for more details.
 */
 
+#include <cmath>
 #include <QSplitter>
 #include <qwt_plot.h>
 #include <qwt_plot_picker.h>
@@ -23,6 +24,7 @@
 #include <qwt_plot_canvas.h>
 #include <qwt_scale_engine.h>
 #include "Fft.h"
+#include "RealFft.h"
 #include "Application.h"
 #include "AudioDevicesManager.h"
 #include "AudioDevice.h"
@@ -45,7 +47,10 @@ const int cSignalSize(4096);
 
 SpectrumWindow::SpectrumWindow(QWidget *pParent)
     : QDockWidget(pParent),
-      m_signal(cSignalSize, 0.0f)
+      m_signal(cSignalSize, 0.0f),
+      m_pFft(new RealFft(cSignalSize)),
+      m_window(Fft::window(Fft::Window_Hann, cSignalSize)),
+      m_spectrum(cSignalSize + 2, 0.0f)
 {
     setObjectName("spectrumWindow");
     setWindowTitle(tr("Audio output"));
@@ -64,6 +69,7 @@ SpectrumWindow::~SpectrumWindow()
 {
     delete m_pWaveformPicker;
     delete m_pSpectrumPicker;
+    delete m_pFft;
 }
 
 void SpectrumWindow::plotWaveform()
@@ -73,17 +79,22 @@ void SpectrumWindow::plotWaveform()
 
 void SpectrumWindow::plotSpectrum()
 {
-    Fft::Array input(m_signal.size());
-    for (int i = 0; i < m_signal.size(); i++) {
-        input[i] = clamp(qRound(m_signal.at(i) * 1e6) / 1e6);
+    Q_ASSERT(m_signal.size() == m_pFft->size());
 
+    float *pSpectrum = m_spectrum.data();
+    for (int i = 0; i < m_signal.size(); i++) {
+        pSpectrum[i] = clamp(qRound(m_signal.at(i) * 1e6) / 1e6) * m_window.at(i);
     }
 
-    Fft::direct(input, Fft::Window_Hann);
+    m_pFft->forward(pSpectrum, pSpectrum);
+
+    // Keep the same scale as the normalized complex transform
+    const float norm = 1.0f / std::sqrt(float(m_signal.size()));
 
     QVector<float> curve;
-    for (int i = 0; i < input.size() / 2; i++) {
-        float v = std::abs(input[i]);
+    curve.reserve(m_signal.size() / 2);
+    for (int i = 0; i < m_signal.size() / 2; i++) {
+        float v = std::hypot(pSpectrum[2 * i], pSpectrum[2 * i + 1]) * norm;
 #if 1
         // Spectrum in dB.
         v = 20 * log(v / 16.0);